@@ -2,7 +2,14 @@
 #include <Library/UefiLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
 #include "ACPI.h"
+#include "FileHelper.h"
+#include "AmlNamespace.h"
+#include "AcpiTopology.h"
+#include "BootPerformance.h"
+#include "SnapshotFormat.h"
 
 //
 // GUID for the ACPI 2.0 or later table, used to find the RSDP
@@ -59,6 +66,337 @@ FindRsdp(
   return EFI_NOT_FOUND;
 }
 
+#define ACPI_SOURCE_XSDT       0    // Where a table was first found
+#define ACPI_SOURCE_RSDT       1
+#define ACPI_SOURCE_FADT       2    // DSDT and FACS, referenced only by the FADT
+
+#define ACPI_CHECKSUM_UNKNOWN  0    // Not computed yet
+#define ACPI_CHECKSUM_VALID    1
+#define ACPI_CHECKSUM_INVALID  2
+#define ACPI_CHECKSUM_NONE     3    // FACS has no checksum
+
+#define ACPI_HEX_BYTES_PER_LINE  16
+#define ACPI_DUMP_LINE_MAX       96
+#define ACPI_DUMP_STEM           L"acpidump"  // File <stem>_<time>_NNN.txt
+#define ACPI_RAW_DIR_STEM        L"acpi"      // Directory <stem>_<time>_NNN of .dat files
+
+#define FACS_SIGNATURE  SIGNATURE_32('F', 'A', 'C', 'S')
+#define FADT_SIGNATURE  SIGNATURE_32('F', 'A', 'C', 'P')
+
+//
+// One entry of the table index. Checksums are computed the first time a row
+// is drawn or opened and then cached here.
+//
+typedef struct {
+  EFI_ACPI_DESCRIPTION_HEADER  *Header;
+  UINT32                       Signature;
+  UINT16                       Instance;       // 0-based among tables of this signature
+  UINT8                        Source;
+  UINT8                        ChecksumState;
+} ACPI_TABLE_ENTRY;
+
+//
+// The index is built once from the XSDT, the RSDT and the FADT. Each table
+// appears once no matter how many roots point at it. Two open-addressing
+// hashes hold entry numbers plus one (0 = empty slot): one keyed by address
+// (used to drop duplicates while building), one keyed by signature and
+// instance (used for lookups).
+//
+STATIC ACPI_TABLE_ENTRY  *mAcpiTables = NULL;
+STATIC UINTN             mAcpiTableCount = 0;
+STATIC UINTN             mAcpiCapacity = 0;
+STATIC UINT16            *mAcpiByAddress = NULL;
+STATIC UINT16            *mAcpiBySignature = NULL;
+STATIC UINTN             mAcpiHashMask = 0;
+STATIC UINTN             mAcpiSelected = 0;
+STATIC UINTN             mAcpiTop = 0;
+
+/**
+  Copy the fixed-width ASCII header fields into NUL-terminated strings.
+*/
+STATIC
+VOID
+GetAcpiHeaderStrings(
+  IN  EFI_ACPI_DESCRIPTION_HEADER  *Header,
+  OUT CHAR8                        Signature[5],
+  OUT CHAR8                        OemId[7],
+  OUT CHAR8                        OemTableId[9],
+  OUT CHAR8                        CreatorId[5]
+  )
+{
+  CopyMem(Signature, &Header->Signature, 4);   Signature[4] = '\0';
+  CopyMem(OemId, Header->OemId, 6);            OemId[6] = '\0';
+  CopyMem(OemTableId, &Header->OemTableId, 8); OemTableId[8] = '\0';
+  CopyMem(CreatorId, &Header->CreatorId, 4);   CreatorId[4] = '\0';
+}
+
+/**
+  Return the cached checksum state of a table, computing it on first use.
+*/
+STATIC
+UINT8
+GetAcpiChecksumState(
+  IN ACPI_TABLE_ENTRY  *Entry
+  )
+{
+  if (Entry->ChecksumState == ACPI_CHECKSUM_UNKNOWN) {
+    if (Entry->Signature == FACS_SIGNATURE) {
+      Entry->ChecksumState = ACPI_CHECKSUM_NONE;
+    } else {
+      Entry->ChecksumState = IsValidChecksum(Entry->Header, Entry->Header->Length) ?
+                               ACPI_CHECKSUM_VALID : ACPI_CHECKSUM_INVALID;
+    }
+  }
+  return Entry->ChecksumState;
+}
+
+/**
+  Multiplicative hash of a 64-bit key into the slot range.
+*/
+STATIC
+UINTN
+AcpiHashSlot(
+  IN UINT64  Key
+  )
+{
+  return (UINTN)RShiftU64(MultU64x64(Key, 0x9E3779B97F4A7C15ULL), 40) & mAcpiHashMask;
+}
+
+STATIC
+UINT64
+AcpiSignatureKey(
+  IN UINT32  Signature,
+  IN UINTN   Instance
+  )
+{
+  return LShiftU64(Instance, 32) | Signature;
+}
+
+/**
+  Find the entry for a signature and instance through the hash.
+*/
+STATIC
+ACPI_TABLE_ENTRY *
+LookupAcpiEntry(
+  IN UINT32  Signature,
+  IN UINTN   Instance
+  )
+{
+  UINTN Slot = AcpiHashSlot(AcpiSignatureKey(Signature, Instance));
+
+  while (mAcpiBySignature[Slot] != 0) {
+    ACPI_TABLE_ENTRY *Entry = &mAcpiTables[mAcpiBySignature[Slot] - 1];
+    if (Entry->Signature == Signature && Entry->Instance == Instance) {
+      return Entry;
+    }
+    Slot = (Slot + 1) & mAcpiHashMask;
+  }
+  return NULL;
+}
+
+/**
+  Add one table to the index unless the same address is already present.
+*/
+STATIC
+VOID
+AddAcpiTable(
+  IN UINT64  Address,
+  IN UINT8   Source
+  )
+{
+  ACPI_TABLE_ENTRY *Entry;
+  UINTN            Slot;
+  UINTN            Instance;
+
+  if (Address == 0 || mAcpiTableCount == mAcpiCapacity) {
+    return;
+  }
+
+  Slot = AcpiHashSlot(Address);
+  while (mAcpiByAddress[Slot] != 0) {
+    if ((UINT64)(UINTN)mAcpiTables[mAcpiByAddress[Slot] - 1].Header == Address) {
+      return;   // Already indexed through another root
+    }
+    Slot = (Slot + 1) & mAcpiHashMask;
+  }
+  mAcpiByAddress[Slot] = (UINT16)(mAcpiTableCount + 1);
+
+  Entry                = &mAcpiTables[mAcpiTableCount];
+  Entry->Header        = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Address;
+  Entry->Signature     = Entry->Header->Signature;
+  Entry->Source        = Source;
+  Entry->ChecksumState = ACPI_CHECKSUM_UNKNOWN;
+
+  // The next free instance number for this signature
+  for (Instance = 0; LookupAcpiEntry(Entry->Signature, Instance) != NULL; Instance++) {
+  }
+  Entry->Instance = (UINT16)Instance;
+
+  Slot = AcpiHashSlot(AcpiSignatureKey(Entry->Signature, Instance));
+  while (mAcpiBySignature[Slot] != 0) {
+    Slot = (Slot + 1) & mAcpiHashMask;
+  }
+  mAcpiBySignature[Slot] = (UINT16)(mAcpiTableCount + 1);
+
+  mAcpiTableCount++;
+}
+
+/**
+  Add the tables referenced by a root table (RSDT or XSDT) to the index.
+*/
+STATIC
+VOID
+AddAcpiRootEntries(
+  IN EFI_ACPI_DESCRIPTION_HEADER  *RootTable,
+  IN UINT8                        Source
+  )
+{
+  UINTN EntrySize  = (Source == ACPI_SOURCE_XSDT) ? sizeof(UINT64) : sizeof(UINT32);
+  UINTN EntryCount = (RootTable->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) / EntrySize;
+  UINT8 *EntryPtr  = (UINT8 *)RootTable + sizeof(EFI_ACPI_DESCRIPTION_HEADER);
+
+  for (UINTN i = 0; i < EntryCount; i++) {
+    UINT64 Address = 0;
+    CopyMem(&Address, EntryPtr + i * EntrySize, EntrySize);
+    AddAcpiTable(Address, Source);
+  }
+}
+
+/**
+  Add the DSDT and FACS of every FADT. The 64-bit X_ fields win when the
+  FADT is long enough to carry them and they are non-zero.
+*/
+STATIC
+VOID
+AddFadtReferences(VOID)
+{
+  ACPI_TABLE_ENTRY                          *Entry;
+  EFI_ACPI_2_0_FIXED_ACPI_DESCRIPTION_TABLE *Fadt;
+  UINT64                                    Dsdt, Facs;
+
+  for (UINTN Instance = 0; (Entry = LookupAcpiEntry(FADT_SIGNATURE, Instance)) != NULL; Instance++) {
+    Fadt = (EFI_ACPI_2_0_FIXED_ACPI_DESCRIPTION_TABLE *)Entry->Header;
+
+    Dsdt = Fadt->Dsdt;
+    if (Fadt->Header.Length >= OFFSET_OF(EFI_ACPI_2_0_FIXED_ACPI_DESCRIPTION_TABLE, XDsdt) + sizeof(UINT64) &&
+        Fadt->XDsdt != 0) {
+      Dsdt = Fadt->XDsdt;
+    }
+    Facs = Fadt->FirmwareCtrl;
+    if (Fadt->Header.Length >= OFFSET_OF(EFI_ACPI_2_0_FIXED_ACPI_DESCRIPTION_TABLE, XFirmwareCtrl) + sizeof(UINT64) &&
+        Fadt->XFirmwareCtrl != 0) {
+      Facs = Fadt->XFirmwareCtrl;
+    }
+    AddAcpiTable(Dsdt, ACPI_SOURCE_FADT);
+    AddAcpiTable(Facs, ACPI_SOURCE_FADT);
+  }
+}
+
+/**
+  Build the deduplicated index once. Only the RSDP and root tables are
+  checksummed here; the tables they point to are checked lazily.
+*/
+STATIC
+EFI_STATUS
+BuildAcpiIndex(VOID)
+{
+  EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER *Rsdp = NULL;
+  EFI_ACPI_DESCRIPTION_HEADER                  *Rsdt = NULL;
+  EFI_ACPI_DESCRIPTION_HEADER                  *Xsdt = NULL;
+  UINTN                                        Capacity = 0;
+  UINTN                                        Slots;
+
+  if (mAcpiTables != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR(FindRsdp(&Rsdp))) {
+    return EFI_NOT_FOUND;
+  }
+  if (!IsValidChecksum(Rsdp, sizeof(EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER))) {
+    return EFI_CRC_ERROR;
+  }
+
+  Rsdt = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->RsdtAddress;
+  if (Rsdt != NULL && IsValidChecksum(Rsdt, Rsdt->Length)) {
+    Capacity += (Rsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) / sizeof(UINT32);
+  } else {
+    Rsdt = NULL;
+  }
+  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->XsdtAddress;
+  if (Xsdt != NULL && IsValidChecksum(Xsdt, Xsdt->Length)) {
+    Capacity += (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) / sizeof(UINT64);
+  } else {
+    Xsdt = NULL;
+  }
+  // Room for the DSDT and FACS of a couple of FADTs
+  Capacity += 4;
+  if (Capacity > MAX_UINT16 / 2) {
+    Capacity = MAX_UINT16 / 2;
+  }
+
+  // Keep the hashes at most half full
+  for (Slots = 16; Slots < Capacity * 2; Slots <<= 1) {
+  }
+
+  mAcpiTables      = AllocateZeroPool(Capacity * sizeof(ACPI_TABLE_ENTRY));
+  mAcpiByAddress   = AllocateZeroPool(Slots * sizeof(UINT16));
+  mAcpiBySignature = AllocateZeroPool(Slots * sizeof(UINT16));
+  if (mAcpiTables == NULL || mAcpiByAddress == NULL || mAcpiBySignature == NULL) {
+    if (mAcpiTables != NULL)      FreePool(mAcpiTables);
+    if (mAcpiByAddress != NULL)   FreePool(mAcpiByAddress);
+    if (mAcpiBySignature != NULL) FreePool(mAcpiBySignature);
+    mAcpiTables      = NULL;
+    mAcpiByAddress   = NULL;
+    mAcpiBySignature = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+  mAcpiCapacity = Capacity;
+  mAcpiHashMask = Slots - 1;
+
+  // XSDT first: on 64-bit firmware it is the authoritative root
+  if (Xsdt != NULL) {
+    AddAcpiRootEntries(Xsdt, ACPI_SOURCE_XSDT);
+  }
+  if (Rsdt != NULL) {
+    AddAcpiRootEntries(Rsdt, ACPI_SOURCE_RSDT);
+  }
+  AddFadtReferences();
+
+  // The address hash is only needed while building
+  FreePool(mAcpiByAddress);
+  mAcpiByAddress = NULL;
+  return EFI_SUCCESS;
+}
+
+EFI_ACPI_DESCRIPTION_HEADER *
+AcpiFindTable(
+  IN UINT32  Signature,
+  IN UINTN   Instance
+  )
+{
+  ACPI_TABLE_ENTRY *Entry;
+
+  if (EFI_ERROR(BuildAcpiIndex())) {
+    return NULL;
+  }
+  Entry = LookupAcpiEntry(Signature, Instance);
+  return (Entry != NULL) ? Entry->Header : NULL;
+}
+
+/**
+  Number of list rows between the header line and the footer.
+*/
+STATIC
+UINTN
+AcpiVisibleRows(VOID)
+{
+  UINTN Columns, Rows;
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  return (Rows > 5) ? (Rows - 4) : 1;
+}
+
 /**
   Prints the header row for the ACPI table list.
 */
@@ -70,123 +408,571 @@ PrintAcpiTableHeader(VOID)
     gST->ConOut->ClearScreen(gST->ConOut);
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
 
-    Print(L"  %-12s %-10s %-10s %-8s %-14s %-s\n", 
-        L"ACPI Table", L"Address", L"Length", L"OEMID", L"OEM Table ID", L"Creator ID");
+    Print(L"  %-6s %-5s %-16s %-10s %-8s %-10s %-6s %-s\n",
+        L"Table", L"From", L"Address", L"Length", L"OEMID", L"OEM Tbl ID", L"Crtr", L"Checksum");
 
     // Restore default attribute
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
 }
 
 /**
-  Prints the entries of a given root table (RSDT or XSDT).
-  
-  @param RootTable      A pointer to the root table (RSDT or XSDT).
-  @param IsXsdt         TRUE if the RootTable is XSDT, FALSE if it's RSDT.
+  Prints one row of the table list at its position in the window.
 */
+STATIC
 VOID
-PrintAcpiTableEntries(
-  IN EFI_ACPI_DESCRIPTION_HEADER *RootTable,
-  IN BOOLEAN IsXsdt
-)
-{
-    UINTN EntryCount;
-    
-    if (IsXsdt) {
-        UINT64 *EntryPtr = (UINT64*)((UINT8*)RootTable + sizeof(EFI_ACPI_DESCRIPTION_HEADER));
-        EntryCount = (RootTable->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) / sizeof(UINT64);
-        for (UINTN i = 0; i < EntryCount; i++) {
-            EFI_ACPI_DESCRIPTION_HEADER* TableHeader = (EFI_ACPI_DESCRIPTION_HEADER*)(UINTN)EntryPtr[i];
-            CHAR8 OemIdStr[7], OemTableIdStr[9], CreatorIdStr[5];
-            
-            CopyMem(OemIdStr, TableHeader->OemId, 6); OemIdStr[6] = '\0';
-            CopyMem(OemTableIdStr, &TableHeader->OemTableId, 8); OemTableIdStr[8] = '\0';
-            *(UINT32*)CreatorIdStr = TableHeader->CreatorId; CreatorIdStr[4] = '\0';
-            
-            Print(L"    %-10a   %-10X %-10X %-8a %-14a %-a\n", 
-                (CHAR8*)&TableHeader->Signature, TableHeader, TableHeader->Length,
-                OemIdStr, OemTableIdStr, CreatorIdStr
-            );
-        }
-    } else { // This is an RSDT with 32-bit pointers
-        UINT32 *EntryPtr = (UINT32*)((UINT8*)RootTable + sizeof(EFI_ACPI_DESCRIPTION_HEADER));
-        EntryCount = (RootTable->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) / sizeof(UINT32);
-        for (UINTN i = 0; i < EntryCount; i++) {
-            EFI_ACPI_DESCRIPTION_HEADER* TableHeader = (EFI_ACPI_DESCRIPTION_HEADER*)(UINTN)EntryPtr[i];
-            CHAR8 OemIdStr[7], OemTableIdStr[9], CreatorIdStr[5];
-            
-            CopyMem(OemIdStr, TableHeader->OemId, 6); OemIdStr[6] = '\0';
-            CopyMem(OemTableIdStr, &TableHeader->OemTableId, 8); OemTableIdStr[8] = '\0';
-            *(UINT32*)CreatorIdStr = TableHeader->CreatorId; CreatorIdStr[4] = '\0';
-            
-            Print(L"    %-10a   %-10X %-10X %-8a %-14a %-a\n", 
-                (CHAR8*)&TableHeader->Signature, TableHeader, TableHeader->Length,
-                OemIdStr, OemTableIdStr, CreatorIdStr
-            );
-        }
+DrawAcpiTableRow(
+  IN UINTN  Index
+  )
+{
+  ACPI_TABLE_ENTRY *Entry = &mAcpiTables[Index];
+  UINTN            Background = (Index == mAcpiSelected) ? EFI_GREEN : EFI_BLUE;
+  CHAR8            Signature[5], OemIdStr[7], OemTableIdStr[9], CreatorIdStr[5];
+  UINT8            State;
+
+  GetAcpiHeaderStrings(Entry->Header, Signature, OemIdStr, OemTableIdStr, CreatorIdStr);
+  State = GetAcpiChecksumState(Entry);
+  if (State == ACPI_CHECKSUM_NONE) {
+    // Past the length the FACS holds other fields, not the OEM strings
+    OemIdStr[0] = OemTableIdStr[0] = CreatorIdStr[0] = '\0';
+  }
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Index - mAcpiTop);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, Background));
+  Print(L"  %-6a ", Signature);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, Background));
+  Print(L"%-5s %016lX %-10X %-8a %-10a %-6a ",
+        (Entry->Source == ACPI_SOURCE_XSDT) ? L"XSDT" :
+        (Entry->Source == ACPI_SOURCE_RSDT) ? L"RSDT" : L"FADT",
+        (UINT64)(UINTN)Entry->Header, Entry->Header->Length,
+        OemIdStr, OemTableIdStr, CreatorIdStr);
+  if (State == ACPI_CHECKSUM_VALID) {
+    Print(L"%-8s", L"OK");
+  } else if (State == ACPI_CHECKSUM_NONE) {
+    Print(L"%-8s", L"n/a");
+  } else {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTRED, Background));
+    Print(L"%-8s", L"BAD");
+  }
+}
+
+/**
+  Draws the visible window of the table list around the selection.
+*/
+STATIC
+VOID
+DrawAcpiTableList(VOID)
+{
+  UINTN Visible = AcpiVisibleRows();
+
+  if (mAcpiSelected < mAcpiTop) {
+    mAcpiTop = mAcpiSelected;
+  } else if (mAcpiSelected >= mAcpiTop + Visible) {
+    mAcpiTop = mAcpiSelected - Visible + 1;
+  }
+
+  PrintAcpiTableHeader();
+  for (UINTN i = mAcpiTop; i < mAcpiTableCount && i < mAcpiTop + Visible; i++) {
+    DrawAcpiTableRow(i);
+  }
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Visible);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"\nTable %3d of %3d. ENTER open, N namespace, T topology, F FPDT, Ctrl+S export",
+        mAcpiSelected + 1, mAcpiTableCount);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
+
+/**
+  Prints one line of the hex view: offset, 16 bytes and their ASCII form.
+*/
+STATIC
+VOID
+PrintAcpiHexLine(
+  IN UINT8  *Table,
+  IN UINTN  Offset,
+  IN UINTN  Length
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"  %06X: ", Offset);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  for (UINTN j = 0; j < ACPI_HEX_BYTES_PER_LINE; j++) {
+    if (Offset + j < Length) {
+      Print(L"%02X ", Table[Offset + j]);
+    } else {
+      Print(L"   ");
+    }
+  }
+  Print(L" ");
+  for (UINTN j = 0; j < ACPI_HEX_BYTES_PER_LINE && Offset + j < Length; j++) {
+    CHAR8 c = (CHAR8)Table[Offset + j];
+    Print(L"%c", (c >= 0x20 && c < 0x7F) ? (CHAR16)c : L'.');
+  }
+  Print(L"\n");
+}
+
+/**
+  Shows one table: decoded header fields and a paged hex view of the body.
+  Only the lines on screen are read, so large tables open instantly.
+*/
+STATIC
+VOID
+ShowAcpiTable(
+  IN ACPI_TABLE_ENTRY  *Entry
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER *Header = Entry->Header;
+  UINT8                       *Table  = (UINT8 *)Header;
+  CHAR8                       Signature[5], OemIdStr[7], OemTableIdStr[9], CreatorIdStr[5];
+  UINTN                       Columns, Rows, Visible;
+  UINTN                       BodyLines;
+  UINTN                       TopLine = 0;
+  EFI_INPUT_KEY               Key;
+
+  UINTN                       BodyStart;
+
+  GetAcpiHeaderStrings(Header, Signature, OemIdStr, OemTableIdStr, CreatorIdStr);
+
+  // The FACS has only a signature and length, so the hex view covers it all
+  BodyStart = (Entry->Signature == FACS_SIGNATURE) ? 0 : sizeof(EFI_ACPI_DESCRIPTION_HEADER);
+
+  // Title, four header lines, a blank line, two footer lines and a spare one
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  Visible   = (Rows > 10) ? (Rows - 9) : 1;
+  BodyLines = (Header->Length > BodyStart) ?
+              (Header->Length - BodyStart + ACPI_HEX_BYTES_PER_LINE - 1) / ACPI_HEX_BYTES_PER_LINE : 0;
+
+  while (TRUE) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" %a table at 0x%lX\n", Signature, (UINT64)(UINTN)Header);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    if (BodyStart == 0) {
+      Print(L"  Signature : %-6a  Length   : 0x%X (%d)\n", Signature, Header->Length, Header->Length);
+      Print(L"  No standard header or checksum.\n\n\n\n");
+    } else {
+      Print(L"  Signature : %-6a  Length   : 0x%X (%d)   Revision: %d\n",
+            Signature, Header->Length, Header->Length, Header->Revision);
+      Print(L"  Checksum  : 0x%02X (%s)\n", Header->Checksum,
+            (GetAcpiChecksumState(Entry) == ACPI_CHECKSUM_VALID) ? L"valid" : L"INVALID");
+      Print(L"  OEM ID    : %-6a  OEM Table ID: %-8a  OEM Revision: 0x%X\n",
+            OemIdStr, OemTableIdStr, Header->OemRevision);
+      Print(L"  Creator ID: %-6a  Creator Revision: 0x%X\n\n", CreatorIdStr, Header->CreatorRevision);
+    }
+
+    for (UINTN Line = TopLine; Line < BodyLines && Line < TopLine + Visible; Line++) {
+      PrintAcpiHexLine(Table, BodyStart + Line * ACPI_HEX_BYTES_PER_LINE, Header->Length);
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nBody line %d of %d. Up/Down/PgUp/PgDn scroll, ESC to return",
+          (BodyLines > 0) ? TopLine + 1 : 0, BodyLines);
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    } else if (Key.ScanCode == SCAN_UP) {
+      if (TopLine > 0) TopLine--;
+    } else if (Key.ScanCode == SCAN_DOWN) {
+      if (TopLine + Visible < BodyLines) TopLine++;
+    } else if (Key.ScanCode == SCAN_PAGE_UP) {
+      TopLine = (TopLine > Visible) ? (TopLine - Visible) : 0;
+    } else if (Key.ScanCode == SCAN_PAGE_DOWN) {
+      if (TopLine + Visible < BodyLines) {
+        TopLine += Visible;
+      }
+    } else if (Key.ScanCode == SCAN_HOME) {
+      TopLine = 0;
+    } else if (Key.ScanCode == SCAN_END) {
+      TopLine = (BodyLines > Visible) ? (BodyLines - Visible) : 0;
+    }
+  }
+}
+
+/**
+  Formats one line of acpidump's hex format: the offset, 16 bytes and their
+  ASCII form. Bytes are converted by table lookup since large DSDTs run to
+  tens of thousands of lines.
+
+  @return The number of characters written to Line.
+*/
+STATIC
+UINTN
+FormatAcpiDumpLine(
+  IN  CONST UINT8  *Data,
+  IN  UINTN        Offset,
+  IN  UINTN        Count,
+  OUT CHAR8        *Line
+  )
+{
+  STATIC CONST CHAR8 HexDigits[] = "0123456789ABCDEF";
+  UINTN              Used;
+
+  // acpidump prints "%8.4X": at least four digits in an eight wide column
+  Used = AsciiSPrint(Line, ACPI_DUMP_LINE_MAX, (Offset > 0xFFFF) ? "%8X: " : "    %04X: ", Offset);
+  for (UINTN j = 0; j < ACPI_HEX_BYTES_PER_LINE; j++) {
+    if (j < Count) {
+      Line[Used++] = HexDigits[Data[j] >> 4];
+      Line[Used++] = HexDigits[Data[j] & 0x0F];
+    } else {
+      Line[Used++] = ' ';
+      Line[Used++] = ' ';
+    }
+    Line[Used++] = ' ';
+  }
+  Line[Used++] = ' ';
+  for (UINTN j = 0; j < Count; j++) {
+    Line[Used++] = (Data[j] >= 0x20 && Data[j] < 0x7F) ? (CHAR8)Data[j] : '.';
+  }
+  Line[Used++] = '\n';
+  return Used;
+}
+
+/**
+  Streams one table in acpidump's text format through the writer.
+*/
+STATIC
+EFI_STATUS
+DumpAcpiTableText(
+  IN FILE_WRITER  *Writer,
+  IN CONST CHAR8  *Signature,
+  IN CONST VOID   *Table,
+  IN UINTN        Length
+  )
+{
+  CONST UINT8 *Data = Table;
+  CHAR8       Line[ACPI_DUMP_LINE_MAX];
+  UINTN       Used;
+
+  Used = AsciiSPrint(Line, sizeof(Line), "%a @ 0x%016lX\n", Signature, (UINT64)(UINTN)Table);
+  FileWriterAppend(Writer, Line, Used);
+  for (UINTN Offset = 0; Offset < Length; Offset += ACPI_HEX_BYTES_PER_LINE) {
+    Used = FormatAcpiDumpLine(Data + Offset, Offset, MIN(ACPI_HEX_BYTES_PER_LINE, Length - Offset), Line);
+    FileWriterAppend(Writer, Line, Used);
+  }
+  return FileWriterAppend(Writer, "\n", 1);
+}
+
+/**
+  Writes one table to its own binary file in Directory, named as acpixtract
+  names them: the lower-case signature, with the instance number when a
+  signature occurs more than once (ssdt1.dat, ssdt2.dat, ...).
+*/
+STATIC
+EFI_STATUS
+DumpAcpiTableRaw(
+  IN CONST CHAR16 *Directory,
+  IN CONST CHAR8  *Signature,
+  IN UINTN        Instance,
+  IN BOOLEAN      Numbered,
+  IN CONST VOID   *Table,
+  IN UINTN        Length
+  )
+{
+  FILE_WRITER Writer;
+  CHAR16      FileName[64];
+  CHAR16      Name[5];
+  EFI_STATUS  Status;
+
+  for (UINTN i = 0; i < 4; i++) {
+    CHAR8 c = Signature[i];
+    if (c >= 'A' && c <= 'Z') {
+      c = (CHAR8)(c - 'A' + 'a');
+    } else if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+      c = '_';
     }
+    Name[i] = (CHAR16)c;
+  }
+  Name[4] = L'\0';
+  if (Numbered) {
+    UnicodeSPrint(FileName, sizeof(FileName), L"%s\\%s%d.dat", Directory, Name, Instance + 1);
+  } else {
+    UnicodeSPrint(FileName, sizeof(FileName), L"%s\\%s.dat", Directory, Name);
+  }
+
+  Status = FileWriterOpen(gImageHandle, FileName, &Writer);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  FileWriterAppend(&Writer, Table, Length);
+  return FileWriterClose(&Writer);
+}
+
+/**
+  Writes every table reachable from the RSDP: the RSDP, XSDT and RSDT,
+  then each table of the index. Text mode streams them all into one
+  acpidump-compatible file; raw mode writes one .dat file per table into a
+  new directory. Names are numbered so earlier exports are kept.
+
+  @param[in]   Raw         TRUE for one binary file per table.
+  @param[out]  Target      Receives the file or directory name.
+  @param[in]   TargetSize  Size of Target in bytes.
+  @param[out]  Count       Number of tables written.
+*/
+STATIC
+EFI_STATUS
+ExportAcpiTables(
+  IN  BOOLEAN  Raw,
+  OUT CHAR16   *Target,
+  IN  UINTN    TargetSize,
+  OUT UINTN    *Count
+  )
+{
+  EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER *Rsdp = NULL;
+  EFI_ACPI_DESCRIPTION_HEADER                  *Root[2];
+  FILE_WRITER                                  Writer;
+  EFI_STATUS                                   Status;
+  CHAR8                                        Signature[5];
+  CHAR16                                       Stem[48];
+  UINTN                                        RsdpLength;
+
+  *Count = 0;
+  Status = BuildAcpiIndex();
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  FindRsdp(&Rsdp);
+  RsdpLength = (Rsdp->Revision >= 2) ? Rsdp->Length : 20;
+  Root[0] = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->XsdtAddress;
+  Root[1] = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->RsdtAddress;
+
+  if (Raw) {
+    MakeTimestampStem(ACPI_RAW_DIR_STEM, Stem, sizeof(Stem));
+    Status = MakeExportDirectory(gImageHandle, Stem, Target, TargetSize);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  } else {
+    MakeTimestampStem(ACPI_DUMP_STEM, Stem, sizeof(Stem));
+    Status = MakeExportFileName(gImageHandle, Stem, L"txt", Target, TargetSize);
+    if (!EFI_ERROR(Status)) {
+      Status = FileWriterOpen(gImageHandle, Target, &Writer);
+    }
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+
+  // The RSDP and the roots are not in the index
+  Status = Raw ? DumpAcpiTableRaw(Target, "RSDP", 0, FALSE, Rsdp, RsdpLength) :
+                 DumpAcpiTableText(&Writer, "RSDP", Rsdp, RsdpLength);
+  if (!EFI_ERROR(Status)) {
+    (*Count)++;
+  }
+  for (UINTN i = 0; i < ARRAY_SIZE(Root) && !EFI_ERROR(Status); i++) {
+    if (Root[i] == NULL || (i == 0 && Rsdp->Revision < 2)) {
+      continue;
+    }
+    CopyMem(Signature, &Root[i]->Signature, 4);
+    Signature[4] = '\0';
+    Status = Raw ? DumpAcpiTableRaw(Target, Signature, 0, FALSE, Root[i], Root[i]->Length) :
+                   DumpAcpiTableText(&Writer, Signature, Root[i], Root[i]->Length);
+    if (!EFI_ERROR(Status)) {
+      (*Count)++;
+    }
+  }
+
+  for (UINTN i = 0; i < mAcpiTableCount && !EFI_ERROR(Status); i++) {
+    ACPI_TABLE_ENTRY *Entry = &mAcpiTables[i];
+
+    CopyMem(Signature, &Entry->Signature, 4);
+    Signature[4] = '\0';
+    if (Raw) {
+      BOOLEAN Numbered = (BOOLEAN)(Entry->Instance > 0 || LookupAcpiEntry(Entry->Signature, 1) != NULL);
+      Status = DumpAcpiTableRaw(Target, Signature, Entry->Instance, Numbered, Entry->Header, Entry->Header->Length);
+    } else {
+      Status = DumpAcpiTableText(&Writer, Signature, Entry->Header, Entry->Header->Length);
+    }
+    if (!EFI_ERROR(Status)) {
+      (*Count)++;
+    }
+  }
+
+  if (!Raw) {
+    if (EFI_ERROR(Status)) {
+      FileWriterClose(&Writer);
+      return Status;
+    }
+    return FileWriterClose(&Writer);
+  }
+  return Status;
+}
+
+/**
+  Appends one table to a snapshot section as SNAPSHOT_ACPI_TABLE + bytes.
+*/
+STATIC
+EFI_STATUS
+AppendAcpiSnapshotTable(
+  IN OUT FILE_WRITER  *Writer,
+  IN     CONST VOID   *Table,
+  IN     UINTN        Length
+  )
+{
+  SNAPSHOT_ACPI_TABLE Record;
+
+  Record.Address  = (UINT64)(UINTN)Table;
+  Record.Length   = (UINT32)Length;
+  Record.Reserved = 0;
+  FileWriterAppend(Writer, &Record, sizeof(Record));
+  return FileWriterAppend(Writer, Table, Length);
+}
+
+EFI_STATUS
+WriteAcpiSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  )
+{
+  EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER *Rsdp = NULL;
+  EFI_ACPI_DESCRIPTION_HEADER                  *Root[2];
+  EFI_STATUS                                   Status;
+
+  *Count = 0;
+  Status = BuildAcpiIndex();
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  FindRsdp(&Rsdp);
+  Root[0] = (Rsdp->Revision >= 2) ? (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->XsdtAddress : NULL;
+  Root[1] = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->RsdtAddress;
+
+  // Same set as the acpidump export: RSDP, the roots, then the index
+  Status = AppendAcpiSnapshotTable(Writer, Rsdp, (Rsdp->Revision >= 2) ? Rsdp->Length : 20);
+  (*Count)++;
+  for (UINTN i = 0; i < ARRAY_SIZE(Root); i++) {
+    if (Root[i] != NULL) {
+      Status = AppendAcpiSnapshotTable(Writer, Root[i], Root[i]->Length);
+      (*Count)++;
+    }
+  }
+  for (UINTN i = 0; i < mAcpiTableCount && !EFI_ERROR(Status); i++) {
+    Status = AppendAcpiSnapshotTable(Writer, mAcpiTables[i].Header, mAcpiTables[i].Header->Length);
+    (*Count)++;
+  }
+  return Status;
+}
+
+/**
+  Asks for the export format on the footer line and runs the export.
+*/
+STATIC
+VOID
+PromptAcpiExport(VOID)
+{
+  EFI_INPUT_KEY Key;
+  EFI_STATUS    Status;
+  UINTN         Exported;
+  BOOLEAN       Raw;
+  CHAR16        Target[64];
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 2 + AcpiVisibleRows());
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"Export all tables: T acpidump text, R raw .dat per table, ESC cancel ");
+
+  gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+  gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+  if (Key.UnicodeChar == L't' || Key.UnicodeChar == L'T' || Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
+    Raw = FALSE;
+  } else if (Key.UnicodeChar == L'r' || Key.UnicodeChar == L'R') {
+    Raw = TRUE;
+  } else {
+    return;
+  }
+
+  Status = ExportAcpiTables(Raw, Target, sizeof(Target), &Exported);
+  gST->ConOut->ClearScreen(gST->ConOut);
+  if (EFI_ERROR(Status)) {
+    Print(L"Export failed after %u tables: %r\n", Exported, Status);
+  } else if (Raw) {
+    Print(L"Exported %u tables as .dat files in %s\\\n", Exported, Target);
+  } else {
+    Print(L"Exported %u tables to %s\n", Exported, Target);
+  }
+  // Wait for a key before continuing
+  gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+  gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
 }
 
 /**
   Main entry point for the ACPI feature.
-  Finds and lists all available ACPI tables from both RSDT and XSDT.
+  Lists every table reachable from the XSDT, RSDT and FADT once; ENTER opens one.
 */
 VOID
 ReadAcpiTables(VOID)
 {
-    EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER *Rsdp = NULL;
-    EFI_ACPI_DESCRIPTION_HEADER                  *Rsdt = NULL;
-    EFI_ACPI_DESCRIPTION_HEADER                  *Xsdt = NULL;
-    UINTN                                        SavedAttribute;
+    UINTN          SavedAttribute;
+    UINTN          Visible;
+    EFI_STATUS     Status;
+    EFI_INPUT_KEY  Key;
 
     // Save current text attribute
     SavedAttribute = gST->ConOut->Mode->Attribute;
-    
+
     // FIX: Set colors to Light Gray on Blue background
     gST->ConOut->ClearScreen(gST->ConOut);
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
 
-    PrintAcpiTableHeader();
-    
-    if (EFI_ERROR(FindRsdp(&Rsdp))) {
-        Print(L"Error: ACPI 2.0+ configuration table not found.\n");
-        gST->ConOut->SetAttribute(gST->ConOut, SavedAttribute); // Restore attribute on exit
-        return;
-    }
-    if (!IsValidChecksum(Rsdp, sizeof(EFI_ACPI_2_0_ROOT_SYSTEM_DESCRIPTION_POINTER))) {
-        Print(L"Error: ACPI RSDP checksum is invalid.\n");
+    // The index is built once per session; checksums fill in as rows are shown
+    Status = BuildAcpiIndex();
+    if (EFI_ERROR(Status) || mAcpiTableCount == 0) {
+        if (Status == EFI_NOT_FOUND) {
+            Print(L"Error: ACPI 2.0+ configuration table not found.\n");
+        } else if (Status == EFI_CRC_ERROR) {
+            Print(L"Error: ACPI RSDP checksum is invalid.\n");
+        } else if (EFI_ERROR(Status)) {
+            Print(L"Failed to build the ACPI table index: %r\n", Status);
+        } else {
+            Print(L"No ACPI tables found.\n");
+        }
+        gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+        gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
         gST->ConOut->SetAttribute(gST->ConOut, SavedAttribute); // Restore attribute on exit
         return;
     }
-
-    // --- Process RSDT ---
-    Rsdt = (EFI_ACPI_DESCRIPTION_HEADER*)(UINTN)Rsdp->RsdtAddress;
-    if (Rsdt != NULL && IsValidChecksum(Rsdt, Rsdt->Length)) {
-        // Set color to yellow for the "RSDT" title
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-        Print(L"RSDT\n");
-        // Set color back for the header and entries
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
-
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-        PrintAcpiTableEntries(Rsdt, FALSE);
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
-        Print(L"\n");
+    if (mAcpiSelected >= mAcpiTableCount) {
+        mAcpiSelected = 0;
     }
 
-    // --- Process XSDT ---
-    Xsdt = (EFI_ACPI_DESCRIPTION_HEADER*)Rsdp->XsdtAddress;
-    if (Xsdt != NULL && IsValidChecksum(Xsdt, Xsdt->Length)) {
-        // Set color to yellow for the "XSDT" title
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-        Print(L"XSDT\n");
-        // Set color back for the header and entries
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    DrawAcpiTableList();
+    while (TRUE) {
+        gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+        gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
 
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-        PrintAcpiTableEntries(Xsdt, TRUE);
-        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+        Visible = AcpiVisibleRows();
+        if (Key.ScanCode == SCAN_ESC) {
+            break;
+        } else if (Key.ScanCode == SCAN_UP) {
+            if (mAcpiSelected > 0) mAcpiSelected--;
+        } else if (Key.ScanCode == SCAN_DOWN) {
+            if (mAcpiSelected + 1 < mAcpiTableCount) mAcpiSelected++;
+        } else if (Key.ScanCode == SCAN_PAGE_UP) {
+            mAcpiSelected = (mAcpiSelected > Visible) ? (mAcpiSelected - Visible) : 0;
+        } else if (Key.ScanCode == SCAN_PAGE_DOWN) {
+            mAcpiSelected = (mAcpiSelected + Visible < mAcpiTableCount) ?
+                            (mAcpiSelected + Visible) : (mAcpiTableCount - 1);
+        } else if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
+            ShowAcpiTable(&mAcpiTables[mAcpiSelected]);
+        } else if (Key.UnicodeChar == L'n' || Key.UnicodeChar == L'N') {
+            ShowAcpiNamespace();
+        } else if (Key.UnicodeChar == L't' || Key.UnicodeChar == L'T') {
+            ShowAcpiTopology();
+        } else if (Key.UnicodeChar == L'f' || Key.UnicodeChar == L'F') {
+            ShowBootPerformance();
+        } else if (Key.UnicodeChar == 0x13) {
+            // Ctrl+S: write every table reachable from the RSDP
+            PromptAcpiExport();
+        } else {
+            continue;
+        }
+        DrawAcpiTableList();
     }
 
     // Restore original text attribute before returning
+    gST->ConOut->ClearScreen(gST->ConOut);
     gST->ConOut->SetAttribute(gST->ConOut, SavedAttribute);
-}
\ No newline at end of file
+}
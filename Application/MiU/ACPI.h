@@ -1,8 +1,42 @@
 #pragma once
 #include <Uefi.h>
 #include <Guid/Acpi.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
 
 // Main entry point for ACPI feature
 VOID ReadAcpiTables(VOID);
 
+/**
+  Finds an ACPI table by signature. Every table reachable from the XSDT,
+  RSDT and FADT is indexed once, so a table listed by both roots is seen
+  once. The index is built on first use.
+
+  @param  Signature  The table signature, e.g. SIGNATURE_32('S','S','D','T').
+  @param  Instance   0 for the first table with this signature, 1 for the
+                     next one, and so on.
+
+  @return The table header, or NULL if there is no such table.
+*/
+EFI_ACPI_DESCRIPTION_HEADER *
+AcpiFindTable(
+  IN UINT32  Signature,
+  IN UINTN   Instance
+  );
+
+/**
+  Streams the RSDP, XSDT, RSDT and every indexed table into a snapshot
+  section as SNAPSHOT_ACPI_TABLE records (SnapshotFormat.h).
+
+  @param  Writer  The section writer.
+  @param  Arena   Collector scratch; unused, tables are written in place.
+  @param  Count   Number of tables written.
+*/
+EFI_STATUS
+WriteAcpiSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  );
+
 // Add more ACPI-related function prototypes here as you implement features
\ No newline at end of file
@@ -0,0 +1,763 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "ACPI.h"
+#include "AcpiTopology.h"
+#include "ShowMemoryMap.h"
+
+#define MADT_SIGNATURE  SIGNATURE_32('A', 'P', 'I', 'C')
+#define SRAT_SIGNATURE  SIGNATURE_32('S', 'R', 'A', 'T')
+#define SLIT_SIGNATURE  SIGNATURE_32('S', 'L', 'I', 'T')
+
+//
+// Structure layouts used by the decoder (ACPI 6.5, 5.2.12 - 5.2.17).
+// Offsets are from the start of each sub-table.
+//
+#define MADT_ENTRIES_OFFSET        44     // Header, local APIC address, flags
+#define MADT_LOCAL_APIC            0x00
+#define MADT_LOCAL_X2APIC          0x09
+#define MADT_GICC                  0x0B
+#define MADT_APIC_UID              2      // UINT8
+#define MADT_APIC_ID               3      // UINT8
+#define MADT_APIC_FLAGS            4
+#define MADT_X2APIC_ID             4
+#define MADT_X2APIC_FLAGS          8
+#define MADT_X2APIC_UID            12
+#define MADT_GICC_INTERFACE        4
+#define MADT_GICC_UID              8
+#define MADT_GICC_FLAGS            12
+#define MADT_GICC_MIN_LENGTH       16
+
+#define SRAT_ENTRIES_OFFSET        48     // Header, table revision, reserved
+#define SRAT_APIC_AFFINITY         0x00
+#define SRAT_MEMORY_AFFINITY       0x01
+#define SRAT_X2APIC_AFFINITY       0x02
+#define SRAT_GICC_AFFINITY         0x03
+#define SRAT_APIC_DOMAIN_LOW       2      // UINT8, bits 7:0
+#define SRAT_APIC_ID               3      // UINT8
+#define SRAT_APIC_FLAGS            4
+#define SRAT_APIC_DOMAIN_HIGH      9      // 3 bytes, bits 31:8
+#define SRAT_MEMORY_DOMAIN         2
+#define SRAT_MEMORY_BASE           8      // UINT64
+#define SRAT_MEMORY_LENGTH         16     // UINT64
+#define SRAT_MEMORY_FLAGS          28
+#define SRAT_X2APIC_DOMAIN         4
+#define SRAT_X2APIC_ID             8
+#define SRAT_X2APIC_FLAGS          12
+#define SRAT_GICC_DOMAIN           2
+#define SRAT_GICC_UID              6
+#define SRAT_GICC_FLAGS            10
+
+#define SLIT_LOCALITY_COUNT        36     // UINT64, then the N x N matrix
+
+#define AFFINITY_ENABLED           BIT0
+#define MEMORY_HOT_PLUGGABLE       BIT1
+#define MEMORY_NON_VOLATILE        BIT2
+
+#define TOPOLOGY_NO_DOMAIN         MAX_UINT32
+#define TOPOLOGY_CPU_APIC          0
+#define TOPOLOGY_CPU_X2APIC        1
+#define TOPOLOGY_CPU_GICC          2
+
+typedef struct {
+  UINT32   Id;            // APIC ID, x2APIC ID or GIC CPU interface number
+  UINT32   Uid;           // ACPI processor UID
+  UINT32   Domain;        // TOPOLOGY_NO_DOMAIN when the SRAT does not place it
+  UINT8    Kind;
+  BOOLEAN  Enabled;
+} TOPOLOGY_CPU;
+
+typedef struct {
+  UINT32   Domain;
+  UINT32   Flags;
+  UINT64   Base;
+  UINT64   Length;
+  UINT64   MappedBytes;   // UEFI memory map RAM inside the range
+  UINT64   FreeBytes;     // Of which EfiConventionalMemory
+} TOPOLOGY_RANGE;
+
+typedef struct {
+  UINT32   Domain;
+  UINTN    CpuCount;
+  UINTN    EnabledCpus;
+  UINTN    RangeCount;
+  UINT64   SratBytes;
+  UINT64   MappedBytes;
+  UINT64   FreeBytes;
+} TOPOLOGY_DOMAIN;
+
+typedef struct {
+  TOPOLOGY_CPU     *Cpus;
+  UINTN            CpuCount;
+  TOPOLOGY_RANGE   *Ranges;
+  UINTN            RangeCount;
+  TOPOLOGY_DOMAIN  *Domains;
+  UINTN            DomainCount;
+  UINT8            *Distances;       // SLIT matrix, inside the table
+  UINTN            Localities;
+  BOOLEAN          HasMadt;
+  BOOLEAN          HasSrat;
+  UINT64           MapRamBytes;      // Every memory map type but MMIO
+  UINT64           UnassignedBytes;  // Map RAM outside every SRAT range
+} TOPOLOGY;
+
+typedef enum {
+  TopologyPageDomains,
+  TopologyPageCpus,
+  TopologyPageMemory,
+  TopologyPageDistances,
+  TopologyPageMax
+} TOPOLOGY_PAGE;
+
+STATIC CONST CHAR16 *mTopologyPageName[TopologyPageMax] = {
+  L"Proximity domains", L"CPUs", L"Memory ranges", L"SLIT distances"
+};
+
+/**
+  Read a little-endian field of Width bytes from a sub-table.
+**/
+STATIC
+UINT64
+ReadTopologyField(
+  IN CONST UINT8  *Entry,
+  IN UINTN        Offset,
+  IN UINTN        Width
+  )
+{
+  UINT64 Value = 0;
+
+  CopyMem(&Value, Entry + Offset, Width);
+  return Value;
+}
+
+/**
+  Key used to match an SRAT processor entry to a MADT CPU: the entry kind
+  with the APIC or x2APIC ID, or with the processor UID for GICC entries.
+**/
+STATIC
+UINT64
+CpuMatchKey(
+  IN UINT8   Kind,
+  IN UINT32  Id
+  )
+{
+  return LShiftU64(Kind, 32) | Id;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareCpuKey(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST TOPOLOGY_CPU *Ca = A;
+  CONST TOPOLOGY_CPU *Cb = B;
+  UINT64             Ka  = CpuMatchKey(Ca->Kind, (Ca->Kind == TOPOLOGY_CPU_GICC) ? Ca->Uid : Ca->Id);
+  UINT64             Kb  = CpuMatchKey(Cb->Kind, (Cb->Kind == TOPOLOGY_CPU_GICC) ? Cb->Uid : Cb->Id);
+
+  return (Ka < Kb) ? -1 : (Ka > Kb) ? 1 : 0;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareRangeBase(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST TOPOLOGY_RANGE *Ra = A;
+  CONST TOPOLOGY_RANGE *Rb = B;
+
+  return (Ra->Base < Rb->Base) ? -1 : (Ra->Base > Rb->Base) ? 1 : 0;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareDomain(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST TOPOLOGY_DOMAIN *Da = A;
+  CONST TOPOLOGY_DOMAIN *Db = B;
+
+  return (Da->Domain < Db->Domain) ? -1 : (Da->Domain > Db->Domain) ? 1 : 0;
+}
+
+/**
+  Binary search of the key-sorted CPU list.
+**/
+STATIC
+TOPOLOGY_CPU *
+FindCpu(
+  IN TOPOLOGY  *Topo,
+  IN UINT64    Key
+  )
+{
+  UINTN Low  = 0;
+  UINTN High = Topo->CpuCount;
+
+  while (Low < High) {
+    UINTN        Mid = (Low + High) / 2;
+    TOPOLOGY_CPU *Cpu = &Topo->Cpus[Mid];
+    UINT64       MidKey = CpuMatchKey(Cpu->Kind, (Cpu->Kind == TOPOLOGY_CPU_GICC) ? Cpu->Uid : Cpu->Id);
+
+    if (MidKey == Key) {
+      return Cpu;
+    } else if (MidKey < Key) {
+      Low = Mid + 1;
+    } else {
+      High = Mid;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Return the domain row for a proximity domain, adding it if needed.
+**/
+STATIC
+TOPOLOGY_DOMAIN *
+GetDomain(
+  IN TOPOLOGY  *Topo,
+  IN UINT32    Domain
+  )
+{
+  for (UINTN i = 0; i < Topo->DomainCount; i++) {
+    if (Topo->Domains[i].Domain == Domain) {
+      return &Topo->Domains[i];
+    }
+  }
+  Topo->Domains[Topo->DomainCount].Domain = Domain;
+  return &Topo->Domains[Topo->DomainCount++];
+}
+
+/**
+  Collect the processor entries of the MADT.
+**/
+STATIC
+VOID
+DecodeMadt(
+  IN     EFI_ACPI_DESCRIPTION_HEADER  *Madt,
+  IN OUT TOPOLOGY                     *Topo
+  )
+{
+  CONST UINT8 *Entry = (CONST UINT8 *)Madt + MADT_ENTRIES_OFFSET;
+  CONST UINT8 *End   = (CONST UINT8 *)Madt + Madt->Length;
+
+  while (Entry + 2 <= End && Entry[1] >= 2 && Entry + Entry[1] <= End) {
+    TOPOLOGY_CPU *Cpu = &Topo->Cpus[Topo->CpuCount];
+
+    if (Entry[0] == MADT_LOCAL_APIC && Entry[1] >= 8) {
+      Cpu->Kind    = TOPOLOGY_CPU_APIC;
+      Cpu->Uid     = Entry[MADT_APIC_UID];
+      Cpu->Id      = Entry[MADT_APIC_ID];
+      Cpu->Enabled = (BOOLEAN)((ReadTopologyField(Entry, MADT_APIC_FLAGS, 4) & AFFINITY_ENABLED) != 0);
+      Cpu->Domain  = TOPOLOGY_NO_DOMAIN;
+      Topo->CpuCount++;
+    } else if (Entry[0] == MADT_LOCAL_X2APIC && Entry[1] >= 16) {
+      Cpu->Kind    = TOPOLOGY_CPU_X2APIC;
+      Cpu->Id      = (UINT32)ReadTopologyField(Entry, MADT_X2APIC_ID, 4);
+      Cpu->Uid     = (UINT32)ReadTopologyField(Entry, MADT_X2APIC_UID, 4);
+      Cpu->Enabled = (BOOLEAN)((ReadTopologyField(Entry, MADT_X2APIC_FLAGS, 4) & AFFINITY_ENABLED) != 0);
+      Cpu->Domain  = TOPOLOGY_NO_DOMAIN;
+      Topo->CpuCount++;
+    } else if (Entry[0] == MADT_GICC && Entry[1] >= MADT_GICC_MIN_LENGTH) {
+      Cpu->Kind    = TOPOLOGY_CPU_GICC;
+      Cpu->Id      = (UINT32)ReadTopologyField(Entry, MADT_GICC_INTERFACE, 4);
+      Cpu->Uid     = (UINT32)ReadTopologyField(Entry, MADT_GICC_UID, 4);
+      Cpu->Enabled = (BOOLEAN)((ReadTopologyField(Entry, MADT_GICC_FLAGS, 4) & AFFINITY_ENABLED) != 0);
+      Cpu->Domain  = TOPOLOGY_NO_DOMAIN;
+      Topo->CpuCount++;
+    }
+    Entry += Entry[1];
+  }
+}
+
+/**
+  Place the CPUs in their domains and collect the memory ranges of the SRAT.
+  Disabled affinity entries are ignored, as the OS does.
+**/
+STATIC
+VOID
+DecodeSrat(
+  IN     EFI_ACPI_DESCRIPTION_HEADER  *Srat,
+  IN OUT TOPOLOGY                     *Topo
+  )
+{
+  CONST UINT8  *Entry = (CONST UINT8 *)Srat + SRAT_ENTRIES_OFFSET;
+  CONST UINT8  *End   = (CONST UINT8 *)Srat + Srat->Length;
+  TOPOLOGY_CPU *Cpu;
+  UINT32       Domain;
+
+  while (Entry + 2 <= End && Entry[1] >= 2 && Entry + Entry[1] <= End) {
+    Cpu    = NULL;
+    Domain = TOPOLOGY_NO_DOMAIN;
+    if (Entry[0] == SRAT_APIC_AFFINITY && Entry[1] >= 16 &&
+        (ReadTopologyField(Entry, SRAT_APIC_FLAGS, 4) & AFFINITY_ENABLED) != 0) {
+      Domain = Entry[SRAT_APIC_DOMAIN_LOW] |
+               ((UINT32)ReadTopologyField(Entry, SRAT_APIC_DOMAIN_HIGH, 3) << 8);
+      Cpu = FindCpu(Topo, CpuMatchKey(TOPOLOGY_CPU_APIC, Entry[SRAT_APIC_ID]));
+      // APIC and x2APIC IDs share one space; either table may use either form
+      if (Cpu == NULL) {
+        Cpu = FindCpu(Topo, CpuMatchKey(TOPOLOGY_CPU_X2APIC, Entry[SRAT_APIC_ID]));
+      }
+    } else if (Entry[0] == SRAT_X2APIC_AFFINITY && Entry[1] >= 24 &&
+               (ReadTopologyField(Entry, SRAT_X2APIC_FLAGS, 4) & AFFINITY_ENABLED) != 0) {
+      Domain = (UINT32)ReadTopologyField(Entry, SRAT_X2APIC_DOMAIN, 4);
+      Cpu = FindCpu(Topo, CpuMatchKey(TOPOLOGY_CPU_X2APIC, (UINT32)ReadTopologyField(Entry, SRAT_X2APIC_ID, 4)));
+      if (Cpu == NULL) {
+        Cpu = FindCpu(Topo, CpuMatchKey(TOPOLOGY_CPU_APIC, (UINT32)ReadTopologyField(Entry, SRAT_X2APIC_ID, 4)));
+      }
+    } else if (Entry[0] == SRAT_GICC_AFFINITY && Entry[1] >= 18 &&
+               (ReadTopologyField(Entry, SRAT_GICC_FLAGS, 4) & AFFINITY_ENABLED) != 0) {
+      Domain = (UINT32)ReadTopologyField(Entry, SRAT_GICC_DOMAIN, 4);
+      Cpu = FindCpu(Topo, CpuMatchKey(TOPOLOGY_CPU_GICC, (UINT32)ReadTopologyField(Entry, SRAT_GICC_UID, 4)));
+    } else if (Entry[0] == SRAT_MEMORY_AFFINITY && Entry[1] >= 40 &&
+               (ReadTopologyField(Entry, SRAT_MEMORY_FLAGS, 4) & AFFINITY_ENABLED) != 0) {
+      TOPOLOGY_RANGE *Range = &Topo->Ranges[Topo->RangeCount++];
+      Range->Domain = (UINT32)ReadTopologyField(Entry, SRAT_MEMORY_DOMAIN, 4);
+      Range->Base   = ReadTopologyField(Entry, SRAT_MEMORY_BASE, 8);
+      Range->Length = ReadTopologyField(Entry, SRAT_MEMORY_LENGTH, 8);
+      Range->Flags  = (UINT32)ReadTopologyField(Entry, SRAT_MEMORY_FLAGS, 4);
+    }
+    // Cpu is only set by an enabled, complete entry, which also set Domain
+    if (Cpu != NULL) {
+      Cpu->Domain = Domain;
+    }
+    Entry += Entry[1];
+  }
+}
+
+/**
+  Spread the UEFI memory map over the SRAT ranges. The ranges are sorted by
+  base, so each descriptor finds its first overlapping range by binary
+  search.
+**/
+STATIC
+VOID
+MapMemoryToRanges(
+  IN OUT TOPOLOGY  *Topo
+  )
+{
+  MEMORY_MAP MemMap = {0};
+
+  if (EFI_ERROR(GetMemoryMapBuffer(&MemMap))) {
+    return;
+  }
+
+  MemMap.DescriptorCount = MemMap.MapSize / MemMap.DescriptorSize;
+  for (UINTN Index = 0; Index < MemMap.DescriptorCount; Index++) {
+    EFI_MEMORY_DESCRIPTOR *Desc =
+      (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)MemMap.Map + Index * MemMap.DescriptorSize);
+    UINT64 Start = Desc->PhysicalStart;
+    UINT64 End   = Start + MultU64x32(Desc->NumberOfPages, EFI_PAGE_SIZE);
+    UINT64 Covered = 0;
+    UINTN  Low = 0, High = Topo->RangeCount;
+
+    if (Desc->Type == EfiMemoryMappedIO || Desc->Type == EfiMemoryMappedIOPortSpace) {
+      continue;
+    }
+    Topo->MapRamBytes += End - Start;
+
+    // First range that ends above the descriptor start
+    while (Low < High) {
+      UINTN Mid = (Low + High) / 2;
+      if (Topo->Ranges[Mid].Base + Topo->Ranges[Mid].Length <= Start) {
+        Low = Mid + 1;
+      } else {
+        High = Mid;
+      }
+    }
+
+    for (UINTN r = Low; r < Topo->RangeCount && Topo->Ranges[r].Base < End; r++) {
+      TOPOLOGY_RANGE *Range = &Topo->Ranges[r];
+      UINT64         OverlapStart = MAX(Start, Range->Base);
+      UINT64         OverlapEnd   = MIN(End, Range->Base + Range->Length);
+
+      if (OverlapEnd > OverlapStart) {
+        Range->MappedBytes += OverlapEnd - OverlapStart;
+        if (Desc->Type == EfiConventionalMemory) {
+          Range->FreeBytes += OverlapEnd - OverlapStart;
+        }
+        Covered += OverlapEnd - OverlapStart;
+      }
+    }
+    Topo->UnassignedBytes += (End - Start) - MIN(Covered, End - Start);
+  }
+
+  FreePool(MemMap.Map);
+}
+
+/**
+  Decode the three tables and total everything per proximity domain.
+**/
+STATIC
+EFI_STATUS
+BuildTopology(
+  OUT TOPOLOGY  *Topo
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER *Madt = AcpiFindTable(MADT_SIGNATURE, 0);
+  EFI_ACPI_DESCRIPTION_HEADER *Srat = AcpiFindTable(SRAT_SIGNATURE, 0);
+  EFI_ACPI_DESCRIPTION_HEADER *Slit = AcpiFindTable(SLIT_SIGNATURE, 0);
+  UINTN                       CpuCapacity = 0;
+  UINTN                       RangeCapacity = 0;
+  TOPOLOGY_DOMAIN             DomainScratch;
+  TOPOLOGY_CPU                CpuScratch;
+  TOPOLOGY_RANGE              RangeScratch;
+
+  ZeroMem(Topo, sizeof(TOPOLOGY));
+  if (Madt == NULL && Srat == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  // Every sub-table is at least 8 (MADT) or 16 (SRAT) bytes long
+  if (Madt != NULL && Madt->Length > MADT_ENTRIES_OFFSET) {
+    CpuCapacity = (Madt->Length - MADT_ENTRIES_OFFSET) / 8;
+  }
+  if (Srat != NULL && Srat->Length > SRAT_ENTRIES_OFFSET) {
+    RangeCapacity = (Srat->Length - SRAT_ENTRIES_OFFSET) / 16;
+  }
+  Topo->Cpus    = AllocateZeroPool((CpuCapacity + 1) * sizeof(TOPOLOGY_CPU));
+  Topo->Ranges  = AllocateZeroPool((RangeCapacity + 1) * sizeof(TOPOLOGY_RANGE));
+  Topo->Domains = AllocateZeroPool((CpuCapacity + RangeCapacity + 1) * sizeof(TOPOLOGY_DOMAIN));
+  if (Topo->Cpus == NULL || Topo->Ranges == NULL || Topo->Domains == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Madt != NULL) {
+    Topo->HasMadt = TRUE;
+    DecodeMadt(Madt, Topo);
+    QuickSort(Topo->Cpus, Topo->CpuCount, sizeof(TOPOLOGY_CPU), CompareCpuKey, &CpuScratch);
+  }
+  if (Srat != NULL) {
+    Topo->HasSrat = TRUE;
+    DecodeSrat(Srat, Topo);
+    QuickSort(Topo->Ranges, Topo->RangeCount, sizeof(TOPOLOGY_RANGE), CompareRangeBase, &RangeScratch);
+  }
+  if (Slit != NULL && Slit->Length >= SLIT_LOCALITY_COUNT + 8) {
+    UINT64 Count = ReadTopologyField((CONST UINT8 *)Slit, SLIT_LOCALITY_COUNT, 8);
+    if (Count > 0 && Count <= 256 &&
+        MultU64x64(Count, Count) <= Slit->Length - SLIT_LOCALITY_COUNT - 8) {
+      Topo->Localities = (UINTN)Count;
+      Topo->Distances  = (UINT8 *)Slit + SLIT_LOCALITY_COUNT + 8;
+    }
+  }
+
+  MapMemoryToRanges(Topo);
+
+  for (UINTN i = 0; i < Topo->CpuCount; i++) {
+    if (Topo->Cpus[i].Domain != TOPOLOGY_NO_DOMAIN) {
+      TOPOLOGY_DOMAIN *Domain = GetDomain(Topo, Topo->Cpus[i].Domain);
+      Domain->CpuCount++;
+      if (Topo->Cpus[i].Enabled) {
+        Domain->EnabledCpus++;
+      }
+    }
+  }
+  for (UINTN i = 0; i < Topo->RangeCount; i++) {
+    TOPOLOGY_DOMAIN *Domain = GetDomain(Topo, Topo->Ranges[i].Domain);
+    Domain->RangeCount++;
+    Domain->SratBytes   += Topo->Ranges[i].Length;
+    Domain->MappedBytes += Topo->Ranges[i].MappedBytes;
+    Domain->FreeBytes   += Topo->Ranges[i].FreeBytes;
+  }
+  QuickSort(Topo->Domains, Topo->DomainCount, sizeof(TOPOLOGY_DOMAIN), CompareDomain, &DomainScratch);
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+FreeTopology(
+  IN TOPOLOGY  *Topo
+  )
+{
+  if (Topo->Cpus != NULL)    FreePool(Topo->Cpus);
+  if (Topo->Ranges != NULL)  FreePool(Topo->Ranges);
+  if (Topo->Domains != NULL) FreePool(Topo->Domains);
+}
+
+/**
+  Page 1: one row per proximity domain, then the layout warnings.
+**/
+STATIC
+VOID
+DrawDomainsPage(
+  IN TOPOLOGY  *Topo,
+  IN UINTN     Top,
+  IN UINTN     Visible
+  )
+{
+  UINT64  MinBytes = MAX_UINT64;
+  UINT64  MaxBytes = 0;
+  BOOLEAN Healthy  = TRUE;
+  UINTN   Enabled  = 0;
+  UINTN   Starved  = 0;
+  UINT32  FirstStarved = 0;
+
+  for (UINTN i = 0; i < Topo->CpuCount; i++) {
+    if (Topo->Cpus[i].Enabled) {
+      Enabled++;
+    }
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L" MADT: %d CPUs, %d enabled.  SRAT: %d domains, %d memory ranges.  SLIT: %d localities\n",
+        Topo->CpuCount, Enabled, Topo->DomainCount, Topo->RangeCount, Topo->Localities);
+  Print(L" Memory map: %ld MB RAM, %ld MB outside every SRAT range\n\n",
+        RShiftU64(Topo->MapRamBytes, 20), RShiftU64(Topo->UnassignedBytes, 20));
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %8s %6s %8s %7s %10s %10s %10s\n",
+        L"Domain", L"CPUs", L"Enabled", L"Ranges", L"SRAT MB", L"Map MB", L"Free MB");
+
+  for (UINTN i = Top; i < Topo->DomainCount && i < Top + Visible; i++) {
+    TOPOLOGY_DOMAIN *Domain = &Topo->Domains[i];
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" %8d ", Domain->Domain);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"%6d %8d %7d %10ld %10ld %10ld\n",
+          Domain->CpuCount, Domain->EnabledCpus, Domain->RangeCount,
+          RShiftU64(Domain->SratBytes, 20), RShiftU64(Domain->MappedBytes, 20),
+          RShiftU64(Domain->FreeBytes, 20));
+  }
+
+  //
+  // Warnings about the layout as a whole
+  //
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"\n");
+  if (!Topo->HasSrat) {
+    Print(L" ! No SRAT: the OS will see a single NUMA node\n");
+    Healthy = FALSE;
+  }
+  for (UINTN i = 0; i < Topo->DomainCount; i++) {
+    TOPOLOGY_DOMAIN *Domain = &Topo->Domains[i];
+    if (Domain->CpuCount > 0 && Domain->MappedBytes == 0) {
+      if (Starved++ == 0) {
+        FirstStarved = Domain->Domain;
+      }
+    } else if (Domain->CpuCount > 0) {
+      MinBytes = MIN(MinBytes, Domain->MappedBytes);
+      MaxBytes = MAX(MaxBytes, Domain->MappedBytes);
+    }
+  }
+  if (Starved > 0) {
+    Print(L" ! %d domain(s) have CPUs but no memory (first: %d)\n", Starved, FirstStarved);
+    Healthy = FALSE;
+  }
+  if (MaxBytes > 0 && MinBytes != MAX_UINT64 && MaxBytes > MultU64x32(MinBytes, 2)) {
+    Print(L" ! Memory is unbalanced across CPU domains: %ld MB to %ld MB\n",
+          RShiftU64(MinBytes, 20), RShiftU64(MaxBytes, 20));
+    Healthy = FALSE;
+  }
+  for (UINTN i = 0; i < Topo->CpuCount; i++) {
+    if (Topo->HasSrat && Topo->Cpus[i].Enabled && Topo->Cpus[i].Domain == TOPOLOGY_NO_DOMAIN) {
+      Print(L" ! Enabled CPUs missing from the SRAT (first: ID 0x%X)\n", Topo->Cpus[i].Id);
+      Healthy = FALSE;
+      break;
+    }
+  }
+  if (Topo->Localities > 0 && Topo->Localities < Topo->DomainCount) {
+    Print(L" ! SLIT covers %d localities but the SRAT has %d domains\n",
+          Topo->Localities, Topo->DomainCount);
+    Healthy = FALSE;
+  }
+  if (Healthy) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGREEN, EFI_BLUE));
+    Print(L" Every CPU domain has memory and memory is balanced\n");
+  }
+}
+
+/**
+  Page 2: the MADT CPUs with their domains.
+**/
+STATIC
+VOID
+DrawCpusPage(
+  IN TOPOLOGY  *Topo,
+  IN UINTN     Top,
+  IN UINTN     Visible
+  )
+{
+  STATIC CONST CHAR16 *KindName[] = { L"APIC", L"x2APIC", L"GICC" };
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %-7s %10s %10s %-9s %8s\n", L"Type", L"ID", L"UID", L"State", L"Domain");
+
+  for (UINTN i = Top; i < Topo->CpuCount && i < Top + Visible; i++) {
+    TOPOLOGY_CPU *Cpu = &Topo->Cpus[i];
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" %-7s ", KindName[Cpu->Kind]);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"%10X %10d %-9s ", Cpu->Id, Cpu->Uid, Cpu->Enabled ? L"enabled" : L"disabled");
+    if (Cpu->Domain == TOPOLOGY_NO_DOMAIN) {
+      Print(L"%8s\n", L"-");
+    } else {
+      Print(L"%8d\n", Cpu->Domain);
+    }
+  }
+}
+
+/**
+  Page 3: the SRAT memory ranges with the memory map RAM inside each.
+**/
+STATIC
+VOID
+DrawMemoryPage(
+  IN TOPOLOGY  *Topo,
+  IN UINTN     Top,
+  IN UINTN     Visible
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %6s %-16s %-16s %9s %9s %s\n",
+        L"Domain", L"Base", L"End", L"SRAT MB", L"Map MB", L"Flags");
+
+  for (UINTN i = Top; i < Topo->RangeCount && i < Top + Visible; i++) {
+    TOPOLOGY_RANGE *Range = &Topo->Ranges[i];
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" %6d ", Range->Domain);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"%016lX %016lX %9ld %9ld ",
+          Range->Base, Range->Base + Range->Length - 1,
+          RShiftU64(Range->Length, 20), RShiftU64(Range->MappedBytes, 20));
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"%s%s\n",
+          ((Range->Flags & MEMORY_HOT_PLUGGABLE) != 0) ? L"HP " : L"",
+          ((Range->Flags & MEMORY_NON_VOLATILE) != 0) ? L"NV" : L"");
+  }
+}
+
+/**
+  Page 4: the SLIT matrix. Rows scroll; columns are cut to the screen.
+**/
+STATIC
+VOID
+DrawDistancesPage(
+  IN TOPOLOGY  *Topo,
+  IN UINTN     Top,
+  IN UINTN     Visible,
+  IN UINTN     Columns
+  )
+{
+  UINTN Shown = (Columns > 10) ? (Columns - 10) / 4 : 1;
+
+  if (Topo->Distances == NULL) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" No SLIT: all localities are reported as equally distant\n");
+    return;
+  }
+  Shown = MIN(Shown, Topo->Localities);
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %6s ", L"From");
+  for (UINTN To = 0; To < Shown; To++) {
+    Print(L"%4d", To);
+  }
+  Print(L"\n");
+
+  for (UINTN From = Top; From < Topo->Localities && From < Top + Visible; From++) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" %6d ", From);
+    for (UINTN To = 0; To < Shown; To++) {
+      UINT8 Distance = Topo->Distances[From * Topo->Localities + To];
+      // Local is 10, 255 means unreachable
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(
+        (From == To) ? EFI_LIGHTGREEN : (Distance == 0xFF) ? EFI_LIGHTRED : EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"%4d", Distance);
+    }
+    Print(L"\n");
+  }
+}
+
+VOID
+ShowAcpiTopology(VOID)
+{
+  EFI_STATUS     Status;
+  TOPOLOGY       Topo;
+  TOPOLOGY_PAGE  Page = TopologyPageDomains;
+  UINTN          Top  = 0;
+  UINTN          Columns, Rows, Visible;
+  EFI_INPUT_KEY  Key;
+
+  Status = BuildTopology(&Topo);
+  if (EFI_ERROR(Status)) {
+    FreeTopology(&Topo);
+    gST->ConOut->ClearScreen(gST->ConOut);
+    Print(L"Unable to decode the MADT/SRAT: %r\n", Status);
+    Print(L"\nPress any key to return\n");
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+    return;
+  }
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+
+  for (;;) {
+    UINTN ItemCount = (Page == TopologyPageDomains) ? Topo.DomainCount :
+                      (Page == TopologyPageCpus)    ? Topo.CpuCount :
+                      (Page == TopologyPageMemory)  ? Topo.RangeCount : Topo.Localities;
+
+    // The domains page keeps a summary above and warnings below the rows
+    Visible = (Page == TopologyPageDomains) ? ((Rows > 16) ? (Rows - 16) : 1) :
+                                              ((Rows > 6) ? (Rows - 6) : 1);
+
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" CPU/NUMA Topology - %-20s (page %u/%u)\n", mTopologyPageName[Page], Page + 1, TopologyPageMax);
+
+    switch (Page) {
+      case TopologyPageDomains: DrawDomainsPage(&Topo, Top, Visible);            break;
+      case TopologyPageCpus:    DrawCpusPage(&Topo, Top, Visible);               break;
+      case TopologyPageMemory:  DrawMemoryPage(&Topo, Top, Visible);             break;
+      default:                  DrawDistancesPage(&Topo, Top, Visible, Columns); break;
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nLeft/Right switch page, Up/Down/PgUp/PgDn scroll, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    switch (Key.ScanCode) {
+      case SCAN_LEFT:
+        Page = (Page == 0) ? (TopologyPageMax - 1) : (Page - 1);
+        Top  = 0;
+        break;
+      case SCAN_RIGHT:
+        Page = (Page + 1) % TopologyPageMax;
+        Top  = 0;
+        break;
+      case SCAN_UP:
+        if (Top > 0) Top--;
+        break;
+      case SCAN_DOWN:
+        if (Top + Visible < ItemCount) Top++;
+        break;
+      case SCAN_PAGE_UP:
+        Top = (Top > Visible) ? (Top - Visible) : 0;
+        break;
+      case SCAN_PAGE_DOWN:
+        if (Top + Visible < ItemCount) Top += Visible;
+        break;
+      default:
+        break;
+    }
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    }
+  }
+
+  FreeTopology(&Topo);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <Uefi.h>
+
+/**
+  CPU and NUMA topology from the MADT, SRAT and SLIT: CPUs and memory
+  ranges per proximity domain, cross-referenced with the UEFI memory map,
+  and the locality distance matrix.
+**/
+VOID
+ShowAcpiTopology(VOID);
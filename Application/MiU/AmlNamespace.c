@@ -0,0 +1,1409 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include "ACPI.h"
+#include "AmlNamespace.h"
+
+//
+// AML encodings used by the namespace walk (ACPI 6.5, chapter 20)
+//
+#define AML_ZERO_OP              0x00
+#define AML_ONE_OP               0x01
+#define AML_ALIAS_OP             0x06
+#define AML_NAME_OP              0x08
+#define AML_BYTE_PREFIX          0x0A
+#define AML_WORD_PREFIX          0x0B
+#define AML_DWORD_PREFIX         0x0C
+#define AML_STRING_PREFIX        0x0D
+#define AML_QWORD_PREFIX         0x0E
+#define AML_SCOPE_OP             0x10
+#define AML_BUFFER_OP            0x11
+#define AML_PACKAGE_OP           0x12
+#define AML_VAR_PACKAGE_OP       0x13
+#define AML_METHOD_OP            0x14
+#define AML_EXTERNAL_OP          0x15
+#define AML_DUAL_NAME_PREFIX     0x2E
+#define AML_MULTI_NAME_PREFIX    0x2F
+#define AML_EXT_OP_PREFIX        0x5B
+#define AML_ROOT_CHAR            0x5C
+#define AML_PARENT_PREFIX        0x5E
+#define AML_LOCAL0_OP            0x60
+#define AML_ARG6_OP              0x6E
+#define AML_CREATE_DWORD_OP      0x8A
+#define AML_CREATE_WORD_OP       0x8B
+#define AML_CREATE_BYTE_OP       0x8C
+#define AML_CREATE_BIT_OP        0x8D
+#define AML_CREATE_QWORD_OP      0x8F
+#define AML_IF_OP                0xA0
+#define AML_ELSE_OP              0xA1
+#define AML_WHILE_OP             0xA2
+#define AML_NOOP_OP              0xA3
+#define AML_ONES_OP              0xFF
+
+// Second byte after AML_EXT_OP_PREFIX
+#define AML_EXT_MUTEX_OP         0x01
+#define AML_EXT_EVENT_OP         0x02
+#define AML_EXT_CREATE_FIELD_OP  0x13
+#define AML_EXT_REVISION_OP      0x30
+#define AML_EXT_REGION_OP        0x80
+#define AML_EXT_FIELD_OP         0x81
+#define AML_EXT_DEVICE_OP        0x82
+#define AML_EXT_PROCESSOR_OP     0x83
+#define AML_EXT_POWER_RES_OP     0x84
+#define AML_EXT_THERMAL_ZONE_OP  0x85
+#define AML_EXT_INDEX_FIELD_OP   0x86
+#define AML_EXT_BANK_FIELD_OP    0x87
+
+//
+// Node kinds
+//
+#define AML_NODE_ROOT            0
+#define AML_NODE_SCOPE           1
+#define AML_NODE_DEVICE          2
+#define AML_NODE_METHOD          3
+#define AML_NODE_NAME            4
+#define AML_NODE_PROCESSOR       5
+#define AML_NODE_POWER_RESOURCE  6
+#define AML_NODE_THERMAL_ZONE    7
+#define AML_NODE_OP_REGION       8
+#define AML_NODE_MUTEX           9
+#define AML_NODE_EVENT           10
+#define AML_NODE_ALIAS           11
+
+// Value kinds of a Name() object
+#define AML_VALUE_NONE           0
+#define AML_VALUE_INTEGER        1
+#define AML_VALUE_STRING         2
+#define AML_VALUE_BUFFER         3
+#define AML_VALUE_PACKAGE        4
+
+// Node flags
+#define AML_FLAG_PLACEHOLDER     BIT0   // Created by a Scope() to an object not defined yet
+#define AML_FLAG_EXPANDED        BIT1
+#define AML_FLAG_OFFSET_UNKNOWN  BIT2   // Region offset is computed at run time
+#define AML_FLAG_LENGTH_UNKNOWN  BIT3   // Region length is computed at run time
+
+#define AML_NO_NODE              MAX_UINT32
+#define AML_NODE_GROW            1024
+#define AML_MAX_NODES            32768  // Caps the arena at about 1.8 MB
+#define AML_MAX_NESTING          64
+#define AML_MAX_EXPRESSION       16     // Nesting of a skipped TermArg expression
+#define AML_PATH_MAX             256
+
+#define DSDT_SIGNATURE  SIGNATURE_32('D', 'S', 'D', 'T')
+#define SSDT_SIGNATURE  SIGNATURE_32('S', 'S', 'D', 'T')
+
+//
+// One object of the namespace. Nodes live in a single arena and refer to
+// each other by index; node 0 is the root, so 0 also means "none" for the
+// child and sibling links. Strings and alias targets point into the table.
+//
+typedef struct {
+  UINT32       Name;          // NameSeg, four characters
+  UINT32       Parent;
+  UINT32       FirstChild;
+  UINT32       LastChild;
+  UINT32       Next;
+  UINT8        Kind;
+  UINT8        ValueKind;
+  UINT8        Flags;
+  UINT8        Table;         // 0 = DSDT, n = the n-th SSDT
+  UINT16       Depth;
+  UINT8        Aux;           // Method flags, region space, processor ID, system level
+  UINT64       Value;         // Integer, element or byte count, region offset, resource order
+  UINT64       Length;        // Region length, or string length
+  CONST UINT8  *Data;         // String bytes or alias target segments
+} AML_NODE;
+
+//
+// A parsed NameString. Segs points at SegCount four-byte NameSegs.
+//
+typedef struct {
+  BOOLEAN      Rooted;
+  UINT8        ParentCount;
+  UINT8        SegCount;
+  CONST UINT8  *Segs;
+} AML_NAME_PATH;
+
+STATIC AML_NODE  *mAmlNodes = NULL;
+STATIC UINTN     mAmlNodeCount = 0;
+STATIC UINTN     mAmlCapacity = 0;
+STATIC BOOLEAN   mAmlTruncated = FALSE;    // The node cap was reached
+STATIC UINTN     mAmlAborted = 0;          // Scopes cut short by an opcode the walk could not skip
+STATIC UINTN     mAmlConditional = 0;      // If/Else/While blocks not evaluated
+STATIC UINTN     mAmlSsdtCount = 0;
+STATIC AML_NODE  mAmlScratch;              // Target for definitions that could not be added
+
+// The expanded part of the tree in display order, and the view position
+STATIC UINT32    *mAmlVisible = NULL;
+STATIC UINTN     mAmlVisibleCount = 0;
+STATIC UINTN     mAmlSelected = 0;
+STATIC UINTN     mAmlTop = 0;
+
+/**
+  Returns the node for an index, or a scratch node for AML_NO_NODE so that
+  callers can keep parsing an object they could not add.
+*/
+STATIC
+AML_NODE *
+AmlNode(
+  IN UINT32  Index
+  )
+{
+  if (Index == AML_NO_NODE) {
+    ZeroMem(&mAmlScratch, sizeof(mAmlScratch));
+    return &mAmlScratch;
+  }
+  return &mAmlNodes[Index];
+}
+
+/**
+  Appends a child node. The arena grows in steps up to AML_MAX_NODES;
+  past that the tree is marked truncated and AML_NO_NODE is returned.
+  Node pointers are invalid after this call because the arena may move.
+*/
+STATIC
+UINT32
+AddAmlNode(
+  IN UINT32  Parent,
+  IN UINT32  Name,
+  IN UINT8   Kind,
+  IN UINT8   Table
+  )
+{
+  AML_NODE *Node;
+  UINT32   Index;
+
+  if (mAmlNodeCount == mAmlCapacity) {
+    UINTN    NewCapacity = mAmlCapacity + AML_NODE_GROW;
+    AML_NODE *Grown;
+
+    if (NewCapacity > AML_MAX_NODES) {
+      mAmlTruncated = TRUE;
+      return AML_NO_NODE;
+    }
+    Grown = ReallocatePool(mAmlCapacity * sizeof(AML_NODE), NewCapacity * sizeof(AML_NODE), mAmlNodes);
+    if (Grown == NULL) {
+      mAmlTruncated = TRUE;
+      return AML_NO_NODE;
+    }
+    mAmlNodes    = Grown;
+    mAmlCapacity = NewCapacity;
+  }
+
+  Index = (UINT32)mAmlNodeCount++;
+  Node  = &mAmlNodes[Index];
+  ZeroMem(Node, sizeof(AML_NODE));
+  Node->Name  = Name;
+  Node->Kind  = Kind;
+  Node->Table = Table;
+
+  if (Index != 0) {
+    Node->Parent = Parent;
+    Node->Depth  = mAmlNodes[Parent].Depth + 1;
+    if (mAmlNodes[Parent].FirstChild == 0) {
+      mAmlNodes[Parent].FirstChild = Index;
+    } else {
+      mAmlNodes[mAmlNodes[Parent].LastChild].Next = Index;
+    }
+    mAmlNodes[Parent].LastChild = Index;
+  }
+  return Index;
+}
+
+/**
+  Finds a direct child by NameSeg. Returns 0 if there is none.
+*/
+STATIC
+UINT32
+FindAmlChild(
+  IN UINT32  Parent,
+  IN UINT32  Name
+  )
+{
+  for (UINT32 Child = mAmlNodes[Parent].FirstChild; Child != 0; Child = mAmlNodes[Child].Next) {
+    if (mAmlNodes[Child].Name == Name) {
+      return Child;
+    }
+  }
+  return 0;
+}
+
+/**
+  Decodes a PkgLength. On return *Ptr is past the encoding and *PkgEnd is
+  the end of the package, which is checked against End.
+*/
+STATIC
+BOOLEAN
+ReadAmlPkgLength(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End,
+  OUT    CONST UINT8  **PkgEnd
+  )
+{
+  CONST UINT8 *Start = *Ptr;
+  UINTN       Count;
+  UINTN       Length;
+
+  if (Start >= End) {
+    return FALSE;
+  }
+  Count = Start[0] >> 6;
+  if (Count > (UINTN)(End - Start) - 1) {
+    return FALSE;
+  }
+
+  if (Count == 0) {
+    Length = Start[0] & 0x3F;
+  } else {
+    Length = Start[0] & 0x0F;
+    for (UINTN i = 0; i < Count; i++) {
+      Length |= (UINTN)Start[1 + i] << (4 + 8 * i);
+    }
+  }
+  if (Length < 1 + Count || Length > (UINTN)(End - Start)) {
+    return FALSE;
+  }
+
+  *PkgEnd = Start + Length;
+  *Ptr    = Start + 1 + Count;
+  return TRUE;
+}
+
+/**
+  Decodes a NameString: an optional root or parent prefixes followed by
+  zero, one, two or N NameSegs.
+*/
+STATIC
+BOOLEAN
+ReadAmlNameString(
+  IN OUT CONST UINT8    **Ptr,
+  IN     CONST UINT8    *End,
+  OUT    AML_NAME_PATH  *Path
+  )
+{
+  CONST UINT8 *p = *Ptr;
+
+  ZeroMem(Path, sizeof(AML_NAME_PATH));
+  if (p < End && *p == AML_ROOT_CHAR) {
+    Path->Rooted = TRUE;
+    p++;
+  } else {
+    while (p < End && *p == AML_PARENT_PREFIX) {
+      Path->ParentCount++;
+      p++;
+    }
+  }
+  if (p >= End) {
+    return FALSE;
+  }
+
+  if (*p == AML_ZERO_OP) {
+    p++;                            // NullName
+  } else if (*p == AML_DUAL_NAME_PREFIX) {
+    Path->SegCount = 2;
+    p++;
+  } else if (*p == AML_MULTI_NAME_PREFIX) {
+    if (p + 1 >= End) {
+      return FALSE;
+    }
+    Path->SegCount = p[1];
+    p += 2;
+  } else if ((*p >= 'A' && *p <= 'Z') || *p == '_') {
+    Path->SegCount = 1;
+  } else {
+    return FALSE;
+  }
+
+  if ((UINTN)Path->SegCount * 4 > (UINTN)(End - p)) {
+    return FALSE;
+  }
+  Path->Segs = p;
+  *Ptr = p + (UINTN)Path->SegCount * 4;
+  return TRUE;
+}
+
+STATIC
+UINT32
+AmlPathSeg(
+  IN AML_NAME_PATH  *Path,
+  IN UINTN          Index
+  )
+{
+  return ReadUnaligned32((CONST UINT32 *)(Path->Segs + Index * 4));
+}
+
+/**
+  Resolves the first SegLimit segments of a path relative to Scope. Missing
+  segments become placeholder scopes when Create is set. A single bare
+  NameSeg is looked up in the enclosing scopes as well, as the AML search
+  rules require.
+*/
+STATIC
+UINT32
+ResolveAmlPath(
+  IN UINT32         Scope,
+  IN AML_NAME_PATH  *Path,
+  IN UINTN          SegLimit,
+  IN BOOLEAN        Create,
+  IN UINT8          Table
+  )
+{
+  UINT32 Node = Path->Rooted ? 0 : Scope;
+  UINT32 Child;
+
+  for (UINTN i = 0; i < Path->ParentCount && Node != 0; i++) {
+    Node = mAmlNodes[Node].Parent;
+  }
+
+  if (!Path->Rooted && Path->ParentCount == 0 && Path->SegCount == 1 && SegLimit == 1) {
+    for (UINT32 Search = Node; ; Search = mAmlNodes[Search].Parent) {
+      Child = FindAmlChild(Search, AmlPathSeg(Path, 0));
+      if (Child != 0) {
+        return Child;
+      }
+      if (Search == 0) {
+        break;
+      }
+    }
+  }
+
+  for (UINTN i = 0; i < SegLimit; i++) {
+    Child = FindAmlChild(Node, AmlPathSeg(Path, i));
+    if (Child == 0) {
+      if (!Create) {
+        return AML_NO_NODE;
+      }
+      Child = AddAmlNode(Node, AmlPathSeg(Path, i), AML_NODE_SCOPE, Table);
+      if (Child == AML_NO_NODE) {
+        return AML_NO_NODE;
+      }
+      mAmlNodes[Child].Flags |= AML_FLAG_PLACEHOLDER;
+    }
+    Node = Child;
+  }
+  return Node;
+}
+
+/**
+  Adds the object named by Path. Objects that can contain others take over
+  a placeholder left by an earlier Scope(); plain objects are appended
+  without a lookup so wide scopes stay linear.
+*/
+STATIC
+UINT32
+AddAmlDefinition(
+  IN UINT32         Scope,
+  IN AML_NAME_PATH  *Path,
+  IN UINT8          Kind,
+  IN UINT8          Table
+  )
+{
+  UINT32 Parent;
+  UINT32 Name;
+  UINT32 Node;
+
+  if (Path->SegCount == 0) {
+    return AML_NO_NODE;
+  }
+
+  // Only the prefix segments are looked up; the last one is the new name
+  Parent = ResolveAmlPath(Scope, Path, Path->SegCount - 1, TRUE, Table);
+  if (Parent == AML_NO_NODE) {
+    return AML_NO_NODE;
+  }
+  Name = AmlPathSeg(Path, Path->SegCount - 1);
+
+  if (Kind == AML_NODE_DEVICE || Kind == AML_NODE_PROCESSOR ||
+      Kind == AML_NODE_POWER_RESOURCE || Kind == AML_NODE_THERMAL_ZONE) {
+    Node = FindAmlChild(Parent, Name);
+    if (Node != 0 && (mAmlNodes[Node].Flags & AML_FLAG_PLACEHOLDER) != 0) {
+      mAmlNodes[Node].Kind   = Kind;
+      mAmlNodes[Node].Table  = Table;
+      mAmlNodes[Node].Flags &= (UINT8)~AML_FLAG_PLACEHOLDER;
+      return Node;
+    }
+  }
+  return AddAmlNode(Parent, Name, Kind, Table);
+}
+
+/**
+  Reads a constant integer: Zero, One, Ones, Revision or a Byte/Word/
+  DWord/QWord constant. Computed TermArgs are not evaluated.
+*/
+STATIC
+BOOLEAN
+ReadAmlInteger(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End,
+  OUT    UINT64       *Value
+  )
+{
+  CONST UINT8 *p = *Ptr;
+  UINTN       Size;
+
+  if (p >= End) {
+    return FALSE;
+  }
+  switch (*p++) {
+  case AML_ZERO_OP:      *Value = 0;          Size = 0; break;
+  case AML_ONE_OP:       *Value = 1;          Size = 0; break;
+  case AML_ONES_OP:      *Value = MAX_UINT64; Size = 0; break;
+  case AML_BYTE_PREFIX:  Size = 1; break;
+  case AML_WORD_PREFIX:  Size = 2; break;
+  case AML_DWORD_PREFIX: Size = 4; break;
+  case AML_QWORD_PREFIX: Size = 8; break;
+  case AML_EXT_OP_PREFIX:
+    if (p >= End || *p != AML_EXT_REVISION_OP) {
+      return FALSE;
+    }
+    *Value = 0;
+    *Ptr   = p + 1;
+    return TRUE;
+  default:
+    return FALSE;
+  }
+
+  if (Size > (UINTN)(End - p)) {
+    return FALSE;
+  }
+  if (Size > 0) {
+    *Value = 0;
+    CopyMem(Value, p, Size);
+  }
+  *Ptr = p + Size;
+  return TRUE;
+}
+
+//
+// Expression opcodes a TermArg may be built from, with their operand
+// counts. Targets count as operands: a NullName target is the ZeroOp byte.
+//
+typedef struct {
+  UINT8  Op;
+  UINT8  Operands;
+} AML_EXPRESSION_OP;
+
+STATIC CONST AML_EXPRESSION_OP  mAmlExpressionOps[] = {
+  { 0x70, 2 },    // Store
+  { 0x71, 1 },    // RefOf
+  { 0x72, 3 },    // Add
+  { 0x73, 3 },    // Concatenate
+  { 0x74, 3 },    // Subtract
+  { 0x75, 1 },    // Increment
+  { 0x76, 1 },    // Decrement
+  { 0x77, 3 },    // Multiply
+  { 0x78, 4 },    // Divide
+  { 0x79, 3 },    // ShiftLeft
+  { 0x7A, 3 },    // ShiftRight
+  { 0x7B, 3 },    // And
+  { 0x7C, 3 },    // Nand
+  { 0x7D, 3 },    // Or
+  { 0x7E, 3 },    // Nor
+  { 0x7F, 3 },    // Xor
+  { 0x80, 2 },    // Not
+  { 0x81, 2 },    // FindSetLeftBit
+  { 0x82, 2 },    // FindSetRightBit
+  { 0x83, 1 },    // DerefOf
+  { 0x84, 3 },    // ConcatenateResTemplate
+  { 0x85, 3 },    // Mod
+  { 0x87, 1 },    // SizeOf
+  { 0x88, 3 },    // Index
+  { 0x8E, 1 },    // ObjectType
+  { 0x90, 2 },    // LAnd
+  { 0x91, 2 },    // LOr
+  { 0x92, 1 },    // LNot, also the prefix of LNotEqual and friends
+  { 0x93, 2 },    // LEqual
+  { 0x94, 2 },    // LGreater
+  { 0x95, 2 },    // LLess
+  { 0x96, 2 },    // ToBuffer
+  { 0x97, 2 },    // ToDecimalString
+  { 0x98, 2 },    // ToHexString
+  { 0x99, 2 },    // ToInteger
+  { 0x9C, 3 },    // ToString
+  { 0x9D, 2 },    // CopyObject
+  { 0x9E, 4 },    // Mid
+};
+
+/**
+  Steps over a TermArg without evaluating it: a constant, a string, a
+  buffer or package, a local or argument, a NameString, or an expression
+  built from those. A NameString is taken to be a reference, not a method
+  call, since the argument count of a method defined later is not known.
+*/
+STATIC
+BOOLEAN
+SkipAmlTermArg(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End,
+  IN     UINTN        Depth
+  )
+{
+  CONST UINT8   *p = *Ptr;
+  CONST UINT8   *PkgEnd;
+  AML_NAME_PATH Path;
+  UINT64        Value;
+
+  if (p >= End || Depth > AML_MAX_EXPRESSION) {
+    return FALSE;
+  }
+  if (ReadAmlInteger(Ptr, End, &Value)) {
+    return TRUE;
+  }
+
+  switch (*p) {
+  case AML_STRING_PREFIX:
+    while (++p < End && *p != '\0') {
+    }
+    if (p >= End) {
+      return FALSE;
+    }
+    *Ptr = p + 1;
+    return TRUE;
+
+  case AML_BUFFER_OP:
+  case AML_PACKAGE_OP:
+  case AML_VAR_PACKAGE_OP:
+    p++;
+    if (!ReadAmlPkgLength(&p, End, &PkgEnd)) {
+      return FALSE;
+    }
+    *Ptr = PkgEnd;
+    return TRUE;
+
+  default:
+    break;
+  }
+
+  if (*p >= AML_LOCAL0_OP && *p <= AML_ARG6_OP) {
+    *Ptr = p + 1;
+    return TRUE;
+  }
+  for (UINTN i = 0; i < ARRAY_SIZE(mAmlExpressionOps); i++) {
+    if (mAmlExpressionOps[i].Op == *p) {
+      p++;
+      for (UINTN Operand = 0; Operand < mAmlExpressionOps[i].Operands; Operand++) {
+        if (!SkipAmlTermArg(&p, End, Depth + 1)) {
+          return FALSE;
+        }
+      }
+      *Ptr = p;
+      return TRUE;
+    }
+  }
+  return ReadAmlNameString(Ptr, End, &Path);
+}
+
+/**
+  Reads the DataRefObject of a Name(): an integer, a string, or a buffer
+  or package whose contents are skipped and only counted.
+*/
+STATIC
+BOOLEAN
+ReadAmlNameValue(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End,
+  IN OUT AML_NODE     *Node
+  )
+{
+  CONST UINT8 *p = *Ptr;
+  CONST UINT8 *PkgEnd;
+  UINT8       Op;
+
+  if (ReadAmlInteger(Ptr, End, &Node->Value)) {
+    Node->ValueKind = AML_VALUE_INTEGER;
+    return TRUE;
+  }
+  if (p >= End) {
+    return FALSE;
+  }
+
+  Op = *p++;
+  switch (Op) {
+  case AML_STRING_PREFIX:
+    Node->Data = p;
+    while (p < End && *p != '\0') {
+      p++;
+    }
+    if (p >= End) {
+      return FALSE;
+    }
+    Node->ValueKind = AML_VALUE_STRING;
+    Node->Length    = (UINT64)(p - Node->Data);
+    *Ptr = p + 1;
+    return TRUE;
+
+  case AML_BUFFER_OP:
+    if (!ReadAmlPkgLength(&p, End, &PkgEnd)) {
+      return FALSE;
+    }
+    Node->ValueKind = AML_VALUE_BUFFER;
+    if (!ReadAmlInteger(&p, PkgEnd, &Node->Value)) {
+      Node->Value = 0;
+    }
+    *Ptr = PkgEnd;
+    return TRUE;
+
+  case AML_PACKAGE_OP:
+  case AML_VAR_PACKAGE_OP:
+    if (!ReadAmlPkgLength(&p, End, &PkgEnd) || p >= PkgEnd) {
+      return FALSE;
+    }
+    Node->ValueKind = AML_VALUE_PACKAGE;
+    if (Op == AML_PACKAGE_OP) {
+      Node->Value = *p;
+    } else if (!ReadAmlInteger(&p, PkgEnd, &Node->Value)) {
+      Node->Value = 0;
+    }
+    *Ptr = PkgEnd;
+    return TRUE;
+
+  default:
+    return FALSE;
+  }
+}
+
+/**
+  Walks a TermList and adds the objects it declares under Scope. Method
+  bodies are skipped by their PkgLength and so are If/Else/While blocks,
+  whose predicates would need an interpreter; expressions are stepped over
+  operand by operand. A malformed object with a PkgLength is dropped on its
+  own. An opcode whose length cannot be known ends only this TermList:
+  Scope is the innermost PkgLength-bounded object, and the caller resumes
+  after it.
+*/
+STATIC
+VOID
+ParseAmlTermList(
+  IN UINT32       Scope,
+  IN CONST UINT8  *Ptr,
+  IN CONST UINT8  *End,
+  IN UINT8        Table,
+  IN UINTN        Nesting
+  )
+{
+  AML_NAME_PATH Path;
+  AML_NAME_PATH Target;
+  CONST UINT8   *PkgEnd;
+  UINT32        Node;
+  UINT8         Op;
+  UINT8         Flags;
+  UINT64        Offset, Length;
+
+  while (Ptr < End && !mAmlTruncated) {
+    Op = *Ptr++;
+    switch (Op) {
+    case AML_NOOP_OP:
+      break;
+
+    case AML_SCOPE_OP:
+      if (!ReadAmlPkgLength(&Ptr, End, &PkgEnd)) {
+        goto Abort;
+      }
+      if (!ReadAmlNameString(&Ptr, PkgEnd, &Path)) {
+        goto SkipObject;
+      }
+      Node = ResolveAmlPath(Scope, &Path, Path.SegCount, TRUE, Table);
+      if (Node != AML_NO_NODE && Nesting < AML_MAX_NESTING) {
+        ParseAmlTermList(Node, Ptr, PkgEnd, Table, Nesting + 1);
+      }
+      Ptr = PkgEnd;
+      break;
+
+    case AML_NAME_OP:
+      if (!ReadAmlNameString(&Ptr, End, &Path)) {
+        goto Abort;
+      }
+      Node = AddAmlDefinition(Scope, &Path, AML_NODE_NAME, Table);
+      if (!ReadAmlNameValue(&Ptr, End, AmlNode(Node))) {
+        goto Abort;
+      }
+      break;
+
+    case AML_METHOD_OP:
+      if (!ReadAmlPkgLength(&Ptr, End, &PkgEnd)) {
+        goto Abort;
+      }
+      if (!ReadAmlNameString(&Ptr, PkgEnd, &Path) || Ptr >= PkgEnd) {
+        goto SkipObject;
+      }
+      Node = AddAmlDefinition(Scope, &Path, AML_NODE_METHOD, Table);
+      AmlNode(Node)->Aux = *Ptr;
+      Ptr = PkgEnd;
+      break;
+
+    case AML_ALIAS_OP:
+      if (!ReadAmlNameString(&Ptr, End, &Target) || !ReadAmlNameString(&Ptr, End, &Path)) {
+        goto Abort;
+      }
+      Node = AddAmlDefinition(Scope, &Path, AML_NODE_ALIAS, Table);
+      AmlNode(Node)->Data   = Target.Segs;
+      AmlNode(Node)->Value  = Target.SegCount;
+      AmlNode(Node)->Aux    = Target.Rooted ? MAX_UINT8 : Target.ParentCount;
+      break;
+
+    case AML_EXTERNAL_OP:
+      // Declares an object defined in another table; nothing to add
+      if (!ReadAmlNameString(&Ptr, End, &Path) || End - Ptr < 2) {
+        goto Abort;
+      }
+      Ptr += 2;
+      break;
+
+    case AML_IF_OP:
+    case AML_ELSE_OP:
+    case AML_WHILE_OP:
+      if (!ReadAmlPkgLength(&Ptr, End, &PkgEnd)) {
+        goto Abort;
+      }
+      mAmlConditional++;
+      Ptr = PkgEnd;
+      break;
+
+    case AML_EXT_OP_PREFIX:
+      if (Ptr >= End) {
+        goto Abort;
+      }
+      Op = *Ptr++;
+      switch (Op) {
+      case AML_EXT_MUTEX_OP:
+        if (!ReadAmlNameString(&Ptr, End, &Path) || Ptr >= End) {
+          goto Abort;
+        }
+        AddAmlDefinition(Scope, &Path, AML_NODE_MUTEX, Table);
+        Ptr++;
+        break;
+
+      case AML_EXT_EVENT_OP:
+        if (!ReadAmlNameString(&Ptr, End, &Path)) {
+          goto Abort;
+        }
+        AddAmlDefinition(Scope, &Path, AML_NODE_EVENT, Table);
+        break;
+
+      case AML_EXT_REGION_OP:
+        if (!ReadAmlNameString(&Ptr, End, &Path) || Ptr >= End) {
+          goto Abort;
+        }
+        Op    = *Ptr++;
+        Flags = 0;
+        // Computed offsets and lengths are left to an interpreter; step over them
+        if (!ReadAmlInteger(&Ptr, End, &Offset)) {
+          if (!SkipAmlTermArg(&Ptr, End, 0)) {
+            goto Abort;
+          }
+          Offset = 0;
+          Flags |= AML_FLAG_OFFSET_UNKNOWN;
+        }
+        if (!ReadAmlInteger(&Ptr, End, &Length)) {
+          if (!SkipAmlTermArg(&Ptr, End, 0)) {
+            goto Abort;
+          }
+          Length = 0;
+          Flags |= AML_FLAG_LENGTH_UNKNOWN;
+        }
+        Node = AddAmlDefinition(Scope, &Path, AML_NODE_OP_REGION, Table);
+        AmlNode(Node)->Aux    = Op;
+        AmlNode(Node)->Value  = Offset;
+        AmlNode(Node)->Length = Length;
+        AmlNode(Node)->Flags |= Flags;
+        break;
+
+      case AML_EXT_FIELD_OP:
+      case AML_EXT_INDEX_FIELD_OP:
+      case AML_EXT_BANK_FIELD_OP:
+        if (!ReadAmlPkgLength(&Ptr, End, &PkgEnd)) {
+          goto Abort;
+        }
+        Ptr = PkgEnd;
+        break;
+
+      case AML_EXT_DEVICE_OP:
+      case AML_EXT_THERMAL_ZONE_OP:
+      case AML_EXT_PROCESSOR_OP:
+      case AML_EXT_POWER_RES_OP:
+        if (!ReadAmlPkgLength(&Ptr, End, &PkgEnd)) {
+          goto Abort;
+        }
+        if (!ReadAmlNameString(&Ptr, PkgEnd, &Path)) {
+          goto SkipObject;
+        }
+        if (Op == AML_EXT_DEVICE_OP) {
+          Node = AddAmlDefinition(Scope, &Path, AML_NODE_DEVICE, Table);
+        } else if (Op == AML_EXT_THERMAL_ZONE_OP) {
+          Node = AddAmlDefinition(Scope, &Path, AML_NODE_THERMAL_ZONE, Table);
+        } else if (Op == AML_EXT_PROCESSOR_OP) {
+          // ProcID, PblkAddr (DWORD), PblkLen
+          if (PkgEnd - Ptr < 6) {
+            goto SkipObject;
+          }
+          Node = AddAmlDefinition(Scope, &Path, AML_NODE_PROCESSOR, Table);
+          AmlNode(Node)->Aux   = Ptr[0];
+          AmlNode(Node)->Value = ReadUnaligned32((CONST UINT32 *)(Ptr + 1));
+          Ptr += 6;
+        } else {
+          // SystemLevel, ResourceOrder (WORD)
+          if (PkgEnd - Ptr < 3) {
+            goto SkipObject;
+          }
+          Node = AddAmlDefinition(Scope, &Path, AML_NODE_POWER_RESOURCE, Table);
+          AmlNode(Node)->Aux   = Ptr[0];
+          AmlNode(Node)->Value = ReadUnaligned16((CONST UINT16 *)(Ptr + 1));
+          Ptr += 3;
+        }
+        if (Node != AML_NO_NODE && Nesting < AML_MAX_NESTING) {
+          ParseAmlTermList(Node, Ptr, PkgEnd, Table, Nesting + 1);
+        }
+        Ptr = PkgEnd;
+        break;
+
+      case AML_EXT_CREATE_FIELD_OP:
+        // SourceBuffer, BitIndex, NumBits, NameString
+        if (!SkipAmlTermArg(&Ptr, End, 0) || !SkipAmlTermArg(&Ptr, End, 0) ||
+            !SkipAmlTermArg(&Ptr, End, 0) || !ReadAmlNameString(&Ptr, End, &Path)) {
+          goto Abort;
+        }
+        break;
+
+      default:
+        goto Abort;
+      }
+      break;
+
+    case AML_CREATE_DWORD_OP:
+    case AML_CREATE_WORD_OP:
+    case AML_CREATE_BYTE_OP:
+    case AML_CREATE_BIT_OP:
+    case AML_CREATE_QWORD_OP:
+      // SourceBuffer, Index, NameString
+      if (!SkipAmlTermArg(&Ptr, End, 0) || !SkipAmlTermArg(&Ptr, End, 0) ||
+          !ReadAmlNameString(&Ptr, End, &Path)) {
+        goto Abort;
+      }
+      break;
+
+    default:
+      // A statement such as Store() at scope level: step over its operands
+      Ptr--;
+      if (!SkipAmlTermArg(&Ptr, End, 0)) {
+        goto Abort;
+      }
+      break;
+    }
+    continue;
+
+SkipObject:
+    // A malformed object whose PkgLength is known: drop it, not the scope
+    mAmlAborted++;
+    Ptr = PkgEnd;
+  }
+  return;
+
+Abort:
+  mAmlAborted++;
+}
+
+/**
+  Parses one definition block into the tree.
+*/
+STATIC
+VOID
+ParseAmlTable(
+  IN EFI_ACPI_DESCRIPTION_HEADER  *Table,
+  IN UINT8                        Index
+  )
+{
+  if (Table->Length <= sizeof(EFI_ACPI_DESCRIPTION_HEADER)) {
+    return;
+  }
+  ParseAmlTermList(0,
+                   (CONST UINT8 *)Table + sizeof(EFI_ACPI_DESCRIPTION_HEADER),
+                   (CONST UINT8 *)Table + Table->Length,
+                   Index, 0);
+}
+
+/**
+  Builds the namespace from the DSDT and every SSDT, once per session.
+*/
+STATIC
+EFI_STATUS
+BuildAmlNamespace(VOID)
+{
+  EFI_ACPI_DESCRIPTION_HEADER *Table;
+
+  if (mAmlNodes != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Table = AcpiFindTable(DSDT_SIGNATURE, 0);
+  if (Table == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  if (AddAmlNode(0, SIGNATURE_32('\\', ' ', ' ', ' '), AML_NODE_ROOT, 0) == AML_NO_NODE) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  mAmlNodes[0].Flags |= AML_FLAG_EXPANDED;
+
+  ParseAmlTable(Table, 0);
+  for (mAmlSsdtCount = 0; mAmlSsdtCount < MAX_UINT8 &&
+       (Table = AcpiFindTable(SSDT_SIGNATURE, mAmlSsdtCount)) != NULL; mAmlSsdtCount++) {
+    ParseAmlTable(Table, (UINT8)(mAmlSsdtCount + 1));
+  }
+
+  mAmlVisible = AllocatePool(mAmlNodeCount * sizeof(UINT32));
+  if (mAmlVisible == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Lists the expanded part of the tree in display order.
+*/
+STATIC
+VOID
+RebuildAmlVisible(VOID)
+{
+  UINT32 Node = 0;
+
+  mAmlVisibleCount = 0;
+  while (TRUE) {
+    mAmlVisible[mAmlVisibleCount++] = Node;
+    if ((mAmlNodes[Node].Flags & AML_FLAG_EXPANDED) != 0 && mAmlNodes[Node].FirstChild != 0) {
+      Node = mAmlNodes[Node].FirstChild;
+      continue;
+    }
+    while (Node != 0 && mAmlNodes[Node].Next == 0) {
+      Node = mAmlNodes[Node].Parent;
+    }
+    if (Node == 0) {
+      break;
+    }
+    Node = mAmlNodes[Node].Next;
+  }
+}
+
+STATIC
+CONST CHAR16 *
+GetAmlKindName(
+  IN UINT8  Kind
+  )
+{
+  switch (Kind) {
+  case AML_NODE_ROOT:           return L"Root";
+  case AML_NODE_SCOPE:          return L"Scope";
+  case AML_NODE_DEVICE:         return L"Device";
+  case AML_NODE_METHOD:         return L"Method";
+  case AML_NODE_NAME:           return L"Name";
+  case AML_NODE_PROCESSOR:      return L"Processor";
+  case AML_NODE_POWER_RESOURCE: return L"PowerRes";
+  case AML_NODE_THERMAL_ZONE:   return L"ThermalZone";
+  case AML_NODE_OP_REGION:      return L"OpRegion";
+  case AML_NODE_MUTEX:          return L"Mutex";
+  case AML_NODE_EVENT:          return L"Event";
+  case AML_NODE_ALIAS:          return L"Alias";
+  default:                      return L"?";
+  }
+}
+
+STATIC
+CONST CHAR16 *
+GetAmlRegionSpaceName(
+  IN UINT8  Space
+  )
+{
+  STATIC CONST CHAR16 *Names[] = {
+    L"SystemMemory", L"SystemIO", L"PCI_Config", L"EmbeddedControl", L"SMBus",
+    L"SystemCMOS", L"PciBarTarget", L"IPMI", L"GeneralPurposeIO", L"GenericSerialBus",
+    L"PCC"
+  };
+
+  if (Space < ARRAY_SIZE(Names)) {
+    return Names[Space];
+  }
+  return (Space >= 0x80) ? L"OEM" : L"Reserved";
+}
+
+/**
+  Decodes a compressed EISA ID such as the _HID of PNP0A08. Returns FALSE
+  if the value does not look like one.
+*/
+STATIC
+BOOLEAN
+DecodeEisaId(
+  IN  UINT64  Value,
+  OUT CHAR16  Id[8]
+  )
+{
+  UINT8 Bytes[4];
+
+  if (Value > MAX_UINT32) {
+    return FALSE;
+  }
+  CopyMem(Bytes, &Value, sizeof(Bytes));
+  if ((Bytes[0] & BIT7) != 0) {
+    return FALSE;
+  }
+
+  Id[0] = (CHAR16)('@' + ((Bytes[0] >> 2) & 0x1F));
+  Id[1] = (CHAR16)('@' + (((Bytes[0] & 0x03) << 3) | (Bytes[1] >> 5)));
+  Id[2] = (CHAR16)('@' + (Bytes[1] & 0x1F));
+  for (UINTN i = 0; i < 3; i++) {
+    if (Id[i] < L'A' || Id[i] > L'Z') {
+      return FALSE;
+    }
+  }
+  UnicodeSPrint(&Id[3], 5 * sizeof(CHAR16), L"%02X%02X", Bytes[2], Bytes[3]);
+  return TRUE;
+}
+
+/**
+  Formats a NameSeg with its trailing '_' padding kept, as ASL does.
+*/
+STATIC
+VOID
+AmlSegToText(
+  IN  UINT32  Name,
+  OUT CHAR16  Text[5]
+  )
+{
+  for (UINTN i = 0; i < 4; i++) {
+    Text[i] = (CHAR16)((Name >> (8 * i)) & 0xFF);
+  }
+  Text[4] = L'\0';
+}
+
+/**
+  Formats the absolute path of a node, e.g. \_SB_.PCI0.LPCB.
+*/
+STATIC
+VOID
+GetAmlNodePath(
+  IN  UINT32  Node,
+  OUT CHAR16  *Path,
+  IN  UINTN   PathSize
+  )
+{
+  UINT32 Chain[AML_MAX_NESTING + 1];
+  UINTN  Depth = 0;
+  UINTN  Used;
+  CHAR16 Seg[5];
+
+  for (; Node != 0 && Depth < ARRAY_SIZE(Chain); Node = mAmlNodes[Node].Parent) {
+    Chain[Depth++] = Node;
+  }
+
+  Used = UnicodeSPrint(Path, PathSize, L"\\");
+  while (Depth > 0) {
+    Depth--;
+    AmlSegToText(mAmlNodes[Chain[Depth]].Name, Seg);
+    Used += UnicodeSPrint(Path + Used, PathSize - Used * sizeof(CHAR16), L"%s%s",
+                          Seg, (Depth > 0) ? L"." : L"");
+  }
+}
+
+/**
+  Formats what is known about a node beyond its name and kind.
+*/
+STATIC
+VOID
+FormatAmlNodeValue(
+  IN  AML_NODE  *Node,
+  OUT CHAR16    *Text,
+  IN  UINTN     TextSize
+  )
+{
+  CHAR16 EisaId[8];
+  CHAR16 Seg[5];
+  UINTN  Used;
+
+  Text[0] = L'\0';
+  switch (Node->Kind) {
+  case AML_NODE_NAME:
+    if (Node->ValueKind == AML_VALUE_INTEGER) {
+      if ((Node->Name == SIGNATURE_32('_', 'H', 'I', 'D') || Node->Name == SIGNATURE_32('_', 'C', 'I', 'D')) &&
+          DecodeEisaId(Node->Value, EisaId)) {
+        UnicodeSPrint(Text, TextSize, L"EisaId (\"%s\")", EisaId);
+      } else {
+        UnicodeSPrint(Text, TextSize, L"0x%lX", Node->Value);
+      }
+    } else if (Node->ValueKind == AML_VALUE_STRING) {
+      UnicodeSPrint(Text, TextSize, L"\"%a\"", Node->Data);
+    } else if (Node->ValueKind == AML_VALUE_BUFFER) {
+      UnicodeSPrint(Text, TextSize, L"Buffer (%ld bytes)", Node->Value);
+    } else if (Node->ValueKind == AML_VALUE_PACKAGE) {
+      UnicodeSPrint(Text, TextSize, L"Package (%ld elements)", Node->Value);
+    }
+    break;
+
+  case AML_NODE_METHOD:
+    UnicodeSPrint(Text, TextSize, L"%d args%s", Node->Aux & 0x07,
+                  ((Node->Aux & BIT3) != 0) ? L", Serialized" : L"");
+    break;
+
+  case AML_NODE_OP_REGION:
+    Used = UnicodeSPrint(Text, TextSize, L"%s ", GetAmlRegionSpaceName(Node->Aux));
+    if ((Node->Flags & AML_FLAG_OFFSET_UNKNOWN) != 0) {
+      Used += UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L"(computed)");
+    } else {
+      Used += UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L"0x%lX", Node->Value);
+    }
+    if ((Node->Flags & AML_FLAG_LENGTH_UNKNOWN) != 0) {
+      UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L" length (computed)");
+    } else {
+      UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L" length 0x%lX", Node->Length);
+    }
+    break;
+
+  case AML_NODE_PROCESSOR:
+    UnicodeSPrint(Text, TextSize, L"ID 0x%02X, PBLK 0x%lX", Node->Aux, Node->Value);
+    break;
+
+  case AML_NODE_POWER_RESOURCE:
+    UnicodeSPrint(Text, TextSize, L"S%d, order %ld", Node->Aux, Node->Value);
+    break;
+
+  case AML_NODE_ALIAS:
+    Used = UnicodeSPrint(Text, TextSize, L"-> ");
+    if (Node->Aux == MAX_UINT8) {
+      Used += UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L"\\");
+    } else {
+      for (UINTN i = 0; i < Node->Aux; i++) {
+        Used += UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L"^");
+      }
+    }
+    for (UINTN i = 0; i < Node->Value; i++) {
+      AmlSegToText(ReadUnaligned32((CONST UINT32 *)(Node->Data + i * 4)), Seg);
+      Used += UnicodeSPrint(Text + Used, TextSize - Used * sizeof(CHAR16), L"%s%s",
+                            Seg, (i + 1 < Node->Value) ? L"." : L"");
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+/**
+  Number of tree rows between the header line and the footer.
+*/
+STATIC
+UINTN
+AmlVisibleRows(VOID)
+{
+  UINTN Columns, Rows;
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  // One header line, two footer lines and a spare line so the screen never scrolls
+  return (Rows > 5) ? (Rows - 4) : 1;
+}
+
+/**
+  Prints one tree row at its position in the window, cut to the screen width.
+*/
+STATIC
+VOID
+DrawAmlRow(
+  IN UINTN  Row
+  )
+{
+  AML_NODE *Node = &mAmlNodes[mAmlVisible[Row]];
+  UINTN    Background = (Row == mAmlSelected) ? EFI_GREEN : EFI_BLUE;
+  UINTN    Columns, Rows;
+  UINTN    Indent;
+  CHAR16   Seg[5];
+  CHAR16   Value[80];
+  CHAR16   Line[160];
+  CHAR16   Marker;
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  if (Columns > ARRAY_SIZE(Line)) {
+    Columns = ARRAY_SIZE(Line);
+  }
+
+  Indent = (Node->Depth < 20) ? Node->Depth * 2 : 40;
+  Marker = (Node->FirstChild == 0) ? L' ' :
+           ((Node->Flags & AML_FLAG_EXPANDED) != 0) ? L'-' : L'+';
+  AmlSegToText(Node->Name, Seg);
+  FormatAmlNodeValue(Node, Value, sizeof(Value));
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Row - mAmlTop);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, Background));
+  UnicodeSPrint(Line, sizeof(Line), L" %*s%c %-4s", Indent, L"", Marker, Seg);
+  Print(L"%s", Line);
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, Background));
+  Indent = StrLen(Line);
+  UnicodeSPrint(Line, sizeof(Line), L"  %-11s %s", GetAmlKindName(Node->Kind), Value);
+  // Pad to the full width so a repaint clears the old row, and never wrap
+  if (Indent + StrLen(Line) < Columns - 1) {
+    Print(L"%s%*s", Line, Columns - 1 - Indent - StrLen(Line), L"");
+  } else if (Indent < Columns - 1) {
+    Line[Columns - 1 - Indent] = L'\0';
+    Print(L"%s", Line);
+  }
+}
+
+/**
+  Prints the footer: the full path and source table of the selected node.
+*/
+STATIC
+VOID
+DrawAmlFooter(VOID)
+{
+  AML_NODE *Node = &mAmlNodes[mAmlVisible[mAmlSelected]];
+  UINTN    Visible = AmlVisibleRows();
+  CHAR16   Path[AML_PATH_MAX];
+  CHAR16   Source[16];
+
+  GetAmlNodePath(mAmlVisible[mAmlSelected], Path, sizeof(Path));
+  if (StrLen(Path) > 50) {
+    // Keep the innermost part of a deep path
+    CopyMem(Path, L"...", 3 * sizeof(CHAR16));
+    CopyMem(Path + 3, Path + StrLen(Path) - 47, 48 * sizeof(CHAR16));
+  }
+  if (Node->Table == 0) {
+    UnicodeSPrint(Source, sizeof(Source), L"DSDT");
+  } else {
+    UnicodeSPrint(Source, sizeof(Source), L"SSDT #%d", Node->Table);
+  }
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Visible);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"%-50s %-10s %5d of %5d\n", Path, Source, mAmlSelected + 1, mAmlVisibleCount);
+  Print(L"ENTER/Right expand, Left collapse or go to parent, ESC to return");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
+
+/**
+  Draws the visible window of the tree around the selection.
+*/
+STATIC
+VOID
+DrawAmlTree(VOID)
+{
+  UINTN Visible = AmlVisibleRows();
+
+  if (mAmlSelected < mAmlTop) {
+    mAmlTop = mAmlSelected;
+  } else if (mAmlSelected >= mAmlTop + Visible) {
+    mAmlTop = mAmlSelected - Visible + 1;
+  }
+
+  gST->ConOut->ClearScreen(gST->ConOut);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+  Print(L" ACPI namespace: %d objects from the DSDT and %d SSDT(s)%s%s\n",
+        mAmlNodeCount - 1, mAmlSsdtCount,
+        mAmlTruncated ? L", truncated" : L"",
+        (mAmlAborted > 0) ? L", some scopes cut short" : L"");
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  for (UINTN i = mAmlTop; i < mAmlVisibleCount && i < mAmlTop + Visible; i++) {
+    DrawAmlRow(i);
+  }
+  DrawAmlFooter();
+}
+
+/**
+  Moves the selection, repainting only the two rows involved when the new
+  row is already on screen.
+*/
+STATIC
+VOID
+MoveAmlSelection(
+  IN UINTN  NewRow
+  )
+{
+  UINTN Visible = AmlVisibleRows();
+  UINTN OldRow  = mAmlSelected;
+
+  if (NewRow >= mAmlVisibleCount || NewRow == OldRow) {
+    return;
+  }
+
+  mAmlSelected = NewRow;
+  if (NewRow < mAmlTop || NewRow >= mAmlTop + Visible) {
+    DrawAmlTree();
+    return;
+  }
+  DrawAmlRow(OldRow);
+  DrawAmlRow(NewRow);
+  DrawAmlFooter();
+}
+
+VOID
+ShowAcpiNamespace(VOID)
+{
+  EFI_STATUS    Status;
+  EFI_INPUT_KEY Key;
+  AML_NODE      *Node;
+  UINTN         Visible;
+
+  gST->ConOut->ClearScreen(gST->ConOut);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+
+  Status = BuildAmlNamespace();
+  if (EFI_ERROR(Status) || mAmlVisible == NULL) {
+    Print(L"Unable to build the ACPI namespace: %r\n", EFI_ERROR(Status) ? Status : EFI_OUT_OF_RESOURCES);
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+    return;
+  }
+
+  RebuildAmlVisible();
+  if (mAmlSelected >= mAmlVisibleCount) {
+    mAmlSelected = 0;
+  }
+  DrawAmlTree();
+
+  while (TRUE) {
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    Visible = AmlVisibleRows();
+    Node    = &mAmlNodes[mAmlVisible[mAmlSelected]];
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    } else if (Key.ScanCode == SCAN_UP) {
+      if (mAmlSelected > 0) MoveAmlSelection(mAmlSelected - 1);
+    } else if (Key.ScanCode == SCAN_DOWN) {
+      MoveAmlSelection(mAmlSelected + 1);
+    } else if (Key.ScanCode == SCAN_PAGE_UP) {
+      MoveAmlSelection((mAmlSelected > Visible) ? (mAmlSelected - Visible) : 0);
+    } else if (Key.ScanCode == SCAN_PAGE_DOWN) {
+      MoveAmlSelection((mAmlSelected + Visible < mAmlVisibleCount) ?
+                       (mAmlSelected + Visible) : (mAmlVisibleCount - 1));
+    } else if (Key.ScanCode == SCAN_HOME) {
+      MoveAmlSelection(0);
+    } else if (Key.ScanCode == SCAN_END) {
+      MoveAmlSelection(mAmlVisibleCount - 1);
+    } else if (Key.ScanCode == SCAN_RIGHT || Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
+      // Rows before the selection do not move when a subtree opens or closes
+      if (Node->FirstChild != 0) {
+        if (Key.ScanCode == SCAN_RIGHT) {
+          Node->Flags |= AML_FLAG_EXPANDED;
+        } else {
+          Node->Flags ^= AML_FLAG_EXPANDED;
+        }
+        RebuildAmlVisible();
+        DrawAmlTree();
+      }
+    } else if (Key.ScanCode == SCAN_LEFT) {
+      if ((Node->Flags & AML_FLAG_EXPANDED) != 0 && Node->FirstChild != 0) {
+        Node->Flags &= (UINT8)~AML_FLAG_EXPANDED;
+        RebuildAmlVisible();
+        DrawAmlTree();
+      } else if (mAmlSelected > 0) {
+        UINTN Row = mAmlSelected;
+        while (Row > 0 && mAmlVisible[Row] != Node->Parent) {
+          Row--;
+        }
+        MoveAmlSelection(Row);
+      }
+    }
+  }
+}
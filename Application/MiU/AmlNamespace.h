@@ -0,0 +1,10 @@
+#pragma once
+#include <Uefi.h>
+
+/**
+  Shows the ACPI namespace declared by the DSDT and all SSDTs as a
+  collapsible tree. The definition blocks are parsed once, on first use;
+  method bodies are not parsed.
+*/
+VOID
+ShowAcpiNamespace(VOID);
@@ -0,0 +1,235 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Protocol/LoadedImage.h>
+#include "Batch.h"
+#include "Snapshot.h"
+#include "FileHelper.h"
+
+typedef struct {
+  CONST CHAR16  *Flag;
+  UINT32        Type;
+} BATCH_SECTION_FLAG;
+
+STATIC CONST BATCH_SECTION_FLAG mBatchSectionFlags[] = {
+  { L"-pci",       SNAPSHOT_SECTION_PCI           },
+  { L"-smbios",    SNAPSHOT_SECTION_SMBIOS        },
+  { L"-acpi",      SNAPSHOT_SECTION_ACPI          },
+  { L"-vars",      SNAPSHOT_SECTION_VARIABLES     },
+  { L"-memmap",    SNAPSHOT_SECTION_MEMORY_MAP    },
+  { L"-loadopts",  SNAPSHOT_SECTION_LOAD_OPTIONS  },
+  { L"-cfgtables", SNAPSHOT_SECTION_CONFIG_TABLES },
+};
+
+STATIC
+VOID
+PrintBatchUsage (
+  VOID
+  )
+{
+  Print(L"Usage: MiU [-pci] [-smbios] [-acpi] [-vars] [-memmap] [-loadopts]\n");
+  Print(L"           [-cfgtables] [-all] [-out FILE] [-nocompress] [-quiet]\n");
+  Print(L"Captures the selected sections (all if none) into one snapshot file on\n");
+  Print(L"the export volume and exits. Without flags MiU starts interactively.\n");
+}
+
+/**
+  Cut the next word out of the command line in place. Double quotes group
+  words with spaces and are removed.
+
+  @param[in,out]  Cursor  Where to continue; moved past the word.
+
+  @return The word, or NULL at the end of the line.
+**/
+STATIC
+CHAR16 *
+NextBatchArgument (
+  IN OUT CHAR16  **Cursor
+  )
+{
+  CHAR16  *Read = *Cursor;
+  CHAR16  *Write;
+  CHAR16  *Word;
+  BOOLEAN Quoted = FALSE;
+
+  while (*Read == L' ' || *Read == L'\t') {
+    Read++;
+  }
+  if (*Read == L'\0') {
+    *Cursor = Read;
+    return NULL;
+  }
+
+  Word = Write = Read;
+  while (*Read != L'\0' && (Quoted || (*Read != L' ' && *Read != L'\t'))) {
+    if (*Read == L'"') {
+      Quoted = !Quoted;
+    } else {
+      *Write++ = *Read;
+    }
+    Read++;
+  }
+  // Step over the separator before it is overwritten by the terminator
+  *Cursor = (*Read != L'\0') ? Read + 1 : Read;
+  *Write  = L'\0';
+  return Word;
+}
+
+/**
+  Copy LoadOptions if they are a printable UCS-2 string. Boot options may
+  pass binary data instead, which is not a command line.
+**/
+STATIC
+CHAR16 *
+CopyCommandLine (
+  IN EFI_HANDLE  ImageHandle
+  )
+{
+  EFI_LOADED_IMAGE_PROTOCOL *LoadedImage;
+  CONST CHAR16              *Options;
+  UINTN                     Length;
+  CHAR16                    *Copy;
+
+  if (EFI_ERROR(gBS->HandleProtocol(ImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage)) ||
+      LoadedImage->LoadOptions == NULL || LoadedImage->LoadOptionsSize < sizeof(CHAR16)) {
+    return NULL;
+  }
+
+  Options = (CONST CHAR16 *)LoadedImage->LoadOptions;
+  for (Length = 0; Length < LoadedImage->LoadOptionsSize / sizeof(CHAR16) && Options[Length] != L'\0'; Length++) {
+    if (Options[Length] < L' ' && Options[Length] != L'\t') {
+      return NULL;
+    }
+  }
+
+  Copy = AllocateZeroPool((Length + 1) * sizeof(CHAR16));
+  if (Copy != NULL) {
+    CopyMem(Copy, Options, Length * sizeof(CHAR16));
+  }
+  return Copy;
+}
+
+EFI_STATUS
+ParseBatchOptions (
+  IN  EFI_HANDLE     ImageHandle,
+  OUT BATCH_OPTIONS  *Options
+  )
+{
+  CHAR16  *Cursor;
+  CHAR16  *Arg;
+  BOOLEAN Found = FALSE;
+  UINTN   i;
+
+  ZeroMem(Options, sizeof(*Options));
+  Options->Compress    = TRUE;
+  Options->CommandLine = CopyCommandLine(ImageHandle);
+  if (Options->CommandLine == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Cursor = Options->CommandLine;
+  Arg    = NextBatchArgument(&Cursor);
+  // The shell passes the program name first; boot option data starts with a flag
+  if (Arg != NULL && Arg[0] != L'-') {
+    Arg = NextBatchArgument(&Cursor);
+  }
+
+  for (; Arg != NULL; Arg = NextBatchArgument(&Cursor)) {
+    Found = TRUE;
+
+    for (i = 0; i < ARRAY_SIZE(mBatchSectionFlags); i++) {
+      if (StrCmp(Arg, mBatchSectionFlags[i].Flag) == 0) {
+        Options->SectionMask |= SNAPSHOT_SELECT(mBatchSectionFlags[i].Type);
+        break;
+      }
+    }
+    if (i < ARRAY_SIZE(mBatchSectionFlags)) {
+      continue;
+    }
+
+    if (StrCmp(Arg, L"-all") == 0) {
+      Options->SectionMask = SNAPSHOT_SELECT_ALL;
+    } else if (StrCmp(Arg, L"-out") == 0) {
+      Options->OutFile = NextBatchArgument(&Cursor);
+      if (Options->OutFile == NULL || Options->OutFile[0] == L'\0') {
+        Print(L"MiU: -out needs a file name\n");
+        PrintBatchUsage();
+        return EFI_INVALID_PARAMETER;
+      }
+    } else if (StrCmp(Arg, L"-nocompress") == 0) {
+      Options->Compress = FALSE;
+    } else if (StrCmp(Arg, L"-quiet") == 0) {
+      Options->Quiet = TRUE;
+    } else if (StrCmp(Arg, L"-h") == 0 || StrCmp(Arg, L"-?") == 0) {
+      Options->Help = TRUE;
+    } else {
+      Print(L"MiU: unknown option %s\n", Arg);
+      PrintBatchUsage();
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  if (!Found) {
+    return EFI_NOT_FOUND;
+  }
+  if (Options->SectionMask == 0) {
+    Options->SectionMask = SNAPSHOT_SELECT_ALL;
+  }
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+RunBatch (
+  IN EFI_HANDLE     ImageHandle,
+  IN BATCH_OPTIONS  *Options
+  )
+{
+  EFI_STATUS Status;
+  EFI_STATUS CollectorStatus;
+  CHAR16     Stem[48];
+  CHAR16     NumberedName[64];
+  CHAR16     *FileName;
+
+  if (Options->Help) {
+    PrintBatchUsage();
+    return EFI_SUCCESS;
+  }
+
+  // Nobody is there to answer the volume picker
+  FileHelperSetInteractive(FALSE);
+
+  FileName = Options->OutFile;
+  if (FileName == NULL) {
+    MakeTimestampStem(L"snapshot", Stem, sizeof(Stem));
+    Status = MakeExportFileName(ImageHandle, Stem, L"miu", NumberedName, sizeof(NumberedName));
+    if (EFI_ERROR(Status)) {
+      Print(L"MiU: no export file: %r\n", Status);
+      return Status;
+    }
+    FileName = NumberedName;
+  }
+
+  Status = CaptureSnapshot(FileName, Options->Compress, Options->SectionMask, !Options->Quiet, &CollectorStatus);
+  if (EFI_ERROR(Status)) {
+    Print(L"MiU: capture to %s failed: %r\n", FileName, Status);
+    return Status;
+  }
+  if (!Options->Quiet) {
+    Print(L"Saved to %s\n", FileName);
+  }
+  return CollectorStatus;
+}
+
+VOID
+FreeBatchOptions (
+  IN OUT BATCH_OPTIONS  *Options
+  )
+{
+  if (Options->CommandLine != NULL) {
+    FreePool(Options->CommandLine);
+  }
+  ZeroMem(Options, sizeof(*Options));
+}
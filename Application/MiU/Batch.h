@@ -0,0 +1,62 @@
+#pragma once
+#include <Uefi.h>
+
+//
+// What the command line asks for when MiU runs without its UI
+//
+typedef struct {
+  CHAR16   *CommandLine;    // Pool copy of LoadOptions, split in place
+  UINT32   SectionMask;     // SNAPSHOT_SELECT() bits of the sections to capture
+  BOOLEAN  Compress;
+  BOOLEAN  Quiet;
+  BOOLEAN  Help;
+  CHAR16   *OutFile;        // -out name inside CommandLine, or NULL for a numbered name
+} BATCH_OPTIONS;
+
+/**
+  Parse the flags MiU was started with (EFI_LOADED_IMAGE_PROTOCOL.LoadOptions):
+
+    -pci -smbios -acpi -vars -memmap   sections to capture (all if none)
+    -loadopts -cfgtables
+    -all                               every section
+    -out FILE                          file on the export volume
+    -nocompress                        store sections uncompressed
+    -quiet                             print nothing but errors
+    -h, -?                             usage
+
+  The first word is skipped unless it starts with '-', so both a shell
+  command line and bare boot option data work.
+
+  @param[in]   ImageHandle  The MiU image handle.
+  @param[out]  Options      Receives the request; release with FreeBatchOptions().
+
+  @retval EFI_SUCCESS            Options holds a batch request.
+  @retval EFI_NOT_FOUND          There are no flags; run the interactive UI.
+  @retval EFI_INVALID_PARAMETER  A flag is unknown or -out has no name.
+                                 The usage text was printed.
+**/
+EFI_STATUS
+ParseBatchOptions (
+  IN  EFI_HANDLE     ImageHandle,
+  OUT BATCH_OPTIONS  *Options
+  );
+
+/**
+  Capture the requested sections into one snapshot file without touching
+  the keyboard or the screen layout. The export volume is chosen without
+  asking: the boot volume if writable, else the first writable one.
+
+  @retval EFI_SUCCESS  The snapshot was written and every collector succeeded.
+  @retval others       The file error, or the first collector error if the
+                       file was still written.
+**/
+EFI_STATUS
+RunBatch (
+  IN EFI_HANDLE     ImageHandle,
+  IN BATCH_OPTIONS  *Options
+  );
+
+VOID
+FreeBatchOptions (
+  IN OUT BATCH_OPTIONS  *Options
+  );
@@ -0,0 +1,665 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "ACPI.h"
+#include "BootPerformance.h"
+#include "GuidNames.h"
+
+#define FPDT_SIGNATURE  SIGNATURE_32('F', 'P', 'D', 'T')
+#define FBPT_SIGNATURE  SIGNATURE_32('F', 'B', 'P', 'T')
+
+//
+// Record layouts (ACPI 6.5, 5.2.24, and edk2 ExtendedFirmwarePerformance.h).
+// Every record starts with Type (UINT16), Length (UINT8) and Revision.
+//
+#define FPDT_RECORD_HEADER_SIZE        4
+#define FPDT_BOOT_POINTER_TYPE         0x0000
+#define FPDT_BOOT_POINTER_ADDRESS      8
+#define FPDT_BOOT_POINTER_LENGTH       16
+
+#define FBPT_HEADER_SIZE               8      // Signature, Length
+#define FBPT_BASIC_BOOT_TYPE           0x0002
+#define FBPT_RESET_END                 8
+#define FBPT_OS_LOADER_LOAD_IMAGE      16
+#define FBPT_OS_LOADER_START_IMAGE     24
+#define FBPT_EXIT_BOOT_SERVICES_ENTRY  32
+#define FBPT_EXIT_BOOT_SERVICES_EXIT   40
+#define FBPT_BASIC_BOOT_LENGTH         48
+
+#define FPDT_GUID_EVENT_TYPE           0x1010
+#define FPDT_DYNAMIC_STRING_TYPE       0x1011
+#define FPDT_DUAL_GUID_STRING_TYPE     0x1012
+#define FPDT_GUID_QWORD_TYPE           0x1013
+#define FPDT_GUID_QWORD_STRING_TYPE    0x1014
+#define FPDT_EVENT_PROGRESS_ID         4      // UINT16
+#define FPDT_EVENT_TIMESTAMP           10     // UINT64, nanoseconds
+#define FPDT_EVENT_GUID                18
+#define FPDT_EVENT_SIZE                34
+#define FPDT_DUAL_GUID_STRING          50
+#define FPDT_QWORD_STRING              42
+
+//
+// Progress IDs of the edk2 records. Below 0x10 odd IDs start and the next
+// even ID ends; from 0x10 on, xx0 starts and xx1 ends.
+//
+#define MODULE_START_ID                0x01
+#define MODULE_LOADIMAGE_START_ID      0x03
+#define MODULE_DB_START_ID             0x05
+#define MODULE_DB_SUPPORT_START_ID     0x07
+#define MODULE_DB_STOP_START_ID        0x09
+#define MODULE_DB_STOP_END_ID          0x0A
+#define PERF_EVENTSIGNAL_START_ID      0x10
+#define PERF_CALLBACK_START_ID         0x20
+#define PERF_FUNCTION_START_ID         0x30
+#define PERF_INMODULE_START_ID         0x40
+#define PERF_CROSSMODULE_START_ID      0x50
+
+#define PERF_NAME_MAX                  32
+
+typedef struct {
+  CONST EFI_GUID  *Guid;
+  CHAR8           Name[PERF_NAME_MAX];   // From the record, may be empty
+  UINT16          StartId;
+  UINT64          Start;                 // Nanoseconds
+  UINT64          Duration;
+} PERF_MEASUREMENT;
+
+typedef struct {
+  CONST EFI_GUID    *Guid;
+  CONST CHAR8       *Name;
+  UINTN             Count;
+  UINT64            Total;
+} PERF_MODULE;
+
+typedef struct {
+  UINT64            ResetEnd;
+  UINT64            LoadImageStart;
+  UINT64            StartImageStart;
+  UINT64            ExitBootServicesEntry;
+  UINT64            ExitBootServicesExit;
+  BOOLEAN           HasBasicRecord;
+  PERF_MEASUREMENT  *Measurements;
+  UINTN             MeasurementCount;
+  UINTN             UnmatchedCount;       // Start records with no end
+  PERF_MEASUREMENT  **ByCost;             // Measurements, longest first
+  PERF_MODULE       *Modules;
+  UINTN             ModuleCount;
+} BOOT_PERFORMANCE;
+
+typedef enum {
+  PerfPageSummary,
+  PerfPageModules,
+  PerfPageMeasurements,
+  PerfPageMax
+} PERF_PAGE;
+
+STATIC CONST CHAR16 *mPerfPageName[PerfPageMax] = {
+  L"Summary and phases", L"Modules by cost", L"All measurements"
+};
+
+STATIC
+UINT64
+ReadRecordU64(
+  IN CONST UINT8  *Record,
+  IN UINTN        Offset
+  )
+{
+  UINT64 Value;
+
+  CopyMem(&Value, Record + Offset, sizeof(Value));
+  return Value;
+}
+
+STATIC
+CONST CHAR16 *
+GetProgressName(
+  IN UINT16  StartId
+  )
+{
+  switch (StartId) {
+  case MODULE_START_ID:            return L"Entry";
+  case MODULE_LOADIMAGE_START_ID:  return L"LoadImage";
+  case MODULE_DB_START_ID:         return L"DB:Start";
+  case MODULE_DB_SUPPORT_START_ID: return L"DB:Support";
+  case MODULE_DB_STOP_START_ID:    return L"DB:Stop";
+  case PERF_EVENTSIGNAL_START_ID:  return L"Event";
+  case PERF_CALLBACK_START_ID:     return L"Callback";
+  case PERF_FUNCTION_START_ID:     return L"Function";
+  case PERF_INMODULE_START_ID:     return L"InModule";
+  case PERF_CROSSMODULE_START_ID:  return L"Phase";
+  default:                         return L"Other";
+  }
+}
+
+STATIC
+BOOLEAN
+IsStartId(
+  IN UINT16  ProgressId
+  )
+{
+  if (ProgressId < PERF_EVENTSIGNAL_START_ID) {
+    return (BOOLEAN)((ProgressId & 1) != 0);
+  }
+  return (BOOLEAN)((ProgressId & 0x0F) == 0);
+}
+
+/**
+  Module measurements are the ones charged to a driver: entry point, image
+  load and driver binding calls.
+**/
+STATIC
+BOOLEAN
+IsModuleMeasurement(
+  IN UINT16  StartId
+  )
+{
+  return (BOOLEAN)(StartId >= MODULE_START_ID && StartId <= MODULE_DB_STOP_END_ID);
+}
+
+STATIC
+INTN
+EFIAPI
+CompareMeasurementCost(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST PERF_MEASUREMENT *Ma = *(PERF_MEASUREMENT * CONST *)A;
+  CONST PERF_MEASUREMENT *Mb = *(PERF_MEASUREMENT * CONST *)B;
+
+  return (Ma->Duration > Mb->Duration) ? -1 : (Ma->Duration < Mb->Duration) ? 1 : 0;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareMeasurementGuid(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST PERF_MEASUREMENT *Ma = *(PERF_MEASUREMENT * CONST *)A;
+  CONST PERF_MEASUREMENT *Mb = *(PERF_MEASUREMENT * CONST *)B;
+
+  return CompareMem(Ma->Guid, Mb->Guid, sizeof(EFI_GUID));
+}
+
+STATIC
+INTN
+EFIAPI
+CompareModuleCost(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST PERF_MODULE *Ma = A;
+  CONST PERF_MODULE *Mb = B;
+
+  return (Ma->Total > Mb->Total) ? -1 : (Ma->Total < Mb->Total) ? 1 : 0;
+}
+
+/**
+  Copy the optional ASCII string that trails an extended record.
+**/
+STATIC
+VOID
+CopyRecordString(
+  IN  CONST UINT8  *Record,
+  IN  UINTN        Offset,
+  OUT CHAR8        *Name
+  )
+{
+  UINTN Length = 0;
+
+  while (Offset + Length < Record[2] && Length + 1 < PERF_NAME_MAX && Record[Offset + Length] != '\0') {
+    Name[Length] = (CHAR8)Record[Offset + Length];
+    Length++;
+  }
+  Name[Length] = '\0';
+}
+
+/**
+  Pair the start and end records of the FBPT in one pass. Open starts are
+  kept on a stack; an end closes the most recent open start with the same
+  GUID, progress ID and name, which handles nested measurements.
+**/
+STATIC
+VOID
+PairBootRecords(
+  IN     CONST UINT8       *Record,
+  IN     CONST UINT8       *End,
+  IN     UINTN             Capacity,
+  IN OUT BOOT_PERFORMANCE  *Perf,
+  IN     PERF_MEASUREMENT  *Open
+  )
+{
+  UINTN OpenCount = 0;
+
+  for (; Record + FPDT_RECORD_HEADER_SIZE <= End && Record[2] >= FPDT_RECORD_HEADER_SIZE &&
+         Record + Record[2] <= End; Record += Record[2]) {
+    UINT16           Type = ReadUnaligned16((CONST UINT16 *)Record);
+    UINT16           ProgressId;
+    PERF_MEASUREMENT Event;
+
+    if (Type == FBPT_BASIC_BOOT_TYPE && Record[2] >= FBPT_BASIC_BOOT_LENGTH) {
+      Perf->HasBasicRecord        = TRUE;
+      Perf->ResetEnd              = ReadRecordU64(Record, FBPT_RESET_END);
+      Perf->LoadImageStart        = ReadRecordU64(Record, FBPT_OS_LOADER_LOAD_IMAGE);
+      Perf->StartImageStart       = ReadRecordU64(Record, FBPT_OS_LOADER_START_IMAGE);
+      Perf->ExitBootServicesEntry = ReadRecordU64(Record, FBPT_EXIT_BOOT_SERVICES_ENTRY);
+      Perf->ExitBootServicesExit  = ReadRecordU64(Record, FBPT_EXIT_BOOT_SERVICES_EXIT);
+      continue;
+    }
+    if (Type < FPDT_GUID_EVENT_TYPE || Type > FPDT_GUID_QWORD_STRING_TYPE || Record[2] < FPDT_EVENT_SIZE) {
+      continue;
+    }
+
+    ZeroMem(&Event, sizeof(Event));
+    ProgressId  = ReadUnaligned16((CONST UINT16 *)(Record + FPDT_EVENT_PROGRESS_ID));
+    Event.Start = ReadRecordU64(Record, FPDT_EVENT_TIMESTAMP);
+    Event.Guid  = (CONST EFI_GUID *)(Record + FPDT_EVENT_GUID);
+    if (Type == FPDT_DYNAMIC_STRING_TYPE) {
+      CopyRecordString(Record, FPDT_EVENT_SIZE, Event.Name);
+    } else if (Type == FPDT_DUAL_GUID_STRING_TYPE) {
+      CopyRecordString(Record, FPDT_DUAL_GUID_STRING, Event.Name);
+    } else if (Type == FPDT_GUID_QWORD_STRING_TYPE) {
+      CopyRecordString(Record, FPDT_QWORD_STRING, Event.Name);
+    }
+
+    if (IsStartId(ProgressId)) {
+      Event.StartId = ProgressId;
+      if (OpenCount < Capacity) {
+        Open[OpenCount++] = Event;
+      }
+      continue;
+    }
+
+    // An end record: close the innermost matching start
+    {
+      UINT16 StartId = (ProgressId < PERF_EVENTSIGNAL_START_ID) ? (UINT16)(ProgressId - 1) :
+                                                                    (UINT16)(ProgressId & ~0x0F);
+      UINTN  i = OpenCount;
+
+      while (i > 0) {
+        PERF_MEASUREMENT *Candidate = &Open[i - 1];
+        if (Candidate->StartId == StartId && CompareGuid(Candidate->Guid, Event.Guid) &&
+            (Event.Name[0] == '\0' || Candidate->Name[0] == '\0' || AsciiStrCmp(Candidate->Name, Event.Name) == 0)) {
+          break;
+        }
+        i--;
+      }
+      if (i == 0) {
+        continue;
+      }
+
+      Perf->Measurements[Perf->MeasurementCount] = Open[i - 1];
+      Perf->Measurements[Perf->MeasurementCount].Duration =
+        (Event.Start > Open[i - 1].Start) ? (Event.Start - Open[i - 1].Start) : 0;
+      if (Perf->Measurements[Perf->MeasurementCount].Name[0] == '\0') {
+        CopyMem(Perf->Measurements[Perf->MeasurementCount].Name, Event.Name, PERF_NAME_MAX);
+      }
+      Perf->MeasurementCount++;
+
+      // Drop the matched start; later opens shift down
+      CopyMem(&Open[i - 1], &Open[i], (OpenCount - i) * sizeof(PERF_MEASUREMENT));
+      OpenCount--;
+    }
+  }
+  Perf->UnmatchedCount = OpenCount;
+}
+
+/**
+  Total the module measurements per driver GUID, most expensive first.
+**/
+STATIC
+VOID
+TotalModules(
+  IN OUT BOOT_PERFORMANCE  *Perf,
+  IN     PERF_MEASUREMENT  **ByGuid
+  )
+{
+  UINTN            Count = 0;
+  PERF_MEASUREMENT *Scratch;
+  PERF_MODULE      ModuleScratch;
+
+  for (UINTN i = 0; i < Perf->MeasurementCount; i++) {
+    if (IsModuleMeasurement(Perf->Measurements[i].StartId)) {
+      ByGuid[Count++] = &Perf->Measurements[i];
+    }
+  }
+  QuickSort(ByGuid, Count, sizeof(*ByGuid), CompareMeasurementGuid, &Scratch);
+
+  for (UINTN i = 0; i < Count; i++) {
+    if (i == 0 || !CompareGuid(ByGuid[i - 1]->Guid, ByGuid[i]->Guid)) {
+      Perf->Modules[Perf->ModuleCount].Guid = ByGuid[i]->Guid;
+      Perf->Modules[Perf->ModuleCount].Name = ByGuid[i]->Name;
+      Perf->ModuleCount++;
+    }
+    PERF_MODULE *Module = &Perf->Modules[Perf->ModuleCount - 1];
+    if (Module->Name[0] == '\0') {
+      Module->Name = ByGuid[i]->Name;
+    }
+    Module->Count++;
+    Module->Total += ByGuid[i]->Duration;
+  }
+  QuickSort(Perf->Modules, Perf->ModuleCount, sizeof(PERF_MODULE), CompareModuleCost, &ModuleScratch);
+}
+
+STATIC
+VOID
+FreeBootPerformance(
+  IN BOOT_PERFORMANCE  *Perf
+  )
+{
+  if (Perf->Measurements != NULL) FreePool(Perf->Measurements);
+  if (Perf->ByCost != NULL)       FreePool(Perf->ByCost);
+  if (Perf->Modules != NULL)      FreePool(Perf->Modules);
+}
+
+/**
+  Follow the FPDT to the FBPT and decode it.
+**/
+STATIC
+EFI_STATUS
+BuildBootPerformance(
+  OUT BOOT_PERFORMANCE  *Perf
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER *Fpdt;
+  CONST UINT8                 *Record;
+  CONST UINT8                 *End;
+  CONST UINT8                 *Fbpt = NULL;
+  UINT32                      FbptLength;
+  UINTN                       Capacity;
+  PERF_MEASUREMENT            *Open;
+  PERF_MEASUREMENT            *Scratch;
+
+  ZeroMem(Perf, sizeof(BOOT_PERFORMANCE));
+
+  Fpdt = AcpiFindTable(FPDT_SIGNATURE, 0);
+  if (Fpdt == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  End = (CONST UINT8 *)Fpdt + Fpdt->Length;
+  for (Record = (CONST UINT8 *)Fpdt + sizeof(EFI_ACPI_DESCRIPTION_HEADER);
+       Record + FPDT_RECORD_HEADER_SIZE <= End && Record[2] >= FPDT_RECORD_HEADER_SIZE && Record + Record[2] <= End;
+       Record += Record[2]) {
+    if (ReadUnaligned16((CONST UINT16 *)Record) == FPDT_BOOT_POINTER_TYPE && Record[2] >= FPDT_BOOT_POINTER_LENGTH) {
+      Fbpt = (CONST UINT8 *)(UINTN)ReadRecordU64(Record, FPDT_BOOT_POINTER_ADDRESS);
+      break;
+    }
+  }
+  if (Fbpt == NULL || ReadUnaligned32((CONST UINT32 *)Fbpt) != FBPT_SIGNATURE) {
+    return EFI_NOT_FOUND;
+  }
+
+  // Every record is at least four bytes, which bounds all the arrays
+  CopyMem(&FbptLength, Fbpt + 4, sizeof(FbptLength));
+  if (FbptLength < FBPT_HEADER_SIZE) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+  Capacity = (FbptLength - FBPT_HEADER_SIZE) / FPDT_RECORD_HEADER_SIZE + 1;
+
+  Perf->Measurements = AllocateZeroPool(Capacity * sizeof(PERF_MEASUREMENT));
+  Open               = AllocatePool(Capacity * sizeof(PERF_MEASUREMENT));
+  if (Perf->Measurements == NULL || Open == NULL) {
+    if (Open != NULL) FreePool(Open);
+    FreeBootPerformance(Perf);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  PairBootRecords(Fbpt + FBPT_HEADER_SIZE, Fbpt + FbptLength, Capacity, Perf, Open);
+  FreePool(Open);
+
+  Perf->ByCost  = AllocatePool((Perf->MeasurementCount + 1) * sizeof(PERF_MEASUREMENT *));
+  Perf->Modules = AllocateZeroPool((Perf->MeasurementCount + 1) * sizeof(PERF_MODULE));
+  if (Perf->ByCost == NULL || Perf->Modules == NULL) {
+    FreeBootPerformance(Perf);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // ByCost doubles as the scratch list for the per-module totals
+  TotalModules(Perf, Perf->ByCost);
+  for (UINTN i = 0; i < Perf->MeasurementCount; i++) {
+    Perf->ByCost[i] = &Perf->Measurements[i];
+  }
+  QuickSort(Perf->ByCost, Perf->MeasurementCount, sizeof(PERF_MEASUREMENT *), CompareMeasurementCost, &Scratch);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Print a nanosecond value as milliseconds with three decimals.
+**/
+STATIC
+VOID
+PrintMs(
+  IN UINT64  Nanoseconds
+  )
+{
+  UINT32 Remainder;
+  UINT64 Ms = DivU64x32Remainder(Nanoseconds, 1000000, &Remainder);
+
+  Print(L"%7ld.%03d ms", Ms, Remainder / 1000);
+}
+
+/**
+  Print the name of a measurement or module: the record string, else the
+  well-known GUID name, else the GUID itself.
+**/
+STATIC
+VOID
+PrintPerfName(
+  IN CONST EFI_GUID  *Guid,
+  IN CONST CHAR8     *Name
+  )
+{
+  CONST CHAR16 *Known;
+
+  if (Name[0] != '\0') {
+    Print(L"%-36a", Name);
+  } else if ((Known = GetGuidName(Guid)) != NULL) {
+    Print(L"%-36s", Known);
+  } else {
+    Print(L"%g", Guid);
+  }
+}
+
+STATIC
+VOID
+PrintBasicField(
+  IN CONST CHAR16  *Label,
+  IN UINT64        Value
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L" %-28s", Label);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  if (Value == 0) {
+    Print(L"%14s\n", L"not reached");
+  } else {
+    PrintMs(Value);
+    Print(L"\n");
+  }
+}
+
+/**
+  Page 1: the basic boot record and the phase measurements in boot order.
+**/
+STATIC
+VOID
+DrawSummaryPage(
+  IN BOOT_PERFORMANCE  *Perf
+  )
+{
+  if (Perf->HasBasicRecord) {
+    PrintBasicField(L"Reset end", Perf->ResetEnd);
+    PrintBasicField(L"OS loader LoadImage start", Perf->LoadImageStart);
+    PrintBasicField(L"OS loader StartImage start", Perf->StartImageStart);
+    PrintBasicField(L"ExitBootServices entry", Perf->ExitBootServicesEntry);
+    PrintBasicField(L"ExitBootServices exit", Perf->ExitBootServicesExit);
+    if (Perf->StartImageStart > Perf->ResetEnd && Perf->ResetEnd != 0) {
+      PrintBasicField(L"Firmware to OS loader", Perf->StartImageStart - Perf->ResetEnd);
+    }
+  } else {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" The FBPT has no basic boot performance record\n");
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"\n %-36s %14s %14s\n", L"Phase", L"Start", L"Duration");
+  for (UINTN i = 0; i < Perf->MeasurementCount; i++) {
+    PERF_MEASUREMENT *M = &Perf->Measurements[i];
+    if (M->StartId != PERF_CROSSMODULE_START_ID) {
+      continue;
+    }
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" ");
+    PrintPerfName(M->Guid, M->Name);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L" ");
+    PrintMs(M->Start);
+    Print(L" ");
+    PrintMs(M->Duration);
+    Print(L"\n");
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"\n %d measurements paired, %d modules, %d start records without an end\n",
+        Perf->MeasurementCount, Perf->ModuleCount, Perf->UnmatchedCount);
+  if (Perf->MeasurementCount == 0) {
+    Print(L" No extended boot records: the firmware only publishes the basic record\n");
+  }
+}
+
+/**
+  Page 2: entry point, image load and driver binding time per module.
+**/
+STATIC
+VOID
+DrawModulesPage(
+  IN BOOT_PERFORMANCE  *Perf,
+  IN UINTN             Top,
+  IN UINTN             Visible
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %-36s %6s %14s\n", L"Module", L"Count", L"Total");
+
+  for (UINTN i = Top; i < Perf->ModuleCount && i < Top + Visible; i++) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" ");
+    PrintPerfName(Perf->Modules[i].Guid, Perf->Modules[i].Name);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L" %6d ", Perf->Modules[i].Count);
+    PrintMs(Perf->Modules[i].Total);
+    Print(L"\n");
+  }
+}
+
+/**
+  Page 3: every paired measurement, longest first.
+**/
+STATIC
+VOID
+DrawMeasurementsPage(
+  IN BOOT_PERFORMANCE  *Perf,
+  IN UINTN             Top,
+  IN UINTN             Visible
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L" %-10s %-36s %14s %14s\n", L"Kind", L"Name", L"Start", L"Duration");
+
+  for (UINTN i = Top; i < Perf->MeasurementCount && i < Top + Visible; i++) {
+    PERF_MEASUREMENT *M = Perf->ByCost[i];
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L" %-10s ", GetProgressName(M->StartId));
+    PrintPerfName(M->Guid, M->Name);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L" ");
+    PrintMs(M->Start);
+    Print(L" ");
+    PrintMs(M->Duration);
+    Print(L"\n");
+  }
+}
+
+VOID
+ShowBootPerformance(VOID)
+{
+  EFI_STATUS        Status;
+  BOOT_PERFORMANCE  Perf;
+  PERF_PAGE         Page = PerfPageSummary;
+  UINTN             Top  = 0;
+  UINTN             Columns, Rows, Visible;
+  EFI_INPUT_KEY     Key;
+
+  Status = BuildBootPerformance(&Perf);
+  if (EFI_ERROR(Status)) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+    Print(L"Unable to read the FPDT boot performance table: %r\n", Status);
+    Print(L"\nPress any key to return\n");
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+    return;
+  }
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  Visible = (Rows > 6) ? (Rows - 6) : 1;
+
+  for (;;) {
+    UINTN ItemCount = (Page == PerfPageModules)      ? Perf.ModuleCount :
+                      (Page == PerfPageMeasurements) ? Perf.MeasurementCount : 0;
+
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" Boot Performance (FPDT) - %-20s (page %u/%u)\n", mPerfPageName[Page], Page + 1, PerfPageMax);
+
+    switch (Page) {
+      case PerfPageSummary: DrawSummaryPage(&Perf);                   break;
+      case PerfPageModules: DrawModulesPage(&Perf, Top, Visible);     break;
+      default:              DrawMeasurementsPage(&Perf, Top, Visible); break;
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nLeft/Right switch page, Up/Down/PgUp/PgDn scroll, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    switch (Key.ScanCode) {
+      case SCAN_LEFT:
+        Page = (Page == 0) ? (PerfPageMax - 1) : (Page - 1);
+        Top  = 0;
+        break;
+      case SCAN_RIGHT:
+        Page = (Page + 1) % PerfPageMax;
+        Top  = 0;
+        break;
+      case SCAN_UP:
+        if (Top > 0) Top--;
+        break;
+      case SCAN_DOWN:
+        if (Top + Visible < ItemCount) Top++;
+        break;
+      case SCAN_PAGE_UP:
+        Top = (Top > Visible) ? (Top - Visible) : 0;
+        break;
+      case SCAN_PAGE_DOWN:
+        if (Top + Visible < ItemCount) Top += Visible;
+        break;
+      default:
+        break;
+    }
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    }
+  }
+
+  FreeBootPerformance(&Perf);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <Uefi.h>
+
+/**
+  Boot performance from the ACPI FPDT: the Firmware Basic Boot Performance
+  Record and, where the firmware publishes them, the edk2 extended boot
+  records paired into per-module and per-phase durations.
+**/
+VOID
+ShowBootPerformance(VOID);
@@ -0,0 +1,110 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "ConfigTables.h"
+#include "GuidNames.h"
+#include "SnapshotFormat.h"
+
+/**
+  Main entry point: list every entry of gST->ConfigurationTable with its
+  friendly name (when known), vendor GUID and table address.
+**/
+VOID
+ShowConfigurationTables(VOID)
+{
+  UINTN          Columns, Rows;
+  UINTN          PageSize;
+  UINTN          CurrentPage = 0;
+  UINTN          PageCount;
+  UINTN          Index;
+  EFI_INPUT_KEY  Key;
+
+  // Leave room for the header line and the two footer lines
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  PageSize  = (Rows > 4) ? (Rows - 4) : 1;
+  PageCount = (gST->NumberOfTableEntries + PageSize - 1) / PageSize;
+  if (PageCount == 0) {
+    PageCount = 1;
+  }
+
+  while (TRUE) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+
+    // Header: white on red
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L"%4s %-26s %-36s %s\n", L"Idx", L"Name", L"Vendor GUID", L"Table");
+
+    for (Index = CurrentPage * PageSize;
+         Index < gST->NumberOfTableEntries && Index < (CurrentPage + 1) * PageSize;
+         Index++) {
+      EFI_CONFIGURATION_TABLE *Entry = &gST->ConfigurationTable[Index];
+      CONST CHAR16            *Name  = GetGuidName(&Entry->VendorGuid);
+
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+      Print(L"%4u ", Index);
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L"%-26s ", (Name != NULL) ? Name : L"Unknown");
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"%g 0x%lx\n", &Entry->VendorGuid, (UINT64)(UINTN)Entry->VendorTable);
+    }
+
+    // Footer with page information and controls
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\n%u tables  Page %u/%u  Up/Down/PgUp/PgDn Scroll  ESC: Exit\n",
+          gST->NumberOfTableEntries, CurrentPage + 1, PageCount);
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    } else if (Key.ScanCode == SCAN_UP || Key.ScanCode == SCAN_PAGE_UP) {
+      if (CurrentPage > 0) {
+        CurrentPage--;
+      }
+    } else if (Key.ScanCode == SCAN_DOWN || Key.ScanCode == SCAN_PAGE_DOWN) {
+      if (CurrentPage + 1 < PageCount) {
+        CurrentPage++;
+      }
+    }
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
+
+EFI_STATUS
+WriteConfigTableSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  )
+{
+  SNAPSHOT_SYSTEM_TABLE Header;
+  SNAPSHOT_CONFIG_TABLE Entry;
+
+  ZeroMem(&Header, sizeof(Header));
+  Header.UefiRevision     = gST->Hdr.Revision;
+  Header.FirmwareRevision = gST->FirmwareRevision;
+  Header.TableCount       = (UINT32)gST->NumberOfTableEntries;
+  if (gST->FirmwareVendor != NULL) {
+    StrnCpyS(Header.FirmwareVendor, ARRAY_SIZE(Header.FirmwareVendor), gST->FirmwareVendor,
+             ARRAY_SIZE(Header.FirmwareVendor) - 1);
+  }
+  // The writer keeps its first error and drops every later append, so its
+  // status is checked once, after the last entry
+  FileWriterAppend(Writer, &Header, sizeof(Header));
+
+  for (UINTN Index = 0; Index < gST->NumberOfTableEntries; Index++) {
+    CopyGuid(&Entry.VendorGuid, &gST->ConfigurationTable[Index].VendorGuid);
+    Entry.Address = (UINT64)(UINTN)gST->ConfigurationTable[Index].VendorTable;
+    FileWriterAppend(Writer, &Entry, sizeof(Entry));
+  }
+  if (EFI_ERROR(Writer->Status)) {
+    *Count = 0;
+    return Writer->Status;
+  }
+  *Count = gST->NumberOfTableEntries;
+  return EFI_SUCCESS;
+}
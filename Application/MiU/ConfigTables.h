@@ -0,0 +1,11 @@
+#pragma once
+#include <Uefi.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
+
+// Main entry point for the UEFI configuration table view
+VOID ShowConfigurationTables(VOID);
+
+// Firmware vendor and revisions, then every configuration table entry, into a
+// snapshot section. Everything is copied from gST, so Arena is not needed.
+EFI_STATUS WriteConfigTableSnapshotSection(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena, OUT UINTN *Count);
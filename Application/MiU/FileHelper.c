@@ -1,11 +1,457 @@
 #include "FileHelper.h"
 #include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/UefiLib.h>
 #include <Protocol/LoadedImage.h>
 #include <Library/DevicePathLib.h>
+#include <Library/PrintLib.h>
+#include <Library/BaseLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Guid/FileInfo.h>
+#include <Guid/FileSystemInfo.h>
+
+//
+// Highest number tried by MakeExportFileName before giving up
+//
+#define EXPORT_NUMBER_MAX  9999
+
+//
+// One file system offered as an export target
+//
+typedef struct {
+  EFI_HANDLE  Handle;
+  CHAR16      Label[32];
+  UINT64      VolumeSize;
+  UINT64      FreeSpace;
+  BOOLEAN     ReadOnly;
+  BOOLEAN     IsImageVolume;
+  CHAR16      *PathText;
+} EXPORT_VOLUME;
+
+//
+// The export volume chosen for the session and its root directory, kept open
+// so back-to-back exports do not reopen the file system each time.
+//
+STATIC EFI_HANDLE         mVolumeHandle = NULL;
+STATIC EFI_FILE_PROTOCOL  *mVolumeRoot  = NULL;
+
+// FALSE in batch mode: an ambiguous volume choice takes the first writable one
+STATIC BOOLEAN            mInteractive = TRUE;
+
+/**
+  Fill in label, size and read-only state of one file system.
+**/
+STATIC
+EFI_STATUS
+QueryExportVolume (
+  IN OUT EXPORT_VOLUME  *Volume
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *SimpleFs;
+  EFI_FILE_PROTOCOL                *Root;
+  EFI_FILE_SYSTEM_INFO             *Info = NULL;
+  UINTN                            InfoSize = 0;
+
+  Status = gBS->HandleProtocol(Volume->Handle, &gEfiSimpleFileSystemProtocolGuid, (VOID **)&SimpleFs);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Status = SimpleFs->OpenVolume(SimpleFs, &Root);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  Status = Root->GetInfo(Root, &gEfiFileSystemInfoGuid, &InfoSize, NULL);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Info = AllocatePool(InfoSize);
+    Status = (Info == NULL) ? EFI_OUT_OF_RESOURCES :
+             Root->GetInfo(Root, &gEfiFileSystemInfoGuid, &InfoSize, Info);
+  }
+  if (!EFI_ERROR(Status)) {
+    Volume->VolumeSize = Info->VolumeSize;
+    Volume->FreeSpace  = Info->FreeSpace;
+    Volume->ReadOnly   = Info->ReadOnly;
+    StrnCpyS(Volume->Label, ARRAY_SIZE(Volume->Label), Info->VolumeLabel,
+             MIN(StrLen(Info->VolumeLabel), ARRAY_SIZE(Volume->Label) - 1));
+  }
+  if (Info != NULL) {
+    FreePool(Info);
+  }
+  Root->Close(Root);
+  return Status;
+}
+
+/**
+  List every handle with EFI_SIMPLE_FILE_SYSTEM_PROTOCOL.
+
+  @param[in]  ImageHandle  Image whose volume is marked IsImageVolume.
+  @param[out] Volumes  Pool array of the volumes; free with FreeExportVolumes().
+  @param[out] Count    Number of volumes.
+**/
+STATIC
+EFI_STATUS
+GetExportVolumes (
+  IN  EFI_HANDLE     ImageHandle,
+  OUT EXPORT_VOLUME  **Volumes,
+  OUT UINTN          *Count
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_HANDLE                 *Handles;
+  UINTN                      HandleCount;
+  EFI_HANDLE                 ImageDevice = NULL;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+  EFI_DEVICE_PATH_PROTOCOL   *DevicePath;
+  EXPORT_VOLUME              *List;
+
+  *Volumes = NULL;
+  *Count   = 0;
+
+  Status = gBS->LocateHandleBuffer(ByProtocol, &gEfiSimpleFileSystemProtocolGuid, NULL, &HandleCount, &Handles);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  List = AllocateZeroPool(HandleCount * sizeof(EXPORT_VOLUME));
+  if (List == NULL) {
+    FreePool(Handles);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (!EFI_ERROR(gBS->HandleProtocol(ImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage))) {
+    ImageDevice = LoadedImage->DeviceHandle;
+  }
+
+  for (UINTN i = 0; i < HandleCount; i++) {
+    EXPORT_VOLUME *Volume = &List[*Count];
+
+    Volume->Handle = Handles[i];
+    if (EFI_ERROR(QueryExportVolume(Volume))) {
+      continue;
+    }
+    Volume->IsImageVolume = (BOOLEAN)(Handles[i] == ImageDevice);
+    DevicePath            = DevicePathFromHandle(Handles[i]);
+    Volume->PathText      = (DevicePath != NULL) ? ConvertDevicePathToText(DevicePath, FALSE, TRUE) : NULL;
+    (*Count)++;
+  }
+
+  FreePool(Handles);
+  *Volumes = List;
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+FreeExportVolumes (
+  IN EXPORT_VOLUME  *Volumes,
+  IN UINTN          Count
+  )
+{
+  for (UINTN i = 0; i < Count; i++) {
+    if (Volumes[i].PathText != NULL) {
+      FreePool(Volumes[i].PathText);
+    }
+  }
+  if (Volumes != NULL) {
+    FreePool(Volumes);
+  }
+}
+
+/**
+  Make Handle the export volume and open its root directory.
+**/
+STATIC
+EFI_STATUS
+UseExportVolume (
+  IN EFI_HANDLE  Handle
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *SimpleFs;
+  EFI_FILE_PROTOCOL                *Root;
+
+  Status = gBS->HandleProtocol(Handle, &gEfiSimpleFileSystemProtocolGuid, (VOID **)&SimpleFs);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Status = SimpleFs->OpenVolume(SimpleFs, &Root);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  FileHelperCloseVolume();
+  mVolumeHandle = Handle;
+  mVolumeRoot   = Root;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+SelectExportVolume (
+  VOID
+  )
+{
+  EFI_STATUS     Status;
+  EXPORT_VOLUME  *Volumes;
+  UINTN          Count;
+  UINTN          Selected = 0;
+  UINTN          Top      = 0;
+  EFI_INPUT_KEY  Key;
+  UINTN          Columns, Rows, Visible;
+
+  Status = GetExportVolumes(gImageHandle, &Volumes, &Count);
+  if (EFI_ERROR(Status) || Count == 0) {
+    Print(L"No file system found to export to.\n");
+    FreeExportVolumes(Volumes, Count);
+    return EFI_NOT_FOUND;
+  }
+
+  // Start on the volume in use, or the first writable one
+  for (UINTN i = Count; i > 0; i--) {
+    if (Volumes[i - 1].Handle == mVolumeHandle ||
+        (mVolumeHandle == NULL && !Volumes[i - 1].ReadOnly)) {
+      Selected = i - 1;
+    }
+  }
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  // Title, blank line, blank line and prompt stay on screen; volumes scroll
+  Visible = (Rows > 6) ? (Rows - 6) : 1;
+
+  for (;;) {
+    // Keep the selection in the window
+    if (Selected < Top) {
+      Top = Selected;
+    } else if (Selected >= Top + Visible) {
+      Top = Selected - Visible + 1;
+    }
+
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L"=== Export Volume ===                \n\n");
+
+    for (UINTN i = Top; i < Count && i < Top + Visible; i++) {
+      EXPORT_VOLUME *Volume = &Volumes[i];
+
+      if (i == Selected) {
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_GREEN));
+      } else if (Volume->ReadOnly) {
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_DARKGRAY, EFI_BLUE));
+      } else {
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+      }
+      Print(L"%c %-16.16s %7ld MB %7ld MB free %s%s ",
+            (Volume->Handle == mVolumeHandle) ? L'*' : L' ',
+            (Volume->Label[0] != L'\0') ? Volume->Label : L"<no label>",
+            DivU64x32(Volume->VolumeSize, SIZE_1MB),
+            DivU64x32(Volume->FreeSpace, SIZE_1MB),
+            Volume->ReadOnly ? L"RO" : L"RW",
+            Volume->IsImageVolume ? L" boot" : L"     ");
+      // The fixed columns take 57 characters, the device path gets the rest
+      if (Volume->PathText != NULL && Columns > 59) {
+        Print(L"%.*s", Columns - 59, Volume->PathText);
+      }
+      Print(L"\n");
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\n%d/%d  * current target. Up/Down/PgUp/PgDn select, Enter to use, ESC to keep\n",
+          Selected + 1, Count);
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
+      if (Volumes[Selected].ReadOnly) {
+        continue;
+      }
+      Status = UseExportVolume(Volumes[Selected].Handle);
+      break;
+    }
+    if (Key.UnicodeChar == CHAR_NULL) {
+      if (Key.ScanCode == SCAN_UP && Selected > 0) {
+        Selected--;
+      } else if (Key.ScanCode == SCAN_DOWN && Selected + 1 < Count) {
+        Selected++;
+      } else if (Key.ScanCode == SCAN_PAGE_UP) {
+        Selected = (Selected > Visible) ? (Selected - Visible) : 0;
+      } else if (Key.ScanCode == SCAN_PAGE_DOWN) {
+        Selected = (Selected + Visible < Count) ? (Selected + Visible) : (Count - 1);
+      } else if (Key.ScanCode == SCAN_HOME) {
+        Selected = 0;
+      } else if (Key.ScanCode == SCAN_END) {
+        Selected = Count - 1;
+      } else if (Key.ScanCode == SCAN_ESC) {
+        Status = (mVolumeRoot != NULL) ? EFI_SUCCESS : EFI_ABORTED;
+        break;
+      }
+    }
+  }
+
+  FreeExportVolumes(Volumes, Count);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  return Status;
+}
+
+/**
+  Return the root of the export volume, choosing one on first use: the
+  volume the image was loaded from if it is writable, else the only
+  writable volume, else whatever the user picks (the first writable one
+  when not interactive).
+**/
+STATIC
+EFI_STATUS
+OpenExportVolume (
+  IN  EFI_HANDLE         ImageHandle,
+  OUT EFI_FILE_PROTOCOL  **RootDir
+  )
+{
+  EFI_STATUS     Status;
+  EXPORT_VOLUME  *Volumes;
+  UINTN          Count;
+  UINTN          Writable = 0;
+  EFI_HANDLE     Choice = NULL;
+
+  if (mVolumeRoot != NULL) {
+    *RootDir = mVolumeRoot;
+    return EFI_SUCCESS;
+  }
+  if (mVolumeHandle != NULL && !EFI_ERROR(UseExportVolume(mVolumeHandle))) {
+    *RootDir = mVolumeRoot;
+    return EFI_SUCCESS;
+  }
+
+  Status = GetExportVolumes(ImageHandle, &Volumes, &Count);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  for (UINTN i = 0; i < Count; i++) {
+    if (Volumes[i].ReadOnly) {
+      continue;
+    }
+    if (Volumes[i].IsImageVolume) {
+      Choice   = Volumes[i].Handle;
+      Writable = 1;
+      break;
+    }
+    if (Writable++ == 0) {
+      Choice = Volumes[i].Handle;
+    }
+  }
+  FreeExportVolumes(Volumes, Count);
+
+  if (Writable == 0) {
+    return EFI_WRITE_PROTECTED;
+  }
+  Status = (Writable == 1 || !mInteractive) ? UseExportVolume(Choice) : SelectExportVolume();
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  *RootDir = mVolumeRoot;
+  return EFI_SUCCESS;
+}
+
+VOID
+FileHelperSetInteractive (
+  IN BOOLEAN  Interactive
+  )
+{
+  mInteractive = Interactive;
+}
+
+VOID
+FileHelperCloseVolume (
+  VOID
+  )
+{
+  if (mVolumeRoot != NULL) {
+    mVolumeRoot->Close(mVolumeRoot);
+    mVolumeRoot = NULL;
+  }
+}
+
+/**
+  Cut an open file down to zero bytes through EFI_FILE_INFO.
+
+  @retval EFI_SUCCESS  The file is empty.
+  @retval others       GetInfo or SetInfo failed.
+**/
+STATIC
+EFI_STATUS
+TruncateFile (
+  IN EFI_FILE_PROTOCOL  *File
+  )
+{
+  EFI_STATUS     Status;
+  EFI_FILE_INFO  *Info;
+  UINTN          InfoSize = 0;
+
+  Status = File->GetInfo(File, &gEfiFileInfoGuid, &InfoSize, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR(Status) ? Status : EFI_DEVICE_ERROR;
+  }
+
+  Info = AllocatePool(InfoSize);
+  if (Info == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = File->GetInfo(File, &gEfiFileInfoGuid, &InfoSize, Info);
+  if (!EFI_ERROR(Status) && Info->FileSize != 0) {
+    Info->FileSize = 0;
+    Status = File->SetInfo(File, &gEfiFileInfoGuid, InfoSize, Info);
+  }
+
+  FreePool(Info);
+  return Status;
+}
+
+/**
+  Create a file, or open an existing one and empty it, so a shorter dump
+  never leaves the tail of an older one behind. If the file system refuses
+  to shrink the file it is deleted and created again.
+**/
+STATIC
+EFI_STATUS
+CreateEmptyFile (
+  IN  EFI_FILE_PROTOCOL  *RootDir,
+  IN  CHAR16             *FileName,
+  OUT EFI_FILE_PROTOCOL  **File
+  )
+{
+  EFI_STATUS Status;
+
+  Status = RootDir->Open(
+                      RootDir,
+                      File,
+                      FileName,
+                      EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
+                      0
+                      );
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  if (!EFI_ERROR(TruncateFile(*File))) {
+    return EFI_SUCCESS;
+  }
+
+  // Delete closes the handle even when it fails
+  Status = (*File)->Delete(*File);
+  *File  = NULL;
+  if (Status != EFI_SUCCESS) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  return RootDir->Open(
+                    RootDir,
+                    File,
+                    FileName,
+                    EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
+                    0
+                    );
+}
 
-// TODO : Don't know why sometimes just can't save the file
-// Need to check why can't overwrite the exist file
 EFI_STATUS
 SaveBytesToFile (
   IN EFI_HANDLE  ImageHandle,
@@ -14,62 +460,265 @@ SaveBytesToFile (
   IN UINTN       BufferSize
   )
 {
-  EFI_STATUS                        Status;
-  EFI_LOADED_IMAGE_PROTOCOL        *LoadedImage;
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *SimpleFs;
-  EFI_FILE_PROTOCOL                *RootDir;
-  EFI_FILE_PROTOCOL                *FileHandle;
-  UINTN                             Size = BufferSize;
-
-  // 1) Get the Loaded Image Protocol for this image
-  Status = gBS->HandleProtocol (
-                  ImageHandle,
-                  &gEfiLoadedImageProtocolGuid,
-                  (VOID**)&LoadedImage
-                  );
+  EFI_STATUS  Status;
+  FILE_WRITER Writer;
+
+  Status = FileWriterOpen(ImageHandle, FileName, &Writer);
   if (EFI_ERROR(Status)) {
     return Status;
   }
 
-  // 2) Get the Simple File System Protocol from the device handle
-  Status = gBS->HandleProtocol (
-                  LoadedImage->DeviceHandle,
-                  &gEfiSimpleFileSystemProtocolGuid,
-                  (VOID**)&SimpleFs
-                  );
+  // With nothing staged, whole buffers of the dump go straight to the file
+  FileWriterAppend(&Writer, Buffer, BufferSize);
+  return FileWriterClose(&Writer);
+}
+
+/**
+  Write whatever is staged in the writer's buffer to the file.
+**/
+STATIC
+EFI_STATUS
+FileWriterFlush (
+  IN OUT FILE_WRITER  *Writer
+  )
+{
+  UINTN Size;
+
+  if (EFI_ERROR(Writer->Status) || Writer->Used == 0) {
+    return Writer->Status;
+  }
+
+  Size = Writer->Used;
+  if (Writer->Sink != NULL) {
+    Writer->Status = Writer->Sink(Writer->SinkContext, Writer->Buffer, Size);
+  } else {
+    Writer->Status = Writer->File->Write(Writer->File, &Size, Writer->Buffer);
+    if (!EFI_ERROR(Writer->Status) && Size != Writer->Used) {
+      Writer->Status = EFI_VOLUME_FULL;
+    }
+  }
+  Writer->Used = 0;
+  return Writer->Status;
+}
+
+EFI_STATUS
+FileWriterOpen (
+  IN  EFI_HANDLE   ImageHandle,
+  IN  CHAR16       *FileName,
+  OUT FILE_WRITER  *Writer
+  )
+{
+  EFI_STATUS Status;
+
+  ZeroMem(Writer, sizeof(*Writer));
+
+  Status = OpenExportVolume(ImageHandle, &Writer->RootDir);
   if (EFI_ERROR(Status)) {
     return Status;
   }
 
-  // 3) Open the volume (root directory)
-  Status = SimpleFs->OpenVolume(SimpleFs, &RootDir);
+  Status = CreateEmptyFile(Writer->RootDir, FileName, &Writer->File);
   if (EFI_ERROR(Status)) {
+    ZeroMem(Writer, sizeof(*Writer));
     return Status;
   }
 
-  // 4) Create or open the target file
-  Status = RootDir->Open(
-                     RootDir,
-                     &FileHandle,
-                     FileName,
-                     EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
-                     0
-                     );
+  return EFI_SUCCESS;
+}
+
+VOID
+FileWriterOpenSink (
+  IN  FILE_WRITER_SINK  Sink,
+  IN  VOID              *SinkContext,
+  OUT FILE_WRITER       *Writer
+  )
+{
+  ZeroMem(Writer, sizeof(*Writer));
+  Writer->Sink        = Sink;
+  Writer->SinkContext = SinkContext;
+}
+
+EFI_STATUS
+FileWriterAppend (
+  IN OUT FILE_WRITER  *Writer,
+  IN     CONST VOID   *Data,
+  IN     UINTN        Size
+  )
+{
+  CONST UINT8 *Bytes = (CONST UINT8 *)Data;
+
+  while (Size > 0 && !EFI_ERROR(Writer->Status)) {
+    UINTN Chunk;
+    UINTN Written;
+
+    if (Writer->Used == 0 && Size >= FILE_WRITER_BUFFER_SIZE) {
+      // Nothing staged and at least a full buffer to go: skip the copy
+      Chunk = Size - Size % FILE_WRITER_BUFFER_SIZE;
+      Written = Chunk;
+      if (Writer->Sink != NULL) {
+        Writer->Status = Writer->Sink(Writer->SinkContext, Bytes, Chunk);
+      } else {
+        Writer->Status = Writer->File->Write(Writer->File, &Written, (VOID *)Bytes);
+        if (!EFI_ERROR(Writer->Status) && Written != Chunk) {
+          Writer->Status = EFI_VOLUME_FULL;
+        }
+      }
+      Writer->BytesWritten += Written;
+      Bytes += Chunk;
+      Size  -= Chunk;
+      continue;
+    }
+
+    // The staging buffer is only needed once a small append shows up
+    if (Writer->Buffer == NULL) {
+      Writer->Buffer = AllocatePool(FILE_WRITER_BUFFER_SIZE);
+      if (Writer->Buffer == NULL) {
+        Writer->Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+    }
+
+    Chunk = FILE_WRITER_BUFFER_SIZE - Writer->Used;
+    if (Chunk > Size) {
+      Chunk = Size;
+    }
+    CopyMem(Writer->Buffer + Writer->Used, Bytes, Chunk);
+    Writer->Used         += Chunk;
+    Writer->BytesWritten += Chunk;
+    Bytes += Chunk;
+    Size  -= Chunk;
+
+    if (Writer->Used == FILE_WRITER_BUFFER_SIZE) {
+      FileWriterFlush(Writer);
+    }
+  }
+
+  return Writer->Status;
+}
+
+EFI_STATUS
+FileWriterClose (
+  IN OUT FILE_WRITER  *Writer
+  )
+{
+  EFI_STATUS Status;
+
+  FileWriterFlush(Writer);
+  Status = Writer->Status;
+
+  // The volume root belongs to the session and stays open
+  if (Writer->File != NULL) {
+    Writer->File->Close(Writer->File);
+  }
+  if (Writer->Buffer != NULL) {
+    FreePool(Writer->Buffer);
+  }
+  ZeroMem(Writer, sizeof(*Writer));
+  return Status;
+}
+
+/**
+  TRUE if Name exists on the export volume, as a file or a directory.
+**/
+STATIC
+BOOLEAN
+ExportNameExists (
+  IN EFI_FILE_PROTOCOL  *RootDir,
+  IN CHAR16             *Name
+  )
+{
+  EFI_FILE_PROTOCOL *File;
+
+  if (EFI_ERROR(RootDir->Open(RootDir, &File, Name, EFI_FILE_MODE_READ, 0))) {
+    return FALSE;
+  }
+  File->Close(File);
+  return TRUE;
+}
+
+EFI_STATUS
+MakeExportFileName (
+  IN  EFI_HANDLE    ImageHandle,
+  IN  CONST CHAR16  *Stem,
+  IN  CONST CHAR16  *Extension  OPTIONAL,
+  OUT CHAR16        *FileName,
+  IN  UINTN         FileNameSize
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *RootDir;
+  CHAR16             Clean[64];
+  UINTN              Length = 0;
+
+  Status = OpenExportVolume(ImageHandle, &RootDir);
   if (EFI_ERROR(Status)) {
-    RootDir->Close(RootDir);
     return Status;
   }
 
-  // 5) Write the buffer to the file
-  Status = FileHandle->Write(FileHandle, &Size, Buffer);
+  // Keep the stem to characters every FAT driver accepts
+  for (CONST CHAR16 *c = Stem; *c != L'\0' && Length < ARRAY_SIZE(Clean) - 1; c++) {
+    BOOLEAN Plain = (BOOLEAN)((*c >= L'0' && *c <= L'9') || (*c >= L'A' && *c <= L'Z') ||
+                              (*c >= L'a' && *c <= L'z') || *c == L'_' || *c == L'-');
+    Clean[Length++] = Plain ? *c : L'_';
+  }
+  Clean[Length] = L'\0';
+
+  for (UINTN Number = 0; Number <= EXPORT_NUMBER_MAX; Number++) {
+    if (Extension != NULL) {
+      UnicodeSPrint(FileName, FileNameSize, L"%s_%03d.%s", Clean, Number, Extension);
+    } else {
+      UnicodeSPrint(FileName, FileNameSize, L"%s_%03d", Clean, Number);
+    }
+    if (!ExportNameExists(RootDir, FileName)) {
+      return EFI_SUCCESS;
+    }
+  }
+  return EFI_ALREADY_STARTED;
+}
+
+EFI_STATUS
+MakeExportDirectory (
+  IN  EFI_HANDLE    ImageHandle,
+  IN  CONST CHAR16  *Stem,
+  OUT CHAR16        *DirName,
+  IN  UINTN         DirNameSize
+  )
+{
+  EFI_STATUS         Status;
+  EFI_FILE_PROTOCOL  *Dir;
+
+  Status = MakeExportFileName(ImageHandle, Stem, NULL, DirName, DirNameSize);
   if (EFI_ERROR(Status)) {
-    FileHandle->Close(FileHandle);
-    RootDir->Close(RootDir);
     return Status;
   }
 
-  // 6) Close file and directory handles
-  FileHandle->Close(FileHandle);
-  RootDir->Close(RootDir);
+  Status = mVolumeRoot->Open(
+                          mVolumeRoot,
+                          &Dir,
+                          DirName,
+                          EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
+                          EFI_FILE_DIRECTORY
+                          );
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  Dir->Close(Dir);
   return EFI_SUCCESS;
 }
+
+VOID
+MakeTimestampStem (
+  IN  CONST CHAR16  *Prefix,
+  OUT CHAR16        *Stem,
+  IN  UINTN         StemSize
+  )
+{
+  EFI_TIME Time;
+
+  if (EFI_ERROR(gRT->GetTime(&Time, NULL))) {
+    UnicodeSPrint(Stem, StemSize, L"%s", Prefix);
+    return;
+  }
+  UnicodeSPrint(Stem, StemSize, L"%s_%04d%02d%02d_%02d%02d%02d", Prefix,
+                Time.Year, Time.Month, Time.Day, Time.Hour, Time.Minute, Time.Second);
+}
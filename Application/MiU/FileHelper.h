@@ -6,7 +6,8 @@
 #include <Protocol/SimpleFileSystem.h>
 
 /**
-  Save a buffer of bytes to a file on the first available simple file system.
+  Save a buffer of bytes to a file on the export volume (see
+  SelectExportVolume()). An existing file is truncated first.
 
   @param[in]  ImageHandle  The EFI image handle.
   @param[in]  FileName     A UTF-16 string (e.g. L"dump.bin").
@@ -24,4 +25,186 @@ SaveBytesToFile (
   IN UINTN       BufferSize
   );
 
+//
+// Size of the staging buffer used by FILE_WRITER. Small appends are copied
+// here and only reach the file system when it fills up or the writer is
+// closed; the buffer is allocated on the first such append.
+//
+#define FILE_WRITER_BUFFER_SIZE  SIZE_64KB
+
+/**
+  Receives the bytes of a writer opened with FileWriterOpenSink() instead of
+  a file, in the chunks the writer flushes.
+**/
+typedef
+EFI_STATUS
+(*FILE_WRITER_SINK) (
+  IN VOID         *Context,
+  IN CONST UINT8  *Data,
+  IN UINTN        Size
+  );
+
+/**
+  Buffered, append-only file writer used by the exporters.
+  Open it with FileWriterOpen(), stream data with FileWriterAppend() and
+  finish with FileWriterClose(). A writer opened with FileWriterOpenSink()
+  hands its output to a callback instead, so the same exporter code can
+  feed a snapshot section.
+**/
+typedef struct {
+  EFI_FILE_PROTOCOL  *RootDir;      // Session volume root, not owned by the writer
+  EFI_FILE_PROTOCOL  *File;
+  FILE_WRITER_SINK   Sink;          // Set instead of File for sink writers
+  VOID               *SinkContext;
+  UINT8              *Buffer;
+  UINTN              Used;          // Bytes currently staged in Buffer
+  UINT64             BytesWritten;  // Total bytes appended so far
+  EFI_STATUS         Status;        // First error hit; later appends are dropped
+} FILE_WRITER;
+
+/**
+  Create a file on the export volume, or truncate it if it exists, and
+  prepare a buffered writer for it. The volume is chosen and opened on the
+  first call and kept open for the session.
+
+  @param[in]   ImageHandle  The EFI image handle.
+  @param[in]   FileName     A UTF-16 string (e.g. L"dump.bin").
+  @param[out]  Writer       The writer to initialize.
+
+  @retval EFI_SUCCESS           The writer is ready.
+  @retval EFI_OUT_OF_RESOURCES  The staging buffer could not be allocated.
+  @retval others                The volume or file could not be opened.
+**/
+EFI_STATUS
+FileWriterOpen (
+  IN  EFI_HANDLE   ImageHandle,
+  IN  CHAR16       *FileName,
+  OUT FILE_WRITER  *Writer
+  );
+
+/**
+  Prepare a buffered writer whose output goes to Sink instead of a file.
+
+  @param[in]   Sink         Callback that receives the flushed bytes.
+  @param[in]   SinkContext  Passed to Sink unchanged.
+  @param[out]  Writer       The writer to initialize.
+**/
+VOID
+FileWriterOpenSink (
+  IN  FILE_WRITER_SINK  Sink,
+  IN  VOID              *SinkContext,
+  OUT FILE_WRITER       *Writer
+  );
+
+/**
+  Append bytes to the file through the staging buffer.
+
+  @param[in,out]  Writer  An open writer.
+  @param[in]      Data    Bytes to append.
+  @param[in]      Size    Number of bytes to append.
+
+  @retval EFI_SUCCESS  The bytes were staged or written.
+  @retval others       The first error the writer encountered.
+**/
+EFI_STATUS
+FileWriterAppend (
+  IN OUT FILE_WRITER  *Writer,
+  IN     CONST VOID   *Data,
+  IN     UINTN        Size
+  );
+
+/**
+  Flush any staged bytes and close the file handle.
+
+  @param[in,out]  Writer  The writer to close. Safe to call after errors.
+
+  @retval EFI_SUCCESS  Everything appended reached the file.
+  @retval others       The first error the writer encountered.
+**/
+EFI_STATUS
+FileWriterClose (
+  IN OUT FILE_WRITER  *Writer
+  );
+
+/**
+  Close the volume root kept open by FileWriterOpen() and SaveBytesToFile().
+  Called once when the application exits.
+**/
+VOID
+FileHelperCloseVolume (
+  VOID
+  );
+
+/**
+  Allow or forbid prompting for the export volume. Without prompts the
+  first export takes the boot volume if it is writable, else the first
+  writable volume found.
+**/
+VOID
+FileHelperSetInteractive (
+  IN BOOLEAN  Interactive
+  );
+
+/**
+  Let the user pick the export volume from every file system in the system
+  (read-only ones are shown but cannot be chosen). The choice holds for the
+  rest of the session. Without a choice, the first export uses the volume
+  MiU was loaded from if it is writable, or the only writable volume, and
+  asks only when that is ambiguous.
+
+  @retval EFI_SUCCESS    A volume is selected.
+  @retval EFI_ABORTED    The user left without choosing and none was set.
+  @retval EFI_NOT_FOUND  There is no file system.
+**/
+EFI_STATUS
+SelectExportVolume (
+  VOID
+  );
+
+/**
+  Build a file name that does not exist yet on the export volume:
+  <Stem>_000.<Extension>, <Stem>_001.<Extension> and so on. Characters
+  other than letters, digits, '_' and '-' in Stem become '_'.
+
+  @param[in]   ImageHandle   The EFI image handle.
+  @param[in]   Stem          Base name, e.g. from a BDF or variable name.
+  @param[in]   Extension     Extension without the dot, or NULL for none.
+  @param[out]  FileName      Receives the name.
+  @param[in]   FileNameSize  Size of FileName in bytes.
+
+  @retval EFI_SUCCESS          FileName is free.
+  @retval EFI_ALREADY_STARTED  Every number up to 9999 is taken.
+  @retval others               The export volume could not be opened.
+**/
+EFI_STATUS
+MakeExportFileName (
+  IN  EFI_HANDLE    ImageHandle,
+  IN  CONST CHAR16  *Stem,
+  IN  CONST CHAR16  *Extension  OPTIONAL,
+  OUT CHAR16        *FileName,
+  IN  UINTN         FileNameSize
+  );
+
+/**
+  Create a new numbered directory <Stem>_NNN in the root of the export
+  volume, for exports that write a set of files.
+**/
+EFI_STATUS
+MakeExportDirectory (
+  IN  EFI_HANDLE    ImageHandle,
+  IN  CONST CHAR16  *Stem,
+  OUT CHAR16        *DirName,
+  IN  UINTN         DirNameSize
+  );
+
+/**
+  <Prefix>_YYYYMMDD_hhmmss from the RTC, or just Prefix without a clock.
+**/
+VOID
+MakeTimestampStem (
+  IN  CONST CHAR16  *Prefix,
+  OUT CHAR16        *Stem,
+  IN  UINTN         StemSize
+  );
+
 #endif // FILE_HELPER_H_
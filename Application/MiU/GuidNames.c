@@ -0,0 +1,162 @@
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include "GuidNames.h"
+
+typedef struct {
+  EFI_GUID        Guid;
+  CONST CHAR16    *Name;
+} GUID_NAME_ENTRY;
+
+//
+// Embedded dictionary of well-known GUIDs.
+// Values are spelled out here (like ACPI_20_TABLE_GUID in ACPI.c) so the
+// module does not need a [Guids] entry for every name it can print.
+//
+STATIC CONST GUID_NAME_ENTRY mGuidNameTable[] = {
+  //
+  // UEFI variable namespaces
+  //
+  { { 0x8BE4DF61, 0x93CA, 0x11D2, { 0xAA, 0x0D, 0x00, 0xE0, 0x98, 0x03, 0x2B, 0x8C } }, L"EfiGlobalVariable" },
+  { { 0xD719B2CB, 0x3D3A, 0x4596, { 0xA3, 0xBC, 0xDA, 0xD0, 0x0E, 0x67, 0x65, 0x6F } }, L"ImageSecurityDatabase" },
+  { { 0x414E6BDD, 0xE47B, 0x47CC, { 0xB2, 0x44, 0xBB, 0x61, 0x02, 0x0C, 0xF5, 0x16 } }, L"HardwareErrorVariable" },
+  { { 0xE20939BE, 0x32D4, 0x41BE, { 0xA1, 0x50, 0x89, 0x7F, 0x85, 0xD4, 0x98, 0x29 } }, L"MemoryOverwriteControl" },
+  { { 0xBB983CCF, 0x151D, 0x40E1, { 0xA0, 0x7B, 0x4A, 0x17, 0xBE, 0x16, 0x82, 0x92 } }, L"MemoryOverwriteControlLock" },
+  { { 0x39B68C46, 0xF7FB, 0x441B, { 0xB6, 0xEC, 0x16, 0xB0, 0xF6, 0x98, 0x21, 0xF3 } }, L"CapsuleReport" },
+  { { 0x158DEF5A, 0xF656, 0x419C, { 0xB0, 0x27, 0x7A, 0x31, 0x92, 0xC0, 0x79, 0xD2 } }, L"ShellVariable" },
+  { { 0xEB704011, 0x1402, 0x11D3, { 0x8E, 0x77, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B } }, L"MonotonicCounter" },
+  { { 0x4C19049F, 0x4137, 0x4DD3, { 0x9C, 0x10, 0x8B, 0x97, 0xA8, 0x3F, 0xFD, 0xFA } }, L"MemoryTypeInformation" },
+  { { 0xC095791A, 0x3001, 0x47B2, { 0x80, 0xC9, 0xEA, 0xC7, 0x31, 0x9F, 0x2F, 0xA4 } }, L"FirmwarePerformance" },
+  { { 0x04B37FE8, 0xF6AE, 0x480B, { 0xBD, 0xD5, 0x37, 0xD9, 0x8C, 0x5E, 0x89, 0xAA } }, L"VarErrorFlag" },
+  { { 0x5B446ED1, 0xE30B, 0x4FAA, { 0x87, 0x1A, 0x36, 0x54, 0xEC, 0xA3, 0x60, 0x80 } }, L"Ip4Config2" },
+  { { 0x937FE521, 0x95AE, 0x4D1A, { 0x89, 0x29, 0x48, 0xBC, 0xD9, 0x0A, 0xD3, 0x1A } }, L"Ip6Config" },
+  { { 0xAEB9C5C1, 0x94F1, 0x4D02, { 0xBF, 0xD9, 0x46, 0x02, 0xDB, 0x2D, 0x3C, 0x54 } }, L"Tcg2PhysicalPresence" },
+  //
+  // edk2 Secure Boot configuration
+  //
+  { { 0xF0A30BC7, 0xAF08, 0x4556, { 0x99, 0xC4, 0x00, 0x10, 0x09, 0xC9, 0x3A, 0x44 } }, L"SecureBootEnableDisable" },
+  { { 0xC076EC0C, 0x7028, 0x4399, { 0xA0, 0x72, 0x71, 0xEE, 0x5C, 0x44, 0x8B, 0x9F } }, L"CustomModeEnable" },
+  { { 0x9073E4E0, 0x60EC, 0x4B6E, { 0x99, 0x03, 0x4C, 0x22, 0x3C, 0x26, 0x0F, 0x3C } }, L"VendorKeysNv" },
+  { { 0xD9BEE56E, 0x75DC, 0x49D9, { 0xB4, 0xD7, 0xB5, 0x34, 0x21, 0x0F, 0x63, 0x7A } }, L"CertDb" },
+  //
+  // Signature types and owners
+  //
+  { { 0xC1C41626, 0x504C, 0x4092, { 0xAC, 0xA9, 0x41, 0xF9, 0x36, 0x93, 0x43, 0x28 } }, L"CertSha256" },
+  { { 0x826CA512, 0xCF10, 0x4AC9, { 0xB1, 0x87, 0xBE, 0x01, 0x49, 0x66, 0x31, 0xBD } }, L"CertSha1" },
+  { { 0xFF3E5307, 0x9FD0, 0x48C9, { 0x85, 0xF1, 0x8A, 0xD5, 0x6C, 0x70, 0x1E, 0x01 } }, L"CertSha384" },
+  { { 0x093E0FAE, 0xA6C4, 0x4F50, { 0x9F, 0x1B, 0xD4, 0x1E, 0x2B, 0x89, 0xC1, 0x9A } }, L"CertSha512" },
+  { { 0x3C5766E8, 0x269C, 0x4E34, { 0xAA, 0x14, 0xED, 0x77, 0x6E, 0x85, 0xB3, 0xB6 } }, L"CertRsa2048" },
+  { { 0xA5C059A1, 0x94E4, 0x4AA7, { 0x87, 0xB5, 0xAB, 0x15, 0x5C, 0x2B, 0xF0, 0x72 } }, L"CertX509" },
+  { { 0x3BD2A492, 0x96C0, 0x4079, { 0xB4, 0x20, 0xFC, 0xF9, 0x8E, 0xF1, 0x03, 0xED } }, L"CertX509Sha256" },
+  { { 0x4AAFD29D, 0x68DF, 0x49EE, { 0x8A, 0xA9, 0x34, 0x7D, 0x37, 0x56, 0x65, 0xA7 } }, L"CertPkcs7" },
+  { { 0xE2B36190, 0x879B, 0x4A3D, { 0xAD, 0x8D, 0xF2, 0xE7, 0xBB, 0xA3, 0x27, 0x84 } }, L"CertRsa2048Sha256" },
+  // WIN_CERTIFICATE_UEFI_GUID CertType, not a signature type
+  { { 0xA7717414, 0xC616, 0x4977, { 0x94, 0x20, 0x84, 0x47, 0x12, 0xA7, 0x35, 0xBF } }, L"CertTypeRsa2048Sha256" },
+  { { 0x77FA9ABD, 0x0359, 0x4D32, { 0xBD, 0x60, 0x28, 0xF4, 0xE7, 0x8F, 0x78, 0x4B } }, L"MicrosoftOwner" },
+  //
+  // OS loader / vendor namespaces
+  //
+  { { 0x605DAB50, 0xE046, 0x4300, { 0xAB, 0xB6, 0x3D, 0xD8, 0x10, 0xDD, 0x8B, 0x23 } }, L"ShimLock" },
+  { { 0x4A67B082, 0x0A4C, 0x41CF, { 0xB6, 0xC7, 0x44, 0x0B, 0x29, 0xBB, 0x8C, 0x4F } }, L"SystemdLoader" },
+  { { 0x1CE1E5BC, 0x7CEB, 0x42F2, { 0x81, 0xE5, 0x8A, 0xAD, 0xF1, 0x80, 0xF5, 0x7B } }, L"LinuxRandomSeed" },
+  { { 0xB7799CB0, 0xECA2, 0x4943, { 0x96, 0x67, 0x1F, 0xAE, 0x07, 0xB7, 0x47, 0xFA } }, L"LinuxTpmEventLog" },
+  //
+  // edk2 variable store formats
+  //
+  { { 0xDDCF3616, 0x3275, 0x4164, { 0x98, 0xB6, 0xFE, 0x85, 0x70, 0x7F, 0xFE, 0x7D } }, L"VariableStore" },
+  { { 0xAAF32C78, 0x947B, 0x439A, { 0xA1, 0x80, 0x2E, 0x14, 0x4E, 0xC3, 0x77, 0x92 } }, L"AuthenticatedVariableStore" },
+  { { 0xFFF12B8D, 0x7696, 0x4C8B, { 0xA9, 0x85, 0x27, 0x47, 0x07, 0x5B, 0x4F, 0x50 } }, L"SystemNvDataFv" },
+  //
+  // Configuration tables
+  //
+  { { 0x8868E871, 0xE4F1, 0x11D3, { 0xBC, 0x22, 0x00, 0x80, 0xC7, 0x3C, 0x88, 0x81 } }, L"ACPI 2.0 RSDP" },
+  { { 0xEB9D2D30, 0x2D88, 0x11D3, { 0x9A, 0x16, 0x00, 0x90, 0x27, 0x3F, 0xC1, 0x4D } }, L"ACPI 1.0 RSDP" },
+  { { 0xEB9D2D31, 0x2D88, 0x11D3, { 0x9A, 0x16, 0x00, 0x90, 0x27, 0x3F, 0xC1, 0x4D } }, L"SMBIOS Entry Point" },
+  { { 0xF2FD1544, 0x9794, 0x4A2C, { 0x99, 0x2E, 0xE5, 0xBB, 0xCF, 0x20, 0xE3, 0x94 } }, L"SMBIOS3 Entry Point" },
+  { { 0xEB9D2D2F, 0x2D88, 0x11D3, { 0x9A, 0x16, 0x00, 0x90, 0x27, 0x3F, 0xC1, 0x4D } }, L"MPS Table" },
+  { { 0xEB9D2D32, 0x2D88, 0x11D3, { 0x9A, 0x16, 0x00, 0x90, 0x27, 0x3F, 0xC1, 0x4D } }, L"SAL System Table" },
+  { { 0xB122A263, 0x3661, 0x4F68, { 0x99, 0x29, 0x78, 0xF8, 0xB0, 0xD6, 0x21, 0x80 } }, L"ESRT" },
+  { { 0xDCFA911D, 0x26EB, 0x469F, { 0xA2, 0x20, 0x38, 0xB7, 0xDC, 0x46, 0x12, 0x20 } }, L"Memory Attributes Table" },
+  { { 0x880AACA3, 0x4ADC, 0x4A04, { 0x90, 0x79, 0xB7, 0x47, 0x34, 0x08, 0x25, 0xE5 } }, L"Properties Table" },
+  { { 0xEB66918A, 0x7EEF, 0x402A, { 0x84, 0x2E, 0x93, 0x1D, 0x21, 0xC3, 0x8A, 0xE9 } }, L"RT Properties Table" },
+  { { 0x05AD34BA, 0x6F02, 0x4214, { 0x95, 0x2E, 0x4D, 0xA0, 0x39, 0x8E, 0x2B, 0xB9 } }, L"DXE Services Table" },
+  { { 0x7739F24C, 0x93D7, 0x11D4, { 0x9A, 0x3A, 0x00, 0x90, 0x27, 0x3F, 0xC1, 0x4D } }, L"HOB List" },
+  { { 0x49152E77, 0x1ADA, 0x4764, { 0xB7, 0xA2, 0x7A, 0xFE, 0xFE, 0xD9, 0x5E, 0x8B } }, L"Debug Image Info Table" },
+  { { 0xEE4E5898, 0x3914, 0x4259, { 0x9D, 0x6E, 0xDC, 0x7B, 0xD7, 0x94, 0x03, 0xCF } }, L"LZMA Custom Decompress" },
+  { { 0x1E2ED096, 0x30E2, 0x4254, { 0xBD, 0x89, 0x86, 0x3B, 0xBE, 0xF8, 0x23, 0x25 } }, L"TCG2 Final Events Table" },
+  { { 0x4E28CA50, 0xD582, 0x44AC, { 0xA1, 0x1F, 0xE3, 0xD5, 0x65, 0x26, 0xDB, 0x34 } }, L"SMM Communication Region" },
+  { { 0xB1B621D5, 0xF19C, 0x41A5, { 0x83, 0x0B, 0xD9, 0x15, 0x2C, 0x69, 0xAA, 0xE0 } }, L"Device Tree" },
+};
+
+//
+// Open-addressing hash over mGuidNameTable. Slots hold (table index + 1),
+// zero marks an empty slot. Must be a power of two and comfortably larger
+// than the table so probe chains stay short.
+//
+#define GUID_HASH_SLOTS  256
+
+STATIC UINT16   mGuidHash[GUID_HASH_SLOTS];
+STATIC BOOLEAN  mGuidHashReady = FALSE;
+
+/**
+  Fold the 128-bit GUID into a slot number.
+**/
+STATIC
+UINTN
+HashGuid (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  CONST UINT32  *Words = (CONST UINT32 *)Guid;
+  UINT32        Hash;
+
+  // Callers pass GUIDs straight out of FPDT records and signature lists
+  Hash  = ReadUnaligned32(&Words[0]) ^ ReadUnaligned32(&Words[1]) ^
+          ReadUnaligned32(&Words[2]) ^ ReadUnaligned32(&Words[3]);
+  Hash ^= Hash >> 16;
+  Hash *= 0x45D9F3B;
+  Hash ^= Hash >> 16;
+  return Hash & (GUID_HASH_SLOTS - 1);
+}
+
+/**
+  Populate mGuidHash from mGuidNameTable. Runs once per application run.
+**/
+STATIC
+VOID
+BuildGuidHash (
+  VOID
+  )
+{
+  for (UINTN Index = 0; Index < ARRAY_SIZE (mGuidNameTable); Index++) {
+    UINTN Slot = HashGuid (&mGuidNameTable[Index].Guid);
+    while (mGuidHash[Slot] != 0) {
+      Slot = (Slot + 1) & (GUID_HASH_SLOTS - 1);
+    }
+    mGuidHash[Slot] = (UINT16)(Index + 1);
+  }
+  mGuidHashReady = TRUE;
+}
+
+CONST CHAR16 *
+GetGuidName (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN Slot;
+
+  if (Guid == NULL) {
+    return NULL;
+  }
+  if (!mGuidHashReady) {
+    BuildGuidHash ();
+  }
+
+  for (Slot = HashGuid (Guid); mGuidHash[Slot] != 0; Slot = (Slot + 1) & (GUID_HASH_SLOTS - 1)) {
+    CONST GUID_NAME_ENTRY *Entry = &mGuidNameTable[mGuidHash[Slot] - 1];
+    if (CompareGuid (&Entry->Guid, Guid)) {
+      return Entry->Name;
+    }
+  }
+  return NULL;
+}
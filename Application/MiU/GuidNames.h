@@ -0,0 +1,21 @@
+#ifndef GUID_NAMES_H_
+#define GUID_NAMES_H_
+
+#include <Uefi.h>
+
+/**
+  Look up the friendly name of a well-known GUID.
+
+  The dictionary is hashed on first use, so each lookup is O(1) and cheap
+  enough to call for every row of a list redraw.
+
+  @param[in]  Guid   The GUID to resolve.
+
+  @return A pointer to a static name string, or NULL if the GUID is unknown.
+**/
+CONST CHAR16 *
+GetGuidName (
+  IN CONST EFI_GUID  *Guid
+  );
+
+#endif // GUID_NAMES_H_
@@ -121,19 +121,25 @@ ShowIoSpace(
 
         // Check if the key is ctrl+S (0x13)
         if (Key.UnicodeChar == 0x13) {
-            // Save the config space to a file
-            Status = SaveBytesToFile(
-            gImageHandle,
-            L"io_config_dump.bin",
-            IoValues,
-            IO_TOTAL_BYTES
-            );
+            // Save the I/O space to a file named after the capture time
+            CHAR16 Stem[48];
+            CHAR16 FileName[64];
+            MakeTimestampStem(L"io", Stem, sizeof(Stem));
+            Status = MakeExportFileName(gImageHandle, Stem, L"bin", FileName, sizeof(FileName));
+            if (!EFI_ERROR(Status)) {
+                Status = SaveBytesToFile(
+                gImageHandle,
+                FileName,
+                IoValues,
+                IO_TOTAL_BYTES
+                );
+            }
             // Print the result
             gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
             if (EFI_ERROR(Status)) {
                 Print(L"\nSave failed: %r\n", Status);
             } else {
-                Print(L"\nSaved to io_config_dump.bin\n");
+                Print(L"\nSaved to %s\n", FileName);
             }
             // Wait for a key before continuing
             gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
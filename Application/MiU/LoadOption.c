@@ -0,0 +1,750 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Library/DevicePathLib.h>
+#include <Guid/GlobalVariable.h>
+#include "LoadOption.h"
+#include "SnapshotFormat.h"
+
+//
+// EFI_LOAD_OPTION layout: Attributes (UINT32), FilePathListLength (UINT16),
+// a NUL-terminated Description, FilePathListLength bytes of device paths and
+// whatever is left as OptionalData.
+//
+#define LOAD_OPTION_FIXED_SIZE  (sizeof (UINT32) + sizeof (UINT16))
+#define LOAD_OPTION_NAME_CHARS  64
+
+//
+// Sort and lookup key: type in the high word, option number in the low word
+//
+#define LOAD_OPTION_KEY(Type, Number)  (((UINT32)(Type) << 16) | (Number))
+
+STATIC CONST CHAR16 *mLoadOptionPrefix[LoadOptionTypeMax] = {
+  L"Boot", L"Driver", L"SysPrep", L"PlatformRecovery"
+};
+
+// PlatformRecovery#### options are tried in numeric order, there is no order variable
+STATIC CONST CHAR16 *mLoadOptionOrderName[LoadOptionTypeMax] = {
+  L"BootOrder", L"DriverOrder", L"SysPrepOrder", NULL
+};
+
+STATIC LOAD_OPTION_ENTRY  *mLoadOptions       = NULL;
+STATIC UINTN              mLoadOptionCount    = 0;
+STATIC UINTN              mLoadOptionCapacity = 0;
+STATIC UINT16             *mOrder[LoadOptionTypeMax];
+STATIC UINTN              mOrderCount[LoadOptionTypeMax];
+STATIC UINTN              mMissingCount[LoadOptionTypeMax];
+
+CONST CHAR16 *
+LoadOptionTypeName(
+  IN LOAD_OPTION_TYPE  Type
+  )
+{
+  return (Type < LoadOptionTypeMax) ? mLoadOptionPrefix[Type] : L"?";
+}
+
+/**
+  Splits a variable name into a load option type and number. Only
+  <Prefix>#### with exactly four uppercase hex digits qualifies, so BootOrder,
+  BootNext and BootCurrent never match.
+**/
+STATIC
+BOOLEAN
+ParseLoadOptionName(
+  IN  CONST CHAR16      *Name,
+  OUT LOAD_OPTION_TYPE  *Type,
+  OUT UINT16            *Number
+  )
+{
+  UINTN   PrefixLength;
+  UINT16  Value;
+
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    PrefixLength = StrLen(mLoadOptionPrefix[t]);
+    if (StrnCmp(Name, mLoadOptionPrefix[t], PrefixLength) != 0 || StrLen(Name) != PrefixLength + 4) {
+      continue;
+    }
+
+    Value = 0;
+    for (UINTN i = PrefixLength; i < PrefixLength + 4; i++) {
+      if (Name[i] >= L'0' && Name[i] <= L'9') {
+        Value = (UINT16)((Value << 4) | (Name[i] - L'0'));
+      } else if (Name[i] >= L'A' && Name[i] <= L'F') {
+        Value = (UINT16)((Value << 4) | (Name[i] - L'A' + 10));
+      } else {
+        return FALSE;
+      }
+    }
+    *Type   = (LOAD_OPTION_TYPE)t;
+    *Number = Value;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+  Walks the file path list of a load option. With Nodes NULL only counts the
+  nodes; otherwise fills them in and converts each one to text.
+
+  @param[in,out] Entry   Option whose FilePathList and FilePathListLength are set.
+  @param[out]    Nodes   Array of at least the counted size, or NULL.
+
+  @return Number of device path nodes, end nodes excluded.
+**/
+STATIC
+UINTN
+WalkLoadOptionPath(
+  IN OUT LOAD_OPTION_ENTRY  *Entry,
+  OUT    LOAD_OPTION_NODE   *Nodes  OPTIONAL
+  )
+{
+  UINT8   *Ptr = (UINT8 *)Entry->FilePathList;
+  UINTN   Remaining = Entry->FilePathListLength;
+  UINTN   Count = 0;
+  UINTN   Length;
+  UINT16  Instance = 0;
+
+  Entry->PathTruncated = TRUE;
+  while (Remaining >= sizeof(EFI_DEVICE_PATH_PROTOCOL)) {
+    Length = DevicePathNodeLength(Ptr);
+    if (Length < sizeof(EFI_DEVICE_PATH_PROTOCOL) || Length > Remaining) {
+      break;
+    }
+
+    if (IsDevicePathEndType(Ptr)) {
+      // End of this instance; the list may carry further paths behind it
+      Instance++;
+      Ptr += Length;
+      Remaining -= Length;
+      if (Remaining == 0) {
+        Entry->PathTruncated = FALSE;
+      }
+      continue;
+    }
+
+    if (Nodes != NULL) {
+      Nodes[Count].Type     = DevicePathType(Ptr);
+      Nodes[Count].SubType  = DevicePathSubType(Ptr);
+      Nodes[Count].Length   = (UINT16)Length;
+      Nodes[Count].Instance = Instance;
+      Nodes[Count].Text     = ConvertDeviceNodeToText((EFI_DEVICE_PATH_PROTOCOL *)Ptr, FALSE, TRUE);
+    }
+    Count++;
+    Ptr += Length;
+    Remaining -= Length;
+  }
+
+  Entry->InstanceCount = Instance;
+  return Count;
+}
+
+/**
+  Splits the raw EFI_LOAD_OPTION of an entry into its fields and converts the
+  device paths to text once, so the views never repeat the conversion.
+
+  @param[in,out] Entry   Option with Data and DataSize filled in.
+**/
+STATIC
+VOID
+DecodeLoadOption(
+  IN OUT LOAD_OPTION_ENTRY  *Entry
+  )
+{
+  CHAR16  *Desc;
+  UINTN   MaxChars;
+  UINTN   Chars;
+  UINTN   Offset;
+
+  Entry->Valid = FALSE;
+  if (Entry->DataSize < LOAD_OPTION_FIXED_SIZE + sizeof(CHAR16)) {
+    StrCpyS(Entry->Description, ARRAY_SIZE(Entry->Description), L"<too short>");
+    return;
+  }
+
+  Entry->LoadAttributes     = ReadUnaligned32((CONST UINT32 *)Entry->Data);
+  Entry->FilePathListLength = ReadUnaligned16((CONST UINT16 *)(Entry->Data + sizeof(UINT32)));
+
+  // The description must be terminated inside the variable
+  Desc     = (CHAR16 *)(Entry->Data + LOAD_OPTION_FIXED_SIZE);
+  MaxChars = (Entry->DataSize - LOAD_OPTION_FIXED_SIZE) / sizeof(CHAR16);
+  for (Chars = 0; Chars < MaxChars && Desc[Chars] != L'\0'; Chars++);
+  if (Chars == MaxChars) {
+    StrCpyS(Entry->Description, ARRAY_SIZE(Entry->Description), L"<unterminated description>");
+    return;
+  }
+  StrnCpyS(Entry->Description, ARRAY_SIZE(Entry->Description), Desc,
+           MIN(Chars, ARRAY_SIZE(Entry->Description) - 1));
+
+  Offset = LOAD_OPTION_FIXED_SIZE + (Chars + 1) * sizeof(CHAR16);
+  if (Entry->FilePathListLength > Entry->DataSize - Offset) {
+    return;
+  }
+
+  Entry->FilePathList     = (EFI_DEVICE_PATH_PROTOCOL *)(Entry->Data + Offset);
+  Entry->OptionalData     = Entry->Data + Offset + Entry->FilePathListLength;
+  Entry->OptionalDataSize = Entry->DataSize - Offset - Entry->FilePathListLength;
+  Entry->Valid            = TRUE;
+
+  Entry->NodeCount = WalkLoadOptionPath(Entry, NULL);
+  if (Entry->NodeCount > 0) {
+    Entry->Nodes = AllocateZeroPool(Entry->NodeCount * sizeof(LOAD_OPTION_NODE));
+    if (Entry->Nodes == NULL) {
+      Entry->NodeCount = 0;
+    } else {
+      WalkLoadOptionPath(Entry, Entry->Nodes);
+    }
+  }
+
+  // The conversion stops at the first end-entire node, i.e. the primary boot path
+  if (!Entry->PathTruncated) {
+    Entry->PathText = ConvertDevicePathToText(Entry->FilePathList, FALSE, TRUE);
+  }
+}
+
+/**
+  Releases the variable data and the cached text of one option.
+**/
+STATIC
+VOID
+FreeLoadOption(
+  IN OUT LOAD_OPTION_ENTRY  *Entry
+  )
+{
+  for (UINTN i = 0; i < Entry->NodeCount; i++) {
+    if (Entry->Nodes[i].Text != NULL) {
+      FreePool(Entry->Nodes[i].Text);
+    }
+  }
+  if (Entry->Nodes != NULL) {
+    FreePool(Entry->Nodes);
+  }
+  if (Entry->PathText != NULL) {
+    FreePool(Entry->PathText);
+  }
+  if (Entry->Data != NULL) {
+    FreePool(Entry->Data);
+  }
+  ZeroMem(Entry, sizeof(*Entry));
+}
+
+/**
+  Reads a global variable of unknown size into a new buffer, from Arena if
+  there is one, else from pool.
+
+  @return The buffer, or NULL if the variable is absent or unreadable.
+**/
+STATIC
+VOID *
+ReadGlobalVariable(
+  IN OUT MIU_ARENA     *Arena       OPTIONAL,
+  IN     CONST CHAR16  *Name,
+  OUT    UINT32        *Attributes  OPTIONAL,
+  OUT    UINTN         *Size
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Buffer;
+
+  *Size = 0;
+  Status = gRT->GetVariable((CHAR16 *)Name, &gEfiGlobalVariableGuid, NULL, Size, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL || *Size == 0) {
+    return NULL;
+  }
+
+  Buffer = (Arena != NULL) ? MiuArenaAlloc(Arena, *Size) : AllocatePool(*Size);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+  Status = gRT->GetVariable((CHAR16 *)Name, &gEfiGlobalVariableGuid, Attributes, Size, Buffer);
+  if (EFI_ERROR(Status)) {
+    // Arena memory goes back when the arena is reset
+    if (Arena == NULL) {
+      FreePool(Buffer);
+    }
+    return NULL;
+  }
+  return Buffer;
+}
+
+/**
+  Appends one option read from <Type>####, growing the table by doubling.
+**/
+STATIC
+EFI_STATUS
+AddLoadOption(
+  IN CONST CHAR16      *Name,
+  IN LOAD_OPTION_TYPE  Type,
+  IN UINT16            Number
+  )
+{
+  LOAD_OPTION_ENTRY  *Entry;
+
+  if (mLoadOptionCount == mLoadOptionCapacity) {
+    UINTN             NewCapacity = (mLoadOptionCapacity == 0) ? 32 : mLoadOptionCapacity * 2;
+    LOAD_OPTION_ENTRY *NewTable;
+
+    NewTable = ReallocatePool(mLoadOptionCapacity * sizeof(LOAD_OPTION_ENTRY),
+                              NewCapacity * sizeof(LOAD_OPTION_ENTRY), mLoadOptions);
+    if (NewTable == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    mLoadOptions        = NewTable;
+    mLoadOptionCapacity = NewCapacity;
+  }
+
+  Entry = &mLoadOptions[mLoadOptionCount];
+  ZeroMem(Entry, sizeof(*Entry));
+  Entry->Type   = Type;
+  Entry->Number = Number;
+  StrCpyS(Entry->Name, ARRAY_SIZE(Entry->Name), Name);
+
+  Entry->Data = ReadGlobalVariable(NULL, Name, &Entry->Attributes, &Entry->DataSize);
+  if (Entry->Data == NULL) {
+    // Deleted between enumeration and read, or unreadable: leave it out
+    return EFI_SUCCESS;
+  }
+  DecodeLoadOption(Entry);
+  mLoadOptionCount++;
+  return EFI_SUCCESS;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareLoadOptionKey(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  CONST LOAD_OPTION_ENTRY *EntryA = (CONST LOAD_OPTION_ENTRY *)A;
+  CONST LOAD_OPTION_ENTRY *EntryB = (CONST LOAD_OPTION_ENTRY *)B;
+  UINT32                  KeyA = LOAD_OPTION_KEY(EntryA->Type, EntryA->Number);
+  UINT32                  KeyB = LOAD_OPTION_KEY(EntryB->Type, EntryB->Number);
+
+  return (KeyA < KeyB) ? -1 : (KeyA > KeyB) ? 1 : 0;
+}
+
+LOAD_OPTION_ENTRY *
+FindLoadOption(
+  IN LOAD_OPTION_TYPE  Type,
+  IN UINT16            Number
+  )
+{
+  UINT32  Key = LOAD_OPTION_KEY(Type, Number);
+  UINTN   Low = 0;
+  UINTN   High = mLoadOptionCount;
+
+  // The table is sorted by key once it is built
+  while (Low < High) {
+    UINTN  Mid    = Low + (High - Low) / 2;
+    UINT32 MidKey = LOAD_OPTION_KEY(mLoadOptions[Mid].Type, mLoadOptions[Mid].Number);
+
+    if (MidKey == Key) {
+      return &mLoadOptions[Mid];
+    }
+    if (MidKey < Key) {
+      Low = Mid + 1;
+    } else {
+      High = Mid;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Reads the order variable of a type and stamps each listed option with its
+  position. Entries naming a missing option are counted, duplicates keep the
+  first position.
+**/
+STATIC
+VOID
+ApplyLoadOptionOrder(
+  IN LOAD_OPTION_TYPE  Type
+  )
+{
+  LOAD_OPTION_ENTRY  *Entry;
+  UINTN              Size;
+
+  if (mLoadOptionOrderName[Type] == NULL) {
+    return;
+  }
+
+  mOrder[Type] = ReadGlobalVariable(NULL, mLoadOptionOrderName[Type], NULL, &Size);
+  if (mOrder[Type] == NULL) {
+    return;
+  }
+  mOrderCount[Type] = Size / sizeof(UINT16);
+
+  for (UINTN i = 0; i < mOrderCount[Type]; i++) {
+    Entry = FindLoadOption(Type, mOrder[Type][i]);
+    if (Entry == NULL) {
+      mMissingCount[Type]++;
+    } else if (Entry->OrderPosition == 0) {
+      Entry->OrderPosition = (UINT16)MIN(i + 1, MAX_UINT16);
+    }
+  }
+}
+
+/**
+  Marks the options named by BootNext and BootCurrent.
+**/
+STATIC
+VOID
+ApplyBootNextCurrent(VOID)
+{
+  STATIC CONST CHAR16 *Names[] = { L"BootNext", L"BootCurrent" };
+  STATIC CONST UINT8  Flags[]  = { LOAD_OPTION_FLAG_BOOT_NEXT, LOAD_OPTION_FLAG_BOOT_CURRENT };
+  LOAD_OPTION_ENTRY   *Entry;
+  UINT16              *Value;
+  UINTN               Size;
+
+  for (UINTN i = 0; i < ARRAY_SIZE(Names); i++) {
+    Value = ReadGlobalVariable(NULL, Names[i], NULL, &Size);
+    if (Value == NULL) {
+      continue;
+    }
+    if (Size == sizeof(UINT16)) {
+      Entry = FindLoadOption(LoadOptionTypeBoot, *Value);
+      if (Entry != NULL) {
+        Entry->Flags |= Flags[i];
+      }
+    }
+    FreePool(Value);
+  }
+}
+
+VOID
+FreeLoadOptionIndex(VOID)
+{
+  for (UINTN i = 0; i < mLoadOptionCount; i++) {
+    FreeLoadOption(&mLoadOptions[i]);
+  }
+  if (mLoadOptions != NULL) {
+    FreePool(mLoadOptions);
+  }
+  mLoadOptions        = NULL;
+  mLoadOptionCount    = 0;
+  mLoadOptionCapacity = 0;
+
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    if (mOrder[t] != NULL) {
+      FreePool(mOrder[t]);
+    }
+    mOrder[t]        = NULL;
+    mOrderCount[t]   = 0;
+    mMissingCount[t] = 0;
+  }
+}
+
+EFI_STATUS
+BuildLoadOptionIndex(VOID)
+{
+  EFI_STATUS         Status;
+  CHAR16             *NameBuf;
+  UINTN              NameCapacity = LOAD_OPTION_NAME_CHARS * sizeof(CHAR16);
+  UINTN              NameSize;
+  EFI_GUID           Guid;
+  LOAD_OPTION_TYPE   Type;
+  UINT16             Number;
+  LOAD_OPTION_ENTRY  Scratch;
+
+  FreeLoadOptionIndex();
+
+  NameBuf = AllocateZeroPool(NameCapacity);
+  if (NameBuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  ZeroMem(&Guid, sizeof(Guid));
+
+  // One pass over the store picks up every option, listed in an order variable or not
+  for (;;) {
+    NameSize = NameCapacity;
+    Status = gRT->GetNextVariableName(&NameSize, NameBuf, &Guid);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      // Grow the name buffer; ReallocatePool keeps the previous name intact
+      CHAR16 *NewBuf = ReallocatePool(NameCapacity, NameSize, NameBuf);
+      if (NewBuf == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      NameBuf      = NewBuf;
+      NameCapacity = NameSize;
+      continue;
+    }
+    if (Status == EFI_NOT_FOUND) {
+      Status = EFI_SUCCESS;   // End of the variable store
+      break;
+    }
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+
+    if (CompareGuid(&Guid, &gEfiGlobalVariableGuid) &&
+        ParseLoadOptionName(NameBuf, &Type, &Number)) {
+      Status = AddLoadOption(NameBuf, Type, Number);
+      if (EFI_ERROR(Status)) {
+        break;
+      }
+    }
+  }
+  FreePool(NameBuf);
+
+  if (EFI_ERROR(Status)) {
+    FreeLoadOptionIndex();
+    return Status;
+  }
+
+  if (mLoadOptionCount > 1) {
+    QuickSort(mLoadOptions, mLoadOptionCount, sizeof(LOAD_OPTION_ENTRY), CompareLoadOptionKey, &Scratch);
+  }
+
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    ApplyLoadOptionOrder((LOAD_OPTION_TYPE)t);
+  }
+  ApplyBootNextCurrent();
+
+  return EFI_SUCCESS;
+}
+
+UINTN
+LoadOptionCount(VOID)
+{
+  return mLoadOptionCount;
+}
+
+LOAD_OPTION_ENTRY *
+GetLoadOption(
+  IN UINTN  Index
+  )
+{
+  return (Index < mLoadOptionCount) ? &mLoadOptions[Index] : NULL;
+}
+
+CONST UINT16 *
+GetLoadOptionOrder(
+  IN  LOAD_OPTION_TYPE  Type,
+  OUT UINTN             *Count
+  )
+{
+  if (Type >= LoadOptionTypeMax) {
+    *Count = 0;
+    return NULL;
+  }
+  *Count = mOrderCount[Type];
+  return mOrder[Type];
+}
+
+UINTN
+LoadOptionMissingCount(
+  IN LOAD_OPTION_TYPE  Type
+  )
+{
+  return (Type < LoadOptionTypeMax) ? mMissingCount[Type] : 0;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareKey(
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  UINT32 KeyA = *(CONST UINT32 *)A;
+  UINT32 KeyB = *(CONST UINT32 *)B;
+
+  return (KeyA < KeyB) ? -1 : (KeyA > KeyB) ? 1 : 0;
+}
+
+/**
+  Enumerates the variable store once into a sorted arena array of the
+  LOAD_OPTION_KEY of every option variable. The array grows by doubling;
+  outgrown copies stay in the arena until it is reset.
+**/
+STATIC
+EFI_STATUS
+CollectLoadOptionKeys(
+  IN OUT MIU_ARENA  *Arena,
+  OUT    UINT32     **Keys,
+  OUT    UINTN      *KeyCount
+  )
+{
+  EFI_STATUS        Status;
+  CHAR16            *NameBuf;
+  UINTN             NameCapacity = LOAD_OPTION_NAME_CHARS * sizeof(CHAR16);
+  UINTN             NameSize;
+  UINTN             KeyCapacity = 32;
+  EFI_GUID          Guid;
+  LOAD_OPTION_TYPE  Type;
+  UINT16            Number;
+  UINT32            Scratch;
+
+  *KeyCount = 0;
+  *Keys     = MiuArenaAlloc(Arena, KeyCapacity * sizeof(UINT32));
+  NameBuf   = MiuArenaAlloc(Arena, NameCapacity);
+  if (*Keys == NULL || NameBuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  NameBuf[0] = L'\0';
+  ZeroMem(&Guid, sizeof(Guid));
+
+  for (;;) {
+    NameSize = NameCapacity;
+    Status = gRT->GetNextVariableName(&NameSize, NameBuf, &Guid);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      // Grow the name buffer, keeping the previous name the next call starts from
+      CHAR16 *NewBuf = MiuArenaAlloc(Arena, NameSize);
+      if (NewBuf == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      CopyMem(NewBuf, NameBuf, NameCapacity);
+      NameBuf      = NewBuf;
+      NameCapacity = NameSize;
+      continue;
+    }
+    if (Status == EFI_NOT_FOUND) {
+      break;   // End of the variable store
+    }
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+
+    if (!CompareGuid(&Guid, &gEfiGlobalVariableGuid) ||
+        !ParseLoadOptionName(NameBuf, &Type, &Number)) {
+      continue;
+    }
+    if (*KeyCount == KeyCapacity) {
+      UINT32 *NewKeys = MiuArenaAlloc(Arena, KeyCapacity * 2 * sizeof(UINT32));
+      if (NewKeys == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      CopyMem(NewKeys, *Keys, KeyCapacity * sizeof(UINT32));
+      *Keys        = NewKeys;
+      KeyCapacity *= 2;
+    }
+    (*Keys)[(*KeyCount)++] = LOAD_OPTION_KEY(Type, Number);
+  }
+
+  if (*KeyCount > 1) {
+    QuickSort(*Keys, *KeyCount, sizeof(UINT32), CompareKey, &Scratch);
+  }
+  return EFI_SUCCESS;
+}
+
+// 1-based position of Number in an order variable, 0 if it is not listed
+STATIC
+UINT16
+LoadOptionOrderPosition(
+  IN CONST UINT16  *Order  OPTIONAL,
+  IN UINTN         OrderCount,
+  IN UINT16        Number
+  )
+{
+  for (UINTN i = 0; i < OrderCount; i++) {
+    if (Order[i] == Number) {
+      return (UINT16)MIN(i + 1, MAX_UINT16);
+    }
+  }
+  return 0;
+}
+
+EFI_STATUS
+WriteLoadOptionSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  )
+{
+  EFI_STATUS           Status;
+  UINT32               *Keys;
+  UINTN                KeyCount;
+  UINT16               *Order[LoadOptionTypeMax];
+  UINTN                OrderCount[LoadOptionTypeMax];
+  UINT16               *BootNext;
+  UINT16               *BootCurrent;
+  UINTN                Size;
+  UINT8                *DataBuf;
+  UINTN                DataCapacity = SIZE_4KB;
+  CHAR16               Name[LOAD_OPTION_NAME_CHARS];
+  SNAPSHOT_LOAD_OPTION Record;
+
+  *Count = 0;
+  Status = CollectLoadOptionKeys(Arena, &Keys, &KeyCount);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    Order[t]      = NULL;
+    OrderCount[t] = 0;
+    if (mLoadOptionOrderName[t] != NULL) {
+      Order[t]      = ReadGlobalVariable(Arena, mLoadOptionOrderName[t], NULL, &Size);
+      OrderCount[t] = (Order[t] != NULL) ? Size / sizeof(UINT16) : 0;
+    }
+  }
+  BootNext = ReadGlobalVariable(Arena, L"BootNext", NULL, &Size);
+  if (Size != sizeof(UINT16)) {
+    BootNext = NULL;
+  }
+  BootCurrent = ReadGlobalVariable(Arena, L"BootCurrent", NULL, &Size);
+  if (Size != sizeof(UINT16)) {
+    BootCurrent = NULL;
+  }
+
+  DataBuf = MiuArenaAlloc(Arena, DataCapacity);
+  if (DataBuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (UINTN i = 0; i < KeyCount; i++) {
+    LOAD_OPTION_TYPE Type   = (LOAD_OPTION_TYPE)(Keys[i] >> 16);
+    UINT16           Number = (UINT16)Keys[i];
+    UINTN            DataSize;
+    UINT32           Attributes;
+
+    UnicodeSPrint(Name, sizeof(Name), L"%s%04X", mLoadOptionPrefix[Type], Number);
+    DataSize = DataCapacity;
+    Status = gRT->GetVariable(Name, &gEfiGlobalVariableGuid, &Attributes, &DataSize, DataBuf);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      DataBuf = MiuArenaAlloc(Arena, DataSize);
+      if (DataBuf == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      DataCapacity = DataSize;
+      Status = gRT->GetVariable(Name, &gEfiGlobalVariableGuid, &Attributes, &DataSize, DataBuf);
+    }
+    if (EFI_ERROR(Status) || DataSize == 0) {
+      // Deleted since the enumeration, or unreadable: leave it out
+      continue;
+    }
+
+    ZeroMem(&Record, sizeof(Record));
+    Record.Type          = (UINT8)Type;
+    Record.Number        = Number;
+    Record.OrderPosition = LoadOptionOrderPosition(Order[Type], OrderCount[Type], Number);
+    Record.Attributes    = Attributes;
+    Record.DataSize      = (UINT32)DataSize;
+    if (Type == LoadOptionTypeBoot) {
+      if (BootNext != NULL && *BootNext == Number) {
+        Record.Flags |= LOAD_OPTION_FLAG_BOOT_NEXT;
+      }
+      if (BootCurrent != NULL && *BootCurrent == Number) {
+        Record.Flags |= LOAD_OPTION_FLAG_BOOT_CURRENT;
+      }
+    }
+
+    Status = FileWriterAppend(Writer, &Record, sizeof(Record));
+    if (!EFI_ERROR(Status)) {
+      Status = FileWriterAppend(Writer, DataBuf, DataSize);
+    }
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+    (*Count)++;
+  }
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <Uefi.h>
+#include <Protocol/DevicePath.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
+
+//
+// The four kinds of EFI_LOAD_OPTION variables defined by the UEFI spec, all
+// under the global variable GUID and named <Prefix>#### with uppercase hex.
+//
+typedef enum {
+  LoadOptionTypeBoot,
+  LoadOptionTypeDriver,
+  LoadOptionTypeSysPrep,
+  LoadOptionTypePlatformRecovery,
+  LoadOptionTypeMax
+} LOAD_OPTION_TYPE;
+
+//
+// LOAD_OPTION_ENTRY.Flags
+//
+#define LOAD_OPTION_FLAG_BOOT_NEXT     BIT0   // BootNext names this option
+#define LOAD_OPTION_FLAG_BOOT_CURRENT  BIT1   // BootCurrent names this option
+
+//
+// One device path node of the file path list, with its text cached.
+//
+typedef struct {
+  UINT8     Type;
+  UINT8     SubType;
+  UINT16    Length;
+  UINT16    Instance;       // which path of the list the node belongs to
+  CHAR16    *Text;          // ConvertDeviceNodeToText result, NULL if unknown
+} LOAD_OPTION_NODE;
+
+typedef struct {
+  LOAD_OPTION_TYPE  Type;
+  UINT16            Number;
+  UINT16            OrderPosition;  // 1-based position in the order variable, 0 if not listed
+  UINT8             Flags;
+  CHAR16            Name[24];       // e.g. Boot0001, PlatformRecovery0000
+  CHAR16            Description[256];
+  UINT32            Attributes;     // variable attributes
+  UINTN             DataSize;
+  UINT8             *Data;
+  //
+  // Decoded EFI_LOAD_OPTION, pointers are into Data
+  //
+  BOOLEAN                   Valid;
+  BOOLEAN                   PathTruncated;
+  UINT32                    LoadAttributes;
+  UINT16                    FilePathListLength;
+  EFI_DEVICE_PATH_PROTOCOL  *FilePathList;
+  UINT8                     *OptionalData;
+  UINTN                     OptionalDataSize;
+  UINTN                     NodeCount;
+  UINT16                    InstanceCount;
+  LOAD_OPTION_NODE          *Nodes;
+  CHAR16                    *PathText;      // first path of the list as one string
+} LOAD_OPTION_ENTRY;
+
+/**
+  Enumerates the variable store once and loads every Boot####, Driver####,
+  SysPrep#### and PlatformRecovery#### variable, decoded and with its device
+  paths converted to text. BootOrder, DriverOrder and SysPrepOrder are read
+  to set each option's OrderPosition. A previous index is freed first.
+
+  @retval EFI_SUCCESS           The index was built (it may be empty).
+  @retval EFI_OUT_OF_RESOURCES  Allocation failed.
+  @retval others                Variable enumeration failed.
+**/
+EFI_STATUS
+BuildLoadOptionIndex(VOID);
+
+// Release the index and every cached string
+VOID FreeLoadOptionIndex(VOID);
+
+// Number of options, and the Index-th of them sorted by type and number
+UINTN LoadOptionCount(VOID);
+LOAD_OPTION_ENTRY *GetLoadOption(IN UINTN Index);
+
+// Option <Type>####, or NULL if the variable does not exist
+LOAD_OPTION_ENTRY *FindLoadOption(IN LOAD_OPTION_TYPE Type, IN UINT16 Number);
+
+// The order variable of a type as read, or NULL (PlatformRecovery has none)
+CONST UINT16 *GetLoadOptionOrder(IN LOAD_OPTION_TYPE Type, OUT UINTN *Count);
+
+// Order entries that name an option variable which does not exist
+UINTN LoadOptionMissingCount(IN LOAD_OPTION_TYPE Type);
+
+// Variable name prefix of a type: Boot, Driver, SysPrep, PlatformRecovery
+CONST CHAR16 *LoadOptionTypeName(IN LOAD_OPTION_TYPE Type);
+
+/**
+  Stream every option into a snapshot section as SNAPSHOT_LOAD_OPTION + the
+  variable bytes, sorted by type and number. The variables are read straight
+  into Arena without decoding, and the interactive index is left alone.
+**/
+EFI_STATUS
+WriteLoadOptionSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  );
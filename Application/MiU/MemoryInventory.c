@@ -0,0 +1,467 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "MemoryInventory.h"
+#include "Smbios.h"
+#include "SmbiosDecode.h"
+#include "ShowMemoryMap.h"
+
+//
+// Field offsets used by the join (DMTF SMBIOS 3.x)
+//
+#define T17_SIZE                   0x0C
+#define T17_DEVICE_LOCATOR         0x10
+#define T17_MEMORY_TYPE            0x12
+#define T17_SPEED                  0x15
+#define T17_PART_NUMBER            0x1A
+#define T17_EXTENDED_SIZE          0x1C
+#define T17_CONFIGURED_SPEED       0x20
+#define T17_EXTENDED_SPEED         0x54
+#define T17_EXTENDED_CONF_SPEED    0x58
+
+#define T19_STARTING_ADDRESS       0x04   // Also Type 20
+#define T19_ENDING_ADDRESS         0x08   // Also Type 20
+#define T19_EXTENDED_START         0x0F
+#define T19_EXTENDED_END           0x17
+#define T20_MEMORY_DEVICE_HANDLE   0x0C
+#define T20_EXTENDED_START         0x13
+#define T20_EXTENDED_END           0x1B
+
+#define INVENTORY_SUMMARY_LINES    9      // Summary block above the DIMM table
+
+typedef struct {
+  SMBIOS_ENTRY  *Entry;
+  UINT16        Handle;
+  UINT64        SizeKb;           // 0 when the slot is empty
+  UINT32        Speed;            // Rated, MT/s
+  UINT32        ConfiguredSpeed;  // MT/s
+  UINT8         MemoryType;
+  UINT64        MappedKb;         // Sum of the Type 20 ranges of this device
+} DIMM_ROW;
+
+typedef struct {
+  DIMM_ROW  *Dimms;
+  UINTN     DimmCount;
+  UINTN     Populated;
+  UINTN     SlowCount;
+  UINTN     UnmappedCount;
+  UINT64    InstalledKb;         // Type 17
+  UINTN     ArrayRangeCount;
+  UINT64    ArrayMappedKb;       // Type 19
+  UINTN     DeviceRangeCount;    // Type 20
+  UINT64    MapRamKb;            // UEFI memory map, every type but MMIO
+  UINT64    MapTypeKb[EfiMaxMemoryType];
+} MEMORY_INVENTORY;
+
+/**
+  Read a little-endian field of Width bytes; FALSE if the record is too
+  short to carry it (older SMBIOS versions).
+**/
+STATIC
+BOOLEAN
+ReadRecordField(
+  IN  SMBIOS_ENTRY  *Entry,
+  IN  UINTN         Offset,
+  IN  UINTN         Width,
+  OUT UINT64        *Value
+  )
+{
+  *Value = 0;
+  if (Offset + Width > Entry->Header->Length) {
+    return FALSE;
+  }
+  CopyMem(Value, (UINT8 *)Entry->Header + Offset, Width);
+  return TRUE;
+}
+
+/**
+  Size in KB of a Type 19/20 range, using the 64-bit byte addresses when the
+  32-bit KB ones are 0xFFFFFFFF.
+**/
+STATIC
+UINT64
+RangeSizeKb(
+  IN SMBIOS_ENTRY  *Entry,
+  IN UINTN         ExtendedStart,
+  IN UINTN         ExtendedEnd
+  )
+{
+  UINT64 Start, End;
+
+  ReadRecordField(Entry, T19_STARTING_ADDRESS, 4, &Start);
+  ReadRecordField(Entry, T19_ENDING_ADDRESS, 4, &End);
+  if (Start == 0xFFFFFFFF) {
+    if (!ReadRecordField(Entry, ExtendedStart, 8, &Start) ||
+        !ReadRecordField(Entry, ExtendedEnd, 8, &End) || End < Start) {
+      return 0;
+    }
+    return RShiftU64(End - Start + 1, 10);
+  }
+  return (End >= Start) ? (End - Start + 1) : 0;
+}
+
+/**
+  Decode one Type 17 record into a row.
+**/
+STATIC
+VOID
+DecodeMemoryDevice(
+  IN  SMBIOS_ENTRY  *Entry,
+  OUT DIMM_ROW      *Row
+  )
+{
+  UINT64 Value;
+
+  ZeroMem(Row, sizeof(*Row));
+  Row->Entry  = Entry;
+  Row->Handle = Entry->Handle;
+
+  ReadRecordField(Entry, T17_SIZE, 2, &Value);
+  if (Value == 0x7FFF) {
+    ReadRecordField(Entry, T17_EXTENDED_SIZE, 4, &Value);
+    Row->SizeKb = LShiftU64(Value & 0x7FFFFFFF, 10);
+  } else if (Value != 0 && Value != 0xFFFF) {
+    Row->SizeKb = (Value & BIT15) ? (Value & 0x7FFF) : LShiftU64(Value & 0x7FFF, 10);
+  }
+
+  ReadRecordField(Entry, T17_MEMORY_TYPE, 1, &Value);
+  Row->MemoryType = (UINT8)Value;
+
+  ReadRecordField(Entry, T17_SPEED, 2, &Value);
+  if (Value == 0xFFFF) {
+    ReadRecordField(Entry, T17_EXTENDED_SPEED, 4, &Value);
+  }
+  Row->Speed = (UINT32)Value;
+
+  ReadRecordField(Entry, T17_CONFIGURED_SPEED, 2, &Value);
+  if (Value == 0xFFFF) {
+    ReadRecordField(Entry, T17_EXTENDED_CONF_SPEED, 4, &Value);
+  }
+  Row->ConfiguredSpeed = (UINT32)Value;
+}
+
+STATIC
+BOOLEAN
+IsDimmSlow(
+  IN CONST DIMM_ROW  *Row
+  )
+{
+  return (BOOLEAN)(Row->SizeKb != 0 && Row->Speed != 0 && Row->ConfiguredSpeed != 0 &&
+                   Row->ConfiguredSpeed < Row->Speed);
+}
+
+STATIC
+INTN
+EFIAPI
+CompareDimmHandle(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  UINT16 A = (*(DIMM_ROW * CONST *)Buffer1)->Handle;
+  UINT16 B = (*(DIMM_ROW * CONST *)Buffer2)->Handle;
+  return (A < B) ? -1 : (A > B) ? 1 : 0;
+}
+
+/**
+  Binary search a handle-sorted DIMM array.
+**/
+STATIC
+DIMM_ROW *
+FindDimmByHandle(
+  IN DIMM_ROW  **ByHandle,
+  IN UINTN     Count,
+  IN UINT16    Handle
+  )
+{
+  UINTN Low = 0, High = Count;
+
+  while (Low < High) {
+    UINTN Mid = Low + (High - Low) / 2;
+    if (ByHandle[Mid]->Handle == Handle) {
+      return ByHandle[Mid];
+    }
+    if (ByHandle[Mid]->Handle < Handle) {
+      Low = Mid + 1;
+    } else {
+      High = Mid;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Build the inventory in one pass over each source: Type 17, Type 19,
+  Type 20 (joined to Type 17 by handle) and the UEFI memory map.
+**/
+STATIC
+EFI_STATUS
+BuildMemoryInventory(
+  OUT MEMORY_INVENTORY  *Inv
+  )
+{
+  EFI_STATUS  Status;
+  DIMM_ROW    **ByHandle;
+  DIMM_ROW    *Scratch;
+  MEMORY_MAP  MemMap = {0};
+  UINTN       Index;
+
+  ZeroMem(Inv, sizeof(*Inv));
+
+  Status = BuildSmbiosIndex();
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  // Type 17: one row per device slot
+  Inv->DimmCount = SmbiosTypeCount(SMBIOS_TYPE_MEMORY_DEVICE);
+  Inv->Dimms     = AllocateZeroPool((Inv->DimmCount + 1) * sizeof(DIMM_ROW));
+  ByHandle       = AllocatePool((Inv->DimmCount + 1) * sizeof(DIMM_ROW *));
+  if (Inv->Dimms == NULL || ByHandle == NULL) {
+    if (Inv->Dimms != NULL) FreePool(Inv->Dimms);
+    if (ByHandle != NULL) FreePool(ByHandle);
+    Inv->Dimms = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+  for (Index = 0; Index < Inv->DimmCount; Index++) {
+    DIMM_ROW *Row = &Inv->Dimms[Index];
+    DecodeMemoryDevice(GetSmbiosRecordOfType(SMBIOS_TYPE_MEMORY_DEVICE, Index), Row);
+    ByHandle[Index] = Row;
+    if (Row->SizeKb != 0) {
+      Inv->Populated++;
+      Inv->InstalledKb += Row->SizeKb;
+    }
+    if (IsDimmSlow(Row)) {
+      Inv->SlowCount++;
+    }
+  }
+  QuickSort(ByHandle, Inv->DimmCount, sizeof(DIMM_ROW *), CompareDimmHandle, &Scratch);
+
+  // Type 19: array-level mapped ranges
+  Inv->ArrayRangeCount = SmbiosTypeCount(SMBIOS_TYPE_MEMORY_ARRAY_MAPPED_ADDRESS);
+  for (Index = 0; Index < Inv->ArrayRangeCount; Index++) {
+    Inv->ArrayMappedKb += RangeSizeKb(
+                            GetSmbiosRecordOfType(SMBIOS_TYPE_MEMORY_ARRAY_MAPPED_ADDRESS, Index),
+                            T19_EXTENDED_START,
+                            T19_EXTENDED_END
+                            );
+  }
+
+  // Type 20: device-level ranges, attributed to their Type 17 by handle
+  Inv->DeviceRangeCount = SmbiosTypeCount(SMBIOS_TYPE_MEMORY_DEVICE_MAPPED_ADDRESS);
+  for (Index = 0; Index < Inv->DeviceRangeCount; Index++) {
+    SMBIOS_ENTRY *Entry = GetSmbiosRecordOfType(SMBIOS_TYPE_MEMORY_DEVICE_MAPPED_ADDRESS, Index);
+    UINT64       Handle;
+    DIMM_ROW     *Row;
+
+    if (!ReadRecordField(Entry, T20_MEMORY_DEVICE_HANDLE, 2, &Handle)) continue;
+    Row = FindDimmByHandle(ByHandle, Inv->DimmCount, (UINT16)Handle);
+    if (Row != NULL) {
+      Row->MappedKb += RangeSizeKb(Entry, T20_EXTENDED_START, T20_EXTENDED_END);
+    }
+  }
+  FreePool(ByHandle);
+
+  // Type 20 is optional; only judge per-DIMM mapping when the firmware provides it
+  if (Inv->DeviceRangeCount > 0) {
+    for (Index = 0; Index < Inv->DimmCount; Index++) {
+      if (Inv->Dimms[Index].SizeKb != 0 && Inv->Dimms[Index].MappedKb == 0) {
+        Inv->UnmappedCount++;
+      }
+    }
+  }
+
+  // UEFI memory map: totals per type
+  Status = GetMemoryMapBuffer(&MemMap);
+  if (!EFI_ERROR(Status)) {
+    MemMap.DescriptorCount = MemMap.MapSize / MemMap.DescriptorSize;
+    for (Index = 0; Index < MemMap.DescriptorCount; Index++) {
+      EFI_MEMORY_DESCRIPTOR *Desc =
+        (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)MemMap.Map + Index * MemMap.DescriptorSize);
+      UINT64 Kb = MultU64x32(Desc->NumberOfPages, EFI_PAGE_SIZE / SIZE_1KB);
+
+      if (Desc->Type < EfiMaxMemoryType) {
+        Inv->MapTypeKb[Desc->Type] += Kb;
+      }
+      if (Desc->Type != EfiMemoryMappedIO && Desc->Type != EfiMemoryMappedIOPortSpace) {
+        Inv->MapRamKb += Kb;
+      }
+    }
+  }
+  if (MemMap.Map != NULL) {
+    FreePool(MemMap.Map);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Firmware legitimately keeps some RAM out of the memory map (legacy holes,
+  SMRAM, stolen graphics memory), so only a gap above 1/32 of the mapped
+  capacity is reported.
+**/
+STATIC
+BOOLEAN
+IsMissingFromMemoryMap(
+  IN CONST MEMORY_INVENTORY  *Inv
+  )
+{
+  return (BOOLEAN)(Inv->ArrayMappedKb > Inv->MapRamKb &&
+                   Inv->ArrayMappedKb - Inv->MapRamKb > RShiftU64(Inv->ArrayMappedKb, 5));
+}
+
+/**
+  Print the summary block (INVENTORY_SUMMARY_LINES lines).
+**/
+STATIC
+VOID
+DrawInventorySummary(
+  IN CONST MEMORY_INVENTORY  *Inv
+  )
+{
+  BOOLEAN Healthy = TRUE;
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L" DIMMs      : %d of %d slots populated, %ld MB installed (Type 17)\n",
+        Inv->Populated, Inv->DimmCount, RShiftU64(Inv->InstalledKb, 10));
+  Print(L" Mapped     : %ld MB in %d array ranges (Type 19), %d device ranges (Type 20)\n",
+        RShiftU64(Inv->ArrayMappedKb, 10), Inv->ArrayRangeCount, Inv->DeviceRangeCount);
+  Print(L" Memory map : %ld MB RAM; free %ld, BS %ld, RT %ld, ACPI %ld, reserved %ld MB\n",
+        RShiftU64(Inv->MapRamKb, 10),
+        RShiftU64(Inv->MapTypeKb[EfiConventionalMemory], 10),
+        RShiftU64(Inv->MapTypeKb[EfiBootServicesCode] + Inv->MapTypeKb[EfiBootServicesData] +
+                  Inv->MapTypeKb[EfiLoaderCode] + Inv->MapTypeKb[EfiLoaderData], 10),
+        RShiftU64(Inv->MapTypeKb[EfiRuntimeServicesCode] + Inv->MapTypeKb[EfiRuntimeServicesData], 10),
+        RShiftU64(Inv->MapTypeKb[EfiACPIReclaimMemory] + Inv->MapTypeKb[EfiACPIMemoryNVS], 10),
+        RShiftU64(Inv->MapTypeKb[EfiReservedMemoryType], 10));
+  Print(L"\n");
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  if (Inv->SlowCount > 0) {
+    Print(L" ! %d DIMM(s) configured below rated speed\n", Inv->SlowCount);
+    Healthy = FALSE;
+  }
+  if (Inv->ArrayRangeCount > 0 && Inv->ArrayMappedKb < Inv->InstalledKb) {
+    Print(L" ! %ld MB installed but not mapped by Type 19\n",
+          RShiftU64(Inv->InstalledKb - Inv->ArrayMappedKb, 10));
+    Healthy = FALSE;
+  }
+  if (Inv->UnmappedCount > 0) {
+    Print(L" ! %d populated DIMM(s) have no Type 20 mapping\n", Inv->UnmappedCount);
+    Healthy = FALSE;
+  }
+  if (IsMissingFromMemoryMap(Inv)) {
+    Print(L" ! %ld MB mapped by SMBIOS is missing from the UEFI memory map\n",
+          RShiftU64(Inv->ArrayMappedKb - Inv->MapRamKb, 10));
+    Healthy = FALSE;
+  }
+  if (Healthy) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGREEN, EFI_BLUE));
+    Print(L" All DIMMs at rated speed and all installed capacity is mapped\n");
+  }
+}
+
+/**
+  Print one DIMM row.
+**/
+STATIC
+VOID
+DrawDimmRow(
+  IN CONST MEMORY_INVENTORY  *Inv,
+  IN DIMM_ROW                *Row
+  )
+{
+  CONST CHAR16 *TypeName;
+  UINT64       Locator, PartNumber;
+
+  ReadRecordField(Row->Entry, T17_DEVICE_LOCATOR, 1, &Locator);
+  ReadRecordField(Row->Entry, T17_PART_NUMBER, 1, &PartNumber);
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  Print(L" %-16a", GetSmbiosString(Row->Entry, (SMBIOS_TABLE_STRING)Locator));
+
+  if (Row->SizeKb == 0) {
+    Print(L"%9s\n", L"Empty");
+    return;
+  }
+
+  TypeName = GetSmbiosMemoryTypeName(Row->MemoryType);
+  Print(L"%6ld MB %-6s %5d %5d  %-20a ",
+        RShiftU64(Row->SizeKb, 10),
+        (TypeName != NULL) ? TypeName : L"?",
+        Row->Speed,
+        Row->ConfiguredSpeed,
+        GetSmbiosString(Row->Entry, (SMBIOS_TABLE_STRING)PartNumber));
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  if (IsDimmSlow(Row)) {
+    Print(L"SLOW ");
+  }
+  if (Inv->DeviceRangeCount > 0 && Row->MappedKb == 0) {
+    Print(L"UNMAPPED");
+  }
+  Print(L"\n");
+}
+
+VOID
+ShowMemoryInventory(VOID)
+{
+  EFI_STATUS        Status;
+  MEMORY_INVENTORY  Inv;
+  UINTN             Columns, Rows, Visible;
+  UINTN             Top = 0;
+  EFI_INPUT_KEY     Key;
+
+  Status = BuildMemoryInventory(&Inv);
+  if (EFI_ERROR(Status)) {
+    Print(L"Unable to build the memory inventory: %r\n", Status);
+    Print(L"\nPress any key to return\n");
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+    return;
+  }
+
+  // Header, summary, table header and footer stay on screen; DIMMs scroll
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  Visible = (Rows > INVENTORY_SUMMARY_LINES + 5) ? (Rows - INVENTORY_SUMMARY_LINES - 5) : 1;
+
+  while (TRUE) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" Memory Inventory: SMBIOS Type 17/19/20 and the UEFI memory map\n");
+
+    DrawInventorySummary(&Inv);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L"\n %-16s%9s %-6s %5s %5s  %-20s %s\n",
+          L"Locator", L"Size", L"Type", L"Rated", L"Conf", L"Part Number", L"Flags");
+
+    for (UINTN i = Top; i < Inv.DimmCount && i < Top + Visible; i++) {
+      DrawDimmRow(&Inv, &Inv.Dimms[i]);
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nUp/Down/PgUp/PgDn scroll, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    } else if (Key.ScanCode == SCAN_UP) {
+      if (Top > 0) Top--;
+    } else if (Key.ScanCode == SCAN_DOWN) {
+      if (Top + Visible < Inv.DimmCount) Top++;
+    } else if (Key.ScanCode == SCAN_PAGE_UP) {
+      Top = (Top > Visible) ? (Top - Visible) : 0;
+    } else if (Key.ScanCode == SCAN_PAGE_DOWN) {
+      if (Top + Visible < Inv.DimmCount) Top += Visible;
+    }
+  }
+
+  FreePool(Inv.Dimms);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
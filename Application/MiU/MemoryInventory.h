@@ -0,0 +1,11 @@
+#pragma once
+#include <Uefi.h>
+
+/**
+  Memory inventory: every SMBIOS Type 17 device joined with its Type 20
+  mappings, the Type 19 array ranges and the UEFI memory map totals.
+  DIMMs configured below their rated speed and installed capacity that is
+  missing from either map are flagged.
+**/
+VOID
+ShowMemoryInventory(VOID);
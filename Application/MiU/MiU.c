@@ -14,6 +14,11 @@
 #include "IoSpace.h"
 #include "ShowMemoryMap.h"
 #include "ShowBootOption.h"
+#include "ConfigTables.h"
+#include "MemoryInventory.h"
+#include "FileHelper.h"
+#include "Snapshot.h"
+#include "Batch.h"
 
 // Globals variable for input handling
 EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL *mInputEx = NULL; 
@@ -104,7 +109,7 @@ ShowHelpPopup(VOID)
 
     // Define popup dimensions
     PopupWidth = 55;
-    PopupHeight = 15;
+    PopupHeight = 17;
     PopupLeft = (Columns - PopupWidth) / 2;
     PopupTop = (Rows - PopupHeight) / 2;
 
@@ -149,10 +154,18 @@ ShowHelpPopup(VOID)
     Print(L"F6 : Show Memory Map");
     ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 9);
     Print(L"F7 : Show Boot Options");
-    
+    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 10);
+    Print(L"F8 : Show Configuration Tables");
     ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 11);
+    Print(L"F9 : Show Memory Inventory");
+    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 12);
+    Print(L"F10: Select Export Volume");
+    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 13);
+    Print(L"F11: Capture Snapshot");
+    
+    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 14);
     Print(L"ENTER : View PCI Config Space");
-    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 11);
+    ConOut->SetCursorPosition(ConOut, PopupLeft + 4, PopupTop + 15);
     Print(L"ESC   : Quit");
 
     // Wait for a key press to close the popup
@@ -247,6 +260,26 @@ MainLoop (VOID) {
         NeedRedraw = TRUE;
         break;
 
+      case SCAN_F8:
+        ShowConfigurationTables();
+        NeedRedraw = TRUE;
+        break;
+
+      case SCAN_F9:
+        ShowMemoryInventory();
+        NeedRedraw = TRUE;
+        break;
+
+      case SCAN_F10:
+        SelectExportVolume();
+        NeedRedraw = TRUE;
+        break;
+
+      case SCAN_F11:
+        ShowSnapshotCapture();
+        NeedRedraw = TRUE;
+        break;
+
       // Handle arrow keys and ESC
       case SCAN_UP:
         if (mSelected > 0) { --mSelected; NeedRedraw = TRUE; }
@@ -313,6 +346,14 @@ MainLoop (VOID) {
           mInputEx->ReadKeyStrokeEx(mInputEx, &KeyData);
           NeedRedraw = TRUE;
           break;
+        case L'8':
+          ShowConfigurationTables();
+          NeedRedraw = TRUE;
+          break;
+        case L'9':
+          ShowMemoryInventory();
+          NeedRedraw = TRUE;
+          break;
         default:
           break;
       }
@@ -332,11 +373,23 @@ EFI_STATUS
 EFIAPI
 UefiMain (IN EFI_HANDLE ImageHandle, IN EFI_SYSTEM_TABLE *SystemTable)
 {
-  EFI_STATUS Status;
+  EFI_STATUS    Status;
+  BATCH_OPTIONS Batch;
 
   // Get the main image handle
   gImageHandle = ImageHandle;
 
+  // Flags on the command line run one capture and exit, for startup.nsh and PXE
+  Status = ParseBatchOptions(ImageHandle, &Batch);
+  if (Status != EFI_NOT_FOUND) {
+    if (!EFI_ERROR(Status)) {
+      Status = RunBatch(ImageHandle, &Batch);
+    }
+    FreeBatchOptions(&Batch);
+    FileHelperCloseVolume();
+    return Status;
+  }
+
   // Initialize SimpleTextInputEx protocol for extended key input
   Status = gBS->LocateProtocol(&gEfiSimpleTextInputExProtocolGuid, NULL, (VOID **)&mInputEx);
   if (EFI_ERROR(Status) || mInputEx == NULL) {
@@ -351,5 +404,6 @@ UefiMain (IN EFI_HANDLE ImageHandle, IN EFI_SYSTEM_TABLE *SystemTable)
   }
 
   MainLoop();
+  FileHelperCloseVolume();
   return EFI_SUCCESS;
 }
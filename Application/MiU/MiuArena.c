@@ -0,0 +1,67 @@
+#include <Uefi.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "MiuArena.h"
+
+#define MIU_ARENA_ALIGNMENT  8
+
+EFI_STATUS
+MiuArenaInit (
+  OUT MIU_ARENA  *Arena,
+  IN  UINTN      Size
+  )
+{
+  ZeroMem(Arena, sizeof(*Arena));
+  Arena->Base = AllocatePool(Size);
+  if (Arena->Base == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Arena->Size = Size;
+  return EFI_SUCCESS;
+}
+
+VOID *
+MiuArenaAlloc (
+  IN OUT MIU_ARENA  *Arena,
+  IN     UINTN      Size
+  )
+{
+  UINTN Start = ALIGN_VALUE(Arena->Used, MIU_ARENA_ALIGNMENT);
+
+  if (Start > Arena->Size || Size > Arena->Size - Start) {
+    return NULL;
+  }
+  Arena->Used = Start + Size;
+  Arena->Peak = MAX(Arena->Peak, Arena->Used);
+  return Arena->Base + Start;
+}
+
+UINTN
+MiuArenaAvailable (
+  IN CONST MIU_ARENA  *Arena
+  )
+{
+  UINTN Start = ALIGN_VALUE(Arena->Used, MIU_ARENA_ALIGNMENT);
+
+  return (Start < Arena->Size) ? Arena->Size - Start : 0;
+}
+
+VOID
+MiuArenaReset (
+  IN OUT MIU_ARENA  *Arena
+  )
+{
+  Arena->Used = 0;
+}
+
+VOID
+MiuArenaFree (
+  IN OUT MIU_ARENA  *Arena
+  )
+{
+  if (Arena->Base != NULL) {
+    FreePool(Arena->Base);
+  }
+  ZeroMem(Arena, sizeof(*Arena));
+}
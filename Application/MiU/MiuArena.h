@@ -0,0 +1,57 @@
+#pragma once
+#include <Uefi.h>
+
+//
+// Bump allocator over one pool block. Allocations are never freed one by
+// one; the whole arena is reset at once. The snapshot engine gives every
+// collector the same arena and resets it between them, so the scratch
+// memory of a capture is one block whatever the size of the machine.
+//
+typedef struct {
+  UINT8  *Base;
+  UINTN  Size;
+  UINTN  Used;
+  UINTN  Peak;      // Highest Used since MiuArenaInit()
+} MIU_ARENA;
+
+/**
+  Allocate the arena's block.
+
+  @retval EFI_SUCCESS           The arena is ready and empty.
+  @retval EFI_OUT_OF_RESOURCES  The block could not be allocated.
+**/
+EFI_STATUS
+MiuArenaInit (
+  OUT MIU_ARENA  *Arena,
+  IN  UINTN      Size
+  );
+
+/**
+  Carve Size bytes, 8-byte aligned, out of the arena. The memory is not
+  zeroed.
+
+  @return The memory, or NULL if the arena has no room left.
+**/
+VOID *
+MiuArenaAlloc (
+  IN OUT MIU_ARENA  *Arena,
+  IN     UINTN      Size
+  );
+
+// Bytes MiuArenaAlloc() can still hand out
+UINTN
+MiuArenaAvailable (
+  IN CONST MIU_ARENA  *Arena
+  );
+
+// Drop every allocation; the block stays allocated
+VOID
+MiuArenaReset (
+  IN OUT MIU_ARENA  *Arena
+  );
+
+// Release the block
+VOID
+MiuArenaFree (
+  IN OUT MIU_ARENA  *Arena
+  );
@@ -0,0 +1,259 @@
+#include "MiuLz.h"
+
+//
+// Input within this many bytes of the end is always emitted as literals, so
+// the match search can read 4 bytes without bounds checks.
+//
+#define MIULZ_TAIL_LITERALS  12
+#define MIULZ_HASH_MULTIPLIER  2654435761U
+
+STATIC UINT32   mCrcTable[256];
+STATIC BOOLEAN  mCrcTableReady = FALSE;
+
+STATIC
+UINT32
+MiuLzRead32 (
+  IN CONST UINT8  *Ptr
+  )
+{
+  return (UINT32)Ptr[0] | ((UINT32)Ptr[1] << 8) | ((UINT32)Ptr[2] << 16) | ((UINT32)Ptr[3] << 24);
+}
+
+/**
+  Append a length extension (the part above 15) as 255-bytes and a remainder.
+
+  @return Updated output position, or NULL if it does not fit.
+**/
+STATIC
+UINT8 *
+MiuLzPutLength (
+  IN UINT8  *Out,
+  IN UINT8  *OutEnd,
+  IN UINTN  Length
+  )
+{
+  while (Length >= 255) {
+    if (Out >= OutEnd) {
+      return NULL;
+    }
+    *Out++ = 255;
+    Length -= 255;
+  }
+  if (Out >= OutEnd) {
+    return NULL;
+  }
+  *Out++ = (UINT8)Length;
+  return Out;
+}
+
+/**
+  Emit one sequence: Literals literal bytes, then a match unless MatchLength
+  is 0 (the closing sequence).
+
+  @return Updated output position, or NULL if it does not fit.
+**/
+STATIC
+UINT8 *
+MiuLzPutSequence (
+  IN UINT8        *Out,
+  IN UINT8        *OutEnd,
+  IN CONST UINT8  *Literals,
+  IN UINTN        LiteralCount,
+  IN UINTN        Offset,
+  IN UINTN        MatchLength
+  )
+{
+  UINT8  *Token;
+  UINTN  MatchCode = (MatchLength != 0) ? MatchLength - MIULZ_MIN_MATCH : 0;
+
+  if (Out >= OutEnd) {
+    return NULL;
+  }
+  Token  = Out++;
+  *Token = (UINT8)(((LiteralCount < 15) ? LiteralCount : 15) << 4);
+  if (LiteralCount >= 15) {
+    Out = MiuLzPutLength(Out, OutEnd, LiteralCount - 15);
+    if (Out == NULL) {
+      return NULL;
+    }
+  }
+
+  if ((UINTN)(OutEnd - Out) < LiteralCount) {
+    return NULL;
+  }
+  for (UINTN i = 0; i < LiteralCount; i++) {
+    Out[i] = Literals[i];
+  }
+  Out += LiteralCount;
+
+  if (MatchLength == 0) {
+    return Out;
+  }
+
+  if ((UINTN)(OutEnd - Out) < 2) {
+    return NULL;
+  }
+  *Out++ = (UINT8)Offset;
+  *Out++ = (UINT8)(Offset >> 8);
+  *Token |= (UINT8)((MatchCode < 15) ? MatchCode : 15);
+  if (MatchCode >= 15) {
+    Out = MiuLzPutLength(Out, OutEnd, MatchCode - 15);
+  }
+  return Out;
+}
+
+UINTN
+MiuLzCompress (
+  IN     CONST UINT8  *Src,
+  IN     UINTN        SrcSize,
+  OUT    UINT8        *Dst,
+  IN     UINTN        DstCapacity,
+  IN OUT UINT32       *HashTable
+  )
+{
+  UINT8  *Out    = Dst;
+  UINT8  *OutEnd = Dst + ((DstCapacity < SrcSize) ? DstCapacity : SrcSize);
+  UINTN  Anchor  = 0;
+  UINTN  Pos     = 0;
+  UINTN  Limit;
+
+  for (UINTN i = 0; i < MIULZ_HASH_SIZE; i++) {
+    HashTable[i] = 0;
+  }
+
+  if (SrcSize > MIULZ_TAIL_LITERALS) {
+    Limit = SrcSize - MIULZ_TAIL_LITERALS;
+    while (Pos < Limit) {
+      UINT32 Sequence  = MiuLzRead32(Src + Pos);
+      UINT32 Hash      = (Sequence * MIULZ_HASH_MULTIPLIER) >> (32 - MIULZ_HASH_BITS);
+      UINTN  Candidate = HashTable[Hash];
+      UINTN  Length;
+
+      HashTable[Hash] = (UINT32)Pos;
+      if (Candidate >= Pos || Pos - Candidate > MIULZ_MAX_OFFSET ||
+          MiuLzRead32(Src + Candidate) != Sequence) {
+        // Step faster through data that keeps missing, it is likely incompressible
+        Pos += 1 + ((Pos - Anchor) >> 6);
+        continue;
+      }
+
+      Length = MIULZ_MIN_MATCH;
+      while (Pos + Length < SrcSize - 5 && Src[Candidate + Length] == Src[Pos + Length]) {
+        Length++;
+      }
+
+      Out = MiuLzPutSequence(Out, OutEnd, Src + Anchor, Pos - Anchor, Pos - Candidate, Length);
+      if (Out == NULL) {
+        return 0;
+      }
+      Pos   += Length;
+      Anchor = Pos;
+    }
+  }
+
+  Out = MiuLzPutSequence(Out, OutEnd, Src + Anchor, SrcSize - Anchor, 0, 0);
+  if (Out == NULL || (UINTN)(Out - Dst) >= SrcSize) {
+    return 0;
+  }
+  return (UINTN)(Out - Dst);
+}
+
+UINTN
+MiuLzDecompress (
+  IN  CONST UINT8  *Src,
+  IN  UINTN        SrcSize,
+  OUT UINT8        *Dst,
+  IN  UINTN        DstCapacity
+  )
+{
+  UINTN  In  = 0;
+  UINTN  Out = 0;
+
+  while (In < SrcSize) {
+    UINT8  Token = Src[In++];
+    UINTN  Count = Token >> 4;
+    UINTN  Offset;
+    UINT8  Extra;
+
+    if (Count == 15) {
+      do {
+        if (In >= SrcSize) {
+          return MAX_UINTN;
+        }
+        Extra  = Src[In++];
+        Count += Extra;
+      } while (Extra == 255);
+    }
+    if (Count > SrcSize - In || Count > DstCapacity - Out) {
+      return MAX_UINTN;
+    }
+    for (UINTN i = 0; i < Count; i++) {
+      Dst[Out + i] = Src[In + i];
+    }
+    In  += Count;
+    Out += Count;
+
+    // The closing sequence has no match
+    if (In == SrcSize) {
+      break;
+    }
+
+    if (SrcSize - In < 2) {
+      return MAX_UINTN;
+    }
+    Offset = (UINTN)Src[In] | ((UINTN)Src[In + 1] << 8);
+    In    += 2;
+    if (Offset == 0 || Offset > Out) {
+      return MAX_UINTN;
+    }
+
+    Count = Token & 0x0F;
+    if (Count == 15) {
+      do {
+        if (In >= SrcSize) {
+          return MAX_UINTN;
+        }
+        Extra  = Src[In++];
+        Count += Extra;
+      } while (Extra == 255);
+    }
+    Count += MIULZ_MIN_MATCH;
+    if (Count > DstCapacity - Out) {
+      return MAX_UINTN;
+    }
+    // Byte by byte: the source may overlap what is being written
+    for (UINTN i = 0; i < Count; i++) {
+      Dst[Out + i] = Dst[Out - Offset + i];
+    }
+    Out += Count;
+  }
+
+  return Out;
+}
+
+UINT32
+MiuCrc32Update (
+  IN UINT32      Crc,
+  IN CONST VOID  *Data,
+  IN UINTN       Size
+  )
+{
+  CONST UINT8 *Bytes = (CONST UINT8 *)Data;
+
+  if (!mCrcTableReady) {
+    for (UINT32 n = 0; n < 256; n++) {
+      UINT32 c = n;
+      for (UINTN k = 0; k < 8; k++) {
+        c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+      }
+      mCrcTable[n] = c;
+    }
+    mCrcTableReady = TRUE;
+  }
+
+  Crc = ~Crc;
+  for (UINTN i = 0; i < Size; i++) {
+    Crc = mCrcTable[(Crc ^ Bytes[i]) & 0xFF] ^ (Crc >> 8);
+  }
+  return ~Crc;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <Base.h>
+
+//
+// MiuLz: a small LZ77 block codec in the LZ4 block layout, plus CRC-32.
+// It only uses Base.h types and no library calls, so host tools can build
+// the same file.
+//
+// A compressed block is a run of sequences:
+//   token        high nibble literal count, low nibble match length - 4
+//   [255...]     more literal count bytes when the nibble is 15
+//   literals
+//   offset       UINT16 little-endian distance back, 1..65535
+//   [255...]     more match length bytes when the nibble is 15
+// The last sequence has literals only and ends the block.
+//
+#define MIULZ_MIN_MATCH    4
+#define MIULZ_MAX_OFFSET   0xFFFF
+#define MIULZ_HASH_BITS    12
+#define MIULZ_HASH_SIZE    (1 << MIULZ_HASH_BITS)
+
+// Worst-case output size for Size input bytes
+#define MIULZ_BOUND(Size)  ((Size) + (Size) / 255 + 16)
+
+/**
+  Compress one block.
+
+  @param[in]      Src          Input bytes.
+  @param[in]      SrcSize      Number of input bytes.
+  @param[out]     Dst          Output buffer.
+  @param[in]      DstCapacity  Size of Dst; output that would not fit fails.
+  @param[in,out]  HashTable    Scratch of MIULZ_HASH_SIZE entries.
+
+  @return Compressed size, or 0 if the output is not smaller than the input
+          or does not fit in DstCapacity. The caller then stores the block
+          uncompressed.
+**/
+UINTN
+MiuLzCompress (
+  IN     CONST UINT8  *Src,
+  IN     UINTN        SrcSize,
+  OUT    UINT8        *Dst,
+  IN     UINTN        DstCapacity,
+  IN OUT UINT32       *HashTable
+  );
+
+/**
+  Decompress one block produced by MiuLzCompress().
+
+  @return Number of bytes written to Dst, or MAX_UINTN if the block is
+          malformed or would overflow DstCapacity.
+**/
+UINTN
+MiuLzDecompress (
+  IN  CONST UINT8  *Src,
+  IN  UINTN        SrcSize,
+  OUT UINT8        *Dst,
+  IN  UINTN        DstCapacity
+  );
+
+/**
+  Continue a CRC-32 (IEEE 802.3, as zlib) over more data. Start with 0.
+**/
+UINT32
+MiuCrc32Update (
+  IN UINT32      Crc,
+  IN CONST VOID  *Data,
+  IN UINTN       Size
+  );
@@ -5,8 +5,11 @@ extern EFI_HANDLE gImageHandle;
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/PrintLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Protocol/PciIo.h>
+#include <IndustryStandard/Pci.h>
 #include "PciDevices.h"
+#include "SnapshotFormat.h"
 #include <MiU.h>
 #include "FileHelper.h"
 
@@ -104,6 +107,96 @@ EnumeratePciDevices (VOID)
   return EFI_SUCCESS;
 }
 
+/**
+  TRUE if the device has a PCI Express capability, so its config space is
+  4KB. The walk is bounded in case the list loops.
+*/
+STATIC
+BOOLEAN
+IsPciExpressDevice(
+  IN EFI_PCI_IO_PROTOCOL  *PciIo
+  )
+{
+  UINT16 PciStatus = 0;
+  UINT8  CapPtr    = 0;
+  UINT8  CapId;
+
+  PciIo->Pci.Read(PciIo, EfiPciIoWidthUint16, PCI_PRIMARY_STATUS_OFFSET, 1, &PciStatus);
+  if ((PciStatus & EFI_PCI_STATUS_CAPABILITY) == 0) {
+    return FALSE;
+  }
+
+  PciIo->Pci.Read(PciIo, EfiPciIoWidthUint8, PCI_CAPBILITY_POINTER_OFFSET, 1, &CapPtr);
+  for (UINTN Hops = 0; Hops < 48 && CapPtr >= 0x40; Hops++) {
+    CapPtr &= 0xFC;
+    if (EFI_ERROR(PciIo->Pci.Read(PciIo, EfiPciIoWidthUint8, CapPtr, 1, &CapId))) {
+      return FALSE;
+    }
+    if (CapId == EFI_PCI_CAPABILITY_ID_PCIEXP) {
+      return TRUE;
+    }
+    PciIo->Pci.Read(PciIo, EfiPciIoWidthUint8, CapPtr + 1, 1, &CapPtr);
+  }
+  return FALSE;
+}
+
+EFI_STATUS
+WritePciSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  )
+{
+  EFI_STATUS          Status;
+  SNAPSHOT_PCI_DEVICE Record;
+  UINT8               *Config;
+
+  *Count = 0;
+  if (mPciList == NULL) {
+    Status = EnumeratePciDevices();
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+  }
+
+  Config = MiuArenaAlloc(Arena, SIZE_4KB);
+  if (Config == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = EFI_SUCCESS;
+  for (UINTN Idx = 0; Idx < mPciCount && !EFI_ERROR(Status); Idx++) {
+    PCI_ENTRY *Entry = &mPciList[Idx];
+
+    if (Entry->PciIo == NULL) {
+      continue;
+    }
+
+    ZeroMem(&Record, sizeof(Record));
+    Record.Segment    = Entry->Segment;
+    Record.Bus        = (UINT8)Entry->Bus;
+    Record.Device     = (UINT8)Entry->Dev;
+    Record.Function   = (UINT8)Entry->Func;
+    Record.VendorId   = Entry->VendorId;
+    Record.DeviceId   = Entry->DeviceId;
+    Record.ConfigSize = IsPciExpressDevice(Entry->PciIo) ? SIZE_4KB : 256;
+
+    // One call for the whole space; fall back to the legacy 256 bytes if
+    // the root bridge refuses extended config access
+    if (EFI_ERROR(Entry->PciIo->Pci.Read(Entry->PciIo, EfiPciIoWidthUint32, 0,
+                                         Record.ConfigSize / 4, Config))) {
+      Record.ConfigSize = 256;
+      SetMem(Config, Record.ConfigSize, 0xFF);
+      Entry->PciIo->Pci.Read(Entry->PciIo, EfiPciIoWidthUint32, 0, Record.ConfigSize / 4, Config);
+    }
+
+    FileWriterAppend(Writer, &Record, sizeof(Record));
+    Status = FileWriterAppend(Writer, Config, Record.ConfigSize);
+    (*Count)++;
+  }
+  return Status;
+}
+
 /**
   Read and display the 256-byte PCI configuration space of @p Entry as a
   16x16 hexadecimal dump.
@@ -213,19 +306,26 @@ ShowPCIConfigSpace(PCI_ENTRY *Entry)
   
     // Check if the key is ctrl+S (0x13)
     if (Key.UnicodeChar == 0x13) {
-      // Save the config space to a file
-      EFI_STATUS Status = SaveBytesToFile(
-        gImageHandle,
-        L"pci_config_dump.bin",
-        Data,
-        sizeof(Data)
-      );
+      // Save the config space to a file named after the BDF
+      CHAR16     Stem[32];
+      CHAR16     FileName[64];
+      UnicodeSPrint(Stem, sizeof(Stem), L"pci_%04x_%02x_%02x_%x",
+                    Entry->Segment, Entry->Bus, Entry->Dev, Entry->Func);
+      EFI_STATUS Status = MakeExportFileName(gImageHandle, Stem, L"bin", FileName, sizeof(FileName));
+      if (!EFI_ERROR(Status)) {
+        Status = SaveBytesToFile(
+          gImageHandle,
+          FileName,
+          Data,
+          sizeof(Data)
+        );
+      }
       // Print the result
       gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
       if (EFI_ERROR(Status)) {
         Print(L"\nSave failed: %r\n", Status);
       } else {
-        Print(L"\nSaved to pci_config_dump.bin\n");
+        Print(L"\nSaved to %s\n", FileName);
       }
       // Wait for a key before continuing
       gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
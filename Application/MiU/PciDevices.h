@@ -1,6 +1,8 @@
 #pragma once
 #include <Uefi.h>
 #include <Protocol/PciIo.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
 
 // PCI device entry structure
 typedef struct {
@@ -25,5 +27,9 @@ extern UINTN      mSelected;
 // Lookup human-readable name from Vendor and Device IDs
 CONST CHAR16* GetPciDeviceName(IN UINT16 VendorId, IN UINT16 DeviceId);
 
+// Every device as SNAPSHOT_PCI_DEVICE + config space into a snapshot section;
+// the config space is read into 4KB of Arena
+EFI_STATUS WritePciSnapshotSection(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena, OUT UINTN *Count);
+
 // Show the 256-byte PCI configuration space in a 16x16 hex dump format
 void ShowPCIConfigSpace(PCI_ENTRY *Entry); 
\ No newline at end of file
@@ -0,0 +1,744 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Guid/ImageAuthentication.h>
+#include <Guid/GlobalVariable.h>
+#include "SecureBoot.h"
+#include "GuidNames.h"
+
+#define MAX_HASH_SIZE       64     // SHA-512
+#define MAX_NAME_TEXT       72     // Characters of subject/issuer shown per row
+#define MAX_ROW_TEXT        200    // One formatted row, before it is cut to the screen
+
+STATIC EFI_GUID mImageSecurityDatabaseGuid = EFI_IMAGE_SECURITY_DATABASE_GUID;
+STATIC EFI_GUID mCertSha1Guid              = EFI_CERT_SHA1_GUID;
+STATIC EFI_GUID mCertSha256Guid            = EFI_CERT_SHA256_GUID;
+STATIC EFI_GUID mCertSha384Guid            = EFI_CERT_SHA384_GUID;
+STATIC EFI_GUID mCertSha512Guid            = EFI_CERT_SHA512_GUID;
+STATIC EFI_GUID mCertX509Guid              = EFI_CERT_X509_GUID;
+
+typedef enum {
+  SigRowList,           // EFI_SIGNATURE_LIST header
+  SigRowHash,           // Image hash entry
+  SigRowCertSubject,    // X.509 entry, subject line
+  SigRowCertIssuer,     // X.509 entry, issuer line
+  SigRowOther           // Any other signature type
+} SIG_ROW_KIND;
+
+// One screen row of the decoded view, rendered lazily when it is visible
+typedef struct {
+  SIG_ROW_KIND               Kind;
+  UINTN                      ListIndex;
+  UINTN                      EntryIndex;
+  CONST EFI_SIGNATURE_LIST   *List;
+  CONST EFI_SIGNATURE_DATA   *Entry;
+  BOOLEAN                    MixedOwners;   // The list's entries have different owners
+} SIG_ROW;
+
+// Sorted index over every hash entry, for binary-search lookups
+typedef struct {
+  CONST UINT8    *Hash;
+  UINTN          HashSize;
+  UINTN          ListIndex;
+  UINTN          EntryIndex;
+} SIG_HASH_KEY;
+
+/**
+  Return the digest size for a hash signature type, or 0 for anything else.
+**/
+STATIC
+UINTN
+HashSizeOfType(
+  IN CONST EFI_GUID  *Type
+  )
+{
+  if (CompareGuid(Type, &mCertSha256Guid)) return 32;
+  if (CompareGuid(Type, &mCertSha1Guid))   return 20;
+  if (CompareGuid(Type, &mCertSha384Guid)) return 48;
+  if (CompareGuid(Type, &mCertSha512Guid)) return 64;
+  return 0;
+}
+
+BOOLEAN
+IsSignatureDatabase(
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  if (CompareGuid(VendorGuid, &mImageSecurityDatabaseGuid)) {
+    return (StrCmp(Name, L"db") == 0 || StrCmp(Name, L"dbx") == 0 ||
+            StrCmp(Name, L"dbt") == 0 || StrCmp(Name, L"dbr") == 0);
+  }
+  if (CompareGuid(VendorGuid, &gEfiGlobalVariableGuid)) {
+    return (StrCmp(Name, L"PK") == 0        || StrCmp(Name, L"KEK") == 0 ||
+            StrCmp(Name, L"PKDefault") == 0 || StrCmp(Name, L"KEKDefault") == 0 ||
+            StrCmp(Name, L"dbDefault") == 0 || StrCmp(Name, L"dbxDefault") == 0 ||
+            StrCmp(Name, L"dbtDefault") == 0 || StrCmp(Name, L"dbrDefault") == 0);
+  }
+  return FALSE;
+}
+
+/**
+  Check that a signature list fits the buffer and its entries tile exactly.
+**/
+STATIC
+BOOLEAN
+IsSignatureListValid(
+  IN CONST EFI_SIGNATURE_LIST  *List,
+  IN UINTN                     Remaining
+  )
+{
+  UINTN Body;
+
+  if (Remaining < sizeof(EFI_SIGNATURE_LIST) ||
+      List->SignatureListSize > Remaining ||
+      List->SignatureListSize < sizeof(EFI_SIGNATURE_LIST) + List->SignatureHeaderSize ||
+      List->SignatureSize < sizeof(EFI_GUID)) {
+    return FALSE;
+  }
+  Body = List->SignatureListSize - sizeof(EFI_SIGNATURE_LIST) - List->SignatureHeaderSize;
+  return (Body % List->SignatureSize) == 0;
+}
+
+STATIC
+UINTN
+SignatureCount(
+  IN CONST EFI_SIGNATURE_LIST  *List
+  )
+{
+  return (List->SignatureListSize - sizeof(EFI_SIGNATURE_LIST) - List->SignatureHeaderSize) /
+         List->SignatureSize;
+}
+
+STATIC
+CONST EFI_SIGNATURE_DATA *
+SignatureAt(
+  IN CONST EFI_SIGNATURE_LIST  *List,
+  IN UINTN                     Index
+  )
+{
+  return (CONST EFI_SIGNATURE_DATA *)((CONST UINT8 *)List + sizeof(EFI_SIGNATURE_LIST) +
+                                      List->SignatureHeaderSize + Index * List->SignatureSize);
+}
+
+//
+// Minimal DER reader: just enough to walk TBSCertificate to the issuer and
+// subject Names. Anything unexpected makes the caller print "<unparsed>".
+//
+
+/**
+  Read one TLV header at *Ptr. On success *Ptr points at the value.
+**/
+STATIC
+BOOLEAN
+DerReadHeader(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End,
+  OUT    UINT8        *Tag,
+  OUT    UINTN        *Length
+  )
+{
+  CONST UINT8 *P = *Ptr;
+  UINTN       Len;
+
+  if (P + 2 > End) {
+    return FALSE;
+  }
+  *Tag = *P++;
+  Len  = *P++;
+  if (Len & 0x80) {
+    UINTN Octets = Len & 0x7F;
+    if (Octets == 0 || Octets > 4 || P + Octets > End) {
+      return FALSE;
+    }
+    Len = 0;
+    while (Octets-- > 0) {
+      Len = (Len << 8) | *P++;
+    }
+  }
+  if (Len > (UINTN)(End - P)) {
+    return FALSE;
+  }
+  *Ptr    = P;
+  *Length = Len;
+  return TRUE;
+}
+
+/**
+  Skip one whole TLV element.
+**/
+STATIC
+BOOLEAN
+DerSkip(
+  IN OUT CONST UINT8  **Ptr,
+  IN     CONST UINT8  *End
+  )
+{
+  UINT8 Tag;
+  UINTN Length;
+
+  if (!DerReadHeader(Ptr, End, &Tag, &Length)) {
+    return FALSE;
+  }
+  *Ptr += Length;
+  return TRUE;
+}
+
+/**
+  Locate the issuer and subject Name elements of a DER certificate.
+**/
+STATIC
+BOOLEAN
+X509FindNames(
+  IN  CONST UINT8  *Cert,
+  IN  UINTN        CertSize,
+  OUT CONST UINT8  **Issuer,
+  OUT CONST UINT8  **Subject,
+  OUT CONST UINT8  **End
+  )
+{
+  CONST UINT8 *P    = Cert;
+  CONST UINT8 *Stop = Cert + CertSize;
+  UINT8       Tag;
+  UINTN       Length;
+
+  // Certificate SEQUENCE, then TBSCertificate SEQUENCE
+  if (!DerReadHeader(&P, Stop, &Tag, &Length) || Tag != 0x30) return FALSE;
+  Stop = P + Length;
+  if (!DerReadHeader(&P, Stop, &Tag, &Length) || Tag != 0x30) return FALSE;
+  Stop = P + Length;
+
+  // Optional [0] version
+  if (P < Stop && *P == 0xA0 && !DerSkip(&P, Stop)) return FALSE;
+  // serialNumber, signature AlgorithmIdentifier
+  if (!DerSkip(&P, Stop) || !DerSkip(&P, Stop)) return FALSE;
+
+  *Issuer = P;
+  if (!DerSkip(&P, Stop)) return FALSE;
+  // validity
+  if (!DerSkip(&P, Stop)) return FALSE;
+  *Subject = P;
+  *End     = Stop;
+  return TRUE;
+}
+
+/**
+  Render an X.501 Name as "CN=..., O=..." (CN, O, OU and C only).
+**/
+STATIC
+VOID
+X509NameToText(
+  IN  CONST UINT8  *Name,
+  IN  CONST UINT8  *End,
+  OUT CHAR16       *Text,
+  IN  UINTN        TextCount
+  )
+{
+  STATIC CONST struct {
+    UINT8           Oid;      // Last arc of 2.5.4.x
+    CONST CHAR16    *Label;
+  } Attributes[] = { { 3, L"CN" }, { 10, L"O" }, { 11, L"OU" }, { 6, L"C" } };
+
+  CONST UINT8 *P = Name;
+  CONST UINT8 *NameEnd;
+  UINT8       Tag;
+  UINTN       Length;
+  UINTN       Out = 0;
+
+  Text[0] = L'\0';
+  if (!DerReadHeader(&P, End, &Tag, &Length) || Tag != 0x30) {
+    StrCpyS(Text, TextCount, L"<unparsed>");
+    return;
+  }
+  NameEnd = P + Length;
+
+  // SEQUENCE OF RelativeDistinguishedName (SET OF AttributeTypeAndValue)
+  while (P < NameEnd) {
+    CONST UINT8 *SetEnd;
+    if (!DerReadHeader(&P, NameEnd, &Tag, &Length) || Tag != 0x31) break;
+    SetEnd = P + Length;
+
+    while (P < SetEnd) {
+      CONST UINT8 *AttrEnd;
+      CONST UINT8 *Oid;
+      UINTN       OidLength;
+
+      if (!DerReadHeader(&P, SetEnd, &Tag, &Length) || Tag != 0x30) break;
+      AttrEnd = P + Length;
+      if (!DerReadHeader(&P, AttrEnd, &Tag, &OidLength) || Tag != 0x06) break;
+      Oid = P;
+      P  += OidLength;
+      if (!DerReadHeader(&P, AttrEnd, &Tag, &Length)) break;
+
+      // id-at = 2.5.4 encodes as 55 04 xx
+      if (OidLength == 3 && Oid[0] == 0x55 && Oid[1] == 0x04) {
+        for (UINTN a = 0; a < ARRAY_SIZE(Attributes); a++) {
+          if (Attributes[a].Oid != Oid[2]) continue;
+
+          if (Out != 0 && Out + 2 < TextCount) {
+            Text[Out++] = L',';
+            Text[Out++] = L' ';
+          }
+          for (CONST CHAR16 *L = Attributes[a].Label; *L != L'\0' && Out + 1 < TextCount; L++) {
+            Text[Out++] = *L;
+          }
+          if (Out + 1 < TextCount) Text[Out++] = L'=';
+
+          // BMPString is UTF-16BE; everything else is shown byte by byte
+          if (Tag == 0x1E) {
+            for (UINTN c = 0; c + 1 < Length && Out + 1 < TextCount; c += 2) {
+              CHAR16 Ch = (CHAR16)((P[c] << 8) | P[c + 1]);
+              Text[Out++] = (Ch >= 0x20 && Ch < 0x7F) ? Ch : L'?';
+            }
+          } else {
+            for (UINTN c = 0; c < Length && Out + 1 < TextCount; c++) {
+              Text[Out++] = (P[c] >= 0x20 && P[c] < 0x7F) ? (CHAR16)P[c] : L'?';
+            }
+          }
+          break;
+        }
+      }
+      P = AttrEnd;
+    }
+    P = SetEnd;
+  }
+  Text[Out] = L'\0';
+}
+
+STATIC
+INTN
+EFIAPI
+CompareHashKeys(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST SIG_HASH_KEY *A = (CONST SIG_HASH_KEY *)Buffer1;
+  CONST SIG_HASH_KEY *B = (CONST SIG_HASH_KEY *)Buffer2;
+
+  if (A->HashSize != B->HashSize) {
+    return (A->HashSize < B->HashSize) ? -1 : 1;
+  }
+  return CompareMem(A->Hash, B->Hash, A->HashSize);
+}
+
+/**
+  Binary search the sorted hash index.
+
+  @return Index into Keys, or -1 if the hash is not present.
+**/
+STATIC
+INTN
+FindHash(
+  IN CONST SIG_HASH_KEY  *Keys,
+  IN UINTN               KeyCount,
+  IN CONST UINT8         *Hash,
+  IN UINTN               HashSize
+  )
+{
+  SIG_HASH_KEY Probe;
+  UINTN        Low  = 0;
+  UINTN        High = KeyCount;
+
+  Probe.Hash     = Hash;
+  Probe.HashSize = HashSize;
+
+  while (Low < High) {
+    UINTN Mid    = Low + (High - Low) / 2;
+    INTN  Result = CompareHashKeys(&Probe, &Keys[Mid]);
+    if (Result == 0) {
+      return (INTN)Mid;
+    }
+    if (Result < 0) {
+      High = Mid;
+    } else {
+      Low = Mid + 1;
+    }
+  }
+  return -1;
+}
+
+/**
+  Prompt for a hex digest (40, 64, 96 or 128 digits).
+
+  @retval TRUE   Hash and HashSize were filled in.
+  @retval FALSE  The user pressed ESC.
+**/
+STATIC
+BOOLEAN
+PromptHashHex(
+  OUT UINT8  *Hash,
+  OUT UINTN  *HashSize
+  )
+{
+  CHAR16        Buffer[MAX_HASH_SIZE * 2 + 1];
+  UINTN         Index = 0;
+  EFI_INPUT_KEY Key;
+
+  gST->ConOut->ClearScreen(gST->ConOut);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  Print(L"Look up an image hash\n\n");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"Enter a SHA-1/256/384/512 digest in hex, then press Enter.  ESC to cancel.\n\n");
+  Print(L"Hash: ");
+  gST->ConOut->EnableCursor(gST->ConOut, TRUE);
+
+  while (TRUE) {
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
+      if (Index == 40 || Index == 64 || Index == 96 || Index == 128) {
+        for (UINTN i = 0; i < Index; i += 2) {
+          CHAR16 Pair[3] = { Buffer[i], Buffer[i + 1], L'\0' };
+          Hash[i / 2] = (UINT8)StrHexToUintn(Pair);
+        }
+        *HashSize = Index / 2;
+        gST->ConOut->EnableCursor(gST->ConOut, FALSE);
+        return TRUE;
+      }
+      // Not a known digest length, keep waiting
+    } else if (Key.ScanCode == SCAN_ESC) {
+      gST->ConOut->EnableCursor(gST->ConOut, FALSE);
+      return FALSE;
+    } else if (Key.UnicodeChar == CHAR_BACKSPACE && Index > 0) {
+      Index--;
+      Print(L"\b \b");
+    } else if (Index < MAX_HASH_SIZE * 2 &&
+              ((Key.UnicodeChar >= L'0' && Key.UnicodeChar <= L'9') ||
+               (Key.UnicodeChar >= L'a' && Key.UnicodeChar <= L'f') ||
+               (Key.UnicodeChar >= L'A' && Key.UnicodeChar <= L'F'))) {
+      Buffer[Index++] = Key.UnicodeChar;
+      Print(L"%c", Key.UnicodeChar);
+    }
+  }
+}
+
+/**
+  Owner GUID of a signature list: its name or GUID text in Text, and FALSE if
+  the entries do not all share the first entry's owner.
+**/
+STATIC
+BOOLEAN
+GetListOwner(
+  IN  CONST EFI_SIGNATURE_LIST  *List,
+  OUT CHAR16                    *Text,
+  IN  UINTN                     TextSize
+  )
+{
+  UINTN          Count = SignatureCount(List);
+  CONST EFI_GUID *Owner;
+
+  Text[0] = L'\0';
+  if (Count == 0) {
+    return TRUE;
+  }
+  Owner = &SignatureAt(List, 0)->SignatureOwner;
+  for (UINTN i = 1; i < Count; i++) {
+    if (!CompareGuid(&SignatureAt(List, i)->SignatureOwner, Owner)) {
+      return FALSE;
+    }
+  }
+  if (GetGuidName(Owner) != NULL) {
+    UnicodeSPrint(Text, TextSize, L"%s", GetGuidName(Owner));
+  } else {
+    UnicodeSPrint(Text, TextSize, L"%g", Owner);
+  }
+  return TRUE;
+}
+
+/**
+  Print one row of the decoded view, cut to the screen width with "..." so
+  long hashes and names never wrap. Entries of a list with mixed owners
+  carry their own owner; otherwise the list row names the one owner.
+**/
+STATIC
+VOID
+DrawSignatureRow(
+  IN CONST SIG_ROW  *Row,
+  IN BOOLEAN        Selected,
+  IN UINTN          Columns
+  )
+{
+  UINTN   Background = Selected ? EFI_GREEN : EFI_BLUE;
+  UINTN   Width      = (Columns > 4) ? (Columns - 1) : 3;
+  CHAR16  Line[MAX_ROW_TEXT];
+  CHAR16  Owner[40];
+  UINTN   Length;
+
+  // Entry rows start with the index, then the owner when it varies
+  Line[0] = L'\0';
+  if (Row->Kind != SigRowList && Row->Kind != SigRowCertIssuer) {
+    UnicodeSPrint(Line, sizeof(Line), L"  %4u ", Row->EntryIndex);
+    if (Row->MixedOwners) {
+      CONST EFI_GUID *Guid = &Row->Entry->SignatureOwner;
+      CONST CHAR16   *Name = GetGuidName(Guid);
+
+      Length = StrLen(Line);
+      if (Name != NULL) {
+        UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L"[%s] ", Name);
+      } else {
+        UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L"[%g] ", Guid);
+      }
+    }
+  }
+  Length = StrLen(Line);
+
+  switch (Row->Kind) {
+    case SigRowList: {
+      CONST CHAR16 *TypeName = GetGuidName(&Row->List->SignatureType);
+      UINTN        Count     = SignatureCount(Row->List);
+
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, Background));
+      if (TypeName != NULL) {
+        UnicodeSPrint(Line, sizeof(Line), L"List %u: %-16s", Row->ListIndex, TypeName);
+      } else {
+        UnicodeSPrint(Line, sizeof(Line), L"List %u: %g", Row->ListIndex, &Row->List->SignatureType);
+      }
+      Length = StrLen(Line);
+      UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L" %u entr%s, %u bytes each",
+                    Count, (Count == 1) ? L"y" : L"ies", Row->List->SignatureSize);
+      Length = StrLen(Line);
+      if (Row->MixedOwners) {
+        StrCatS(Line, ARRAY_SIZE(Line), L", mixed owners");
+      } else if (Count > 0) {
+        GetListOwner(Row->List, Owner, sizeof(Owner));
+        UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L", owner %s", Owner);
+      }
+      break;
+    }
+
+    case SigRowHash: {
+      UINTN HashSize = HashSizeOfType(&Row->List->SignatureType);
+
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, Background));
+      for (UINTN i = 0; i < HashSize && Length + 2 < ARRAY_SIZE(Line); i++) {
+        UnicodeSPrint(Line + Length, 3 * sizeof(CHAR16), L"%02x", Row->Entry->SignatureData[i]);
+        Length += 2;
+      }
+      break;
+    }
+
+    case SigRowCertSubject:
+    case SigRowCertIssuer: {
+      CHAR16      Text[MAX_NAME_TEXT];
+      CONST UINT8 *Issuer;
+      CONST UINT8 *Subject;
+      CONST UINT8 *End;
+      UINTN       CertSize = Row->List->SignatureSize - sizeof(EFI_GUID);
+
+      if (X509FindNames(Row->Entry->SignatureData, CertSize, &Issuer, &Subject, &End)) {
+        X509NameToText((Row->Kind == SigRowCertSubject) ? Subject : Issuer, End, Text, ARRAY_SIZE(Text));
+      } else {
+        StrCpyS(Text, ARRAY_SIZE(Text), L"<unparsed certificate>");
+      }
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, Background));
+      if (Row->Kind == SigRowCertSubject) {
+        UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L"Subject: %s", Text);
+      } else {
+        UnicodeSPrint(Line, sizeof(Line), L"       Issuer:  %s", Text);
+      }
+      break;
+    }
+
+    default:
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, Background));
+      UnicodeSPrint(Line + Length, sizeof(Line) - Length * sizeof(CHAR16), L"%u bytes of signature data",
+                    Row->List->SignatureSize - sizeof(EFI_GUID));
+      break;
+  }
+
+  if (StrLen(Line) > Width) {
+    StrCpyS(Line + Width - 3, ARRAY_SIZE(Line) - (Width - 3), L"...");
+  }
+  Print(L"%s\n", Line);
+}
+
+VOID
+ShowSignatureDatabase(
+  IN CONST CHAR16  *Name,
+  IN CONST UINT8   *Data,
+  IN UINTN         DataSize
+  )
+{
+  SIG_ROW       *Rows;
+  SIG_HASH_KEY  *Keys;
+  SIG_HASH_KEY  KeyScratch;
+  UINTN         RowCount  = 0;
+  UINTN         KeyCount  = 0;
+  UINTN         ListCount = 0;
+  UINTN         Offset;
+  BOOLEAN       Truncated = FALSE;
+  UINTN         Columns, ScreenRows, Visible;
+  UINTN         Top = 0, Selected = 0;
+  EFI_INPUT_KEY Key;
+
+  //
+  // Pass 1: validate the lists and count rows and hash keys
+  //
+  for (Offset = 0; Offset < DataSize; ) {
+    CONST EFI_SIGNATURE_LIST *List = (CONST EFI_SIGNATURE_LIST *)(Data + Offset);
+    UINTN                    Count;
+
+    if (!IsSignatureListValid(List, DataSize - Offset)) {
+      Truncated = TRUE;
+      break;
+    }
+    Count = SignatureCount(List);
+    RowCount += 1 + (CompareGuid(&List->SignatureType, &mCertX509Guid) ? 2 * Count : Count);
+    if (HashSizeOfType(&List->SignatureType) != 0 &&
+        List->SignatureSize >= sizeof(EFI_GUID) + HashSizeOfType(&List->SignatureType)) {
+      KeyCount += Count;
+    }
+    Offset += List->SignatureListSize;
+  }
+
+  Rows = AllocateZeroPool(sizeof(*Rows) * (RowCount + 1));
+  Keys = AllocateZeroPool(sizeof(*Keys) * (KeyCount + 1));
+  if (Rows == NULL || Keys == NULL) {
+    if (Rows != NULL) FreePool(Rows);
+    if (Keys != NULL) FreePool(Keys);
+    Print(L"Out of resources\n");
+    return;
+  }
+
+  //
+  // Pass 2: fill the row table and the hash index
+  //
+  RowCount = 0;
+  KeyCount = 0;
+  for (Offset = 0; Offset < DataSize; ListCount++) {
+    CONST EFI_SIGNATURE_LIST *List = (CONST EFI_SIGNATURE_LIST *)(Data + Offset);
+    BOOLEAN                  IsCert;
+    BOOLEAN                  MixedOwners;
+    CHAR16                   OwnerText[40];
+    UINTN                    HashSize;
+
+    if (!IsSignatureListValid(List, DataSize - Offset)) {
+      break;
+    }
+    IsCert   = CompareGuid(&List->SignatureType, &mCertX509Guid);
+    HashSize = HashSizeOfType(&List->SignatureType);
+    if (List->SignatureSize < sizeof(EFI_GUID) + HashSize) {
+      HashSize = 0;
+    }
+
+    Rows[RowCount].Kind        = SigRowList;
+    Rows[RowCount].ListIndex   = ListCount;
+    Rows[RowCount].List        = List;
+    Rows[RowCount].MixedOwners = !GetListOwner(List, OwnerText, sizeof(OwnerText));
+    MixedOwners                = Rows[RowCount].MixedOwners;
+    RowCount++;
+
+    for (UINTN i = 0; i < SignatureCount(List); i++) {
+      CONST EFI_SIGNATURE_DATA *Entry = SignatureAt(List, i);
+
+      Rows[RowCount].Kind        = IsCert ? SigRowCertSubject : (HashSize != 0 ? SigRowHash : SigRowOther);
+      Rows[RowCount].ListIndex   = ListCount;
+      Rows[RowCount].EntryIndex  = i;
+      Rows[RowCount].List        = List;
+      Rows[RowCount].Entry       = Entry;
+      Rows[RowCount].MixedOwners = MixedOwners;
+      RowCount++;
+      if (IsCert) {
+        Rows[RowCount]      = Rows[RowCount - 1];
+        Rows[RowCount].Kind = SigRowCertIssuer;
+        RowCount++;
+      }
+
+      if (HashSize != 0) {
+        Keys[KeyCount].Hash       = Entry->SignatureData;
+        Keys[KeyCount].HashSize   = HashSize;
+        Keys[KeyCount].ListIndex  = ListCount;
+        Keys[KeyCount].EntryIndex = i;
+        KeyCount++;
+      }
+    }
+    Offset += List->SignatureListSize;
+  }
+
+  QuickSort(Keys, KeyCount, sizeof(*Keys), CompareHashKeys, &KeyScratch);
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &ScreenRows);
+  Visible = (ScreenRows > 5) ? (ScreenRows - 5) : 1;
+
+  for (;;) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" %s: %u signature lists, %u indexed hashes%s\n",
+          Name, ListCount, KeyCount, Truncated ? L" (malformed tail ignored)" : L"");
+
+    // Only the rows on screen are rendered, so large dbx files stay fast
+    for (UINTN i = Top; i < RowCount && i < Top + Visible; i++) {
+      DrawSignatureRow(&Rows[i], i == Selected, Columns);
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nUp/Down/PgUp/PgDn scroll, 'f' find hash, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.UnicodeChar == L'f' || Key.UnicodeChar == L'F') {
+      UINT8 Hash[MAX_HASH_SIZE];
+      UINTN HashSize;
+
+      if (PromptHashHex(Hash, &HashSize)) {
+        INTN Found = FindHash(Keys, KeyCount, Hash, HashSize);
+
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+        if (Found >= 0) {
+          Print(L"\n\nFOUND in %s: list %u, entry %u\n", Name, Keys[Found].ListIndex, Keys[Found].EntryIndex);
+          // Move the selection onto the matching row
+          for (UINTN i = 0; i < RowCount; i++) {
+            if (Rows[i].Kind == SigRowHash && Rows[i].ListIndex == Keys[Found].ListIndex &&
+                Rows[i].EntryIndex == Keys[Found].EntryIndex) {
+              Selected = i;
+              Top      = (i >= Visible / 2) ? (i - Visible / 2) : 0;
+              break;
+            }
+          }
+        } else {
+          Print(L"\n\nNot present in %s\n", Name);
+        }
+        Print(L"Press any key...");
+        gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+        gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+      }
+      continue;
+    }
+
+    switch (Key.ScanCode) {
+      case SCAN_UP:
+        if (Selected > 0) Selected--;
+        break;
+      case SCAN_DOWN:
+        if (Selected + 1 < RowCount) Selected++;
+        break;
+      case SCAN_PAGE_UP:
+        Selected = (Selected > Visible) ? (Selected - Visible) : 0;
+        break;
+      case SCAN_PAGE_DOWN:
+        Selected = (Selected + Visible < RowCount) ? (Selected + Visible) : (RowCount > 0 ? RowCount - 1 : 0);
+        break;
+      case SCAN_ESC:
+        FreePool(Keys);
+        FreePool(Rows);
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+        return;
+      default:
+        break;
+    }
+
+    // Keep the selection inside the window
+    if (Selected < Top) {
+      Top = Selected;
+    } else if (Selected >= Top + Visible) {
+      Top = Selected - Visible + 1;
+    }
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <Uefi.h>
+
+/**
+  Tell whether a variable holds EFI_SIGNATURE_LISTs (PK, KEK, db, dbx, dbt,
+  dbr and the *Default copies).
+
+  @param[in]  Name        Variable name.
+  @param[in]  VendorGuid  Variable vendor GUID.
+
+  @retval TRUE   The variable is a signature database.
+  @retval FALSE  Anything else.
+**/
+BOOLEAN
+IsSignatureDatabase(
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *VendorGuid
+  );
+
+/**
+  Decoded view of a signature database: one header per EFI_SIGNATURE_LIST
+  with type, owner and entry count, hashes in hex and subject/issuer for
+  X.509 certificates. 'f' looks up a hash through a sorted index.
+
+  @param[in]  Name      Variable name, for the title.
+  @param[in]  Data      Variable data.
+  @param[in]  DataSize  Size of Data in bytes.
+**/
+VOID
+ShowSignatureDatabase(
+  IN CONST CHAR16  *Name,
+  IN CONST UINT8   *Data,
+  IN UINTN         DataSize
+  );
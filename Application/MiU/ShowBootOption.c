@@ -5,25 +5,12 @@
 #include <Protocol/LoadedImage.h>
 #include <Protocol/DevicePath.h>
 #include "FileHelper.h"
-
-/**
-  Display all Boot#### variables in the system.
-
-  @retval EFI_SUCCESS     Successfully displayed all boot options.
-  @retval Others          Failed to get or display boot options.
-**/
-typedef struct {
-  CHAR16    Name[16];       // Boot#### format
-  CHAR16    Description[256];
-  UINT32    Attributes;
-  UINTN     DataSize;
-  UINT8     *Data;
-} BOOT_OPTION_ENTRY;
+#include "LoadOption.h"
 
 STATIC
 VOID
 ShowBootOptionData(
-  IN BOOT_OPTION_ENTRY  *BootEntry
+  IN LOAD_OPTION_ENTRY  *BootEntry
   )
 {
   EFI_INPUT_KEY Key;
@@ -120,6 +107,199 @@ ShowBootOptionData(
   gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
 }
 
+/**
+  Category and flag names of the load option attributes.
+**/
+STATIC
+VOID
+FormatLoadAttributes(
+  IN  UINT32  Attributes,
+  OUT CHAR16  *Buffer,
+  IN  UINTN   BufferSize
+  )
+{
+  UnicodeSPrint(Buffer, BufferSize, L"0x%08X %s%s%s%s",
+                Attributes,
+                ((Attributes & LOAD_OPTION_CATEGORY) == LOAD_OPTION_CATEGORY_APP) ? L"APP" :
+                ((Attributes & LOAD_OPTION_CATEGORY) == LOAD_OPTION_CATEGORY_BOOT) ? L"BOOT" : L"CATEGORY?",
+                (Attributes & LOAD_OPTION_ACTIVE) ? L" ACTIVE" : L" INACTIVE",
+                (Attributes & LOAD_OPTION_HIDDEN) ? L" HIDDEN" : L"",
+                (Attributes & LOAD_OPTION_FORCE_RECONNECT) ? L" FORCE_RECONNECT" : L"");
+}
+
+/**
+  Decoded view of one load option: attributes, description, every device
+  path node and the optional data. 'H' opens the raw hex dump.
+**/
+STATIC
+VOID
+ShowBootOptionDetails(
+  IN LOAD_OPTION_ENTRY  *BootEntry
+  )
+{
+  EFI_INPUT_KEY Key;
+  UINTN         Columns, Rows;
+  UINTN         Visible;
+  UINTN         Top = 0;
+  UINTN         Width;
+  CHAR16        Flags[64];
+  BOOLEAN       ExitView = FALSE;
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  // Text of a node starts after the 24 column type/length prefix
+  Width = (Columns > 26) ? Columns - 26 : 1;
+  // Ten lines of fields above the node list, three footer lines below
+  Visible = (Rows > 15) ? Rows - 14 : 1;
+
+  while (!ExitView) {
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L"=== %s ===\n", BootEntry->Name);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Description     : ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"%.*s\n", Width + 8, BootEntry->Description);
+
+    FormatLoadAttributes(BootEntry->LoadAttributes, Flags, sizeof(Flags));
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Attributes      : ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"%s\n", BootEntry->Valid ? Flags : L"-");
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Variable        : ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"0x%X bytes, attributes 0x%08X\n", BootEntry->DataSize, BootEntry->Attributes);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Order           : ");
+    if (BootEntry->Type == LoadOptionTypePlatformRecovery) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"tried in numeric order");
+    } else if (BootEntry->OrderPosition != 0) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"position %d in %sOrder", BootEntry->OrderPosition, LoadOptionTypeName(BootEntry->Type));
+    } else {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L"not in %sOrder (orphan)", LoadOptionTypeName(BootEntry->Type));
+    }
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"%s%s\n",
+          (BootEntry->Flags & LOAD_OPTION_FLAG_BOOT_CURRENT) ? L", BootCurrent" : L"",
+          (BootEntry->Flags & LOAD_OPTION_FLAG_BOOT_NEXT) ? L", BootNext" : L"");
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"FilePathList    : ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"0x%X bytes, %d path(s), %d node(s)\n",
+          BootEntry->FilePathListLength, BootEntry->InstanceCount, BootEntry->NodeCount);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Optional data   : ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L"0x%X bytes", BootEntry->OptionalDataSize);
+    for (UINTN i = 0; i < BootEntry->OptionalDataSize && i < 16; i++) {
+      Print(L" %02x", BootEntry->OptionalData[i]);
+    }
+    Print(L"%s\n", (BootEntry->OptionalDataSize > 16) ? L" ..." : L"");
+
+    if (!BootEntry->Valid) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L" ! Malformed EFI_LOAD_OPTION, see the hex dump\n");
+    } else if (BootEntry->PathTruncated) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L" ! File path list is not terminated by an end node\n");
+    } else {
+      Print(L"\n");
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nPath Type/Sub   Length  Node\n");
+    for (UINTN i = Top; i < BootEntry->NodeCount && i < Top + Visible; i++) {
+      LOAD_OPTION_NODE *Node = &BootEntry->Nodes[i];
+
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"%4d  %02x/%02x    %5d  ", Node->Instance, Node->Type, Node->SubType, Node->Length);
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L"%.*s\n", Width, (Node->Text != NULL) ? Node->Text : L"<unknown>");
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nUp/Down scroll, H hex dump, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    if (Key.UnicodeChar == L'h' || Key.UnicodeChar == L'H') {
+      ShowBootOptionData(BootEntry);
+    } else if (Key.UnicodeChar == CHAR_NULL) {
+      switch (Key.ScanCode) {
+        case SCAN_UP:
+          if (Top > 0) Top--;
+          break;
+        case SCAN_DOWN:
+          if (Top + Visible < BootEntry->NodeCount) Top++;
+          break;
+        case SCAN_ESC:
+          ExitView = TRUE;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+/**
+  Builds the display order: per type, the options in their order variable
+  first, then the ones no order variable lists, by number.
+
+  @param[out] Count   Number of rows.
+
+  @return Array of option pointers, or NULL if there are none.
+**/
+STATIC
+LOAD_OPTION_ENTRY **
+BuildLoadOptionRows(
+  OUT UINTN  *Count
+  )
+{
+  LOAD_OPTION_ENTRY  **Rows;
+  LOAD_OPTION_ENTRY  *Entry;
+  CONST UINT16       *Order;
+  UINTN              OrderCount;
+  UINTN              Total = LoadOptionCount();
+
+  *Count = 0;
+  if (Total == 0) {
+    return NULL;
+  }
+  Rows = AllocatePool(Total * sizeof(LOAD_OPTION_ENTRY *));
+  if (Rows == NULL) {
+    return NULL;
+  }
+
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    Order = GetLoadOptionOrder((LOAD_OPTION_TYPE)t, &OrderCount);
+    for (UINTN i = 0; i < OrderCount; i++) {
+      Entry = FindLoadOption((LOAD_OPTION_TYPE)t, Order[i]);
+      // Skip missing options and repeated order entries
+      if (Entry != NULL && Entry->OrderPosition == i + 1) {
+        Rows[(*Count)++] = Entry;
+      }
+    }
+    // The index is sorted by type and number
+    for (UINTN i = 0; i < Total; i++) {
+      Entry = GetLoadOption(i);
+      if (Entry->Type == t && Entry->OrderPosition == 0) {
+        Rows[(*Count)++] = Entry;
+      }
+    }
+  }
+  return Rows;
+}
+
 EFI_STATUS
 EFIAPI
 ShowBootOptions (
@@ -127,101 +307,111 @@ ShowBootOptions (
   )
 {
   EFI_STATUS         Status;
-  UINT16             BootOrder[100];
-  UINTN             BootOrderSize;
-  BOOT_OPTION_ENTRY *BootList;
-  UINTN             BootCount = 0;
-  EFI_INPUT_KEY     Key;
-  UINTN             CurrentSelection = 0;
-  BOOLEAN           ExitMenu = FALSE;
-
-  // Get the BootOrder variable
-  BootOrderSize = sizeof(BootOrder);
-  Status = gRT->GetVariable(
-                  L"BootOrder",
-                  &gEfiGlobalVariableGuid,
-                  NULL,
-                  &BootOrderSize,
-                  BootOrder
-                  );
+  LOAD_OPTION_ENTRY  **BootList;
+  UINTN              BootCount = 0;
+  UINTN              TypeCount[LoadOptionTypeMax];
+  UINTN              OrphanCount[LoadOptionTypeMax];
+  UINTN              Missing = 0;
+  EFI_INPUT_KEY      Key;
+  UINTN              CurrentSelection = 0;
+  UINTN              Top = 0;
+  UINTN              Columns, Rows;
+  UINTN              Visible;
+  BOOLEAN            ExitMenu = FALSE;
 
+  // One enumeration of the variable store finds every load option
+  Status = BuildLoadOptionIndex();
   if (EFI_ERROR(Status)) {
-    Print(L"Failed to get BootOrder variable: %r\n", Status);
+    Print(L"Failed to enumerate load options: %r\n", Status);
     return Status;
   }
 
-  // Allocate array for boot options
-  UINTN MaxBootOptions = BootOrderSize / sizeof(UINT16);
-  BootList = AllocateZeroPool(sizeof(BOOT_OPTION_ENTRY) * MaxBootOptions);
+  BootList = BuildLoadOptionRows(&BootCount);
   if (BootList == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+    Print(L"No Boot####, Driver####, SysPrep#### or PlatformRecovery#### variables found.\n");
+    FreeLoadOptionIndex();
+    return EFI_NOT_FOUND;
   }
 
-  // Read all boot options
-  for (UINTN i = 0; i < MaxBootOptions; i++) {
-    CHAR16 BootVarName[16];
-    UnicodeSPrint(BootVarName, sizeof(BootVarName), L"Boot%04x", BootOrder[i]);
-    
-    // Copy the name
-    StrCpyS(BootList[BootCount].Name, 16, BootVarName);
-    
-    // Get the boot option data
-    UINTN VarSize = 0;
-    Status = gRT->GetVariable(
-                    BootVarName,
-                    &gEfiGlobalVariableGuid,
-                    &BootList[BootCount].Attributes,
-                    &VarSize,
-                    NULL
-                    );
-
-    if (Status == EFI_BUFFER_TOO_SMALL && VarSize > 0) {
-      BootList[BootCount].Data = AllocatePool(VarSize);
-      BootList[BootCount].DataSize = VarSize;
-      
-      if (BootList[BootCount].Data != NULL) {
-        Status = gRT->GetVariable(
-                      BootVarName,
-                      &gEfiGlobalVariableGuid,
-                      &BootList[BootCount].Attributes,
-                      &VarSize,
-                      BootList[BootCount].Data
-                      );
-
-        if (!EFI_ERROR(Status)) {
-          // Copy description (starts after Attributes(4) + FilePathListLength(2))
-          CHAR16 *Desc = (CHAR16 *)(BootList[BootCount].Data + 6);
-          StrCpyS(BootList[BootCount].Description, 256, Desc);
-          BootCount++;
-        } else {
-          FreePool(BootList[BootCount].Data);
-        }
-      }
+  ZeroMem(TypeCount, sizeof(TypeCount));
+  ZeroMem(OrphanCount, sizeof(OrphanCount));
+  for (UINTN i = 0; i < BootCount; i++) {
+    TypeCount[BootList[i]->Type]++;
+    if (BootList[i]->OrderPosition == 0 && BootList[i]->Type != LoadOptionTypePlatformRecovery) {
+      OrphanCount[BootList[i]->Type]++;
     }
   }
+  for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+    Missing += LoadOptionMissingCount((LOAD_OPTION_TYPE)t);
+  }
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  // Header, summary and warning lines on top, three footer lines below
+  Visible = (Rows > 8) ? Rows - 7 : 1;
 
   // Main menu loop
   while (!ExitMenu) {
+    if (CurrentSelection < Top) {
+      Top = CurrentSelection;
+    } else if (CurrentSelection >= Top + Visible) {
+      Top = CurrentSelection - Visible + 1;
+    }
+
     // Clear screen and set colors
     gST->ConOut->ClearScreen(gST->ConOut);
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
-    Print(L"=== Boot Options ===                \n\n");
+    Print(L"=== Load Options ===                \n");
 
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    for (UINTN t = 0; t < LoadOptionTypeMax; t++) {
+      Print(L"%s%s %d", (t == 0) ? L"" : L", ", LoadOptionTypeName((LOAD_OPTION_TYPE)t), TypeCount[t]);
+      if (OrphanCount[t] != 0) {
+        Print(L" (%d not in order)", OrphanCount[t]);
+      }
+    }
+    Print(L"\n");
+    if (Missing != 0) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+      Print(L" ! %d order entries name options that do not exist\n", Missing);
+    } else {
+      Print(L"\n");
+    }
+
+    // Display the options that fit: order position, flags, description and the cached path text
+    for (UINTN i = Top; i < BootCount && i < Top + Visible; i++) {
+      LOAD_OPTION_ENTRY *Entry = BootList[i];
+      UINTN             Used;
 
-    // Display all boot options
-    for (UINTN i = 0; i < BootCount; i++) {
       if (i == CurrentSelection) {
         gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_GREEN));
+      } else if (Entry->OrderPosition == 0 && Entry->Type != LoadOptionTypePlatformRecovery) {
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
       } else {
         gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
       }
-      Print(L"%s: %s\n", BootList[i].Name, BootList[i].Description);
+      if (Entry->OrderPosition != 0) {
+        Print(L"%-20s %3d ", Entry->Name, Entry->OrderPosition);
+      } else {
+        Print(L"%-20s   - ", Entry->Name);
+      }
+      Print(L"%c%c%c %-28.28s",
+            (Entry->LoadAttributes & LOAD_OPTION_ACTIVE) ? L'A' : L'-',
+            (Entry->LoadAttributes & LOAD_OPTION_HIDDEN) ? L'H' : L'-',
+            (Entry->Flags & LOAD_OPTION_FLAG_BOOT_NEXT) ? L'N' :
+            (Entry->Flags & LOAD_OPTION_FLAG_BOOT_CURRENT) ? L'C' : L'-',
+            Entry->Description);
+      // Name, position, flags and description take 57 columns
+      Used = 57;
+      if (Entry->PathText != NULL && Columns > Used + 2) {
+        Print(L" %.*s", Columns - Used - 2, Entry->PathText);
+      }
+      Print(L"\n");
     }
 
     // Reset color to blue background for the instruction text
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-    Print(L"\nUse Up/Down to select, Enter to view details, ESC to exit\n");
+    Print(L"\nOption %d of %d. A active, H hidden, N BootNext, C BootCurrent. Enter details, ESC exit\n",
+          CurrentSelection + 1, BootCount);
 
     // Wait for key
     gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
@@ -229,7 +419,7 @@ ShowBootOptions (
 
     if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN) {
       // Show details of selected boot option
-      ShowBootOptionData(&BootList[CurrentSelection]);
+      ShowBootOptionDetails(BootList[CurrentSelection]);
     } else if (Key.UnicodeChar == CHAR_NULL) {
       switch (Key.ScanCode) {
         case SCAN_UP:
@@ -248,6 +438,12 @@ ShowBootOptions (
             CurrentSelection = 0;
           }
           break;
+        case SCAN_PAGE_UP:
+          CurrentSelection = (CurrentSelection > Visible) ? CurrentSelection - Visible : 0;
+          break;
+        case SCAN_PAGE_DOWN:
+          CurrentSelection = MIN(CurrentSelection + Visible, BootCount - 1);
+          break;
         case SCAN_ESC:
           ExitMenu = TRUE;
           break;
@@ -258,12 +454,8 @@ ShowBootOptions (
   }
 
   // Cleanup
-  for (UINTN i = 0; i < BootCount; i++) {
-    if (BootList[i].Data != NULL) {
-      FreePool(BootList[i].Data);
-    }
-  }
   FreePool(BootList);
+  FreeLoadOptionIndex();
 
   return EFI_SUCCESS;
 }
@@ -8,7 +8,9 @@
 #include <Library/MemoryAllocationLib.h>
 
 /**
-  Display all Boot#### variables in the system.
+  Display every Boot####, Driver####, SysPrep#### and PlatformRecovery####
+  variable in the system, in BootOrder/DriverOrder/SysPrepOrder order with
+  the options no order variable lists flagged.
 
   @retval EFI_SUCCESS     Successfully displayed all boot options.
   @retval Others          Failed to get or display boot options.
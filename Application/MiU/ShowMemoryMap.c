@@ -1,16 +1,5 @@
 #include "ShowMemoryMap.h"
 
-/**
-  Structure to hold memory map information.
-**/
-typedef struct {
-  EFI_MEMORY_DESCRIPTOR *Map;            // Pointer to memory descriptor buffer
-  UINTN                MapSize;         // Size of the buffer in bytes
-  UINTN                DescriptorSize;  // Size of each descriptor
-  UINT32               DescriptorVersion;
-  UINTN                DescriptorCount; // Number of descriptors
-} MEMORY_MAP;
-
 /**
   Retrieve the memory map into a dynamically allocated buffer.
   Caller must free the buffer using FreePool.
@@ -19,7 +8,6 @@ typedef struct {
   @retval EFI_SUCCESS     Memory map retrieved successfully.
   @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
 **/
-STATIC
 EFI_STATUS
 GetMemoryMapBuffer(
   IN OUT MEMORY_MAP *MemMap
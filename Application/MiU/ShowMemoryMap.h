@@ -10,6 +10,30 @@
 // Maximum number of memory descriptors supported (adjust as needed)
 #define MEMORY_MAP_MAX_DESCRIPTORS 128
 
+/**
+  Structure to hold memory map information.
+**/
+typedef struct {
+  EFI_MEMORY_DESCRIPTOR *Map;            // Pointer to memory descriptor buffer
+  UINTN                MapSize;         // Size of the buffer in bytes
+  UINTN                DescriptorSize;  // Size of each descriptor
+  UINT32               DescriptorVersion;
+  UINTN                DescriptorCount; // Number of descriptors
+} MEMORY_MAP;
+
+/**
+  Retrieve the memory map into a dynamically allocated buffer.
+  Caller must free MemMap->Map using FreePool.
+
+  @param[in,out] MemMap   Pointer to a zeroed MEMORY_MAP structure.
+  @retval EFI_SUCCESS     Memory map retrieved successfully.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+**/
+EFI_STATUS
+GetMemoryMapBuffer(
+  IN OUT MEMORY_MAP *MemMap
+  );
+
 /**
   Display the system memory map with paging and scrolling support.
 **/
@@ -3,14 +3,39 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/PrintLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
 #include <IndustryStandard/SmBios.h>
 #include "Smbios.h"
+#include "SmbiosDecode.h"
+#include "SnapshotFormat.h"
 
+//
+// Configuration table GUIDs for the SMBIOS 2.x and 3.x entry points
+//
+#define SMBIOS_TABLE_GUID \
+  {0xeb9d2d31, 0x2d88, 0x11d3, {0x9a, 0x16, 0x00, 0x90, 0x27, 0x3f, 0xc1, 0x4d}}
+#define SMBIOS3_TABLE_GUID \
+  {0xf2fd1544, 0x9794, 0x4a2c, {0x99, 0x2e, 0xe5, 0xbb, 0xcf, 0x20, 0xe3, 0x94}}
 
-// Globals for SMBIOS record list and navigation
+#define SMBIOS_LIST_GROW  64    // Entries added each time the index grows
+
+// Globals for SMBIOS record list and navigation. The index is built on the
+// first visit and kept for the lifetime of the application.
 STATIC SMBIOS_ENTRY *mSmbiosList = NULL;   // Array of SMBIOS_ENTRY structs
 STATIC UINTN         mSmbiosCount = 0;     // Number of SMBIOS records found
+STATIC UINTN         mSmbiosCapacity = 0;  // Allocated entries in mSmbiosList
+STATIC UINT16       *mSmbiosStrings = NULL;   // String offsets of all records, back to back
+STATIC UINTN         mSmbiosStringCount = 0;
+STATIC UINTN         mSmbiosStringCapacity = 0;
+STATIC UINTN         mSmbiosTypeStart[257];   // Bucket t spans mSmbiosTypeOrder[Start[t]..Start[t+1])
+STATIC UINTN        *mSmbiosTypeOrder = NULL; // Record indices grouped by type, table order within a type
 STATIC UINTN         mSmbiosSelected = 0;  // Currently selected record index
+STATIC UINTN         mSmbiosTop = 0;       // First record shown in the list window
+STATIC BOOLEAN       mSmbiosIndexed = FALSE;
+STATIC CHAR16        mSmbiosSource[64];    // Where the index came from, for the list footer
+STATIC UINT8         mSmbiosMajorVersion = 0;
+STATIC UINT8         mSmbiosMinorVersion = 0;
 
 /**
   Returns a human-readable name for a given SMBIOS type ID.
@@ -67,157 +92,108 @@ STATIC CONST CHAR16* GetSmbiosTypeName(IN UINT8 Type) {
 }
 
 /**
-  Retrieves a string from an SMBIOS record.
-  @param  SmbiosHeader  Pointer to the SMBIOS structure.
+  Retrieves a string from an SMBIOS record through its precomputed offset table.
+  @param  Entry         The indexed SMBIOS record.
   @param  StringNumber  The 1-based index of the string to retrieve.
   @return               A pointer to the CHAR8 string, or a default string.
 */
-STATIC CONST CHAR8* GetSmbiosString(IN SMBIOS_STRUCTURE *SmbiosHeader, IN SMBIOS_TABLE_STRING StringNumber) {
-  UINTN  i;
-  CHAR8 *String;
-  String = (CHAR8 *)SmbiosHeader + SmbiosHeader->Length;
+CONST CHAR8* GetSmbiosString(IN SMBIOS_ENTRY *Entry, IN SMBIOS_TABLE_STRING StringNumber) {
   if (StringNumber == 0) return "Not specified";
-  for (i = 1; i < StringNumber; i++) {
-    while (*String != 0) String++;
-    String++;
-  }
-  if (*String == 0) return "Invalid String";
-  return String;
+  if (StringNumber > Entry->StringCount) return "Invalid String";
+  return (CONST CHAR8 *)Entry->Header + mSmbiosStrings[Entry->FirstString + StringNumber - 1];
 }
 
 /**
   Displays the detailed information for a single SMBIOS record.
-  Shows decoded fields for known types, or a hex dump for unknown types.
-  Waits for ESC key to return.
+  Shows decoded fields for types with a layout, or a hex dump for the rest;
+  'r' switches between the two. Waits for ESC key to return.
 */
 STATIC VOID ShowSmbiosRecordDetail(IN SMBIOS_ENTRY *Entry) {
   EFI_INPUT_KEY Key;
-  UINTN SavedAttr = gST->ConOut->Mode->Attribute;
-
-  gST->ConOut->ClearScreen(gST->ConOut);
-
-  //
-  // Header line: white on red background
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
-  Print(L"--- SMBIOS Record Detail ---\n");
-
-  //
-  // Back to main theme (blue background)
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+  UINTN   SavedAttr  = gST->ConOut->Mode->Attribute;
+  BOOLEAN HasLayout  = HasSmbiosLayout(Entry->Header->Type);
+  BOOLEAN ShowRaw    = !HasLayout;
 
-  //
-  // "Type:" (white) + value (yellow)
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-  Print(L"Type: ");
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-  Print(L"%d (%s)\n", Entry->Header->Type, GetSmbiosTypeName(Entry->Header->Type));
-
-  //
-  // "Handle:" (white) + value (yellow)
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-  Print(L"Handle: ");
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-  Print(L"0x%04X\n", Entry->Handle);
-
-  //
-  // "Length:" (white) + value (yellow)
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-  Print(L"Length: ");
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-  Print(L"0x%02X\n\n", Entry->Header->Length);
-
-  //
-  // Decoded view for known types with the same color rule (title white, value yellow)
-  //
-  switch (Entry->Header->Type) {
-    case SMBIOS_TYPE_SYSTEM_INFORMATION: {
-      SMBIOS_TABLE_TYPE1 *Rec = (SMBIOS_TABLE_TYPE1 *)Entry->Header;
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Manufacturer: ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n", GetSmbiosString(Entry->Header, Rec->Manufacturer));
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Product Name: ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n", GetSmbiosString(Entry->Header, Rec->ProductName));
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Version:      ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n", GetSmbiosString(Entry->Header, Rec->Version));
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Serial Number:");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n\n", GetSmbiosString(Entry->Header, Rec->SerialNumber));
-      break;
-    }
-
-    case SMBIOS_TYPE_BIOS_INFORMATION: {
-      SMBIOS_TABLE_TYPE0 *Rec = (SMBIOS_TABLE_TYPE0 *)Entry->Header;
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Vendor:       ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n", GetSmbiosString(Entry->Header, Rec->Vendor));
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Version:      ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n", GetSmbiosString(Entry->Header, Rec->BiosVersion));
-
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  Release Date: ");
-      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
-      Print(L"%a\n\n", GetSmbiosString(Entry->Header, Rec->BiosReleaseDate));
-      break;
-    }
-
-    default:
-      // keep behavior below (raw dump); known types will also show raw dump for consistency
-      break;
-  }
-
-  //
-  // Raw dump title and header (title white on blue; bytes lightgray on blue)
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-  Print(L"Raw data dump:\n");
-  Print(L"Ofs: 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F\n");
-  Print(L"  --------------------------------------------------\n");
+  while (TRUE) {
+    gST->ConOut->ClearScreen(gST->ConOut);
 
-  {
-    UINT8 *Data = (UINT8 *)Entry->Header;
-    for (UINTN i = 0; i < Entry->Header->Length; i += 16) {
+    //
+    // Header line: white on red background
+    //
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L"--- SMBIOS Record Detail ---\n");
+
+    //
+    // "Type:" (white) + value (yellow)
+    //
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Type: ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"%d (%s)\n", Entry->Header->Type, GetSmbiosTypeName(Entry->Header->Type));
+
+    //
+    // "Handle:" (white) + value (yellow)
+    //
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Handle: ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"0x%04X\n", Entry->Handle);
+
+    //
+    // "Length:" (white) + value (yellow)
+    //
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"Length: ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"0x%02X\n\n", Entry->Header->Length);
+
+    if (!ShowRaw) {
+      //
+      // Decoded view from the field layout table (title white, value yellow)
+      //
+      PrintSmbiosFields(Entry);
+    } else {
+      //
+      // Raw dump title and header (title white on blue; bytes lightgray on blue)
+      //
       gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-      Print(L"  %02Xh: ", i);
-      for (UINTN j = 0; j < 16; j++) {
-        if (i + j < Entry->Header->Length) {
-          gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
-          Print(L"%02X ", Data[i + j]);
+      Print(L"Raw data dump:\n");
+      Print(L"Ofs: 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F\n");
+      Print(L"  --------------------------------------------------\n");
+
+      UINT8 *Data = (UINT8 *)Entry->Header;
+      for (UINTN i = 0; i < Entry->Header->Length; i += 16) {
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+        Print(L"  %02Xh: ", i);
+        for (UINTN j = 0; j < 16; j++) {
+          if (i + j < Entry->Header->Length) {
+            gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+            Print(L"%02X ", Data[i + j]);
+          }
         }
+        Print(L"\n");
       }
-      Print(L"\n");
     }
-  }
 
-  //
-  // Footer prompt
-  //
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
-  Print(L"\nPress ESC to return...");
+    //
+    // Footer prompt
+    //
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    if (HasLayout) {
+      Print(L"\nPress 'r' for the %s view, ESC to return...", ShowRaw ? L"decoded" : L"raw");
+    } else {
+      Print(L"\nPress ESC to return...");
+    }
 
-  do {
     gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
     gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
-  } while (Key.ScanCode != SCAN_ESC);
+    if (Key.ScanCode == SCAN_ESC) {
+      break;
+    }
+    if (HasLayout && (Key.UnicodeChar == L'r' || Key.UnicodeChar == L'R')) {
+      ShowRaw = !ShowRaw;
+    }
+  }
 
   gST->ConOut->SetAttribute(gST->ConOut, SavedAttr);
 }
@@ -275,6 +251,56 @@ PromptSmbiosTypeHex(OUT UINT8 *OutType)
   }
 }
 
+/**
+  Group the indexed records into 256 per-type buckets with a counting sort,
+  and give every record its position within its bucket.
+*/
+STATIC
+EFI_STATUS
+BuildSmbiosTypeBuckets(VOID)
+{
+  UINTN Fill[256];
+
+  mSmbiosTypeOrder = AllocatePool(mSmbiosCount * sizeof(UINTN));
+  if (mSmbiosTypeOrder == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem(mSmbiosTypeStart, sizeof(mSmbiosTypeStart));
+  for (UINTN i = 0; i < mSmbiosCount; i++) {
+    mSmbiosTypeStart[mSmbiosList[i].Header->Type + 1]++;
+  }
+  for (UINTN t = 0; t < 256; t++) {
+    mSmbiosTypeStart[t + 1] += mSmbiosTypeStart[t];
+    Fill[t] = 0;
+  }
+  for (UINTN i = 0; i < mSmbiosCount; i++) {
+    UINT8 Type = mSmbiosList[i].Header->Type;
+    mSmbiosList[i].TypeOrdinal = Fill[Type];
+    mSmbiosTypeOrder[mSmbiosTypeStart[Type] + Fill[Type]++] = i;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Number of records of the given type.
+*/
+UINTN
+SmbiosTypeCount(IN UINT8 Type)
+{
+  return mSmbiosTypeStart[Type + 1] - mSmbiosTypeStart[Type];
+}
+
+/**
+  The Ordinal-th record (0-based, table order) of the given type.
+*/
+SMBIOS_ENTRY *
+GetSmbiosRecordOfType(IN UINT8 Type, IN UINTN Ordinal)
+{
+  if (mSmbiosTypeOrder == NULL || Ordinal >= SmbiosTypeCount(Type)) return NULL;
+  return &mSmbiosList[mSmbiosTypeOrder[mSmbiosTypeStart[Type] + Ordinal]];
+}
+
 /**
   Searches for a specific SMBIOS type in the list.
   Returns the index of the first matching type, or -1 if not found.
@@ -283,56 +309,141 @@ STATIC
 INTN
 FindSmbiosIndexByType(IN UINT8 Type)
 {
-  if (mSmbiosList == NULL || mSmbiosCount == 0) return -1;
-  for (UINTN i = 0; i < mSmbiosCount; i++) {
-    if (mSmbiosList[i].Header != NULL && mSmbiosList[i].Header->Type == Type) {
-      return (INTN)i;
-    }
+  if (mSmbiosTypeOrder == NULL || SmbiosTypeCount(Type) == 0) return -1;
+  return (INTN)mSmbiosTypeOrder[mSmbiosTypeStart[Type]];
+}
+
+/**
+  Returns the record of the same type after (Forward) or before the given
+  one, wrapping around at either end of the bucket.
+*/
+STATIC
+UINTN
+StepSmbiosIndexInType(IN UINTN Index, IN BOOLEAN Forward)
+{
+  UINT8 Type  = mSmbiosList[Index].Header->Type;
+  UINTN Count = SmbiosTypeCount(Type);
+  UINTN Ordinal;
+
+  if (Forward) {
+    Ordinal = (mSmbiosList[Index].TypeOrdinal + 1) % Count;
+  } else {
+    Ordinal = (mSmbiosList[Index].TypeOrdinal + Count - 1) % Count;
   }
-  return -1;
+  return mSmbiosTypeOrder[mSmbiosTypeStart[Type] + Ordinal];
 }
 
 /**
-  Draws the list of all found SMBIOS tables.
-  Highlights the currently selected record.
+  Number of list rows that fit between the header line and the footer.
 */
-STATIC VOID DrawSmbiosList() {
-  UINTN BackgroundColor;
+STATIC UINTN SmbiosVisibleRows(VOID) {
+  UINTN Columns, Rows;
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  // One header line, three footer lines and a spare line so the screen never scrolls
+  return (Rows > 6) ? (Rows - 5) : 1;
+}
+
+/**
+  Draws one record at its row inside the list window.
+*/
+STATIC VOID DrawSmbiosRow(IN UINTN Index) {
+  SMBIOS_ENTRY *E = &mSmbiosList[Index];
+  UINTN BackgroundColor = (Index == mSmbiosSelected) ? EFI_GREEN : EFI_BLUE;
   CHAR16 HandleString[16];
 
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Index - mSmbiosTop);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, BackgroundColor));
+  Print(L" (%03d) ", E->Header->Type);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, BackgroundColor));
+  Print(L"%-47s", GetSmbiosTypeName(E->Header->Type));
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, BackgroundColor));
+  UnicodeSPrint(HandleString, sizeof(HandleString), L"%04Xh", E->Handle);
+  Print(L"%-8s %04Xh", HandleString, E->Header->Length);
+}
+
+/**
+  Draws the header line, which counts the records of the selected type.
+*/
+STATIC VOID DrawSmbiosHeader() {
+  SMBIOS_ENTRY *E = &mSmbiosList[mSmbiosSelected];
+  CHAR16 Title[64];
+
+  UnicodeSPrint(Title, sizeof(Title), L" SMBIOS Type      (type %d: %d of %d)",
+                E->Header->Type, E->TypeOrdinal + 1, SmbiosTypeCount(E->Header->Type));
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 0);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+  Print(L"%-54s %-8s %-6s", Title, L"Handle", L"Length");
+}
+
+/**
+  Draws the window of SMBIOS records around the current selection.
+  Only the rows that fit on screen are printed, so the cost does not
+  depend on the number of records.
+*/
+STATIC VOID DrawSmbiosList() {
+  UINTN Visible = SmbiosVisibleRows();
+
   // If no SMBIOS records are available, show a message and return
   if (mSmbiosList == NULL || mSmbiosCount == 0) {
     gST->ConOut->ClearScreen(gST->ConOut);
     Print(L"No SMBIOS records found.\n");
     return;
   }
-  
-  // Clear the screen and set the header attributes
+
+  // Keep the selection inside the window
+  if (mSmbiosSelected < mSmbiosTop) {
+    mSmbiosTop = mSmbiosSelected;
+  } else if (mSmbiosSelected >= mSmbiosTop + Visible) {
+    mSmbiosTop = mSmbiosSelected - Visible + 1;
+  }
+
+  // Clear the screen and print the header
   gST->ConOut->ClearScreen(gST->ConOut);
-  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+  DrawSmbiosHeader();
 
-  // Print the header
-  Print(L"%-54s %-8s %s\n", L" SMBIOS Type", L"Handle", L"Length");
+  // Print the visible window of SMBIOS entries
+  for (UINTN i = mSmbiosTop; i < mSmbiosCount && i < mSmbiosTop + Visible; i++) {
+    DrawSmbiosRow(i);
+  }
+
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 1 + Visible);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"\nRecord %4d of %4d. 't' jumps to a Type (00-FF), 'n'/'p' next/previous of the same type\n",
+        mSmbiosSelected + 1, mSmbiosCount);
+  Print(L"Source: %s", mSmbiosSource);
 
-  // Print the list of SMBIOS entries
-  for (UINTN i = 0; i < mSmbiosCount; i++) {
-    SMBIOS_ENTRY *E = &mSmbiosList[i];
-    BackgroundColor = (i == mSmbiosSelected) ? EFI_GREEN : EFI_BLUE;
-    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, BackgroundColor));
-    Print(L" (%03d) ", E->Header->Type);
-    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, BackgroundColor));
-    Print(L"%-47s", GetSmbiosTypeName(E->Header->Type));
-    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, BackgroundColor));
-    UnicodeSPrint(HandleString, sizeof(HandleString), L"%04Xh", E->Handle);
-    Print(L"%-8s %04Xh\n", HandleString, E->Header->Length);
-  }
-
-  Print(L"\nHint: Press 't' to jump to a specific SMBIOS Type (00-FF)\n");
-  
   // Restore default attribute
   gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
 }
 
+/**
+  Moves the selection. When the new record is already on screen only the
+  two affected rows and the footer counter are repainted.
+*/
+STATIC VOID MoveSmbiosSelection(IN UINTN NewIndex) {
+  UINTN Visible = SmbiosVisibleRows();
+  UINTN OldIndex = mSmbiosSelected;
+
+  if (NewIndex >= mSmbiosCount || NewIndex == OldIndex) {
+    return;
+  }
+
+  mSmbiosSelected = NewIndex;
+  if (NewIndex < mSmbiosTop || NewIndex >= mSmbiosTop + Visible) {
+    DrawSmbiosList();
+    return;
+  }
+
+  DrawSmbiosHeader();
+  DrawSmbiosRow(OldIndex);
+  DrawSmbiosRow(NewIndex);
+  gST->ConOut->SetCursorPosition(gST->ConOut, 0, 2 + Visible);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"Record %4d of %4d.", mSmbiosSelected + 1, mSmbiosCount);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+}
+
 /**
   Main loop for navigating the SMBIOS list and viewing record details.
   Handles user input for navigation and selection.
@@ -342,7 +453,11 @@ STATIC VOID SmbiosMainLoop() {
   // Main loop for SMBIOS record selection and display
   EFI_INPUT_KEY Key;
   BOOLEAN ExitLoop = FALSE;
-  mSmbiosSelected = 0;
+
+  // The index persists between visits, so keep the previous selection
+  if (mSmbiosSelected >= mSmbiosCount) {
+    mSmbiosSelected = 0;
+  }
 
   // Draw the initial list of SMBIOS records
   DrawSmbiosList();
@@ -354,15 +469,28 @@ STATIC VOID SmbiosMainLoop() {
     switch(Key.ScanCode) {
       case SCAN_UP:
         if (mSmbiosSelected > 0) {
-          mSmbiosSelected--;
-          DrawSmbiosList();
+          MoveSmbiosSelection(mSmbiosSelected - 1);
         }
         break;
       case SCAN_DOWN:
-        if (mSmbiosSelected + 1 < mSmbiosCount) {
-          mSmbiosSelected++;
-          DrawSmbiosList();
-        }
+        MoveSmbiosSelection(mSmbiosSelected + 1);
+        break;
+      case SCAN_PAGE_UP: {
+        UINTN Visible = SmbiosVisibleRows();
+        MoveSmbiosSelection((mSmbiosSelected > Visible) ? (mSmbiosSelected - Visible) : 0);
+        break;
+      }
+      case SCAN_PAGE_DOWN: {
+        UINTN Visible = SmbiosVisibleRows();
+        MoveSmbiosSelection((mSmbiosSelected + Visible < mSmbiosCount) ?
+                            (mSmbiosSelected + Visible) : (mSmbiosCount - 1));
+        break;
+      }
+      case SCAN_HOME:
+        MoveSmbiosSelection(0);
+        break;
+      case SCAN_END:
+        MoveSmbiosSelection(mSmbiosCount - 1);
         break;
       case SCAN_ESC:
         ExitLoop = TRUE;
@@ -372,6 +500,14 @@ STATIC VOID SmbiosMainLoop() {
           ShowSmbiosRecordDetail(&mSmbiosList[mSmbiosSelected]);
           DrawSmbiosList();
         }
+        // 'n'/'p' cycle through the records of the selected type
+        else if (Key.UnicodeChar == L'n' || Key.UnicodeChar == L'N' ||
+                 Key.UnicodeChar == L'p' || Key.UnicodeChar == L'P') {
+          MoveSmbiosSelection(StepSmbiosIndexInType(
+                                mSmbiosSelected,
+                                (BOOLEAN)(Key.UnicodeChar == L'n' || Key.UnicodeChar == L'N')
+                                ));
+        }
         // Check for 't' key to jump to a specific type
         else if (Key.UnicodeChar == L't' || Key.UnicodeChar == L'T') {
           UINT8 Want;
@@ -402,67 +538,348 @@ STATIC VOID SmbiosMainLoop() {
 }
 
 /**
-  Main entry point for the SMBIOS feature.
-  Enumerates SMBIOS tables, allocates memory, and enters navigation loop.
+  Measure one structure: formatted area plus string set up to and including
+  the double NUL.
+
+  @param  Header  Start of the structure.
+  @param  Limit   Bytes available from Header to the end of the table.
+
+  @return Size in bytes, or 0 if the structure does not fit in Limit.
 */
-VOID ReadSmbiosData(VOID) {
+STATIC
+UINTN
+SmbiosStructureSize(
+  IN CONST SMBIOS_STRUCTURE  *Header,
+  IN UINTN                   Limit
+  )
+{
+  CONST UINT8 *Bytes = (CONST UINT8 *)Header;
+  UINTN       Offset;
+
+  if (Limit < sizeof(SMBIOS_STRUCTURE) || Header->Length < sizeof(SMBIOS_STRUCTURE) ||
+      Header->Length > Limit) {
+    return 0;
+  }
+  for (Offset = Header->Length; Offset + 1 < Limit; Offset++) {
+    if (Bytes[Offset] == 0 && Bytes[Offset + 1] == 0) {
+      return Offset + 2;
+    }
+  }
+  return 0;
+}
+
+/**
+  Record the offset of every string in a structure's string set. Only called
+  for structures whose double NUL was found, so the walk stays in bounds.
+*/
+STATIC
+EFI_STATUS
+IndexSmbiosStrings(
+  IN OUT SMBIOS_ENTRY  *Entry
+  )
+{
+  CONST UINT8 *Bytes = (CONST UINT8 *)Entry->Header;
+  UINTN       Offset = Entry->Header->Length;
+  UINT16      *Grown;
+
+  Entry->FirstString = mSmbiosStringCount;
+  Entry->StringCount = 0;
+
+  // An empty string set is just the double NUL
+  if (Entry->Size == 0 || Bytes[Offset] == 0) {
+    return EFI_SUCCESS;
+  }
+
+  // Strings are referenced by a UINT8, so anything past 255 is unreachable
+  while (Offset + 1 < Entry->Size && Offset <= MAX_UINT16 && Entry->StringCount < MAX_UINT8) {
+    if (mSmbiosStringCount == mSmbiosStringCapacity) {
+      Grown = ReallocatePool(
+                mSmbiosStringCapacity * sizeof(UINT16),
+                (mSmbiosStringCapacity + SMBIOS_LIST_GROW * 4) * sizeof(UINT16),
+                mSmbiosStrings
+                );
+      if (Grown == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      mSmbiosStrings         = Grown;
+      mSmbiosStringCapacity += SMBIOS_LIST_GROW * 4;
+    }
+    mSmbiosStrings[mSmbiosStringCount++] = (UINT16)Offset;
+    Entry->StringCount++;
+
+    while (Bytes[Offset] != 0) Offset++;
+    Offset++;
+    if (Bytes[Offset] == 0) {
+      break;    // Second NUL of the terminator
+    }
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Append one record to the index, growing it as needed.
+*/
+STATIC
+EFI_STATUS
+AppendSmbiosEntry(
+  IN SMBIOS_STRUCTURE  *Header,
+  IN UINTN             Size
+  )
+{
+  EFI_STATUS   Status;
+  SMBIOS_ENTRY *Grown;
+
+  if (mSmbiosCount == mSmbiosCapacity) {
+    Grown = ReallocatePool(
+              mSmbiosCapacity * sizeof(SMBIOS_ENTRY),
+              (mSmbiosCapacity + SMBIOS_LIST_GROW) * sizeof(SMBIOS_ENTRY),
+              mSmbiosList
+              );
+    if (Grown == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    mSmbiosList      = Grown;
+    mSmbiosCapacity += SMBIOS_LIST_GROW;
+  }
+
+  mSmbiosList[mSmbiosCount].Handle = Header->Handle;
+  mSmbiosList[mSmbiosCount].Header = Header;
+  mSmbiosList[mSmbiosCount].Size   = Size;
+  Status = IndexSmbiosStrings(&mSmbiosList[mSmbiosCount]);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+  mSmbiosCount++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Locate the structure table through the SMBIOS 3.x entry point, falling back
+  to the 2.x one. The anchor and checksum of the entry point are verified.
+
+  @param  Table      Receives the structure table address.
+  @param  TableSize  Receives the table (maximum) size in bytes.
+
+  @retval EFI_SUCCESS    A usable entry point was found.
+  @retval EFI_NOT_FOUND  Neither entry point is published or valid.
+*/
+STATIC
+EFI_STATUS
+FindSmbiosTable(
+  OUT UINT8  **Table,
+  OUT UINTN  *TableSize
+  )
+{
+  EFI_GUID Smbios3Guid = SMBIOS3_TABLE_GUID;
+  EFI_GUID SmbiosGuid  = SMBIOS_TABLE_GUID;
+  SMBIOS_TABLE_3_0_ENTRY_POINT *Ep3 = NULL;
+  SMBIOS_TABLE_ENTRY_POINT     *Ep2 = NULL;
+
+  for (UINTN i = 0; i < gST->NumberOfTableEntries; i++) {
+    if (CompareGuid(&gST->ConfigurationTable[i].VendorGuid, &Smbios3Guid)) {
+      Ep3 = (SMBIOS_TABLE_3_0_ENTRY_POINT *)gST->ConfigurationTable[i].VendorTable;
+    } else if (CompareGuid(&gST->ConfigurationTable[i].VendorGuid, &SmbiosGuid)) {
+      Ep2 = (SMBIOS_TABLE_ENTRY_POINT *)gST->ConfigurationTable[i].VendorTable;
+    }
+  }
+
+  if (Ep3 != NULL && CompareMem(Ep3->AnchorString, "_SM3_", 5) == 0 &&
+      CalculateSum8((UINT8 *)Ep3, Ep3->EntryPointLength) == 0) {
+    *Table     = (UINT8 *)(UINTN)Ep3->TableAddress;
+    *TableSize = Ep3->TableMaximumSize;
+    UnicodeSPrint(mSmbiosSource, sizeof(mSmbiosSource), L"SMBIOS %d.%d entry point, table at 0x%lX",
+                  Ep3->MajorVersion, Ep3->MinorVersion, Ep3->TableAddress);
+    mSmbiosMajorVersion = Ep3->MajorVersion;
+    mSmbiosMinorVersion = Ep3->MinorVersion;
+    return EFI_SUCCESS;
+  }
+
+  if (Ep2 != NULL && CompareMem(Ep2->AnchorString, "_SM_", 4) == 0 &&
+      CalculateSum8((UINT8 *)Ep2, Ep2->EntryPointLength) == 0) {
+    *Table     = (UINT8 *)(UINTN)Ep2->TableAddress;
+    *TableSize = Ep2->TableLength;
+    UnicodeSPrint(mSmbiosSource, sizeof(mSmbiosSource), L"SMBIOS %d.%d entry point, table at 0x%X",
+                  Ep2->MajorVersion, Ep2->MinorVersion, Ep2->TableAddress);
+    mSmbiosMajorVersion = Ep2->MajorVersion;
+    mSmbiosMinorVersion = Ep2->MinorVersion;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Index the structure table in place with a single linear scan. Records point
+  straight into firmware memory; nothing is copied. The scan stops at the
+  End-of-Table record, at the end of the table, or at the first malformed
+  structure.
+*/
+STATIC
+EFI_STATUS
+IndexSmbiosTable(
+  IN UINT8  *Table,
+  IN UINTN  TableSize
+  )
+{
+  EFI_STATUS Status;
+  UINTN      Offset = 0;
+  UINTN      Size;
+
+  while (Offset < TableSize) {
+    SMBIOS_STRUCTURE *Header = (SMBIOS_STRUCTURE *)(Table + Offset);
+
+    Size = SmbiosStructureSize(Header, TableSize - Offset);
+    if (Size == 0) {
+      break;
+    }
+    Status = AppendSmbiosEntry(Header, Size);
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
+    if (Header->Type == SMBIOS_TYPE_END_OF_TABLE) {
+      break;
+    }
+    Offset += Size;
+  }
+
+  return (mSmbiosCount > 0) ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+/**
+  Fallback for firmware that publishes no usable entry point: walk the
+  SMBIOS protocol once, growing the index as records arrive.
+*/
+STATIC
+EFI_STATUS
+IndexSmbiosProtocol(VOID)
+{
   EFI_STATUS                  Status;
   EFI_SMBIOS_PROTOCOL        *Smbios;
   EFI_SMBIOS_HANDLE           TempHandle;
   EFI_SMBIOS_TABLE_HEADER    *TempRecord;
-  UINTN                       Index;
 
-  // Locate the SMBIOS protocol
   Status = gBS->LocateProtocol(&gEfiSmbiosProtocolGuid, NULL, (VOID **)&Smbios);
   if (EFI_ERROR(Status)) {
-    Print(L"Could not locate SMBIOS protocol: %r\n", Status);
-    gBS->Stall(2000000);
-    return;
+    return Status;
   }
 
-  // Initialize globals
-  mSmbiosCount = 0;
-
-  // First pass to count the number of SMBIOS records
   TempHandle = SMBIOS_HANDLE_PI_RESERVED;
-  while(TRUE) {
+  while (TRUE) {
     Status = Smbios->GetNext(Smbios, &TempHandle, NULL, &TempRecord, NULL);
     if (EFI_ERROR(Status)) break;
-    mSmbiosCount++;
+    // Protocol records carry no table bound; a record is at most 64KB
+    Status = AppendSmbiosEntry(TempRecord, SmbiosStructureSize(TempRecord, SIZE_64KB));
+    if (EFI_ERROR(Status)) {
+      return Status;
+    }
   }
 
-  // If no records found, exit early
-  if (mSmbiosCount == 0) return;
+  UnicodeSPrint(mSmbiosSource, sizeof(mSmbiosSource), L"SMBIOS protocol %d.%d",
+                Smbios->MajorVersion, Smbios->MinorVersion);
+  mSmbiosMajorVersion = Smbios->MajorVersion;
+  mSmbiosMinorVersion = Smbios->MinorVersion;
+  return (mSmbiosCount > 0) ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
 
-  // Allocate memory for the SMBIOS entries
-  mSmbiosList = AllocateZeroPool(mSmbiosCount * sizeof(SMBIOS_ENTRY));
-  if (mSmbiosList == NULL) {
-    Print(L"Error: Not enough memory for SMBIOS list.\n");
-    gBS->Stall(2000000);
-    return;
+/**
+  Build the SMBIOS index once; later calls return immediately.
+*/
+EFI_STATUS
+BuildSmbiosIndex(VOID)
+{
+  EFI_STATUS Status;
+  UINT8      *Table;
+  UINTN      TableSize;
+
+  if (mSmbiosIndexed) {
+    return EFI_SUCCESS;
   }
 
-  // Second pass to actually read the SMBIOS records into the list
-  Index = 0;
-  TempHandle = SMBIOS_HANDLE_PI_RESERVED;
-  while(TRUE) {
-    Status = Smbios->GetNext(Smbios, &TempHandle, NULL, &TempRecord, NULL);
-    if (EFI_ERROR(Status)) break;
-    mSmbiosList[Index].Handle = TempHandle;
-    mSmbiosList[Index].Header = TempRecord;
-    Index++;
+  Status = FindSmbiosTable(&Table, &TableSize);
+  if (!EFI_ERROR(Status)) {
+    Status = IndexSmbiosTable(Table, TableSize);
+  }
+  if (EFI_ERROR(Status)) {
+    // Start over from the protocol if the table was missing or unusable
+    mSmbiosCount       = 0;
+    mSmbiosStringCount = 0;
+    Status = IndexSmbiosProtocol();
+  }
+  if (!EFI_ERROR(Status)) {
+    Status = BuildSmbiosTypeBuckets();
+  }
+  if (EFI_ERROR(Status)) {
+    if (mSmbiosList != NULL) {
+      FreePool(mSmbiosList);
+    }
+    if (mSmbiosStrings != NULL) {
+      FreePool(mSmbiosStrings);
+    }
+    mSmbiosList           = NULL;
+    mSmbiosCount          = 0;
+    mSmbiosCapacity       = 0;
+    mSmbiosStrings        = NULL;
+    mSmbiosStringCount    = 0;
+    mSmbiosStringCapacity = 0;
+    return Status;
+  }
+
+  mSmbiosIndexed = TRUE;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+WriteSmbiosSnapshotSection(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *Count
+  )
+{
+  EFI_STATUS             Status;
+  SNAPSHOT_SMBIOS        Header;
+  SNAPSHOT_SMBIOS_RECORD Record;
+
+  *Count = 0;
+  Status = BuildSmbiosIndex();
+  if (EFI_ERROR(Status)) {
+    return Status;
   }
 
-  // Check if we read the expected number of records
-  if (Index != mSmbiosCount) {
-    Print(L"Warning: Mismatch in SMBIOS count (%d vs %d)\n", Index, mSmbiosCount);
+  ZeroMem(&Header, sizeof(Header));
+  Header.MajorVersion = mSmbiosMajorVersion;
+  Header.MinorVersion = mSmbiosMinorVersion;
+  Header.RecordCount  = (UINT32)mSmbiosCount;
+  Status = FileWriterAppend(Writer, &Header, sizeof(Header));
+
+  // Table order, as the firmware laid the records out
+  for (UINTN i = 0; i < mSmbiosCount && !EFI_ERROR(Status); i++) {
+    SMBIOS_ENTRY *Entry = &mSmbiosList[i];
+
+    ZeroMem(&Record, sizeof(Record));
+    Record.Handle = Entry->Handle;
+    Record.Type   = Entry->Header->Type;
+    Record.Length = (UINT32)((Entry->Size != 0) ? Entry->Size : Entry->Header->Length);
+    FileWriterAppend(Writer, &Record, sizeof(Record));
+    Status = FileWriterAppend(Writer, Entry->Header, Record.Length);
+    (*Count)++;
+  }
+  return Status;
+}
+
+/**
+  Main entry point for the SMBIOS feature.
+  Builds the record index on the first call and enters the navigation loop.
+*/
+VOID ReadSmbiosData(VOID) {
+  EFI_STATUS Status;
+
+  Status = BuildSmbiosIndex();
+  if (EFI_ERROR(Status)) {
+    Print(L"Could not read SMBIOS data: %r\n", Status);
+    gBS->Stall(2000000);
+    return;
   }
 
   // Start the main loop for SMBIOS record navigation
   SmbiosMainLoop();
-
-  // Free the allocated memory for SMBIOS entries
-  FreePool(mSmbiosList);
-  mSmbiosList = NULL;
-  mSmbiosCount = 0;
 }
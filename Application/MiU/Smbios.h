@@ -2,12 +2,32 @@
 #include <Uefi.h>
 #include <Protocol/Smbios.h>
 #include <IndustryStandard/SmBios.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
 
 // Forward declaration for SMBIOS_ENTRY struct
 typedef struct {
   EFI_SMBIOS_HANDLE      Handle;
   EFI_SMBIOS_TABLE_HEADER *Header;
+  UINTN                  Size;        // Formatted area plus string set, 0 if unterminated
+  UINTN                  FirstString; // Index of string 1 in the shared offset table
+  UINT8                  StringCount; // Strings in the set; 0 if empty or unterminated
+  UINTN                  TypeOrdinal; // Position among the records of the same type
 } SMBIOS_ENTRY;
 
 // Main entry point for SMBIOS feature
 VOID ReadSmbiosData(VOID);
+
+// String N (1-based) of an indexed record, or a placeholder if absent
+CONST CHAR8* GetSmbiosString(IN SMBIOS_ENTRY *Entry, IN SMBIOS_TABLE_STRING StringNumber);
+
+// Build the record index and per-type buckets once for the session
+EFI_STATUS BuildSmbiosIndex(VOID);
+
+// Number of records of a type, and the Ordinal-th of them (NULL past the end)
+UINTN SmbiosTypeCount(IN UINT8 Type);
+SMBIOS_ENTRY *GetSmbiosRecordOfType(IN UINT8 Type, IN UINTN Ordinal);
+
+// Every indexed record as SNAPSHOT_SMBIOS_RECORD + bytes into a snapshot
+// section, straight from the table; Arena is not used
+EFI_STATUS WriteSmbiosSnapshotSection(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena, OUT UINTN *Count);
@@ -0,0 +1,685 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "SmbiosDecode.h"
+
+//
+// Field descriptors: every described type is a list of (offset, width, kind,
+// label, map) rows rendered by one interpreter. Adding a type means adding a
+// table, not code.
+//
+
+typedef enum {
+  SmbiosFieldHex,         // Width bytes, shown as 0x...
+  SmbiosFieldDecimal,     // Width bytes, shown in decimal
+  SmbiosFieldString,      // String number, resolved through the offset table
+  SmbiosFieldEnum,        // Value (after Mask) looked up in Map
+  SmbiosFieldBits,        // Every set bit named from Map (Value = bit number)
+  SmbiosFieldHandle,      // Structure handle, 0xFFFF means none
+  SmbiosFieldUuid,        // 16-byte SMBIOS UUID
+  SmbiosFieldMemorySize   // Type 17 Size word (MB, or KB when bit 15 is set)
+} SMBIOS_FIELD_KIND;
+
+typedef struct {
+  UINT32        Value;
+  CONST CHAR16  *Name;
+} SMBIOS_VALUE_NAME;
+
+typedef struct {
+  UINT8                    Offset;
+  UINT8                    Width;
+  UINT8                    Kind;
+  UINT8                    Mask;    // Applied to enums when non-zero
+  CONST CHAR16             *Label;
+  CONST SMBIOS_VALUE_NAME  *Map;    // Terminated by a NULL Name
+} SMBIOS_FIELD;
+
+typedef struct {
+  UINT8               Type;
+  CONST SMBIOS_FIELD  *Fields;
+  UINTN               FieldCount;
+} SMBIOS_LAYOUT;
+
+#define FIELD(Off, Width, Kind, Label)           { Off, Width, Kind, 0, Label, NULL }
+#define FIELD_MAP(Off, Width, Kind, Label, Map)  { Off, Width, Kind, 0, Label, Map }
+
+//
+// Value maps
+//
+
+STATIC CONST SMBIOS_VALUE_NAME mBiosCharacteristics[] = {
+  { 3, L"Not supported" }, { 4, L"ISA" }, { 5, L"MCA" }, { 6, L"EISA" }, { 7, L"PCI" },
+  { 8, L"PCMCIA" }, { 9, L"PnP" }, { 10, L"APM" }, { 11, L"Flash upgradeable" },
+  { 12, L"Shadowing" }, { 13, L"VL-VESA" }, { 14, L"ESCD" }, { 15, L"CD boot" },
+  { 16, L"Selectable boot" }, { 17, L"ROM socketed" }, { 18, L"PCMCIA boot" },
+  { 19, L"EDD" }, { 26, L"Print screen" }, { 27, L"8042 keyboard" }, { 28, L"Serial" },
+  { 29, L"Printer" }, { 30, L"CGA/Mono video" }, { 31, L"NEC PC-98" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mBiosExtension1[] = {
+  { 0, L"ACPI" }, { 1, L"USB legacy" }, { 2, L"AGP" }, { 3, L"I2O boot" },
+  { 4, L"LS-120 boot" }, { 5, L"ATAPI ZIP boot" }, { 6, L"1394 boot" },
+  { 7, L"Smart battery" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mBiosExtension2[] = {
+  { 0, L"BIOS boot specification" }, { 1, L"Network boot on F-key" },
+  { 2, L"Targeted content distribution" }, { 3, L"UEFI" }, { 4, L"Virtual machine" },
+  { 5, L"Manufacturing mode capable" }, { 6, L"Manufacturing mode enabled" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mWakeUpType[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"APM Timer" }, { 4, L"Modem Ring" },
+  { 5, L"LAN Remote" }, { 6, L"Power Switch" }, { 7, L"PCI PME#" }, { 8, L"AC Power Restored" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mBoardFeatures[] = {
+  { 0, L"Hosting board" }, { 1, L"Requires daughter board" }, { 2, L"Removable" },
+  { 3, L"Replaceable" }, { 4, L"Hot swappable" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mBoardType[] = {
+  { 1, L"Unknown" }, { 2, L"Other" }, { 3, L"Server Blade" }, { 4, L"Connectivity Switch" },
+  { 5, L"System Management Module" }, { 6, L"Processor Module" }, { 7, L"I/O Module" },
+  { 8, L"Memory Module" }, { 9, L"Daughter board" }, { 10, L"Motherboard" },
+  { 11, L"Processor/Memory Module" }, { 12, L"Processor/IO Module" },
+  { 13, L"Interconnect board" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mChassisType[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Desktop" }, { 4, L"Low Profile Desktop" },
+  { 5, L"Pizza Box" }, { 6, L"Mini Tower" }, { 7, L"Tower" }, { 8, L"Portable" },
+  { 9, L"Laptop" }, { 10, L"Notebook" }, { 11, L"Hand Held" }, { 12, L"Docking Station" },
+  { 13, L"All in One" }, { 14, L"Sub Notebook" }, { 15, L"Space-saving" },
+  { 16, L"Lunch Box" }, { 17, L"Main Server Chassis" }, { 18, L"Expansion Chassis" },
+  { 19, L"SubChassis" }, { 20, L"Bus Expansion Chassis" }, { 21, L"Peripheral Chassis" },
+  { 22, L"RAID Chassis" }, { 23, L"Rack Mount Chassis" }, { 24, L"Sealed-case PC" },
+  { 25, L"Multi-system chassis" }, { 26, L"Compact PCI" }, { 27, L"Advanced TCA" },
+  { 28, L"Blade" }, { 29, L"Blade Enclosure" }, { 30, L"Tablet" }, { 31, L"Convertible" },
+  { 32, L"Detachable" }, { 33, L"IoT Gateway" }, { 34, L"Embedded PC" },
+  { 35, L"Mini PC" }, { 36, L"Stick PC" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mChassisState[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Safe" }, { 4, L"Warning" },
+  { 5, L"Critical" }, { 6, L"Non-recoverable" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mChassisSecurity[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"None" },
+  { 4, L"External interface locked out" }, { 5, L"External interface enabled" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mProcessorType[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Central Processor" }, { 4, L"Math Processor" },
+  { 5, L"DSP Processor" }, { 6, L"Video Processor" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mProcessorFamily[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x0B, L"Pentium" }, { 0x0C, L"Pentium Pro" },
+  { 0x0E, L"Pentium with MMX technology" }, { 0x28, L"Core Duo" }, { 0x2B, L"Atom" }, { 0x2C, L"Core M" }, { 0x3F, L"AMD FX" },
+  { 0x6B, L"AMD Zen" }, { 0xB3, L"Xeon" }, { 0xC6, L"Core i7" }, { 0xCD, L"Core i5" },
+  { 0xCE, L"Core i3" }, { 0xCF, L"Core i9" }, { 0xFE, L"See Processor Family 2" },
+  { 0x100, L"ARMv7" }, { 0x101, L"ARMv8" }, { 0x102, L"ARMv9" },
+  { 0x200, L"RISC-V RV32" }, { 0x201, L"RISC-V RV64" }, { 0x202, L"RISC-V RV128" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mProcessorUpgrade[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x03, L"Daughter Board" }, { 0x04, L"ZIF Socket" },
+  { 0x05, L"Replaceable Piggy Back" }, { 0x06, L"None" }, { 0x07, L"LIF Socket" },
+  { 0x08, L"Slot 1" }, { 0x09, L"Slot 2" }, { 0x0A, L"370-pin Socket" }, { 0x0B, L"Slot A" },
+  { 0x0C, L"Slot M" }, { 0x0D, L"Socket 423" }, { 0x0E, L"Socket A (462)" },
+  { 0x0F, L"Socket 478" }, { 0x10, L"Socket 754" }, { 0x11, L"Socket 940" },
+  { 0x12, L"Socket 939" }, { 0x13, L"mPGA604" }, { 0x14, L"LGA771" }, { 0x15, L"LGA775" },
+  { 0x16, L"S1" }, { 0x17, L"AM2" }, { 0x18, L"F (1207)" }, { 0x19, L"LGA1366" },
+  { 0x1A, L"G34" }, { 0x1B, L"AM3" }, { 0x1C, L"C32" }, { 0x1D, L"LGA1156" },
+  { 0x1E, L"LGA1567" }, { 0x1F, L"PGA988A" }, { 0x20, L"BGA1288" }, { 0x21, L"rPGA988B" },
+  { 0x22, L"BGA1023" }, { 0x23, L"BGA1224" }, { 0x24, L"LGA1155" }, { 0x25, L"LGA1356" },
+  { 0x26, L"LGA2011" }, { 0x27, L"FS1" }, { 0x28, L"FS2" }, { 0x29, L"FM1" }, { 0x2A, L"FM2" },
+  { 0x2B, L"LGA2011-3" }, { 0x2C, L"LGA1356-3" }, { 0x2D, L"LGA1150" }, { 0x2E, L"BGA1168" },
+  { 0x2F, L"BGA1234" }, { 0x30, L"BGA1364" }, { 0x31, L"AM4" }, { 0x32, L"LGA1151" },
+  { 0x33, L"BGA1356" }, { 0x34, L"BGA1440" }, { 0x35, L"BGA1515" }, { 0x36, L"LGA3647-1" },
+  { 0x37, L"SP3" }, { 0x38, L"SP3r2" }, { 0x39, L"LGA2066" }, { 0x3A, L"BGA1392" },
+  { 0x3B, L"BGA1510" }, { 0x3C, L"BGA1528" }, { 0x3D, L"LGA4189" }, { 0x3E, L"LGA1200" },
+  { 0x3F, L"LGA4677" }, { 0x40, L"LGA1700" }, { 0x41, L"BGA1744" }, { 0x42, L"BGA1781" },
+  { 0x43, L"BGA1211" }, { 0x44, L"BGA2422" }, { 0x45, L"LGA1211" }, { 0x46, L"LGA2422" },
+  { 0x47, L"LGA5773" }, { 0x48, L"BGA5773" }, { 0x49, L"AM5" }, { 0x4A, L"SP5" },
+  { 0x4B, L"SP6" }, { 0x4C, L"BGA883" }, { 0x4D, L"BGA1190" }, { 0x4E, L"BGA4129" },
+  { 0x4F, L"LGA4710" }, { 0x50, L"LGA7529" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mProcessorCharacteristics[] = {
+  { 2, L"64-bit" }, { 3, L"Multi-core" }, { 4, L"Hardware thread" },
+  { 5, L"Execute protection" }, { 6, L"Enhanced virtualization" },
+  { 7, L"Power/performance control" }, { 8, L"128-bit" }, { 9, L"Arm64 SoC ID" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSramType[] = {
+  { 0, L"Other" }, { 1, L"Unknown" }, { 2, L"Non-Burst" }, { 3, L"Burst" },
+  { 4, L"Pipeline Burst" }, { 5, L"Synchronous" }, { 6, L"Asynchronous" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mErrorCorrection[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"None" }, { 4, L"Parity" },
+  { 5, L"Single-bit ECC" }, { 6, L"Multi-bit ECC" }, { 7, L"CRC" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSystemCacheType[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Instruction" }, { 4, L"Data" },
+  { 5, L"Unified" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mCacheAssociativity[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Direct Mapped" }, { 4, L"2-way" },
+  { 5, L"4-way" }, { 6, L"Fully Associative" }, { 7, L"8-way" }, { 8, L"16-way" },
+  { 9, L"12-way" }, { 10, L"24-way" }, { 11, L"32-way" }, { 12, L"48-way" },
+  { 13, L"64-way" }, { 14, L"20-way" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotType[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x03, L"ISA" }, { 0x06, L"PCI" },
+  { 0x0E, L"PCI-X" }, { 0x0F, L"AGP" }, { 0x1F, L"PCI Express Gen 2 SFF-8639 (U.2)" },
+  { 0x20, L"PCI Express Gen 3 SFF-8639 (U.2)" }, { 0x21, L"PCIe Mini 52-pin with keep-outs" },
+  { 0x22, L"PCIe Mini 52-pin" }, { 0x23, L"PCIe Mini 76-pin" },
+  { 0x24, L"PCI Express Gen 4 SFF-8639 (U.2)" }, { 0x25, L"PCI Express Gen 5 SFF-8639 (U.2)" },
+  { 0x26, L"OCP NIC 3.0 Small" }, { 0x27, L"OCP NIC 3.0 Large" }, { 0x28, L"OCP NIC Prior to 3.0" },
+  { 0xA5, L"PCI Express" }, { 0xA6, L"PCI Express x1" }, { 0xA7, L"PCI Express x2" },
+  { 0xA8, L"PCI Express x4" }, { 0xA9, L"PCI Express x8" }, { 0xAA, L"PCI Express x16" },
+  { 0xAB, L"PCI Express Gen 2" }, { 0xAC, L"PCI Express Gen 2 x1" },
+  { 0xAD, L"PCI Express Gen 2 x2" }, { 0xAE, L"PCI Express Gen 2 x4" },
+  { 0xAF, L"PCI Express Gen 2 x8" }, { 0xB0, L"PCI Express Gen 2 x16" },
+  { 0xB1, L"PCI Express Gen 3" }, { 0xB2, L"PCI Express Gen 3 x1" },
+  { 0xB3, L"PCI Express Gen 3 x2" }, { 0xB4, L"PCI Express Gen 3 x4" },
+  { 0xB5, L"PCI Express Gen 3 x8" }, { 0xB6, L"PCI Express Gen 3 x16" },
+  { 0xB8, L"PCI Express Gen 4" }, { 0xB9, L"PCI Express Gen 4 x1" },
+  { 0xBA, L"PCI Express Gen 4 x2" }, { 0xBB, L"PCI Express Gen 4 x4" },
+  { 0xBC, L"PCI Express Gen 4 x8" }, { 0xBD, L"PCI Express Gen 4 x16" },
+  { 0xBE, L"PCI Express Gen 5" }, { 0xBF, L"PCI Express Gen 5 x1" },
+  { 0xC0, L"PCI Express Gen 5 x2" }, { 0xC1, L"PCI Express Gen 5 x4" },
+  { 0xC2, L"PCI Express Gen 5 x8" }, { 0xC3, L"PCI Express Gen 5 x16" },
+  { 0xC4, L"PCI Express Gen 6" }, { 0xC5, L"EDSFF E1.S/E1.L" }, { 0xC6, L"EDSFF E3.S/E3.L" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotDataBusWidth[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"8 bit" }, { 4, L"16 bit" }, { 5, L"32 bit" },
+  { 6, L"64 bit" }, { 7, L"128 bit" }, { 8, L"x1" }, { 9, L"x2" }, { 10, L"x4" },
+  { 11, L"x8" }, { 12, L"x12" }, { 13, L"x16" }, { 14, L"x32" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotUsage[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Available" }, { 4, L"In use" },
+  { 5, L"Unavailable" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotLength[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Short" }, { 4, L"Long" },
+  { 5, L"2.5\" drive form factor" }, { 6, L"3.5\" drive form factor" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotCharacteristics1[] = {
+  { 0, L"Unknown" }, { 1, L"5.0V" }, { 2, L"3.3V" }, { 3, L"Shared" }, { 4, L"PC Card-16" },
+  { 5, L"CardBus" }, { 6, L"Zoom Video" }, { 7, L"Modem ring resume" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mSlotCharacteristics2[] = {
+  { 0, L"PME#" }, { 1, L"Hot-plug" }, { 2, L"SMBus" }, { 3, L"Bifurcation" },
+  { 4, L"Async surprise removal" }, { 5, L"Flexbus CXL 1.0" }, { 6, L"Flexbus CXL 2.0" },
+  { 7, L"Flexbus CXL 3.0" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryArrayLocation[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x03, L"System board" },
+  { 0x04, L"ISA add-on card" }, { 0x05, L"EISA add-on card" }, { 0x06, L"PCI add-on card" },
+  { 0x07, L"MCA add-on card" }, { 0x08, L"PCMCIA add-on card" },
+  { 0x09, L"Proprietary add-on card" }, { 0x0A, L"NuBus" }, { 0xA0, L"PC-98/C20" },
+  { 0xA1, L"PC-98/C24" }, { 0xA2, L"PC-98/E" }, { 0xA3, L"PC-98/Local bus" },
+  { 0xA4, L"CXL add-on card" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryArrayUse[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"System memory" }, { 4, L"Video memory" },
+  { 5, L"Flash memory" }, { 6, L"Non-volatile RAM" }, { 7, L"Cache memory" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryFormFactor[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x03, L"SIMM" }, { 0x04, L"SIP" },
+  { 0x05, L"Chip" }, { 0x06, L"DIP" }, { 0x07, L"ZIP" }, { 0x08, L"Proprietary Card" },
+  { 0x09, L"DIMM" }, { 0x0A, L"TSOP" }, { 0x0B, L"Row of chips" }, { 0x0C, L"RIMM" },
+  { 0x0D, L"SODIMM" }, { 0x0E, L"SRIMM" }, { 0x0F, L"FB-DIMM" }, { 0x10, L"Die" },
+  { 0x11, L"CAMM" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryType[] = {
+  { 0x01, L"Other" }, { 0x02, L"Unknown" }, { 0x03, L"DRAM" }, { 0x04, L"EDRAM" },
+  { 0x05, L"VRAM" }, { 0x06, L"SRAM" }, { 0x07, L"RAM" }, { 0x08, L"ROM" },
+  { 0x09, L"FLASH" }, { 0x0A, L"EEPROM" }, { 0x0B, L"FEPROM" }, { 0x0C, L"EPROM" },
+  { 0x0D, L"CDRAM" }, { 0x0E, L"3DRAM" }, { 0x0F, L"SDRAM" }, { 0x10, L"SGRAM" },
+  { 0x11, L"RDRAM" }, { 0x12, L"DDR" }, { 0x13, L"DDR2" }, { 0x14, L"DDR2 FB-DIMM" },
+  { 0x18, L"DDR3" }, { 0x19, L"FBD2" }, { 0x1A, L"DDR4" }, { 0x1B, L"LPDDR" },
+  { 0x1C, L"LPDDR2" }, { 0x1D, L"LPDDR3" }, { 0x1E, L"LPDDR4" },
+  { 0x1F, L"Logical non-volatile device" }, { 0x20, L"HBM" }, { 0x21, L"HBM2" },
+  { 0x22, L"DDR5" }, { 0x23, L"LPDDR5" }, { 0x24, L"HBM3" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryTypeDetail[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Fast-paged" }, { 4, L"Static column" },
+  { 5, L"Pseudo-static" }, { 6, L"RAMBUS" }, { 7, L"Synchronous" }, { 8, L"CMOS" },
+  { 9, L"EDO" }, { 10, L"Window DRAM" }, { 11, L"Cache DRAM" }, { 12, L"Non-volatile" },
+  { 13, L"Registered" }, { 14, L"Unbuffered" }, { 15, L"LRDIMM" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mMemoryTechnology[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"DRAM" }, { 4, L"NVDIMM-N" },
+  { 5, L"NVDIMM-F" }, { 6, L"NVDIMM-P" }, { 7, L"Intel Optane persistent memory" },
+  { 8, L"MRDIMM" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mIpmiInterfaceType[] = {
+  { 0, L"Unknown" }, { 1, L"KCS" }, { 2, L"SMIC" }, { 3, L"BT" }, { 4, L"SSIF" },
+  { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mOnboardDeviceType[] = {
+  { 1, L"Other" }, { 2, L"Unknown" }, { 3, L"Video" }, { 4, L"SCSI Controller" },
+  { 5, L"Ethernet" }, { 6, L"Token Ring" }, { 7, L"Sound" }, { 8, L"PATA Controller" },
+  { 9, L"SATA Controller" }, { 10, L"SAS Controller" }, { 11, L"Wireless LAN" },
+  { 12, L"Bluetooth" }, { 13, L"WWAN" }, { 14, L"eMMC" }, { 15, L"NVMe Controller" },
+  { 16, L"UFS Controller" }, { 0, NULL }
+};
+
+STATIC CONST SMBIOS_VALUE_NAME mTpmCharacteristics[] = {
+  { 2, L"Not supported" }, { 3, L"Family configurable via firmware update" },
+  { 4, L"Family configurable via platform software" },
+  { 5, L"Family configurable via OEM mechanism" }, { 0, NULL }
+};
+
+//
+// Layouts. Offsets and widths follow the DMTF SMBIOS specification; fields
+// added by later versions sit at the end and are skipped on shorter records.
+//
+
+STATIC CONST SMBIOS_FIELD mType0Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Vendor"),
+  FIELD    (0x05, 1, SmbiosFieldString,  L"BIOS Version"),
+  FIELD    (0x06, 2, SmbiosFieldHex,     L"Starting Segment"),
+  FIELD    (0x08, 1, SmbiosFieldString,  L"Release Date"),
+  FIELD    (0x09, 1, SmbiosFieldHex,     L"ROM Size (64K units - 1)"),
+  FIELD_MAP(0x0A, 8, SmbiosFieldBits,    L"Characteristics", mBiosCharacteristics),
+  FIELD_MAP(0x12, 1, SmbiosFieldBits,    L"Extension Byte 1", mBiosExtension1),
+  FIELD_MAP(0x13, 1, SmbiosFieldBits,    L"Extension Byte 2", mBiosExtension2),
+  FIELD    (0x14, 1, SmbiosFieldDecimal, L"System BIOS Major"),
+  FIELD    (0x15, 1, SmbiosFieldDecimal, L"System BIOS Minor"),
+  FIELD    (0x16, 1, SmbiosFieldDecimal, L"EC Firmware Major"),
+  FIELD    (0x17, 1, SmbiosFieldDecimal, L"EC Firmware Minor"),
+  FIELD    (0x18, 2, SmbiosFieldHex,     L"Extended ROM Size")
+};
+
+STATIC CONST SMBIOS_FIELD mType1Fields[] = {
+  FIELD    (0x04, 1,  SmbiosFieldString, L"Manufacturer"),
+  FIELD    (0x05, 1,  SmbiosFieldString, L"Product Name"),
+  FIELD    (0x06, 1,  SmbiosFieldString, L"Version"),
+  FIELD    (0x07, 1,  SmbiosFieldString, L"Serial Number"),
+  FIELD    (0x08, 16, SmbiosFieldUuid,   L"UUID"),
+  FIELD_MAP(0x18, 1,  SmbiosFieldEnum,   L"Wake-up Type", mWakeUpType),
+  FIELD    (0x19, 1,  SmbiosFieldString, L"SKU Number"),
+  FIELD    (0x1A, 1,  SmbiosFieldString, L"Family")
+};
+
+STATIC CONST SMBIOS_FIELD mType2Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Manufacturer"),
+  FIELD    (0x05, 1, SmbiosFieldString,  L"Product"),
+  FIELD    (0x06, 1, SmbiosFieldString,  L"Version"),
+  FIELD    (0x07, 1, SmbiosFieldString,  L"Serial Number"),
+  FIELD    (0x08, 1, SmbiosFieldString,  L"Asset Tag"),
+  FIELD_MAP(0x09, 1, SmbiosFieldBits,    L"Feature Flags", mBoardFeatures),
+  FIELD    (0x0A, 1, SmbiosFieldString,  L"Location in Chassis"),
+  FIELD    (0x0B, 2, SmbiosFieldHandle,  L"Chassis Handle"),
+  FIELD_MAP(0x0D, 1, SmbiosFieldEnum,    L"Board Type", mBoardType),
+  FIELD    (0x0E, 1, SmbiosFieldDecimal, L"Contained Object Handles")
+};
+
+STATIC CONST SMBIOS_FIELD mType3Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Manufacturer"),
+  { 0x05, 1, SmbiosFieldEnum, 0x7F, L"Type", mChassisType },
+  FIELD    (0x06, 1, SmbiosFieldString,  L"Version"),
+  FIELD    (0x07, 1, SmbiosFieldString,  L"Serial Number"),
+  FIELD    (0x08, 1, SmbiosFieldString,  L"Asset Tag"),
+  FIELD_MAP(0x09, 1, SmbiosFieldEnum,    L"Boot-up State", mChassisState),
+  FIELD_MAP(0x0A, 1, SmbiosFieldEnum,    L"Power Supply State", mChassisState),
+  FIELD_MAP(0x0B, 1, SmbiosFieldEnum,    L"Thermal State", mChassisState),
+  FIELD_MAP(0x0C, 1, SmbiosFieldEnum,    L"Security Status", mChassisSecurity),
+  FIELD    (0x0D, 4, SmbiosFieldHex,     L"OEM-defined"),
+  FIELD    (0x11, 1, SmbiosFieldDecimal, L"Height (U)"),
+  FIELD    (0x12, 1, SmbiosFieldDecimal, L"Power Cords"),
+  FIELD    (0x13, 1, SmbiosFieldDecimal, L"Contained Elements"),
+  FIELD    (0x14, 1, SmbiosFieldDecimal, L"Element Record Length")
+};
+
+STATIC CONST SMBIOS_FIELD mType4Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Socket Designation"),
+  FIELD_MAP(0x05, 1, SmbiosFieldEnum,    L"Processor Type", mProcessorType),
+  FIELD_MAP(0x06, 1, SmbiosFieldEnum,    L"Processor Family", mProcessorFamily),
+  FIELD    (0x07, 1, SmbiosFieldString,  L"Manufacturer"),
+  FIELD    (0x08, 8, SmbiosFieldHex,     L"Processor ID"),
+  FIELD    (0x10, 1, SmbiosFieldString,  L"Version"),
+  FIELD    (0x11, 1, SmbiosFieldHex,     L"Voltage"),
+  FIELD    (0x12, 2, SmbiosFieldDecimal, L"External Clock (MHz)"),
+  FIELD    (0x14, 2, SmbiosFieldDecimal, L"Max Speed (MHz)"),
+  FIELD    (0x16, 2, SmbiosFieldDecimal, L"Current Speed (MHz)"),
+  FIELD    (0x18, 1, SmbiosFieldHex,     L"Status"),
+  FIELD_MAP(0x19, 1, SmbiosFieldEnum,    L"Upgrade", mProcessorUpgrade),
+  FIELD    (0x1A, 2, SmbiosFieldHandle,  L"L1 Cache Handle"),
+  FIELD    (0x1C, 2, SmbiosFieldHandle,  L"L2 Cache Handle"),
+  FIELD    (0x1E, 2, SmbiosFieldHandle,  L"L3 Cache Handle"),
+  FIELD    (0x20, 1, SmbiosFieldString,  L"Serial Number"),
+  FIELD    (0x21, 1, SmbiosFieldString,  L"Asset Tag"),
+  FIELD    (0x22, 1, SmbiosFieldString,  L"Part Number"),
+  FIELD    (0x23, 1, SmbiosFieldDecimal, L"Core Count"),
+  FIELD    (0x24, 1, SmbiosFieldDecimal, L"Cores Enabled"),
+  FIELD    (0x25, 1, SmbiosFieldDecimal, L"Thread Count"),
+  FIELD_MAP(0x26, 2, SmbiosFieldBits,    L"Characteristics", mProcessorCharacteristics),
+  FIELD_MAP(0x28, 2, SmbiosFieldEnum,    L"Processor Family 2", mProcessorFamily),
+  FIELD    (0x2A, 2, SmbiosFieldDecimal, L"Core Count 2"),
+  FIELD    (0x2C, 2, SmbiosFieldDecimal, L"Cores Enabled 2"),
+  FIELD    (0x2E, 2, SmbiosFieldDecimal, L"Thread Count 2"),
+  FIELD    (0x30, 2, SmbiosFieldDecimal, L"Threads Enabled")
+};
+
+STATIC CONST SMBIOS_FIELD mType7Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Socket Designation"),
+  FIELD    (0x05, 2, SmbiosFieldHex,     L"Configuration"),
+  FIELD    (0x07, 2, SmbiosFieldHex,     L"Maximum Size"),
+  FIELD    (0x09, 2, SmbiosFieldHex,     L"Installed Size"),
+  FIELD_MAP(0x0B, 2, SmbiosFieldBits,    L"Supported SRAM Type", mSramType),
+  FIELD_MAP(0x0D, 2, SmbiosFieldBits,    L"Current SRAM Type", mSramType),
+  FIELD    (0x0F, 1, SmbiosFieldDecimal, L"Speed (ns)"),
+  FIELD_MAP(0x10, 1, SmbiosFieldEnum,    L"Error Correction", mErrorCorrection),
+  FIELD_MAP(0x11, 1, SmbiosFieldEnum,    L"System Cache Type", mSystemCacheType),
+  FIELD_MAP(0x12, 1, SmbiosFieldEnum,    L"Associativity", mCacheAssociativity),
+  FIELD    (0x13, 4, SmbiosFieldHex,     L"Maximum Size 2"),
+  FIELD    (0x17, 4, SmbiosFieldHex,     L"Installed Size 2")
+};
+
+STATIC CONST SMBIOS_FIELD mType9Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Slot Designation"),
+  FIELD_MAP(0x05, 1, SmbiosFieldEnum,    L"Slot Type", mSlotType),
+  FIELD_MAP(0x06, 1, SmbiosFieldEnum,    L"Data Bus Width", mSlotDataBusWidth),
+  FIELD_MAP(0x07, 1, SmbiosFieldEnum,    L"Current Usage", mSlotUsage),
+  FIELD_MAP(0x08, 1, SmbiosFieldEnum,    L"Slot Length", mSlotLength),
+  FIELD    (0x09, 2, SmbiosFieldHex,     L"Slot ID"),
+  FIELD_MAP(0x0B, 1, SmbiosFieldBits,    L"Characteristics 1", mSlotCharacteristics1),
+  FIELD_MAP(0x0C, 1, SmbiosFieldBits,    L"Characteristics 2", mSlotCharacteristics2),
+  FIELD    (0x0D, 2, SmbiosFieldHex,     L"Segment Group"),
+  FIELD    (0x0F, 1, SmbiosFieldHex,     L"Bus Number"),
+  FIELD    (0x10, 1, SmbiosFieldHex,     L"Device/Function"),
+  FIELD    (0x11, 1, SmbiosFieldDecimal, L"Data Bus Width (lanes)"),
+  FIELD    (0x12, 1, SmbiosFieldDecimal, L"Peer Grouping Count")
+};
+
+STATIC CONST SMBIOS_FIELD mType16Fields[] = {
+  FIELD_MAP(0x04, 1, SmbiosFieldEnum,    L"Location", mMemoryArrayLocation),
+  FIELD_MAP(0x05, 1, SmbiosFieldEnum,    L"Use", mMemoryArrayUse),
+  FIELD_MAP(0x06, 1, SmbiosFieldEnum,    L"Error Correction", mErrorCorrection),
+  FIELD    (0x07, 4, SmbiosFieldDecimal, L"Maximum Capacity (KB)"),
+  FIELD    (0x0B, 2, SmbiosFieldHandle,  L"Error Info Handle"),
+  FIELD    (0x0D, 2, SmbiosFieldDecimal, L"Memory Devices"),
+  FIELD    (0x0F, 8, SmbiosFieldDecimal, L"Extended Max Capacity (B)")
+};
+
+STATIC CONST SMBIOS_FIELD mType17Fields[] = {
+  FIELD    (0x04, 2, SmbiosFieldHandle,     L"Physical Array Handle"),
+  FIELD    (0x06, 2, SmbiosFieldHandle,     L"Error Info Handle"),
+  FIELD    (0x08, 2, SmbiosFieldDecimal,    L"Total Width (bits)"),
+  FIELD    (0x0A, 2, SmbiosFieldDecimal,    L"Data Width (bits)"),
+  FIELD    (0x0C, 2, SmbiosFieldMemorySize, L"Size"),
+  FIELD_MAP(0x0E, 1, SmbiosFieldEnum,       L"Form Factor", mMemoryFormFactor),
+  FIELD    (0x0F, 1, SmbiosFieldHex,        L"Device Set"),
+  FIELD    (0x10, 1, SmbiosFieldString,     L"Device Locator"),
+  FIELD    (0x11, 1, SmbiosFieldString,     L"Bank Locator"),
+  FIELD_MAP(0x12, 1, SmbiosFieldEnum,       L"Memory Type", mMemoryType),
+  FIELD_MAP(0x13, 2, SmbiosFieldBits,       L"Type Detail", mMemoryTypeDetail),
+  FIELD    (0x15, 2, SmbiosFieldDecimal,    L"Speed (MT/s)"),
+  FIELD    (0x17, 1, SmbiosFieldString,     L"Manufacturer"),
+  FIELD    (0x18, 1, SmbiosFieldString,     L"Serial Number"),
+  FIELD    (0x19, 1, SmbiosFieldString,     L"Asset Tag"),
+  FIELD    (0x1A, 1, SmbiosFieldString,     L"Part Number"),
+  FIELD    (0x1B, 1, SmbiosFieldHex,        L"Attributes (rank)"),
+  FIELD    (0x1C, 4, SmbiosFieldDecimal,    L"Extended Size (MB)"),
+  FIELD    (0x20, 2, SmbiosFieldDecimal,    L"Configured Speed (MT/s)"),
+  FIELD    (0x22, 2, SmbiosFieldDecimal,    L"Minimum Voltage (mV)"),
+  FIELD    (0x24, 2, SmbiosFieldDecimal,    L"Maximum Voltage (mV)"),
+  FIELD    (0x26, 2, SmbiosFieldDecimal,    L"Configured Voltage (mV)"),
+  FIELD_MAP(0x28, 1, SmbiosFieldEnum,       L"Memory Technology", mMemoryTechnology),
+  FIELD    (0x2B, 1, SmbiosFieldString,     L"Firmware Version"),
+  FIELD    (0x2C, 2, SmbiosFieldHex,        L"Module Manufacturer ID"),
+  FIELD    (0x2E, 2, SmbiosFieldHex,        L"Module Product ID"),
+  FIELD    (0x54, 4, SmbiosFieldDecimal,    L"Extended Speed (MT/s)"),
+  FIELD    (0x58, 4, SmbiosFieldDecimal,    L"Extended Configured Speed")
+};
+
+STATIC CONST SMBIOS_FIELD mType19Fields[] = {
+  FIELD    (0x04, 4, SmbiosFieldHex,     L"Starting Address (KB)"),
+  FIELD    (0x08, 4, SmbiosFieldHex,     L"Ending Address (KB)"),
+  FIELD    (0x0C, 2, SmbiosFieldHandle,  L"Memory Array Handle"),
+  FIELD    (0x0E, 1, SmbiosFieldDecimal, L"Partition Width"),
+  FIELD    (0x0F, 8, SmbiosFieldHex,     L"Extended Starting Address"),
+  FIELD    (0x17, 8, SmbiosFieldHex,     L"Extended Ending Address")
+};
+
+STATIC CONST SMBIOS_FIELD mType38Fields[] = {
+  FIELD_MAP(0x04, 1, SmbiosFieldEnum,    L"Interface Type", mIpmiInterfaceType),
+  FIELD    (0x05, 1, SmbiosFieldHex,     L"IPMI Revision (BCD)"),
+  FIELD    (0x06, 1, SmbiosFieldHex,     L"I2C Target Address"),
+  FIELD    (0x07, 1, SmbiosFieldHex,     L"NV Storage Address"),
+  FIELD    (0x08, 8, SmbiosFieldHex,     L"Base Address"),
+  FIELD    (0x10, 1, SmbiosFieldHex,     L"Address Modifier"),
+  FIELD    (0x11, 1, SmbiosFieldDecimal, L"Interrupt Number")
+};
+
+STATIC CONST SMBIOS_FIELD mType41Fields[] = {
+  FIELD    (0x04, 1, SmbiosFieldString,  L"Reference Designation"),
+  { 0x05, 1, SmbiosFieldEnum, 0x7F, L"Device Type", mOnboardDeviceType },
+  FIELD    (0x06, 1, SmbiosFieldDecimal, L"Device Type Instance"),
+  FIELD    (0x07, 2, SmbiosFieldHex,     L"Segment Group"),
+  FIELD    (0x09, 1, SmbiosFieldHex,     L"Bus Number"),
+  FIELD    (0x0A, 1, SmbiosFieldHex,     L"Device/Function")
+};
+
+STATIC CONST SMBIOS_FIELD mType43Fields[] = {
+  FIELD    (0x04, 4, SmbiosFieldHex,     L"Vendor ID"),
+  FIELD    (0x08, 1, SmbiosFieldDecimal, L"Spec Major Version"),
+  FIELD    (0x09, 1, SmbiosFieldDecimal, L"Spec Minor Version"),
+  FIELD    (0x0A, 4, SmbiosFieldHex,     L"Firmware Version 1"),
+  FIELD    (0x0E, 4, SmbiosFieldHex,     L"Firmware Version 2"),
+  FIELD    (0x12, 1, SmbiosFieldString,  L"Description"),
+  FIELD_MAP(0x13, 8, SmbiosFieldBits,    L"Characteristics", mTpmCharacteristics),
+  FIELD    (0x1B, 4, SmbiosFieldHex,     L"OEM-defined")
+};
+
+STATIC CONST SMBIOS_LAYOUT mSmbiosLayouts[] = {
+  { SMBIOS_TYPE_BIOS_INFORMATION,               mType0Fields,  ARRAY_SIZE(mType0Fields)  },
+  { SMBIOS_TYPE_SYSTEM_INFORMATION,             mType1Fields,  ARRAY_SIZE(mType1Fields)  },
+  { SMBIOS_TYPE_BASEBOARD_INFORMATION,          mType2Fields,  ARRAY_SIZE(mType2Fields)  },
+  { SMBIOS_TYPE_SYSTEM_ENCLOSURE,               mType3Fields,  ARRAY_SIZE(mType3Fields)  },
+  { SMBIOS_TYPE_PROCESSOR_INFORMATION,          mType4Fields,  ARRAY_SIZE(mType4Fields)  },
+  { SMBIOS_TYPE_CACHE_INFORMATION,              mType7Fields,  ARRAY_SIZE(mType7Fields)  },
+  { SMBIOS_TYPE_SYSTEM_SLOTS,                   mType9Fields,  ARRAY_SIZE(mType9Fields)  },
+  { SMBIOS_TYPE_PHYSICAL_MEMORY_ARRAY,          mType16Fields, ARRAY_SIZE(mType16Fields) },
+  { SMBIOS_TYPE_MEMORY_DEVICE,                  mType17Fields, ARRAY_SIZE(mType17Fields) },
+  { SMBIOS_TYPE_MEMORY_ARRAY_MAPPED_ADDRESS,    mType19Fields, ARRAY_SIZE(mType19Fields) },
+  { SMBIOS_TYPE_IPMI_DEVICE_INFORMATION,        mType38Fields, ARRAY_SIZE(mType38Fields) },
+  { SMBIOS_TYPE_ONBOARD_DEVICES_EXTENDED_INFORMATION, mType41Fields, ARRAY_SIZE(mType41Fields) },
+  { 43 /* TPM Device */,                        mType43Fields, ARRAY_SIZE(mType43Fields) }
+};
+
+/**
+  Find the layout for a type, or NULL.
+*/
+STATIC
+CONST SMBIOS_LAYOUT *
+FindSmbiosLayout(
+  IN UINT8  Type
+  )
+{
+  for (UINTN i = 0; i < ARRAY_SIZE(mSmbiosLayouts); i++) {
+    if (mSmbiosLayouts[i].Type == Type) {
+      return &mSmbiosLayouts[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+  Look up a value in a map, or NULL.
+*/
+STATIC
+CONST CHAR16 *
+LookupValueName(
+  IN CONST SMBIOS_VALUE_NAME  *Map,
+  IN UINT64                   Value
+  )
+{
+  for (; Map->Name != NULL; Map++) {
+    if (Map->Value == Value) {
+      return Map->Name;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Print the value of one field (label already printed).
+*/
+STATIC
+VOID
+PrintSmbiosFieldValue(
+  IN SMBIOS_ENTRY        *Entry,
+  IN CONST SMBIOS_FIELD  *Field
+  )
+{
+  CONST UINT8  *Data = (CONST UINT8 *)Entry->Header + Field->Offset;
+  UINT64       Value = 0;
+  CONST CHAR16 *Name;
+  BOOLEAN      First;
+
+  // Records are byte packed, so read through CopyMem rather than casts
+  if (Field->Width <= sizeof(Value)) {
+    CopyMem(&Value, Data, Field->Width);
+  }
+
+  switch (Field->Kind) {
+    case SmbiosFieldString:
+      Print(L"%a", GetSmbiosString(Entry, Data[0]));
+      break;
+
+    case SmbiosFieldDecimal:
+      Print(L"%ld", Value);
+      break;
+
+    case SmbiosFieldEnum:
+      if (Field->Mask != 0) {
+        Value &= Field->Mask;
+      }
+      Name = LookupValueName(Field->Map, Value);
+      if (Name != NULL) {
+        Print(L"%s", Name);
+      } else {
+        Print(L"0x%lX", Value);
+      }
+      break;
+
+    case SmbiosFieldBits:
+      Print(L"0x%0*lX", Field->Width * 2, Value);
+      First = TRUE;
+      for (UINTN Bit = 0; Bit < Field->Width * 8U; Bit++) {
+        if ((Value & LShiftU64(1, Bit)) == 0) continue;
+        Name = LookupValueName(Field->Map, Bit);
+        if (Name == NULL) continue;
+        Print(First ? L" (%s" : L", %s", Name);
+        First = FALSE;
+      }
+      if (!First) {
+        Print(L")");
+      }
+      break;
+
+    case SmbiosFieldHandle:
+      if (Value == 0xFFFF) {
+        Print(L"None");
+      } else {
+        Print(L"0x%04lX", Value);
+      }
+      break;
+
+    case SmbiosFieldUuid:
+      // The first three fields are little-endian, as in EFI_GUID
+      Print(L"%g", (EFI_GUID *)Data);
+      break;
+
+    case SmbiosFieldMemorySize:
+      if (Value == 0) {
+        Print(L"No module installed");
+      } else if (Value == 0xFFFF) {
+        Print(L"Unknown");
+      } else if (Value == 0x7FFF) {
+        Print(L"See Extended Size");
+      } else {
+        Print(L"%ld %s", Value & 0x7FFF, (Value & BIT15) ? L"KB" : L"MB");
+      }
+      break;
+
+    default:
+      Print(L"0x%0*lX", Field->Width * 2, Value);
+      break;
+  }
+}
+
+CONST CHAR16 *
+GetSmbiosMemoryTypeName(
+  IN UINT8  MemoryType
+  )
+{
+  return LookupValueName(mMemoryType, MemoryType);
+}
+
+BOOLEAN
+HasSmbiosLayout(
+  IN UINT8  Type
+  )
+{
+  return (BOOLEAN)(FindSmbiosLayout(Type) != NULL);
+}
+
+BOOLEAN
+PrintSmbiosFields(
+  IN SMBIOS_ENTRY  *Entry
+  )
+{
+  CONST SMBIOS_LAYOUT *Layout = FindSmbiosLayout(Entry->Header->Type);
+
+  if (Layout == NULL) {
+    return FALSE;
+  }
+
+  for (UINTN i = 0; i < Layout->FieldCount; i++) {
+    CONST SMBIOS_FIELD *Field = &Layout->Fields[i];
+
+    // Shorter records come from older spec versions and lack the later fields
+    if ((UINTN)Field->Offset + Field->Width > Entry->Header->Length) {
+      continue;
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"  %-27s ", Field->Label);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    PrintSmbiosFieldValue(Entry, Field);
+    Print(L"\n");
+  }
+  return TRUE;
+}
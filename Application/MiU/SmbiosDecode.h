@@ -0,0 +1,33 @@
+#pragma once
+#include <Uefi.h>
+#include "Smbios.h"
+
+/**
+  Returns TRUE if a field layout is described for the given SMBIOS type.
+*/
+BOOLEAN
+HasSmbiosLayout(
+  IN UINT8  Type
+  );
+
+/**
+  Returns the name of a Type 17 Memory Type value, or NULL if unknown.
+*/
+CONST CHAR16 *
+GetSmbiosMemoryTypeName(
+  IN UINT8  MemoryType
+  );
+
+/**
+  Prints the decoded fields of one SMBIOS record from its layout table.
+  Fields past the record's Length (older SMBIOS versions) are skipped.
+
+  @param  Entry  The indexed SMBIOS record.
+
+  @retval TRUE   The record type has a layout and was printed.
+  @retval FALSE  No layout is described for this type.
+*/
+BOOLEAN
+PrintSmbiosFields(
+  IN SMBIOS_ENTRY  *Entry
+  );
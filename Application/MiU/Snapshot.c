@@ -0,0 +1,424 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "Snapshot.h"
+#include "MiuLz.h"
+#include "ACPI.h"
+#include "Variables.h"
+#include "PciDevices.h"
+#include "Smbios.h"
+#include "LoadOption.h"
+#include "ConfigTables.h"
+
+// Collectors append through a FILE_WRITER, whose flushes are exactly one block
+STATIC_ASSERT(SNAPSHOT_BLOCK_SIZE == FILE_WRITER_BUFFER_SIZE, "snapshot blocks must match the writer buffer");
+
+typedef struct {
+  UINT32              Type;
+  CONST CHAR8         *Name;
+  SNAPSHOT_COLLECTOR  Collect;
+} SNAPSHOT_COLLECTOR_ENTRY;
+
+STATIC EFI_STATUS CollectVariables(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena, OUT UINTN *ItemCount);
+STATIC EFI_STATUS CollectMemoryMap(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena, OUT UINTN *ItemCount);
+
+//
+// Every section a capture can hold, in the order they are written
+//
+STATIC CONST SNAPSHOT_COLLECTOR_ENTRY mSnapshotCollectors[] = {
+  { SNAPSHOT_SECTION_PCI,           "pci",          WritePciSnapshotSection         },
+  { SNAPSHOT_SECTION_SMBIOS,        "smbios",       WriteSmbiosSnapshotSection      },
+  { SNAPSHOT_SECTION_ACPI,          "acpi",         WriteAcpiSnapshotSection        },
+  { SNAPSHOT_SECTION_VARIABLES,     "variables",    CollectVariables                },
+  { SNAPSHOT_SECTION_MEMORY_MAP,    "memmap",       CollectMemoryMap                },
+  { SNAPSHOT_SECTION_LOAD_OPTIONS,  "loadoptions",  WriteLoadOptionSnapshotSection  },
+  { SNAPSHOT_SECTION_CONFIG_TABLES, "configtables", WriteConfigTableSnapshotSection },
+};
+
+/**
+  The variable store as archive records, the same stream Ctrl+S writes in
+  the variable list, without the archive header.
+**/
+STATIC
+EFI_STATUS
+CollectVariables (
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *ItemCount
+  )
+{
+  EFI_STATUS Status;
+  UINT32     EndMarker = 0;
+
+  // Only a complete record stream gets the end marker
+  Status = WriteVariableArchiveRecords(Writer, Arena, ItemCount);
+  if (!EFI_ERROR(Status)) {
+    Status = FileWriterAppend(Writer, &EndMarker, sizeof(EndMarker));
+  }
+  return Status;
+}
+
+/**
+  The memory map, read into the arena. The arena is allocated up front, so
+  unlike a pool buffer, taking the buffer does not add a descriptor to the
+  map it is sized for.
+**/
+STATIC
+EFI_STATUS
+CollectMemoryMap (
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *ItemCount
+  )
+{
+  EFI_STATUS            Status;
+  EFI_MEMORY_DESCRIPTOR *Map;
+  UINTN                 MapSize;
+  UINTN                 MapKey;
+  UINTN                 DescriptorSize;
+  UINT32                DescriptorVersion;
+  SNAPSHOT_MEMORY_MAP   Header;
+
+  *ItemCount = 0;
+  MapSize    = 0;
+  Status     = gBS->GetMemoryMap(&MapSize, NULL, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR(Status) ? Status : EFI_DEVICE_ERROR;
+  }
+  // Slack for an event that changes the map in between
+  MapSize += 2 * DescriptorSize;
+  Map      = MiuArenaAlloc(Arena, MapSize);
+  if (Map == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Status = gBS->GetMemoryMap(&MapSize, Map, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  *ItemCount               = MapSize / DescriptorSize;
+  Header.DescriptorSize    = (UINT32)DescriptorSize;
+  Header.DescriptorVersion = DescriptorVersion;
+  Header.DescriptorCount   = (UINT32)*ItemCount;
+  Header.Reserved          = 0;
+  FileWriterAppend(Writer, &Header, sizeof(Header));
+  return FileWriterAppend(Writer, Map, MapSize);
+}
+
+/**
+  FILE_WRITER sink of the current section: CRC the raw bytes, then store
+  them as they are or as MiuLz blocks. Blocks that do not shrink are stored
+  raw, so incompressible data costs only the block header.
+**/
+STATIC
+EFI_STATUS
+SnapshotSectionSink (
+  IN VOID         *Context,
+  IN CONST UINT8  *Data,
+  IN UINTN        Size
+  )
+{
+  SNAPSHOT_WRITER       *Snapshot = (SNAPSHOT_WRITER *)Context;
+  SNAPSHOT_BLOCK_HEADER Block;
+  UINTN                 Chunk;
+  UINTN                 Packed;
+
+  Snapshot->Current.Crc32    = MiuCrc32Update(Snapshot->Current.Crc32, Data, Size);
+  Snapshot->Current.RawSize += Size;
+
+  if (!Snapshot->Compress) {
+    return FileWriterAppend(&Snapshot->File, Data, Size);
+  }
+
+  while (Size > 0) {
+    Chunk  = MIN(Size, SNAPSHOT_BLOCK_SIZE);
+    Packed = MiuLzCompress(Data, Chunk, Snapshot->Packed, MIULZ_BOUND(SNAPSHOT_BLOCK_SIZE), Snapshot->HashTable);
+
+    Block.RawSize = (UINT32)Chunk;
+    if (Packed == 0) {
+      Block.StoredSize = (UINT32)Chunk | SNAPSHOT_BLOCK_STORED;
+      FileWriterAppend(&Snapshot->File, &Block, sizeof(Block));
+      FileWriterAppend(&Snapshot->File, Data, Chunk);
+    } else {
+      Block.StoredSize = (UINT32)Packed;
+      FileWriterAppend(&Snapshot->File, &Block, sizeof(Block));
+      FileWriterAppend(&Snapshot->File, Snapshot->Packed, Packed);
+    }
+    Data += Chunk;
+    Size -= Chunk;
+  }
+  return Snapshot->File.Status;
+}
+
+EFI_STATUS
+SnapshotCreate (
+  IN  CHAR16           *FileName,
+  IN  BOOLEAN          Compress,
+  OUT SNAPSHOT_WRITER  *Snapshot
+  )
+{
+  EFI_STATUS      Status;
+  SNAPSHOT_HEADER Header;
+  EFI_TIME        Time;
+
+  ZeroMem(Snapshot, sizeof(*Snapshot));
+  Snapshot->Compress = Compress;
+  if (Compress) {
+    Snapshot->Packed    = AllocatePool(MIULZ_BOUND(SNAPSHOT_BLOCK_SIZE));
+    Snapshot->HashTable = AllocatePool(MIULZ_HASH_SIZE * sizeof(UINT32));
+    if (Snapshot->Packed == NULL || Snapshot->HashTable == NULL) {
+      SnapshotClose(Snapshot);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+  Status = MiuArenaInit(&Snapshot->Arena, SNAPSHOT_ARENA_SIZE);
+  if (EFI_ERROR(Status)) {
+    SnapshotClose(Snapshot);
+    return Status;
+  }
+
+  Status = FileWriterOpen(gImageHandle, FileName, &Snapshot->File);
+  if (EFI_ERROR(Status)) {
+    SnapshotClose(Snapshot);
+    return Status;
+  }
+
+  ZeroMem(&Header, sizeof(Header));
+  Header.Signature  = SNAPSHOT_SIGNATURE;
+  Header.Version    = SNAPSHOT_VERSION;
+  Header.HeaderSize = sizeof(Header);
+  Header.BlockSize  = SNAPSHOT_BLOCK_SIZE;
+  if (!EFI_ERROR(gRT->GetTime(&Time, NULL))) {
+    Header.Year   = Time.Year;
+    Header.Month  = Time.Month;
+    Header.Day    = Time.Day;
+    Header.Hour   = Time.Hour;
+    Header.Minute = Time.Minute;
+    Header.Second = Time.Second;
+  }
+  Status = FileWriterAppend(&Snapshot->File, &Header, sizeof(Header));
+  if (EFI_ERROR(Status)) {
+    SnapshotClose(Snapshot);
+  }
+  return Status;
+}
+
+EFI_STATUS
+SnapshotBeginSection (
+  IN OUT SNAPSHOT_WRITER  *Snapshot,
+  IN     UINT32           Type,
+  IN     CONST CHAR8      *Name,
+  OUT    FILE_WRITER      **Writer
+  )
+{
+  if (EFI_ERROR(Snapshot->File.Status)) {
+    return Snapshot->File.Status;
+  }
+
+  ZeroMem(&Snapshot->Current, sizeof(Snapshot->Current));
+  Snapshot->Current.Type   = Type;
+  Snapshot->Current.Flags  = Snapshot->Compress ? SNAPSHOT_SECTION_COMPRESSED : 0;
+  Snapshot->Current.Offset = Snapshot->File.BytesWritten;
+  for (UINTN i = 0; i < sizeof(Snapshot->Current.Name) - 1 && Name[i] != '\0'; i++) {
+    Snapshot->Current.Name[i] = Name[i];
+  }
+
+  MiuArenaReset(&Snapshot->Arena);
+  FileWriterOpenSink(SnapshotSectionSink, Snapshot, &Snapshot->Section);
+  *Writer = &Snapshot->Section;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+SnapshotEndSection (
+  IN OUT SNAPSHOT_WRITER  *Snapshot,
+  IN     UINTN            ItemCount
+  )
+{
+  EFI_STATUS Status;
+
+  // Closing the sink writer pushes its last partial block through the sink
+  Status = FileWriterClose(&Snapshot->Section);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  if (Snapshot->SectionCount == Snapshot->SectionCapacity) {
+    UINTN                  NewCapacity = Snapshot->SectionCapacity + 8;
+    SNAPSHOT_SECTION_ENTRY *NewTable;
+
+    NewTable = ReallocatePool(Snapshot->SectionCapacity * sizeof(SNAPSHOT_SECTION_ENTRY),
+                              NewCapacity * sizeof(SNAPSHOT_SECTION_ENTRY), Snapshot->Sections);
+    if (NewTable == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Snapshot->Sections        = NewTable;
+    Snapshot->SectionCapacity = NewCapacity;
+  }
+
+  Snapshot->Current.StoredSize = Snapshot->File.BytesWritten - Snapshot->Current.Offset;
+  Snapshot->Current.ItemCount  = (UINT32)ItemCount;
+  Snapshot->Sections[Snapshot->SectionCount++] = Snapshot->Current;
+  return Snapshot->File.Status;
+}
+
+EFI_STATUS
+SnapshotClose (
+  IN OUT SNAPSHOT_WRITER  *Snapshot
+  )
+{
+  EFI_STATUS       Status = EFI_SUCCESS;
+  SNAPSHOT_TRAILER Trailer;
+  UINTN            TableSize = Snapshot->SectionCount * sizeof(SNAPSHOT_SECTION_ENTRY);
+
+  if (Snapshot->File.File != NULL) {
+    if (!EFI_ERROR(Snapshot->File.Status)) {
+      ZeroMem(&Trailer, sizeof(Trailer));
+      Trailer.TableOffset  = Snapshot->File.BytesWritten;
+      Trailer.SectionCount = (UINT32)Snapshot->SectionCount;
+      Trailer.EntrySize    = sizeof(SNAPSHOT_SECTION_ENTRY);
+      Trailer.TableCrc32   = MiuCrc32Update(0, Snapshot->Sections, TableSize);
+      Trailer.Signature    = SNAPSHOT_END_SIGNATURE;
+      FileWriterAppend(&Snapshot->File, Snapshot->Sections, TableSize);
+      FileWriterAppend(&Snapshot->File, &Trailer, sizeof(Trailer));
+    }
+    Status = FileWriterClose(&Snapshot->File);
+  }
+
+  // A section left open by an error still owns a staging buffer
+  if (Snapshot->Section.Buffer != NULL) {
+    FreePool(Snapshot->Section.Buffer);
+  }
+  if (Snapshot->Sections != NULL) {
+    FreePool(Snapshot->Sections);
+  }
+  if (Snapshot->Packed != NULL) {
+    FreePool(Snapshot->Packed);
+  }
+  if (Snapshot->HashTable != NULL) {
+    FreePool(Snapshot->HashTable);
+  }
+  MiuArenaFree(&Snapshot->Arena);
+  ZeroMem(Snapshot, sizeof(*Snapshot));
+  return Status;
+}
+
+EFI_STATUS
+CaptureSnapshot (
+  IN  CHAR16      *FileName,
+  IN  BOOLEAN     Compress,
+  IN  UINT32      SectionMask,
+  IN  BOOLEAN     ShowProgress,
+  OUT EFI_STATUS  *CollectorStatus  OPTIONAL
+  )
+{
+  EFI_STATUS      Status;
+  EFI_STATUS      CollectStatus;
+  SNAPSHOT_WRITER Snapshot;
+  FILE_WRITER     *Writer;
+  UINTN           ItemCount;
+
+  if (CollectorStatus != NULL) {
+    *CollectorStatus = EFI_SUCCESS;
+  }
+
+  Status = SnapshotCreate(FileName, Compress, &Snapshot);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  for (UINTN i = 0; i < ARRAY_SIZE(mSnapshotCollectors); i++) {
+    CONST SNAPSHOT_COLLECTOR_ENTRY *Collector = &mSnapshotCollectors[i];
+
+    if ((SectionMask & SNAPSHOT_SELECT(Collector->Type)) == 0) {
+      continue;
+    }
+
+    Status = SnapshotBeginSection(&Snapshot, Collector->Type, Collector->Name, &Writer);
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    // A collector that fails (no ACPI, say) leaves what it wrote; only file errors abort
+    ItemCount     = 0;
+    CollectStatus = Collector->Collect(Writer, &Snapshot.Arena, &ItemCount);
+    Status        = SnapshotEndSection(&Snapshot, ItemCount);
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    if (EFI_ERROR(CollectStatus) && CollectorStatus != NULL && !EFI_ERROR(*CollectorStatus)) {
+      *CollectorStatus = CollectStatus;
+    }
+
+    if (ShowProgress) {
+      SNAPSHOT_SECTION_ENTRY *Entry = &Snapshot.Sections[Snapshot.SectionCount - 1];
+      Print(L"  %-12a %6d items %10ld -> %10ld bytes", Collector->Name, ItemCount, Entry->RawSize, Entry->StoredSize);
+      if (EFI_ERROR(CollectStatus)) {
+        Print(L"  (%r)", CollectStatus);
+      }
+      Print(L"\n");
+    }
+  }
+
+  if (EFI_ERROR(Status)) {
+    SnapshotClose(&Snapshot);
+    return Status;
+  }
+  if (ShowProgress) {
+    Print(L"  %-12s %6d sections, %ld bytes in the file, %d KB scratch\n", L"total", Snapshot.SectionCount,
+          Snapshot.File.BytesWritten + Snapshot.SectionCount * sizeof(SNAPSHOT_SECTION_ENTRY) + sizeof(SNAPSHOT_TRAILER),
+          Snapshot.Arena.Peak / SIZE_1KB);
+  }
+  return SnapshotClose(&Snapshot);
+}
+
+VOID
+ShowSnapshotCapture (
+  VOID
+  )
+{
+  EFI_STATUS    Status;
+  EFI_INPUT_KEY Key;
+  BOOLEAN       Compress;
+  CHAR16        Stem[48];
+  CHAR16        FileName[64];
+
+  gST->ConOut->ClearScreen(gST->ConOut);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+  Print(L"=== Capture Snapshot ===                \n\n");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"Writes PCI config spaces, SMBIOS, ACPI tables, variables, the memory map,\n");
+  Print(L"load options and configuration tables into one file.\n");
+  Print(L"Enter compressed, U uncompressed, ESC cancel ");
+
+  gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+  gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+  if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN || Key.UnicodeChar == L'c' || Key.UnicodeChar == L'C') {
+    Compress = TRUE;
+  } else if (Key.UnicodeChar == L'u' || Key.UnicodeChar == L'U') {
+    Compress = FALSE;
+  } else {
+    return;
+  }
+  Print(L"\n\n");
+
+  MakeTimestampStem(L"snapshot", Stem, sizeof(Stem));
+  Status = MakeExportFileName(gImageHandle, Stem, L"miu", FileName, sizeof(FileName));
+  if (!EFI_ERROR(Status)) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Status = CaptureSnapshot(FileName, Compress, SNAPSHOT_SELECT_ALL, TRUE, NULL);
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  if (EFI_ERROR(Status)) {
+    Print(L"\nCapture failed: %r\n", Status);
+  } else {
+    Print(L"\nSaved to %s\n", FileName);
+  }
+  Print(L"\nPress any key to return...");
+  gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+  gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+}
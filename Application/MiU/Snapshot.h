@@ -0,0 +1,131 @@
+#pragma once
+#include <Uefi.h>
+#include "FileHelper.h"
+#include "SnapshotFormat.h"
+#include "MiuArena.h"
+
+// Scratch shared by the collectors of one capture
+#define SNAPSHOT_ARENA_SIZE  SIZE_1MB
+
+//
+// Streaming writer for the snapshot container in SnapshotFormat.h. Sections
+// are written one after another through a FILE_WRITER sink. Each flushed
+// chunk is CRC'd and, with compression on, packed into MiuLz blocks before
+// it reaches the file, so no section is ever held in memory whole. Whatever
+// else a collector needs comes from Arena, which every section starts empty.
+//
+typedef struct {
+  FILE_WRITER             File;             // The snapshot file
+  FILE_WRITER             Section;          // Sink writer handed to collectors
+  BOOLEAN                 Compress;
+  SNAPSHOT_SECTION_ENTRY  Current;          // Section being written
+  SNAPSHOT_SECTION_ENTRY  *Sections;        // Finished sections, for the table
+  UINTN                   SectionCount;
+  UINTN                   SectionCapacity;
+  UINT8                   *Packed;          // One compressed block
+  UINT32                  *HashTable;       // MiuLz match finder scratch
+  MIU_ARENA               Arena;            // Collector scratch
+} SNAPSHOT_WRITER;
+
+//
+// Fills one section through Writer and reports how many items it wrote.
+// Arena is empty on entry; its memory is dropped after the section.
+//
+typedef
+EFI_STATUS
+(*SNAPSHOT_COLLECTOR) (
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena,
+  OUT    UINTN        *ItemCount
+  );
+
+// Bit of a section type in the SectionMask of CaptureSnapshot()
+#define SNAPSHOT_SELECT(Type)  (1U << (Type))
+#define SNAPSHOT_SELECT_ALL    MAX_UINT32
+
+/**
+  Create a snapshot file on the export volume and write its header.
+
+  @param[in]   FileName  Name of the file, see MakeExportFileName().
+  @param[in]   Compress  TRUE to store sections as MiuLz blocks.
+  @param[out]  Snapshot  The writer to initialize.
+
+  @retval EFI_SUCCESS  The header was written; close with SnapshotClose().
+  @retval others       Nothing is left open.
+**/
+EFI_STATUS
+SnapshotCreate (
+  IN  CHAR16           *FileName,
+  IN  BOOLEAN          Compress,
+  OUT SNAPSHOT_WRITER  *Snapshot
+  );
+
+/**
+  Start a section. Everything appended to *Writer until SnapshotEndSection()
+  becomes its payload. Snapshot->Arena is reset for the section.
+
+  @param[in,out]  Snapshot  An open snapshot with no section in progress.
+  @param[in]      Type      SNAPSHOT_SECTION_*.
+  @param[in]      Name      Short name stored in the section table.
+  @param[out]     Writer    Receives the section writer.
+**/
+EFI_STATUS
+SnapshotBeginSection (
+  IN OUT SNAPSHOT_WRITER  *Snapshot,
+  IN     UINT32           Type,
+  IN     CONST CHAR8      *Name,
+  OUT    FILE_WRITER      **Writer
+  );
+
+/**
+  Flush the current section and record it in the section table.
+**/
+EFI_STATUS
+SnapshotEndSection (
+  IN OUT SNAPSHOT_WRITER  *Snapshot,
+  IN     UINTN            ItemCount
+  );
+
+/**
+  Write the section table and trailer and close the file. Safe to call
+  after errors; the file is then left without a trailer.
+
+  @retval EFI_SUCCESS  The snapshot is complete.
+  @retval others       The first write error.
+**/
+EFI_STATUS
+SnapshotClose (
+  IN OUT SNAPSHOT_WRITER  *Snapshot
+  );
+
+/**
+  Run the selected collectors once each into a new snapshot file.
+
+  @param[in]   FileName         Name of the file on the export volume.
+  @param[in]   Compress         TRUE to compress the sections.
+  @param[in]   SectionMask      SNAPSHOT_SELECT() bits, or SNAPSHOT_SELECT_ALL.
+  @param[in]   ShowProgress     Print one line per section as it completes.
+  @param[out]  CollectorStatus  Receives the first collector error, or
+                                EFI_SUCCESS if every collector succeeded.
+
+  @retval EFI_SUCCESS  Every selected section was written; a collector
+                       that found nothing leaves an empty section.
+  @retval others       The file could not be written.
+**/
+EFI_STATUS
+CaptureSnapshot (
+  IN  CHAR16      *FileName,
+  IN  BOOLEAN     Compress,
+  IN  UINT32      SectionMask,
+  IN  BOOLEAN     ShowProgress,
+  OUT EFI_STATUS  *CollectorStatus  OPTIONAL
+  );
+
+/**
+  Ask for compression, capture every section into a numbered
+  snapshot_<time>_NNN.miu on the export volume and show the result.
+**/
+VOID
+ShowSnapshotCapture (
+  VOID
+  );
@@ -0,0 +1,158 @@
+#ifndef SNAPSHOT_FORMAT_H_
+#define SNAPSHOT_FORMAT_H_
+
+//
+// On-disk layout of a MiU snapshot. Everything is little-endian and
+// byte-packed:
+//
+//   SNAPSHOT_HEADER
+//   section payloads                                  (back to back)
+//   SNAPSHOT_SECTION_ENTRY[SectionCount]              (the section table)
+//   SNAPSHOT_TRAILER                                  (last bytes of the file)
+//
+// A reader seeks to the trailer, reads the section table and can then read
+// any single section without touching the others. Crc32 is the CRC-32 of
+// the section's uncompressed bytes (MiuCrc32Update), so a section can be
+// verified after decompression.
+//
+// A section with SNAPSHOT_SECTION_COMPRESSED is stored as a run of blocks,
+// each a SNAPSHOT_BLOCK_HEADER followed by StoredSize bytes. The block is a
+// MiuLz block, or raw bytes if SNAPSHOT_BLOCK_STORED is set. Every block
+// except the last expands to SNAPSHOT_HEADER.BlockSize bytes. Sections
+// without the flag are the raw bytes.
+//
+// Readers skip section types they do not know, so adding a section type
+// does not change SNAPSHOT_VERSION; changing a layout below does.
+//
+// Tools/MiuSnap builds this header on the host to read and diff snapshots;
+// keep it free of anything beyond Base.h.
+//
+#define SNAPSHOT_SIGNATURE      SIGNATURE_64 ('M', 'I', 'U', 'S', 'N', 'A', 'P', '\0')
+#define SNAPSHOT_END_SIGNATURE  SIGNATURE_64 ('M', 'I', 'U', 'S', 'N', 'E', 'N', 'D')
+#define SNAPSHOT_VERSION        1
+
+#define SNAPSHOT_SECTION_COMPRESSED  BIT0
+
+#define SNAPSHOT_BLOCK_STORED   BIT31
+#define SNAPSHOT_BLOCK_SIZE     SIZE_64KB
+
+//
+// Section types and their payloads
+//
+#define SNAPSHOT_SECTION_ACPI           1   // SNAPSHOT_ACPI_TABLE + table bytes, repeated
+#define SNAPSHOT_SECTION_VARIABLES      2   // VARIABLE_ARCHIVE_RECORDs as in VariableArchive.h,
+                                            // ending with a UINT32 0
+#define SNAPSHOT_SECTION_MEMORY_MAP     3   // SNAPSHOT_MEMORY_MAP + descriptors
+#define SNAPSHOT_SECTION_PCI            4   // SNAPSHOT_PCI_DEVICE + config space, repeated
+#define SNAPSHOT_SECTION_SMBIOS         5   // SNAPSHOT_SMBIOS, then SNAPSHOT_SMBIOS_RECORD +
+                                            // structure bytes, repeated
+#define SNAPSHOT_SECTION_LOAD_OPTIONS   6   // SNAPSHOT_LOAD_OPTION + variable bytes, repeated
+#define SNAPSHOT_SECTION_CONFIG_TABLES  7   // SNAPSHOT_SYSTEM_TABLE, then one
+                                            // SNAPSHOT_CONFIG_TABLE per entry
+
+#pragma pack(1)
+
+typedef struct {
+  UINT64    Signature;        // SNAPSHOT_SIGNATURE
+  UINT16    Version;          // SNAPSHOT_VERSION
+  UINT16    HeaderSize;       // sizeof (SNAPSHOT_HEADER)
+  UINT32    BlockSize;        // Uncompressed bytes per block of compressed sections
+  UINT16    Year;             // Capture time from the RTC, 0 if unavailable
+  UINT8     Month;
+  UINT8     Day;
+  UINT8     Hour;
+  UINT8     Minute;
+  UINT8     Second;
+  UINT8     Reserved[9];
+} SNAPSHOT_HEADER;
+
+typedef struct {
+  UINT32    Type;             // SNAPSHOT_SECTION_*
+  UINT32    Flags;            // SNAPSHOT_SECTION_COMPRESSED
+  UINT64    Offset;           // File offset of the payload
+  UINT64    StoredSize;       // Payload bytes in the file
+  UINT64    RawSize;          // Payload bytes after decompression
+  UINT32    Crc32;            // CRC-32 of the uncompressed payload
+  UINT32    ItemCount;        // Tables, variables, descriptors... as the collector counts them
+  CHAR8     Name[16];         // Short NUL-padded name, e.g. "acpi"
+} SNAPSHOT_SECTION_ENTRY;
+
+typedef struct {
+  UINT64    TableOffset;      // File offset of the first SNAPSHOT_SECTION_ENTRY
+  UINT32    SectionCount;
+  UINT32    EntrySize;        // sizeof (SNAPSHOT_SECTION_ENTRY)
+  UINT32    TableCrc32;       // CRC-32 of the section table
+  UINT32    Reserved;
+  UINT64    Signature;        // SNAPSHOT_END_SIGNATURE
+} SNAPSHOT_TRAILER;
+
+typedef struct {
+  UINT32    StoredSize;       // Bytes that follow; SNAPSHOT_BLOCK_STORED if raw
+  UINT32    RawSize;          // Bytes after decompression
+} SNAPSHOT_BLOCK_HEADER;
+
+typedef struct {
+  UINT64    Address;          // Physical address the table was found at
+  UINT32    Length;           // Bytes of table that follow
+  UINT32    Reserved;
+} SNAPSHOT_ACPI_TABLE;
+
+typedef struct {
+  UINT32    DescriptorSize;
+  UINT32    DescriptorVersion;
+  UINT32    DescriptorCount;
+  UINT32    Reserved;
+} SNAPSHOT_MEMORY_MAP;
+
+typedef struct {
+  UINT16    Segment;
+  UINT8     Bus;
+  UINT8     Device;
+  UINT8     Function;
+  UINT8     Reserved;
+  UINT16    VendorId;
+  UINT16    DeviceId;
+  UINT32    ConfigSize;       // Bytes of config space that follow: 256, or 4096 for PCIe
+} SNAPSHOT_PCI_DEVICE;
+
+typedef struct {
+  UINT8     MajorVersion;     // From the entry point or the SMBIOS protocol
+  UINT8     MinorVersion;
+  UINT16    Reserved;
+  UINT32    RecordCount;
+} SNAPSHOT_SMBIOS;
+
+typedef struct {
+  UINT16    Handle;
+  UINT8     Type;
+  UINT8     Reserved;
+  UINT32    Length;           // Formatted area and string set; the formatted
+                              // area only if the set was unterminated
+} SNAPSHOT_SMBIOS_RECORD;
+
+typedef struct {
+  UINT8     Type;             // 0 Boot, 1 Driver, 2 SysPrep, 3 PlatformRecovery
+  UINT8     Flags;            // BIT0 named by BootNext, BIT1 by BootCurrent
+  UINT16    Number;           // The #### of the variable name
+  UINT16    OrderPosition;    // 1-based position in BootOrder etc., 0 if not listed
+  UINT16    Reserved;
+  UINT32    Attributes;       // Variable attributes
+  UINT32    DataSize;         // Bytes of the variable that follow
+} SNAPSHOT_LOAD_OPTION;
+
+typedef struct {
+  UINT32    UefiRevision;     // EFI_SYSTEM_TABLE.Hdr.Revision
+  UINT32    FirmwareRevision;
+  UINT32    TableCount;       // SNAPSHOT_CONFIG_TABLEs that follow
+  UINT32    Reserved;
+  CHAR16    FirmwareVendor[32];  // NUL-terminated, cut to fit
+} SNAPSHOT_SYSTEM_TABLE;
+
+typedef struct {
+  GUID      VendorGuid;
+  UINT64    Address;          // VendorTable pointer
+} SNAPSHOT_CONFIG_TABLE;
+
+#pragma pack()
+
+#endif // SNAPSHOT_FORMAT_H_
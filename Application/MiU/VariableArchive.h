@@ -0,0 +1,38 @@
+#ifndef VARIABLE_ARCHIVE_H_
+#define VARIABLE_ARCHIVE_H_
+
+//
+// On-disk layout of the variable archive written by ExportAllVariables().
+// Everything is little-endian and byte-packed:
+//
+//   VARIABLE_ARCHIVE_HEADER
+//   VARIABLE_ARCHIVE_RECORD + Name (UTF-16, NUL terminated) + Data   (repeated)
+//   UINT32 0                                                         (end marker)
+//
+// RecordSize counts the record header, the name and the data, so a reader
+// can skip any record without decoding it. Tools/MiuVarArchive.py parses
+// this format on the host; Tools/MiuSnap decodes the same records in the
+// variables section of a snapshot.
+//
+#define VARIABLE_ARCHIVE_SIGNATURE  SIGNATURE_64 ('M', 'I', 'U', 'V', 'A', 'R', 'S', '\0')
+#define VARIABLE_ARCHIVE_VERSION    1
+
+#pragma pack(1)
+
+typedef struct {
+  UINT64    Signature;        // VARIABLE_ARCHIVE_SIGNATURE
+  UINT32    Version;          // VARIABLE_ARCHIVE_VERSION
+  UINT32    HeaderSize;       // sizeof (VARIABLE_ARCHIVE_HEADER)
+} VARIABLE_ARCHIVE_HEADER;
+
+typedef struct {
+  UINT32      RecordSize;     // Header + NameSize + DataSize; 0 ends the archive
+  UINT32      Attributes;
+  EFI_GUID    VendorGuid;
+  UINT32      NameSize;       // Bytes, including the terminating NUL
+  UINT32      DataSize;       // Bytes
+} VARIABLE_ARCHIVE_RECORD;
+
+#pragma pack()
+
+#endif // VARIABLE_ARCHIVE_H_
@@ -0,0 +1,354 @@
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include "VariableUsage.h"
+#include "GuidNames.h"
+
+//
+// Attribute combinations passed to QueryVariableInfo. Firmware keeps separate
+// (or separately accounted) stores for these, so each one is reported.
+//
+typedef struct {
+  UINT32          Attributes;
+  CONST CHAR16    *Label;
+} STORE_QUERY;
+
+STATIC CONST STORE_QUERY mStoreQueries[] = {
+  { EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,                                    L"NV+BS"            },
+  { EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,      L"NV+BS+RT"         },
+  { EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS |
+    EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS,                                             L"NV+BS+RT+AT"      },
+  { EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS |
+    EFI_VARIABLE_HARDWARE_ERROR_RECORD,                                                             L"NV+BS+RT+HR"      },
+  { EFI_VARIABLE_BOOTSERVICE_ACCESS,                                                                L"BS (volatile)"    },
+  { EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,                                  L"BS+RT (volatile)" },
+};
+
+// Variables sharing a vendor GUID and attribute set
+typedef struct {
+  EFI_GUID    VendorGuid;
+  UINT32      Attributes;
+  UINTN       Count;
+  UINTN       Bytes;
+} USAGE_GROUP;
+
+typedef enum {
+  UsagePageCapacity,
+  UsagePageGroups,
+  UsagePageTop,
+  UsagePageMax
+} USAGE_PAGE;
+
+STATIC CONST CHAR16 *mUsagePageName[UsagePageMax] = {
+  L"Store capacity", L"By GUID/attributes", L"Top consumers"
+};
+
+/**
+  Approximate store footprint of a variable: its name plus its data.
+**/
+STATIC
+UINTN
+VariableFootprint(
+  IN CONST VARIABLE_ENTRY  *Entry
+  )
+{
+  return Entry->DataSize + (Entry->NameLength + 1) * sizeof(CHAR16);
+}
+
+STATIC
+INTN
+EFIAPI
+CompareByGuidAndAttributes(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST VARIABLE_ENTRY *A = *(CONST VARIABLE_ENTRY **)Buffer1;
+  CONST VARIABLE_ENTRY *B = *(CONST VARIABLE_ENTRY **)Buffer2;
+  INTN                 Result;
+
+  Result = CompareMem(&A->VendorGuid, &B->VendorGuid, sizeof(EFI_GUID));
+  if (Result == 0 && A->Attributes != B->Attributes) {
+    Result = (A->Attributes < B->Attributes) ? -1 : 1;
+  }
+  return Result;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareByFootprint(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  UINTN A = VariableFootprint(*(CONST VARIABLE_ENTRY **)Buffer1);
+  UINTN B = VariableFootprint(*(CONST VARIABLE_ENTRY **)Buffer2);
+
+  if (A == B) {
+    return 0;
+  }
+  return (A > B) ? -1 : 1;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareGroupsByBytes(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST USAGE_GROUP *A = (CONST USAGE_GROUP *)Buffer1;
+  CONST USAGE_GROUP *B = (CONST USAGE_GROUP *)Buffer2;
+
+  if (A->Bytes == B->Bytes) {
+    return 0;
+  }
+  return (A->Bytes > B->Bytes) ? -1 : 1;
+}
+
+/**
+  Print a GUID as its friendly name when known, raw otherwise, padded to Width.
+**/
+STATIC
+VOID
+PrintGuidColumn(
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           Width
+  )
+{
+  CONST CHAR16 *Name = GetGuidName(Guid);
+
+  if (Name != NULL) {
+    Print(L"%-*s", Width, Name);
+  } else {
+    Print(L"%g", Guid);
+    if (Width > 36) {
+      Print(L"%*s", Width - 36, L"");
+    }
+  }
+}
+
+/**
+  Page 1: QueryVariableInfo results plus totals from the enumeration.
+**/
+STATIC
+VOID
+DrawCapacityPage(
+  IN VARIABLE_ENTRY  *List,
+  IN UINTN           VarCount
+  )
+{
+  UINTN NvBytes       = 0;
+  UINTN VolatileBytes = 0;
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%-18s %12s %12s %12s %5s %10s\n",
+        L"Attributes", L"Maximum", L"Remaining", L"Used", L"Use%", L"Max var");
+
+  for (UINTN i = 0; i < ARRAY_SIZE(mStoreQueries); i++) {
+    UINT64     Maximum   = 0;
+    UINT64     Remaining = 0;
+    UINT64     MaxVar    = 0;
+    EFI_STATUS Status;
+
+    Status = gRT->QueryVariableInfo(mStoreQueries[i].Attributes, &Maximum, &Remaining, &MaxVar);
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"%-18s ", mStoreQueries[i].Label);
+    if (EFI_ERROR(Status)) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+      Print(L"%r\n", Status);
+      continue;
+    }
+
+    UINT64 Used    = (Maximum > Remaining) ? (Maximum - Remaining) : 0;
+    UINTN  Percent = (Maximum != 0) ? (UINTN)DivU64x64Remainder(MultU64x32(Used, 100), Maximum, NULL) : 0;
+
+    // Flag stores that are close to exhaustion
+    if (Percent >= 90) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTRED, EFI_BLUE));
+    } else if (Percent >= 75) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    } else {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    }
+    Print(L"%12lu %12lu %12lu %4u%% %10lu\n", Maximum, Remaining, Used, Percent, MaxVar);
+  }
+
+  for (UINTN i = 0; i < VarCount; i++) {
+    if (List[i].Attributes & EFI_VARIABLE_NON_VOLATILE) {
+      NvBytes += VariableFootprint(&List[i]);
+    } else {
+      VolatileBytes += VariableFootprint(&List[i]);
+    }
+  }
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"\nEnumerated %u variables: %u bytes non-volatile, %u bytes volatile (name+data)\n",
+        VarCount, NvBytes, VolatileBytes);
+  Print(L"Used space above the enumerated total is header overhead or\n");
+  Print(L"deleted variables waiting for reclaim.\n");
+}
+
+/**
+  Page 2: usage grouped by vendor GUID and attribute set, largest first.
+**/
+STATIC
+VOID
+DrawGroupsPage(
+  IN USAGE_GROUP  *Groups,
+  IN UINTN        GroupCount,
+  IN UINTN        Top,
+  IN UINTN        Visible
+  )
+{
+  CHAR16 AttrBuf[20];
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%-36s %-15s %6s %10s\n", L"Vendor GUID", L"Attributes", L"Count", L"Bytes");
+
+  for (UINTN i = Top; i < GroupCount && i < Top + Visible; i++) {
+    BuildAttributeString(Groups[i].Attributes, AttrBuf, ARRAY_SIZE(AttrBuf));
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    PrintGuidColumn(&Groups[i].VendorGuid, 36);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    Print(L" %-15s %6u %10u\n", AttrBuf, Groups[i].Count, Groups[i].Bytes);
+  }
+}
+
+/**
+  Page 3: individual variables ordered by footprint, largest first.
+**/
+STATIC
+VOID
+DrawTopPage(
+  IN VARIABLE_ENTRY  **BySize,
+  IN UINTN           VarCount,
+  IN UINTN           Top,
+  IN UINTN           Visible
+  )
+{
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%4s %-30s %-36s %8s\n", L"#", L"Name", L"Vendor GUID", L"Bytes");
+
+  for (UINTN i = Top; i < VarCount && i < Top + Visible; i++) {
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"%4u %-30s ", i + 1, BySize[i]->Name);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+    PrintGuidColumn(&BySize[i]->VendorGuid, 36);
+    Print(L" %8u\n", VariableFootprint(BySize[i]));
+  }
+}
+
+VOID
+ShowVariableUsage(
+  IN VARIABLE_ENTRY  *List,
+  IN UINTN           VarCount
+  )
+{
+  VARIABLE_ENTRY  **ByGroup;
+  VARIABLE_ENTRY  **BySize;
+  VARIABLE_ENTRY  *Scratch;
+  USAGE_GROUP     *Groups;
+  USAGE_GROUP     GroupScratch;
+  UINTN           GroupCount = 0;
+  USAGE_PAGE      Page = UsagePageCapacity;
+  UINTN           Top  = 0;
+  UINTN           Columns, Rows, Visible;
+  EFI_INPUT_KEY   Key;
+
+  if (VarCount == 0) {
+    return;
+  }
+
+  ByGroup = AllocatePool(sizeof(*ByGroup) * VarCount);
+  BySize  = AllocatePool(sizeof(*BySize) * VarCount);
+  Groups  = AllocateZeroPool(sizeof(*Groups) * VarCount);
+  if (ByGroup == NULL || BySize == NULL || Groups == NULL) {
+    if (ByGroup != NULL) FreePool(ByGroup);
+    if (BySize != NULL)  FreePool(BySize);
+    if (Groups != NULL)  FreePool(Groups);
+    return;
+  }
+
+  //
+  // Group: sort by (GUID, attributes), then collapse runs
+  //
+  for (UINTN i = 0; i < VarCount; i++) {
+    ByGroup[i] = &List[i];
+    BySize[i]  = &List[i];
+  }
+  QuickSort(ByGroup, VarCount, sizeof(*ByGroup), CompareByGuidAndAttributes, &Scratch);
+  for (UINTN i = 0; i < VarCount; i++) {
+    if (i == 0 || CompareByGuidAndAttributes(&ByGroup[i - 1], &ByGroup[i]) != 0) {
+      CopyGuid(&Groups[GroupCount].VendorGuid, &ByGroup[i]->VendorGuid);
+      Groups[GroupCount].Attributes = ByGroup[i]->Attributes;
+      GroupCount++;
+    }
+    Groups[GroupCount - 1].Count++;
+    Groups[GroupCount - 1].Bytes += VariableFootprint(ByGroup[i]);
+  }
+  QuickSort(Groups, GroupCount, sizeof(*Groups), CompareGroupsByBytes, &GroupScratch);
+  QuickSort(BySize, VarCount, sizeof(*BySize), CompareByFootprint, &Scratch);
+
+  gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
+  Visible = (Rows > 6) ? (Rows - 6) : 1;
+
+  for (;;) {
+    UINTN ItemCount = (Page == UsagePageGroups) ? GroupCount :
+                      (Page == UsagePageTop)    ? VarCount   : 0;
+
+    gST->ConOut->ClearScreen(gST->ConOut);
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_RED));
+    Print(L" Variable Store Usage - %-20s (page %u/%u)\n", mUsagePageName[Page], Page + 1, UsagePageMax);
+
+    switch (Page) {
+      case UsagePageCapacity: DrawCapacityPage(List, VarCount);                 break;
+      case UsagePageGroups:   DrawGroupsPage(Groups, GroupCount, Top, Visible); break;
+      default:                DrawTopPage(BySize, VarCount, Top, Visible);      break;
+    }
+
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+    Print(L"\nLeft/Right switch page, Up/Down/PgUp/PgDn scroll, ESC to return\n");
+
+    gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+    gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+
+    switch (Key.ScanCode) {
+      case SCAN_LEFT:
+        Page = (USAGE_PAGE)((Page + UsagePageMax - 1) % UsagePageMax);
+        Top  = 0;
+        break;
+      case SCAN_RIGHT:
+        Page = (USAGE_PAGE)((Page + 1) % UsagePageMax);
+        Top  = 0;
+        break;
+      case SCAN_UP:
+        if (Top > 0) Top--;
+        break;
+      case SCAN_DOWN:
+        if (Top + Visible < ItemCount) Top++;
+        break;
+      case SCAN_PAGE_UP:
+        Top = (Top > Visible) ? (Top - Visible) : 0;
+        break;
+      case SCAN_PAGE_DOWN:
+        if (Top + Visible < ItemCount) Top += Visible;
+        break;
+      case SCAN_ESC:
+        FreePool(Groups);
+        FreePool(BySize);
+        FreePool(ByGroup);
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_LIGHTGRAY, EFI_BLUE));
+        return;
+      default:
+        break;
+    }
+  }
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Uefi.h>
+#include "Variables.h"
+
+/**
+  Show the variable store capacity and usage dashboard.
+
+  Capacity comes from QueryVariableInfo; the per GUID/attribute grouping
+  and the top consumers are derived from the list ReadAllVariables() has
+  already enumerated, so no extra GetNextVariableName pass is made.
+
+  @param[in]  List      Enumerated variables.
+  @param[in]  VarCount  Number of entries in List.
+**/
+VOID
+ShowVariableUsage(
+  IN VARIABLE_ENTRY  *List,
+  IN UINTN           VarCount
+  );
@@ -9,16 +9,40 @@ extern EFI_HANDLE gImageHandle;
 #include <Library/PrintLib.h>
 #include "Variables.h"
 #include "FileHelper.h"
+#include "GuidNames.h"
+#include "VariableArchive.h"
+#include "VariableUsage.h"
+#include "SecureBoot.h"
 
 #define MAX_VARIABLES     1024
-#define MAX_NAME_CHARS    512
 #define ITEMS_PER_PAGE    10
-
+#define MAX_SEARCH_CHARS  32
+
+typedef enum {
+  VariableSortNone,         // Enumeration order
+  VariableSortName,
+  VariableSortGuid,
+  VariableSortSize,
+  VariableSortMax
+} VARIABLE_SORT_KEY;
+
+STATIC CONST CHAR16 *mVariableSortName[VariableSortMax] = {
+  L"none", L"name", L"GUID", L"size"
+};
+
+//
+// Search/filter state for the variable list.
+// It lives for one ReadAllVariables() call, like the list it filters.
+//
 typedef struct {
-  CHAR16    Name[MAX_NAME_CHARS];
-  UINT32    Attributes;
-  EFI_GUID  VendorGuid;
-} VARIABLE_ENTRY;
+  CHAR16             Search[MAX_SEARCH_CHARS];  // Case-insensitive name substring
+  UINTN              SearchLength;
+  BOOLEAN            Editing;                   // TRUE while typing into Search
+  BOOLEAN            GuidFilter;                // Only show entries with VendorGuid == Guid
+  EFI_GUID           Guid;
+  UINT32             RequiredAttributes;        // Every bit set here must be set on the entry
+  VARIABLE_SORT_KEY  SortKey;
+} VARIABLE_FILTER;
 
 /**
   Display the variable data in hex, allow cursor movement, and return on ESC.
@@ -151,26 +175,39 @@ ShowVariableData(
     // Bottom: prompt
     gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
     Print(L"\nUse Up/Down/Left/Right arrows to move, ESC to return\n");
+    if (IsSignatureDatabase(VarEntry->Name, &VarEntry->VendorGuid)) {
+      Print(L"Press 'd' to decode the signature database\n");
+    }
 
     // wait for key
     gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
     gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
 
+    if ((Key.UnicodeChar == L'd' || Key.UnicodeChar == L'D') &&
+        IsSignatureDatabase(VarEntry->Name, &VarEntry->VendorGuid)) {
+      ShowSignatureDatabase(VarEntry->Name, DataBuf, DataSize);
+      continue;
+    }
+
     // Check if the key is ctrl+S (0x13)
     if (Key.UnicodeChar == 0x13) {
-        // Save the variable to a file
-        Status = SaveBytesToFile(
-        gImageHandle,
-        L"variable_dump.bin",
-        DataBuf,
-        DataSize
-        );
+        // Save the variable to a file named after it
+        CHAR16 FileName[80];
+        Status = MakeExportFileName(gImageHandle, VarEntry->Name, L"bin", FileName, sizeof(FileName));
+        if (!EFI_ERROR(Status)) {
+            Status = SaveBytesToFile(
+            gImageHandle,
+            FileName,
+            DataBuf,
+            DataSize
+            );
+        }
         // Print the result
         gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
         if (EFI_ERROR(Status)) {
             Print(L"\nSave failed: %r\n", Status);
         } else {
-            Print(L"\nSaved to variable_dump.bin\n");
+            Print(L"\nSaved to %s\n", FileName);
         }
         // Wait for a key before continuing
         gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
@@ -206,12 +243,425 @@ ShowVariableData(
   FreePool(DataBuf);
 }
 
+/**
+  Build the short attribute string shown in the variable lists ("NV BS RT HR AT").
+*/
+VOID
+BuildAttributeString(
+  IN  UINT32  Attributes,
+  OUT CHAR16  *Buffer,
+  IN  UINTN   BufferCount
+  )
+{
+  Buffer[0] = L'\0';
+  if (Attributes & EFI_VARIABLE_NON_VOLATILE)          StrCatS(Buffer, BufferCount, L"NV ");
+  if (Attributes & EFI_VARIABLE_BOOTSERVICE_ACCESS)    StrCatS(Buffer, BufferCount, L"BS ");
+  if (Attributes & EFI_VARIABLE_RUNTIME_ACCESS)        StrCatS(Buffer, BufferCount, L"RT ");
+  if (Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) StrCatS(Buffer, BufferCount, L"HR ");
+  if (Attributes & VARIABLE_ATTRIBUTE_AUTH)            StrCatS(Buffer, BufferCount, L"AT");
+}
+
+/**
+  ASCII-only case folding, enough for variable names.
+*/
+STATIC
+CHAR16
+FoldChar(
+  IN CHAR16  Char
+  )
+{
+  if (Char >= L'A' && Char <= L'Z') {
+    return (CHAR16)(Char - L'A' + L'a');
+  }
+  return Char;
+}
+
+/**
+  Case-insensitive substring match of Needle (already folded) in Entry->Name.
+*/
+STATIC
+BOOLEAN
+NameContains(
+  IN CONST VARIABLE_ENTRY  *Entry,
+  IN CONST CHAR16          *Needle,
+  IN UINTN                 NeedleLength
+  )
+{
+  if (NeedleLength == 0) {
+    return TRUE;
+  }
+  if (NeedleLength > Entry->NameLength) {
+    return FALSE;
+  }
+  for (UINTN Start = 0; Start + NeedleLength <= Entry->NameLength; Start++) {
+    UINTN Match = 0;
+    while (Match < NeedleLength && FoldChar(Entry->Name[Start + Match]) == Needle[Match]) {
+      Match++;
+    }
+    if (Match == NeedleLength) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+//
+// QuickSort comparators. The sort buffer holds VARIABLE_ENTRY pointers, so
+// each callback receives a pointer to a pointer.
+//
+STATIC
+INTN
+EFIAPI
+CompareVariableByName(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST VARIABLE_ENTRY *A = *(CONST VARIABLE_ENTRY **)Buffer1;
+  CONST VARIABLE_ENTRY *B = *(CONST VARIABLE_ENTRY **)Buffer2;
+  INTN                 Result;
+
+  Result = StrCmp(A->Name, B->Name);
+  if (Result == 0) {
+    Result = CompareMem(&A->VendorGuid, &B->VendorGuid, sizeof(EFI_GUID));
+  }
+  return Result;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareVariableByGuid(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST VARIABLE_ENTRY *A = *(CONST VARIABLE_ENTRY **)Buffer1;
+  CONST VARIABLE_ENTRY *B = *(CONST VARIABLE_ENTRY **)Buffer2;
+  INTN                 Result;
+
+  Result = CompareMem(&A->VendorGuid, &B->VendorGuid, sizeof(EFI_GUID));
+  if (Result == 0) {
+    Result = StrCmp(A->Name, B->Name);
+  }
+  return Result;
+}
+
+STATIC
+INTN
+EFIAPI
+CompareVariableBySize(
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST VARIABLE_ENTRY *A = *(CONST VARIABLE_ENTRY **)Buffer1;
+  CONST VARIABLE_ENTRY *B = *(CONST VARIABLE_ENTRY **)Buffer2;
+
+  // Largest first: that is what you are looking for when sorting by size
+  if (A->DataSize != B->DataSize) {
+    return (A->DataSize > B->DataSize) ? -1 : 1;
+  }
+  return StrCmp(A->Name, B->Name);
+}
+
+/**
+  (Re)build the sorted index over the enumerated variables.
+  Only called when the sort key changes, never per keystroke.
+*/
+STATIC
+VOID
+SortVariableIndex(
+  IN     VARIABLE_ENTRY     *List,
+  IN     UINTN              VarCount,
+  IN     VARIABLE_SORT_KEY  SortKey,
+  IN OUT VARIABLE_ENTRY     **Sorted
+  )
+{
+  VARIABLE_ENTRY    *Scratch;
+  BASE_SORT_COMPARE Compare;
+
+  for (UINTN i = 0; i < VarCount; i++) {
+    Sorted[i] = &List[i];
+  }
+
+  switch (SortKey) {
+    case VariableSortName: Compare = CompareVariableByName; break;
+    case VariableSortGuid: Compare = CompareVariableByGuid; break;
+    case VariableSortSize: Compare = CompareVariableBySize; break;
+    default:               return;
+  }
+
+  QuickSort(Sorted, VarCount, sizeof(*Sorted), Compare, &Scratch);
+}
+
+/**
+  Filter the sorted index into View. This is the per-keystroke path: it only
+  touches the in-memory index and never calls runtime services.
+
+  @return Number of entries placed in View.
+*/
+STATIC
+UINTN
+ApplyVariableFilter(
+  IN  VARIABLE_ENTRY         **Sorted,
+  IN  UINTN                  VarCount,
+  IN  CONST VARIABLE_FILTER  *Filter,
+  OUT VARIABLE_ENTRY         **View
+  )
+{
+  CHAR16 Needle[MAX_SEARCH_CHARS];
+  UINTN  ViewCount = 0;
+  UINT32 RequiredAttributes;
+
+  // Either authenticated bit satisfies the "AT" filter, so it is checked on its own
+  RequiredAttributes = Filter->RequiredAttributes & ~(UINT32)VARIABLE_ATTRIBUTE_AUTH;
+
+  for (UINTN i = 0; i < Filter->SearchLength; i++) {
+    Needle[i] = FoldChar(Filter->Search[i]);
+  }
+
+  for (UINTN i = 0; i < VarCount; i++) {
+    VARIABLE_ENTRY *Entry = Sorted[i];
+
+    if ((Entry->Attributes & RequiredAttributes) != RequiredAttributes) {
+      continue;
+    }
+    if ((Filter->RequiredAttributes & VARIABLE_ATTRIBUTE_AUTH) != 0 &&
+        (Entry->Attributes & VARIABLE_ATTRIBUTE_AUTH) == 0) {
+      continue;
+    }
+    if (Filter->GuidFilter && !CompareGuid(&Entry->VendorGuid, &Filter->Guid)) {
+      continue;
+    }
+    if (!NameContains(Entry, Needle, Filter->SearchLength)) {
+      continue;
+    }
+    View[ViewCount++] = Entry;
+  }
+
+  return ViewCount;
+}
+
+/**
+  Print the one-line summary of the active search, filters and sort key.
+*/
+STATIC
+VOID
+DrawVariableFilterLine(
+  IN CONST VARIABLE_FILTER  *Filter,
+  IN UINTN                  ViewCount,
+  IN UINTN                  VarCount
+  )
+{
+  CHAR16 AttrBuf[20];
+
+  BuildAttributeString(Filter->RequiredAttributes, AttrBuf, ARRAY_SIZE(AttrBuf));
+
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"Search: ");
+  gST->ConOut->SetAttribute(gST->ConOut, Filter->Editing
+                                         ? EFI_TEXT_ATTR(EFI_BLACK, EFI_LIGHTGRAY)
+                                         : EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%s%s", Filter->Search, Filter->Editing ? L"_" : L"");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"  Attr: ");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%s", (AttrBuf[0] != L'\0') ? AttrBuf : L"any");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"  Sort: ");
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+  Print(L"%s", mVariableSortName[Filter->SortKey]);
+  gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+  Print(L"  Shown: %u/%u\n", ViewCount, VarCount);
+
+  if (Filter->GuidFilter) {
+    Print(L"GUID: ");
+    gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_YELLOW, EFI_BLUE));
+    Print(L"%g %s\n", &Filter->Guid, (GetGuidName(&Filter->Guid) != NULL) ? GetGuidName(&Filter->Guid) : L"");
+  }
+}
+
+/**
+  Scratch buffer of WriteVariableArchiveRecords(), from Arena if there is
+  one, else from pool.
+**/
+STATIC
+VOID *
+AllocateArchiveScratch(
+  IN OUT MIU_ARENA  *Arena  OPTIONAL,
+  IN     UINTN      Size
+  )
+{
+  return (Arena != NULL) ? MiuArenaAlloc(Arena, Size) : AllocatePool(Size);
+}
+
+// Arena memory goes back when the arena is reset
+STATIC
+VOID
+FreeArchiveScratch(
+  IN MIU_ARENA  *Arena  OPTIONAL,
+  IN VOID       *Buffer
+  )
+{
+  if (Arena == NULL && Buffer != NULL) {
+    FreePool(Buffer);
+  }
+}
+
+/**
+  Stream every variable in the store into Writer as VARIABLE_ARCHIVE_RECORDs.
+
+  Names come straight from GetNextVariableName and data is read into one
+  reusable buffer that only grows when a larger variable shows up, so memory
+  use is bounded by the largest variable rather than by the whole store.
+
+  @param[in,out]  Writer  An open writer positioned after the archive header.
+  @param[in,out]  Arena   Scratch for the name and data buffers, or NULL to
+                          use pool.
+  @param[out]     Count   Number of records written.
+
+  @retval EFI_SUCCESS  The whole store was enumerated.
+  @retval others       Enumeration, allocation or write failure.
+**/
+EFI_STATUS
+WriteVariableArchiveRecords(
+  IN OUT FILE_WRITER  *Writer,
+  IN OUT MIU_ARENA    *Arena  OPTIONAL,
+  OUT    UINTN        *Count
+  )
+{
+  EFI_STATUS               Status;
+  CHAR16                  *NameBuf;
+  UINTN                    NameCapacity = MAX_NAME_CHARS * sizeof(CHAR16);
+  UINTN                    NameSize;
+  UINT8                   *DataBuf;
+  UINTN                    DataCapacity = SIZE_4KB;
+  UINTN                    DataSize;
+  EFI_GUID                 Guid;
+  UINT32                   Attr;
+  VARIABLE_ARCHIVE_RECORD  Record;
+
+  *Count  = 0;
+  NameBuf = AllocateArchiveScratch(Arena, NameCapacity);
+  DataBuf = AllocateArchiveScratch(Arena, DataCapacity);
+  if (NameBuf == NULL || DataBuf == NULL) {
+    FreeArchiveScratch(Arena, NameBuf);
+    FreeArchiveScratch(Arena, DataBuf);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  NameBuf[0] = L'\0';
+  ZeroMem(&Guid, sizeof(Guid));
+
+  for (;;) {
+    NameSize = NameCapacity;
+    Status = gRT->GetNextVariableName(&NameSize, NameBuf, &Guid);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      // Grow the name buffer, keeping the previous name the next call starts from
+      CHAR16 *NewBuf = AllocateArchiveScratch(Arena, NameSize);
+      if (NewBuf == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      CopyMem(NewBuf, NameBuf, NameCapacity);
+      FreeArchiveScratch(Arena, NameBuf);
+      NameBuf      = NewBuf;
+      NameCapacity = NameSize;
+      continue;
+    }
+    if (Status == EFI_NOT_FOUND) {
+      Status = EFI_SUCCESS;   // End of the variable store
+      break;
+    }
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+
+    DataSize = DataCapacity;
+    Status = gRT->GetVariable(NameBuf, &Guid, &Attr, &DataSize, DataBuf);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      FreeArchiveScratch(Arena, DataBuf);
+      DataBuf = AllocateArchiveScratch(Arena, DataSize);
+      if (DataBuf == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      DataCapacity = DataSize;
+      Status = gRT->GetVariable(NameBuf, &Guid, &Attr, &DataSize, DataBuf);
+    }
+    if (EFI_ERROR(Status)) {
+      // Variable vanished or is unreadable; keep going with the rest
+      continue;
+    }
+
+    Record.NameSize   = (UINT32)StrSize(NameBuf);
+    Record.DataSize   = (UINT32)DataSize;
+    Record.RecordSize = sizeof(Record) + Record.NameSize + Record.DataSize;
+    Record.Attributes = Attr;
+    CopyGuid(&Record.VendorGuid, &Guid);
+
+    FileWriterAppend(Writer, &Record, sizeof(Record));
+    FileWriterAppend(Writer, NameBuf, Record.NameSize);
+    Status = FileWriterAppend(Writer, DataBuf, DataSize);
+    if (EFI_ERROR(Status)) {
+      break;
+    }
+    (*Count)++;
+  }
+
+  FreeArchiveScratch(Arena, NameBuf);
+  FreeArchiveScratch(Arena, DataBuf);
+  return Status;
+}
+
+/**
+  Export the whole variable store into one archive file in a single pass.
+
+  @param[out]  Count  Number of variables exported.
+**/
+STATIC
+EFI_STATUS
+ExportAllVariables(
+  IN  CHAR16  *FileName,
+  OUT UINTN   *Count
+  )
+{
+  EFI_STATUS               Status;
+  FILE_WRITER              Writer;
+  VARIABLE_ARCHIVE_HEADER  Header;
+  UINT32                   EndMarker = 0;
+
+  Status = FileWriterOpen(gImageHandle, FileName, &Writer);
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
+  Header.Signature  = VARIABLE_ARCHIVE_SIGNATURE;
+  Header.Version    = VARIABLE_ARCHIVE_VERSION;
+  Header.HeaderSize = sizeof(Header);
+  FileWriterAppend(&Writer, &Header, sizeof(Header));
+
+  // A record error leaves the archive without its end marker, so readers
+  // see it as interrupted rather than complete
+  Status = WriteVariableArchiveRecords(&Writer, NULL, Count);
+  if (EFI_ERROR(Status)) {
+    FileWriterClose(&Writer);
+    return Status;
+  }
+  FileWriterAppend(&Writer, &EndMarker, sizeof(EndMarker));
+  return FileWriterClose(&Writer);
+}
+
 EFI_STATUS
 ReadAllVariables(VOID)
 {
   EFI_STATUS       Status;
   VARIABLE_ENTRY  *List;
+  VARIABLE_ENTRY **Sorted;
+  VARIABLE_ENTRY **View;
   UINTN            VarCount = 0;
+  UINTN            ViewCount;
+  VARIABLE_FILTER  Filter;
 
   //
   // 1) Gather all variable names + attributes
@@ -239,7 +689,8 @@ ReadAllVariables(VOID)
     UINT32   Attr       = 0;
     UINTN    DataSize   = 0;
     //
-    // DataSize = 0 + Data = NULL is enough to retrieve Attributes
+    // DataSize = 0 + Data = NULL is enough to retrieve Attributes,
+    // and the EFI_BUFFER_TOO_SMALL return reports the data size as well
     //
     gRT->GetVariable(NameBuf, &Guid, &Attr, &DataSize, NULL);
 
@@ -247,8 +698,10 @@ ReadAllVariables(VOID)
     // Copy into our array
     //
     StrnCpyS(List[VarCount].Name, MAX_NAME_CHARS, NameBuf, MAX_NAME_CHARS-1);
+    List[VarCount].NameLength = StrLen(List[VarCount].Name);
     List[VarCount].Attributes = Attr;
     List[VarCount].VendorGuid = Guid;
+    List[VarCount].DataSize   = DataSize;
     VarCount++;
 
     //
@@ -267,14 +720,35 @@ ReadAllVariables(VOID)
   }
 
   //
-  // 2) Paging & selection loop
+  // 2) Build the in-memory index once; filtering and sorting only use it
+  //
+  Sorted = AllocatePool(sizeof(*Sorted) * VarCount);
+  View   = AllocatePool(sizeof(*View) * VarCount);
+  if (Sorted == NULL || View == NULL) {
+    if (Sorted != NULL) FreePool(Sorted);
+    if (View != NULL)   FreePool(View);
+    FreePool(List);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem(&Filter, sizeof(Filter));
+  SortVariableIndex(List, VarCount, Filter.SortKey, Sorted);
+  ViewCount = ApplyVariableFilter(Sorted, VarCount, &Filter, View);
+
+  //
+  // 3) Paging & selection loop
   //
-  UINTN TotalPages = (VarCount + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE;
   UINTN CurrPage   = 0;
   UINTN CurrSel    = 0;
   EFI_INPUT_KEY Key;
 
   for (;;) {
+    UINTN TotalPages = (ViewCount + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE;
+    BOOLEAN Refilter = FALSE;
+
+    if (TotalPages == 0) {
+      TotalPages = 1;
+    }
 
     UINTN Columns, Rows;
     gST->ConOut->QueryMode(gST->ConOut, gST->ConOut->Mode->Mode, &Columns, &Rows);
@@ -298,12 +772,14 @@ ReadAllVariables(VOID)
     UINTN Padding = (Columns > HeaderTextLength) ? (Columns - HeaderTextLength) : 0;
     Print(L" %s%*s", L"GUID", Padding, L"");
 
+    DrawVariableFilterLine(&Filter, ViewCount, VarCount);
+
     //
     // Print each line in this page
     //
     for (UINTN i = 0; i < ITEMS_PER_PAGE; i++) {
       UINTN Index = CurrPage * ITEMS_PER_PAGE + i;
-      if (Index >= VarCount) {
+      if (Index >= ViewCount) {
         break;
       }
 
@@ -317,19 +793,24 @@ ReadAllVariables(VOID)
       //
       // build attribute string
       //
-      CHAR16 AttrBuf[20] = L"";
-      // Use StrCatS for CHAR16 strings
-      if (List[Index].Attributes & EFI_VARIABLE_NON_VOLATILE)       StrCatS(AttrBuf, ARRAY_SIZE(AttrBuf), L"NV ");
-      if (List[Index].Attributes & EFI_VARIABLE_BOOTSERVICE_ACCESS) StrCatS(AttrBuf, ARRAY_SIZE(AttrBuf), L"BS ");
-      if (List[Index].Attributes & EFI_VARIABLE_RUNTIME_ACCESS)     StrCatS(AttrBuf, ARRAY_SIZE(AttrBuf), L"RT");
+      CHAR16 AttrBuf[20];
+      BuildAttributeString(View[Index]->Attributes, AttrBuf, ARRAY_SIZE(AttrBuf));
 
       //
-      // Print name, attrs, GUID (%g prints a GUID)
+      // Print name, attrs and the GUID's friendly name if it is a known one
+      // (%g prints a raw GUID otherwise)
       //
-      Print(L"%-30s %-15s %g\n",
-            List[Index].Name,
-            AttrBuf,
-            &List[Index].VendorGuid);
+      CONST CHAR16 *GuidName = GetGuidName(&View[Index]->VendorGuid);
+      if (GuidName != NULL) {
+        Print(L"%-30s %-15s %s\n", View[Index]->Name, AttrBuf, GuidName);
+      } else {
+        Print(L"%-30s %-15s %g\n", View[Index]->Name, AttrBuf, &View[Index]->VendorGuid);
+      }
+    }
+
+    if (ViewCount == 0) {
+      gST->ConOut->SetAttribute(gST->ConOut, EFI_BACKGROUND_BLUE | EFI_WHITE);
+      Print(L"No variables match the current filter.\n");
     }
 
     //
@@ -338,6 +819,12 @@ ReadAllVariables(VOID)
     gST->ConOut->SetAttribute(gST->ConOut, EFI_BACKGROUND_BLUE | EFI_WHITE);
     Print(L"\nPage %u/%u   (up/down select, PgUp/PgDn switch page, Esc to exit)\n",
           CurrPage + 1, TotalPages);
+    if (Filter.Editing) {
+      Print(L"Type to search, Backspace to delete, Enter to keep, Esc to clear\n");
+    } else {
+      Print(L"'/' search  n/b/r/a NV/BS/RT/Auth  g GUID of selection  s sort  c clear\n");
+      Print(L"u store usage  Ctrl+S export every variable to variable_archive_<time>.bin\n");
+    }
 
     //
     // Wait for and process key
@@ -350,13 +837,125 @@ ReadAllVariables(VOID)
       continue;
     }
 
+    //
+    // Incremental search: every printable key refines the view immediately
+    //
+    if (Filter.Editing) {
+      if (Key.ScanCode == SCAN_ESC) {
+        Filter.Editing      = FALSE;
+        Filter.SearchLength = 0;
+        Filter.Search[0]    = L'\0';
+        Refilter            = TRUE;
+      } else if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN || Key.UnicodeChar == CHAR_LINEFEED) {
+        Filter.Editing = FALSE;
+      } else if (Key.UnicodeChar == CHAR_BACKSPACE) {
+        if (Filter.SearchLength > 0) {
+          Filter.Search[--Filter.SearchLength] = L'\0';
+          Refilter = TRUE;
+        }
+      } else if (Key.UnicodeChar >= L' ' && Key.UnicodeChar < 0x7F &&
+                 Filter.SearchLength + 1 < MAX_SEARCH_CHARS) {
+        Filter.Search[Filter.SearchLength++] = Key.UnicodeChar;
+        Filter.Search[Filter.SearchLength]   = L'\0';
+        Refilter = TRUE;
+      }
+
+      if (Refilter) {
+        ViewCount = ApplyVariableFilter(Sorted, VarCount, &Filter, View);
+        CurrPage  = 0;
+        CurrSel   = 0;
+      }
+      continue;
+    }
+
+    // Check if the key is ctrl+S (0x13): export the whole store in one pass
+    if (Key.UnicodeChar == 0x13) {
+        UINTN  Exported = 0;
+        CHAR16 Stem[48];
+        CHAR16 FileName[64];
+        MakeTimestampStem(L"variable_archive", Stem, sizeof(Stem));
+        Status = MakeExportFileName(gImageHandle, Stem, L"bin", FileName, sizeof(FileName));
+        if (!EFI_ERROR(Status)) {
+            Status = ExportAllVariables(FileName, &Exported);
+        }
+        gST->ConOut->SetAttribute(gST->ConOut, EFI_TEXT_ATTR(EFI_WHITE, EFI_BLUE));
+        if (EFI_ERROR(Status)) {
+            Print(L"\nExport failed after %u variables: %r\n", Exported, Status);
+        } else {
+            Print(L"\nExported %u variables to %s\n", Exported, FileName);
+        }
+        // Wait for a key before continuing
+        gBS->WaitForEvent(1, &gST->ConIn->WaitForKey, NULL);
+        gST->ConIn->ReadKeyStroke(gST->ConIn, &Key);
+        continue;
+    }
+
     // Handle enter key or carriage return
     if (Key.UnicodeChar == CHAR_CARRIAGE_RETURN || Key.UnicodeChar == CHAR_LINEFEED) {
         UINTN Index = CurrPage * ITEMS_PER_PAGE + CurrSel;
-        ShowVariableData(&List[Index]);
+        if (Index < ViewCount) {
+          ShowVariableData(View[Index]);
+        }
         continue; // redraw the screen
     }
 
+    //
+    // Filter and sort hotkeys
+    //
+    switch (Key.UnicodeChar) {
+      case L'/':
+        Filter.Editing = TRUE;
+        break;
+      case L'n': case L'N':
+        Filter.RequiredAttributes ^= EFI_VARIABLE_NON_VOLATILE;
+        Refilter = TRUE;
+        break;
+      case L'b': case L'B':
+        Filter.RequiredAttributes ^= EFI_VARIABLE_BOOTSERVICE_ACCESS;
+        Refilter = TRUE;
+        break;
+      case L'r': case L'R':
+        Filter.RequiredAttributes ^= EFI_VARIABLE_RUNTIME_ACCESS;
+        Refilter = TRUE;
+        break;
+      case L'a': case L'A':
+        Filter.RequiredAttributes ^= VARIABLE_ATTRIBUTE_AUTH;
+        Refilter = TRUE;
+        break;
+      case L'g': case L'G':
+        if (Filter.GuidFilter) {
+          Filter.GuidFilter = FALSE;
+        } else if (CurrPage * ITEMS_PER_PAGE + CurrSel < ViewCount) {
+          Filter.GuidFilter = TRUE;
+          Filter.Guid       = View[CurrPage * ITEMS_PER_PAGE + CurrSel]->VendorGuid;
+        }
+        Refilter = TRUE;
+        break;
+      case L's': case L'S':
+        Filter.SortKey = (VARIABLE_SORT_KEY)((Filter.SortKey + 1) % VariableSortMax);
+        SortVariableIndex(List, VarCount, Filter.SortKey, Sorted);
+        Refilter = TRUE;
+        break;
+      case L'u': case L'U':
+        // Dashboard reuses this enumeration; no extra GetNextVariableName pass
+        ShowVariableUsage(List, VarCount);
+        break;
+      case L'c': case L'C':
+        ZeroMem(&Filter, sizeof(Filter));
+        SortVariableIndex(List, VarCount, Filter.SortKey, Sorted);
+        Refilter = TRUE;
+        break;
+      default:
+        break;
+    }
+
+    if (Refilter) {
+      ViewCount = ApplyVariableFilter(Sorted, VarCount, &Filter, View);
+      CurrPage  = 0;
+      CurrSel   = 0;
+      continue;
+    }
+
     // Arrow keys come through ScanCode==0 for UnicodeChar, so:
     if (Key.UnicodeChar == CHAR_NULL) {
       switch (Key.ScanCode) {
@@ -371,7 +970,7 @@ ReadAllVariables(VOID)
 
         case SCAN_DOWN:
           if ((CurrSel + 1 < ITEMS_PER_PAGE) &&
-              ((CurrPage * ITEMS_PER_PAGE + CurrSel + 1) < VarCount))
+              ((CurrPage * ITEMS_PER_PAGE + CurrSel + 1) < ViewCount))
           {
             CurrSel++;
           } else if (CurrPage + 1 < TotalPages) {
@@ -395,6 +994,8 @@ ReadAllVariables(VOID)
           break;
 
         case SCAN_ESC:
+          FreePool(View);
+          FreePool(Sorted);
           FreePool(List);
           return EFI_SUCCESS;
 
@@ -405,4 +1006,4 @@ ReadAllVariables(VOID)
   }
 
   // never reached
-}
\ No newline at end of file
+}
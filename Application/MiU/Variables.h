@@ -1,7 +1,31 @@
 #pragma once
 #include <Uefi.h>
+#include "FileHelper.h"
+#include "MiuArena.h"
+
+#define MAX_NAME_CHARS    512
+
+// Either flavor of authenticated write access counts as "authenticated"
+#define VARIABLE_ATTRIBUTE_AUTH  (EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS | \
+                                  EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS)
+
+// One enumerated variable, as built by ReadAllVariables()
+typedef struct {
+  CHAR16    Name[MAX_NAME_CHARS];
+  UINTN     NameLength;     // Cached StrLen(Name), used by the search filter
+  UINT32    Attributes;
+  EFI_GUID  VendorGuid;
+  UINTN     DataSize;       // Size reported by GetVariable during enumeration
+} VARIABLE_ENTRY;
 
 // Main entry point for UEFI variable feature
 EFI_STATUS ReadAllVariables(VOID);
 
+// Stream every variable into an open writer as archive records (VariableArchive.h),
+// with the name and data buffers taken from Arena if one is given
+EFI_STATUS WriteVariableArchiveRecords(IN OUT FILE_WRITER *Writer, IN OUT MIU_ARENA *Arena OPTIONAL, OUT UINTN *Count);
+
+// Short attribute string ("NV BS RT HR AT") into Buffer; 15 characters is enough
+VOID BuildAttributeString(IN UINT32 Attributes, OUT CHAR16 *Buffer, IN UINTN BufferCount);
+
 // Add more variable-related function prototypes here as you implement features
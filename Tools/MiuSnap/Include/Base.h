@@ -0,0 +1,68 @@
+/** @file
+  The subset of edk2's MdePkg Base.h that the shared MiU headers and
+  MiuLz.c use, mapped onto the host C library, so the host tools build the
+  firmware's own format definitions and codec unchanged.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef MIU_HOST_BASE_H_
+#define MIU_HOST_BASE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t    UINT8;
+typedef uint16_t   UINT16;
+typedef uint32_t   UINT32;
+typedef uint64_t   UINT64;
+typedef int8_t     INT8;
+typedef int16_t    INT16;
+typedef int32_t    INT32;
+typedef int64_t    INT64;
+typedef size_t     UINTN;
+typedef intptr_t   INTN;
+typedef UINT8      BOOLEAN;
+typedef char       CHAR8;
+typedef UINT16     CHAR16;    // UCS-2 as in firmware, not the host wchar_t
+typedef void       VOID;
+
+typedef struct {
+  UINT32    Data1;
+  UINT16    Data2;
+  UINT16    Data3;
+  UINT8     Data4[8];
+} GUID;
+
+typedef GUID  EFI_GUID;
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST   const
+#define STATIC  static
+
+#define TRUE   ((BOOLEAN)(1 == 1))
+#define FALSE  ((BOOLEAN)(0 == 1))
+
+#define MAX_UINT32  ((UINT32)0xFFFFFFFF)
+#define MAX_UINT64  ((UINT64)0xFFFFFFFFFFFFFFFFULL)
+#define MAX_UINTN   ((UINTN)SIZE_MAX)
+
+#define BIT0   0x00000001
+#define BIT1   0x00000002
+#define BIT31  0x80000000
+
+#define SIZE_1KB   0x00000400
+#define SIZE_4KB   0x00001000
+#define SIZE_64KB  0x00010000
+#define SIZE_1MB   0x00100000
+
+#define SIGNATURE_16(A, B)        ((A) | (B << 8))
+#define SIGNATURE_32(A, B, C, D)  (SIGNATURE_16 (A, B) | (SIGNATURE_16 (C, D) << 16))
+#define SIGNATURE_64(A, B, C, D, E, F, G, H) \
+    (SIGNATURE_32 (A, B, C, D) | ((UINT64) (SIGNATURE_32 (E, F, G, H)) << 32))
+
+#define ARRAY_SIZE(Array)  (sizeof (Array) / sizeof ((Array)[0]))
+
+#endif // MIU_HOST_BASE_H_
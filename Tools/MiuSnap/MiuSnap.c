@@ -0,0 +1,717 @@
+/** @file
+  MiuSnap: reads MiU snapshot files on the host. Lists and prints sections
+  as text or JSON, extracts raw payloads, verifies CRCs and compares two
+  snapshots section by section.
+
+  Exit status: 0 on success (diff: snapshots match), 1 if diff found
+  differences or verify found a bad file, 2 on usage or read errors.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SnapshotReader.h"
+#include "SnapshotViews.h"
+
+#define EXIT_SAME   0
+#define EXIT_DIFF   1
+#define EXIT_ERROR  2
+
+STATIC CONST CHAR8  mUsage[] =
+  "Usage: MiuSnap info FILE [--json]\n"
+  "       MiuSnap show FILE [SECTION...] [--json]\n"
+  "       MiuSnap extract FILE SECTION [OUT|-]\n"
+  "       MiuSnap verify FILE...\n"
+  "       MiuSnap diff FILE1 FILE2 [SECTION...] [--json]\n"
+  "SECTION is a section name such as pci or acpi, or its type number.\n";
+
+typedef struct {
+  BOOLEAN        Json;
+  CONST CHAR8    **Names;       // Positional arguments after the files
+  int            NameCount;
+} COMMAND_ARGS;
+
+/**
+  Split argv after the command into the --json flag and positional
+  arguments. Names points into a malloc'd array the caller frees.
+**/
+STATIC
+int
+ParseCommandArgs (
+  IN  int           Argc,
+  IN  CHAR8         **Argv,
+  OUT COMMAND_ARGS  *Args
+  )
+{
+  memset(Args, 0, sizeof(*Args));
+  Args->Names = calloc((size_t)Argc + 1, sizeof(*Args->Names));
+  if (Args->Names == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < Argc; i++) {
+    if (strcmp(Argv[i], "--json") == 0) {
+      Args->Json = TRUE;
+    } else if (Argv[i][0] == '-' && Argv[i][1] == '-') {
+      fprintf(stderr, "MiuSnap: unknown option %s\n", Argv[i]);
+      return -1;
+    } else {
+      Args->Names[Args->NameCount++] = Argv[i];
+    }
+  }
+  return 0;
+}
+
+STATIC
+VOID
+PrintCaptureTime (
+  IN FILE                   *Out,
+  IN CONST SNAPSHOT_HEADER  *Header
+  )
+{
+  fprintf(Out, "%04u-%02u-%02uT%02u:%02u:%02u",
+          Header->Year, Header->Month, Header->Day, Header->Hour, Header->Minute, Header->Second);
+}
+
+STATIC
+int
+CommandInfo (
+  IN CONST SNAPSHOT_FILE  *File,
+  IN BOOLEAN              Json
+  )
+{
+  CONST SNAPSHOT_HEADER *Header = &File->Header;
+
+  if (Json) {
+    printf("{\"file\":");
+    PrintJsonString(stdout, File->Path);
+    printf(",\"version\":%u,\"size\":%llu,\"block_size\":%u,\"captured\":",
+           Header->Version, (unsigned long long)File->Size, Header->BlockSize);
+    if (Header->Year != 0) {
+      putchar('"');
+      PrintCaptureTime(stdout, Header);
+      putchar('"');
+    } else {
+      printf("null");
+    }
+    printf(",\"sections\":[");
+    for (UINT32 i = 0; i < File->SectionCount; i++) {
+      CONST SNAPSHOT_SECTION_ENTRY *Section = &File->Sections[i];
+
+      printf("%s{\"name\":", (i != 0) ? "," : "");
+      PrintJsonString(stdout, Section->Name);
+      printf(",\"type\":%u,\"compressed\":%s,\"item_count\":%u,\"raw_size\":%llu,\"stored_size\":%llu,\"crc32\":\"%08x\"}",
+             Section->Type, (Section->Flags & SNAPSHOT_SECTION_COMPRESSED) ? "true" : "false",
+             Section->ItemCount, (unsigned long long)Section->RawSize,
+             (unsigned long long)Section->StoredSize, Section->Crc32);
+    }
+    printf("]}\n");
+    return EXIT_SAME;
+  }
+
+  printf("%s: snapshot version %u, %llu bytes, captured ", File->Path, Header->Version,
+         (unsigned long long)File->Size);
+  if (Header->Year != 0) {
+    PrintCaptureTime(stdout, Header);
+  } else {
+    printf("at an unknown time");
+  }
+  printf("\n%-16s %-12s %8s %10s %10s %6s  %s\n", "name", "type", "items", "raw", "stored", "ratio", "crc32");
+  for (UINT32 i = 0; i < File->SectionCount; i++) {
+    CONST SNAPSHOT_SECTION_ENTRY *Section = &File->Sections[i];
+    UINT64                       Percent  = (Section->RawSize != 0) ? Section->StoredSize * 100 / Section->RawSize : 100;
+
+    printf("%-16s %-12s %8u %10llu %10llu %5llu%%  %08x\n",
+           Section->Name, SectionTypeName(Section->Type), Section->ItemCount,
+           (unsigned long long)Section->RawSize, (unsigned long long)Section->StoredSize,
+           (unsigned long long)Percent, Section->Crc32);
+  }
+  return EXIT_SAME;
+}
+
+/**
+  Resolve the named sections, or all of them when none are named, into a
+  malloc'd array.
+**/
+STATIC
+int
+SelectSections (
+  IN  CONST SNAPSHOT_FILE            *File,
+  IN  CONST COMMAND_ARGS             *Args,
+  OUT CONST SNAPSHOT_SECTION_ENTRY   ***Selected,
+  OUT UINTN                          *Count
+  )
+{
+  UINTN Total = (Args->NameCount != 0) ? (UINTN)Args->NameCount : File->SectionCount;
+
+  *Count    = 0;
+  *Selected = calloc(Total + 1, sizeof(**Selected));
+  if (*Selected == NULL) {
+    return -1;
+  }
+  for (UINTN i = 0; i < Total; i++) {
+    CONST SNAPSHOT_SECTION_ENTRY *Section = (Args->NameCount != 0) ?
+                                            SnapshotFindSection(File, Args->Names[i]) :
+                                            &File->Sections[i];
+    if (Section == NULL) {
+      fprintf(stderr, "MiuSnap: %s: no section %s\n", File->Path, Args->Names[i]);
+      free(*Selected);
+      return -1;
+    }
+    (*Selected)[(*Count)++] = Section;
+  }
+  return 0;
+}
+
+STATIC
+int
+CommandShow (
+  IN CONST SNAPSHOT_FILE  *File,
+  IN CONST COMMAND_ARGS   *Args
+  )
+{
+  CONST SNAPSHOT_SECTION_ENTRY **Selected;
+  UINTN                        Count;
+  int                          Result = EXIT_SAME;
+
+  if (SelectSections(File, Args, &Selected, &Count) != 0) {
+    return EXIT_ERROR;
+  }
+  if (Args->Json) {
+    printf("{\"file\":");
+    PrintJsonString(stdout, File->Path);
+    printf(",\"sections\":[");
+  }
+
+  for (UINTN i = 0; i < Count; i++) {
+    SECTION_VIEW View;
+
+    if (BuildSectionView(File, Selected[i], &View) != 0) {
+      Result = EXIT_ERROR;
+      continue;
+    }
+    if (Args->Json) {
+      if (i != 0) {
+        putchar(',');
+      }
+      PrintSectionViewJson(stdout, &View);
+    } else {
+      PrintSectionViewText(stdout, &View);
+      if (i + 1 < Count) {
+        putchar('\n');
+      }
+    }
+    FreeSectionView(&View);
+  }
+
+  if (Args->Json) {
+    printf("]}\n");
+  }
+  free(Selected);
+  return Result;
+}
+
+STATIC
+int
+CommandExtract (
+  IN CONST SNAPSHOT_FILE  *File,
+  IN CONST COMMAND_ARGS   *Args
+  )
+{
+  CONST SNAPSHOT_SECTION_ENTRY *Section;
+  CONST CHAR8                  *OutPath;
+  UINT8                        *Payload;
+  FILE                         *Out;
+  BOOLEAN                      Written;
+
+  if (Args->NameCount < 1 || Args->NameCount > 2) {
+    fputs(mUsage, stderr);
+    return EXIT_ERROR;
+  }
+  Section = SnapshotFindSection(File, Args->Names[0]);
+  if (Section == NULL) {
+    fprintf(stderr, "MiuSnap: %s: no section %s\n", File->Path, Args->Names[0]);
+    return EXIT_ERROR;
+  }
+  if (SnapshotReadSection(File, Section, &Payload) != 0) {
+    return EXIT_ERROR;
+  }
+
+  OutPath = (Args->NameCount == 2) ? Args->Names[1] : "-";
+  Out     = (strcmp(OutPath, "-") == 0) ? stdout : fopen(OutPath, "wb");
+  if (Out == NULL) {
+    perror(OutPath);
+    free(Payload);
+    return EXIT_ERROR;
+  }
+  Written = (BOOLEAN)(fwrite(Payload, 1, (size_t)Section->RawSize, Out) == Section->RawSize);
+  if (Out != stdout) {
+    Written = (BOOLEAN)((fclose(Out) == 0) && Written);
+  }
+  free(Payload);
+  if (!Written) {
+    fprintf(stderr, "MiuSnap: %s: write failed\n", OutPath);
+    return EXIT_ERROR;
+  }
+  return EXIT_SAME;
+}
+
+STATIC
+int
+CommandVerify (
+  IN int          Count,
+  IN CHAR8        **Paths
+  )
+{
+  int Result = EXIT_SAME;
+
+  for (int i = 0; i < Count; i++) {
+    SNAPSHOT_FILE File;
+    UINT32        Bad = 0;
+
+    if (SnapshotOpen(Paths[i], &File) != 0) {
+      Result = EXIT_DIFF;
+      continue;
+    }
+    for (UINT32 s = 0; s < File.SectionCount; s++) {
+      UINT8 *Payload;
+
+      if (SnapshotReadSection(&File, &File.Sections[s], &Payload) != 0) {
+        Bad++;
+        continue;
+      }
+      free(Payload);
+    }
+    if (Bad != 0) {
+      printf("%s: %u of %u sections failed\n", File.Path, Bad, File.SectionCount);
+      Result = EXIT_DIFF;
+    } else {
+      printf("%s: OK, %u sections\n", File.Path, File.SectionCount);
+    }
+    SnapshotFree(&File);
+  }
+  return Result;
+}
+
+//
+// diff
+//
+
+typedef struct {
+  BOOLEAN  Json;
+  BOOLEAN  FirstSection;      // No JSON separator needed yet
+  UINTN    Added;
+  UINTN    Removed;
+  UINTN    Changed;
+} DIFF_CONTEXT;
+
+STATIC
+int
+CompareItemPointers (
+  CONST VOID  *Left,
+  CONST VOID  *Right
+  )
+{
+  return strcmp((*(VIEW_ITEM * CONST *)Left)->Key, (*(VIEW_ITEM * CONST *)Right)->Key);
+}
+
+STATIC
+VIEW_ITEM **
+SortItems (
+  IN CONST SECTION_VIEW  *View
+  )
+{
+  VIEW_ITEM **Sorted = calloc(View->ItemCount + 1, sizeof(*Sorted));
+
+  if (Sorted != NULL) {
+    for (UINTN i = 0; i < View->ItemCount; i++) {
+      Sorted[i] = &View->Items[i];
+    }
+    qsort(Sorted, View->ItemCount, sizeof(*Sorted), CompareItemPointers);
+  }
+  return Sorted;
+}
+
+// "name=value" pairs of an item for the added/removed lines
+STATIC
+VOID
+PrintItemText (
+  IN CHAR8            Marker,
+  IN CONST VIEW_ITEM  *Item
+  )
+{
+  printf("%c %s", Marker, Item->Key);
+  for (UINTN f = 0; f < Item->FieldCount; f++) {
+    if (Item->Fields[f].Value[0] != '\0' && strcmp(Item->Fields[f].Value, Item->Key) != 0) {
+      printf("  %s=%s", Item->Fields[f].Name, Item->Fields[f].Value);
+    }
+  }
+  putchar('\n');
+}
+
+STATIC
+VOID
+PrintItemJson (
+  IN CONST CHAR8      *Change,
+  IN CONST VIEW_ITEM  *Item,
+  IN BOOLEAN          First
+  )
+{
+  printf("%s{\"change\":\"%s\",\"key\":", First ? "" : ",", Change);
+  PrintJsonString(stdout, Item->Key);
+  printf(",\"fields\":{");
+  for (UINTN f = 0; f < Item->FieldCount; f++) {
+    printf("%s", (f != 0) ? "," : "");
+    PrintJsonString(stdout, Item->Fields[f].Name);
+    putchar(':');
+    if (Item->Fields[f].IsNumber) {
+      printf("%s", Item->Fields[f].Value);
+    } else {
+      PrintJsonString(stdout, Item->Fields[f].Value);
+    }
+  }
+  printf("}}");
+}
+
+/**
+  Report the fields that differ between two versions of an item, or that
+  only the bytes differ. Returns FALSE if the items are identical.
+**/
+STATIC
+BOOLEAN
+DiffItem (
+  IN CONST VIEW_FIELD  *OldFields,
+  IN UINTN             OldCount,
+  IN CONST VIEW_FIELD  *NewFields,
+  IN UINTN             NewCount,
+  IN BOOLEAN           BytesDiffer,
+  IN CONST CHAR8       *Key,
+  IN BOOLEAN           Json,
+  IN BOOLEAN           First
+  )
+{
+  BOOLEAN Reported = FALSE;
+
+  for (UINTN f = 0; f < NewCount; f++) {
+    CONST VIEW_FIELD *Old = FindViewField(OldFields, OldCount, NewFields[f].Name);
+
+    if (Old == NULL || strcmp(Old->Value, NewFields[f].Value) == 0) {
+      continue;
+    }
+    if (!Reported) {
+      if (Json) {
+        printf("%s{\"change\":\"changed\",\"key\":", First ? "" : ",");
+        PrintJsonString(stdout, Key);
+        printf(",\"fields\":{");
+      } else {
+        printf("~ %s", Key);
+      }
+    } else if (Json) {
+      putchar(',');
+    }
+    if (Json) {
+      PrintJsonString(stdout, NewFields[f].Name);
+      printf(":{\"from\":");
+      PrintJsonString(stdout, Old->Value);
+      printf(",\"to\":");
+      PrintJsonString(stdout, NewFields[f].Value);
+      putchar('}');
+    } else {
+      printf("  %s: %s -> %s", NewFields[f].Name, Old->Value, NewFields[f].Value);
+    }
+    Reported = TRUE;
+  }
+
+  if (!Reported && !BytesDiffer) {
+    return FALSE;
+  }
+  if (Json) {
+    if (!Reported) {
+      printf("%s{\"change\":\"changed\",\"key\":", First ? "" : ",");
+      PrintJsonString(stdout, Key);
+      printf(",\"fields\":{");
+    }
+    printf("},\"bytes_differ\":%s}", BytesDiffer ? "true" : "false");
+  } else if (Reported) {
+    putchar('\n');
+  } else {
+    printf("~ %s  contents differ\n", Key);
+  }
+  return TRUE;
+}
+
+/**
+  Merge the items of two decoded sections by key and report what changed.
+**/
+STATIC
+int
+DiffViews (
+  IN     CONST SECTION_VIEW  *Old,
+  IN     CONST SECTION_VIEW  *New,
+  IN OUT DIFF_CONTEXT        *Context
+  )
+{
+  VIEW_ITEM **OldItems = SortItems(Old);
+  VIEW_ITEM **NewItems = SortItems(New);
+  UINTN     o          = 0;
+  UINTN     n          = 0;
+  BOOLEAN   First;
+
+  if (OldItems == NULL || NewItems == NULL) {
+    free(OldItems);
+    free(NewItems);
+    fprintf(stderr, "MiuSnap: out of memory\n");
+    return -1;
+  }
+
+  // Section-wide values are reported as a change of the "info" pseudo-item
+  First = !DiffItem(Old->Info, Old->InfoCount, New->Info, New->InfoCount, FALSE, "(info)",
+                    Context->Json, TRUE);
+  if (!First) {
+    Context->Changed++;
+  }
+
+  while (o < Old->ItemCount || n < New->ItemCount) {
+    int Order;
+
+    if (o == Old->ItemCount) {
+      Order = 1;
+    } else if (n == New->ItemCount) {
+      Order = -1;
+    } else {
+      Order = strcmp(OldItems[o]->Key, NewItems[n]->Key);
+    }
+
+    if (Order < 0) {
+      if (Context->Json) {
+        PrintItemJson("removed", OldItems[o], First);
+      } else {
+        PrintItemText('-', OldItems[o]);
+      }
+      Context->Removed++;
+      First = FALSE;
+      o++;
+    } else if (Order > 0) {
+      if (Context->Json) {
+        PrintItemJson("added", NewItems[n], First);
+      } else {
+        PrintItemText('+', NewItems[n]);
+      }
+      Context->Added++;
+      First = FALSE;
+      n++;
+    } else {
+      CONST VIEW_ITEM *A          = OldItems[o++];
+      CONST VIEW_ITEM *B          = NewItems[n++];
+      BOOLEAN         BytesDiffer = (BOOLEAN)(A->DataSize != B->DataSize ||
+                                              memcmp(A->Data, B->Data, A->DataSize) != 0);
+
+      if (DiffItem(A->Fields, A->FieldCount, B->Fields, B->FieldCount, BytesDiffer, B->Key,
+                   Context->Json, First)) {
+        Context->Changed++;
+        First = FALSE;
+      }
+    }
+  }
+
+  free(OldItems);
+  free(NewItems);
+  return 0;
+}
+
+STATIC
+VOID
+BeginSectionReport (
+  IN OUT DIFF_CONTEXT  *Context,
+  IN     CONST CHAR8   *Name,
+  IN     CONST CHAR8   *Status
+  )
+{
+  if (Context->Json) {
+    printf("%s{\"name\":", Context->FirstSection ? "" : ",");
+    PrintJsonString(stdout, Name);
+    printf(",\"status\":\"%s\",\"items\":[", Status);
+  } else {
+    printf("== %s: %s\n", Name, Status);
+  }
+  Context->FirstSection = FALSE;
+}
+
+/**
+  Compare one section present in at least one of the snapshots.
+
+  @return EXIT_SAME, EXIT_DIFF or EXIT_ERROR.
+**/
+STATIC
+int
+DiffSection (
+  IN     CONST SNAPSHOT_FILE           *OldFile,
+  IN     CONST SNAPSHOT_SECTION_ENTRY  *OldSection OPTIONAL,
+  IN     CONST SNAPSHOT_FILE           *NewFile,
+  IN     CONST SNAPSHOT_SECTION_ENTRY  *NewSection OPTIONAL,
+  IN OUT DIFF_CONTEXT                  *Context
+  )
+{
+  SECTION_VIEW  OldView;
+  SECTION_VIEW  NewView;
+  CONST CHAR8   *Name = (OldSection != NULL) ? OldSection->Name : NewSection->Name;
+  int           Status;
+
+  if (OldSection == NULL || NewSection == NULL) {
+    BeginSectionReport(Context, Name, (OldSection == NULL) ? "added" : "removed");
+    printf("%s", Context->Json ? "]}" : "");
+    return EXIT_DIFF;
+  }
+
+  // Same CRC and size: skip decoding, which keeps CI runs on big captures fast
+  if (OldSection->Crc32 == NewSection->Crc32 && OldSection->RawSize == NewSection->RawSize) {
+    if (Context->Json) {
+      BeginSectionReport(Context, Name, "same");
+      printf("]}");
+    }
+    return EXIT_SAME;
+  }
+
+  if (BuildSectionView(OldFile, OldSection, &OldView) != 0) {
+    return EXIT_ERROR;
+  }
+  if (BuildSectionView(NewFile, NewSection, &NewView) != 0) {
+    FreeSectionView(&OldView);
+    return EXIT_ERROR;
+  }
+
+  Context->Added   = 0;
+  Context->Removed = 0;
+  Context->Changed = 0;
+  BeginSectionReport(Context, Name, "changed");
+  Status = (DiffViews(&OldView, &NewView, Context) == 0) ? EXIT_DIFF : EXIT_ERROR;
+  if (Context->Json) {
+    printf("],\"added\":%zu,\"removed\":%zu,\"changed\":%zu}",
+           Context->Added, Context->Removed, Context->Changed);
+  } else {
+    printf("   %zu added, %zu removed, %zu changed\n", Context->Added, Context->Removed, Context->Changed);
+  }
+
+  FreeSectionView(&OldView);
+  FreeSectionView(&NewView);
+  return Status;
+}
+
+STATIC
+int
+CommandDiff (
+  IN CONST SNAPSHOT_FILE  *OldFile,
+  IN CONST SNAPSHOT_FILE  *NewFile,
+  IN CONST COMMAND_ARGS   *Args
+  )
+{
+  DIFF_CONTEXT  Context;
+  int           Result = EXIT_SAME;
+  int           Status;
+
+  memset(&Context, 0, sizeof(Context));
+  Context.Json         = Args->Json;
+  Context.FirstSection = TRUE;
+  if (Context.Json) {
+    printf("{\"old\":");
+    PrintJsonString(stdout, OldFile->Path);
+    printf(",\"new\":");
+    PrintJsonString(stdout, NewFile->Path);
+    printf(",\"sections\":[");
+  }
+
+  if (Args->NameCount != 0) {
+    for (int i = 0; i < Args->NameCount; i++) {
+      CONST SNAPSHOT_SECTION_ENTRY *Old = SnapshotFindSection(OldFile, Args->Names[i]);
+      CONST SNAPSHOT_SECTION_ENTRY *New = SnapshotFindSection(NewFile, Args->Names[i]);
+
+      if (Old == NULL && New == NULL) {
+        fprintf(stderr, "MiuSnap: no section %s in either snapshot\n", Args->Names[i]);
+        Result = EXIT_ERROR;
+        continue;
+      }
+      Status = DiffSection(OldFile, Old, NewFile, New, &Context);
+      Result = (Status > Result) ? Status : Result;
+    }
+  } else {
+    // Sections of the old snapshot in order, then those only the new one has
+    for (UINT32 i = 0; i < OldFile->SectionCount; i++) {
+      Status = DiffSection(OldFile, &OldFile->Sections[i], NewFile,
+                           SnapshotFindSection(NewFile, OldFile->Sections[i].Name), &Context);
+      Result = (Status > Result) ? Status : Result;
+    }
+    for (UINT32 i = 0; i < NewFile->SectionCount; i++) {
+      if (SnapshotFindSection(OldFile, NewFile->Sections[i].Name) == NULL) {
+        Status = DiffSection(OldFile, NULL, NewFile, &NewFile->Sections[i], &Context);
+        Result = (Status > Result) ? Status : Result;
+      }
+    }
+  }
+
+  if (Context.Json) {
+    printf("],\"identical\":%s}\n", (Result == EXIT_SAME) ? "true" : "false");
+  } else if (Result == EXIT_SAME) {
+    printf("Snapshots match\n");
+  }
+  return Result;
+}
+
+int
+main (
+  int    Argc,
+  char   **Argv
+  )
+{
+  COMMAND_ARGS  Args;
+  SNAPSHOT_FILE Files[2];
+  CONST CHAR8   *Command;
+  int           FileCount;
+  int           Result;
+
+  if (Argc < 3) {
+    fputs(mUsage, (Argc == 2 && (strcmp(Argv[1], "-h") == 0 || strcmp(Argv[1], "--help") == 0)) ? stdout : stderr);
+    return (Argc == 2 && Argv[1][0] == '-') ? EXIT_SAME : EXIT_ERROR;
+  }
+  Command = Argv[1];
+  if (strcmp(Command, "verify") == 0) {
+    return CommandVerify(Argc - 2, Argv + 2);
+  }
+
+  FileCount = (strcmp(Command, "diff") == 0) ? 2 : 1;
+  if (Argc < 2 + FileCount ||
+      (strcmp(Command, "info") != 0 && strcmp(Command, "show") != 0 &&
+       strcmp(Command, "extract") != 0 && FileCount == 1)) {
+    fputs(mUsage, stderr);
+    return EXIT_ERROR;
+  }
+  if (ParseCommandArgs(Argc - 2 - FileCount, Argv + 2 + FileCount, &Args) != 0) {
+    free(Args.Names);
+    return EXIT_ERROR;
+  }
+
+  memset(Files, 0, sizeof(Files));
+  for (int i = 0; i < FileCount; i++) {
+    if (SnapshotOpen(Argv[2 + i], &Files[i]) != 0) {
+      SnapshotFree(&Files[0]);
+      free(Args.Names);
+      return EXIT_ERROR;
+    }
+  }
+
+  if (strcmp(Command, "info") == 0) {
+    Result = CommandInfo(&Files[0], Args.Json);
+  } else if (strcmp(Command, "show") == 0) {
+    Result = CommandShow(&Files[0], &Args);
+  } else if (strcmp(Command, "extract") == 0) {
+    Result = CommandExtract(&Files[0], &Args);
+  } else {
+    Result = CommandDiff(&Files[0], &Files[1], &Args);
+  }
+
+  for (int i = 0; i < FileCount; i++) {
+    SnapshotFree(&Files[i]);
+  }
+  free(Args.Names);
+  return Result;
+}
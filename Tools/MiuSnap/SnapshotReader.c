@@ -0,0 +1,252 @@
+/** @file
+  Snapshot file loading, validation and section decompression.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SnapshotReader.h"
+#include "MiuLz.h"
+
+STATIC
+int
+SnapshotError (
+  IN CONST CHAR8  *Path,
+  IN CONST CHAR8  *Message
+  )
+{
+  fprintf(stderr, "MiuSnap: %s: %s\n", Path, Message);
+  return -1;
+}
+
+STATIC
+int
+ReadWholeFile (
+  IN  CONST CHAR8  *Path,
+  OUT UINT8        **Data,
+  OUT UINTN        *Size
+  )
+{
+  FILE  *Stream;
+  long  Length;
+
+  *Data  = NULL;
+  Stream = fopen(Path, "rb");
+  if (Stream == NULL) {
+    return SnapshotError(Path, strerror(errno));
+  }
+  if (fseek(Stream, 0, SEEK_END) != 0 || (Length = ftell(Stream)) < 0 || fseek(Stream, 0, SEEK_SET) != 0) {
+    fclose(Stream);
+    return SnapshotError(Path, "cannot determine the file size");
+  }
+
+  *Size = (UINTN)Length;
+  *Data = malloc(*Size + 1);
+  if (*Data == NULL || fread(*Data, 1, *Size, Stream) != *Size) {
+    fclose(Stream);
+    free(*Data);
+    *Data = NULL;
+    return SnapshotError(Path, "read failed");
+  }
+  fclose(Stream);
+  return 0;
+}
+
+int
+SnapshotOpen (
+  IN  CONST CHAR8    *Path,
+  OUT SNAPSHOT_FILE  *File
+  )
+{
+  SNAPSHOT_TRAILER  Trailer;
+  UINT64            TableEnd;
+  UINT64            TableSize;
+
+  memset(File, 0, sizeof(*File));
+  File->Path = Path;
+  if (ReadWholeFile(Path, &File->Data, &File->Size) != 0) {
+    return -1;
+  }
+
+  if (File->Size < sizeof(SNAPSHOT_HEADER) + sizeof(SNAPSHOT_TRAILER)) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "too small for a snapshot");
+  }
+  memcpy(&File->Header, File->Data, sizeof(File->Header));
+  if (File->Header.Signature != SNAPSHOT_SIGNATURE) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "not a MiU snapshot");
+  }
+  if (File->Header.Version != SNAPSHOT_VERSION || File->Header.HeaderSize < sizeof(SNAPSHOT_HEADER)) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "unsupported snapshot version");
+  }
+
+  // A capture that was cut short has no trailer, and so no section table
+  memcpy(&Trailer, File->Data + File->Size - sizeof(Trailer), sizeof(Trailer));
+  if (Trailer.Signature != SNAPSHOT_END_SIGNATURE) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "no trailer, the capture did not finish");
+  }
+
+  // Both fields come from the file; compare by subtraction so no sum can wrap
+  TableEnd = File->Size - sizeof(Trailer);
+  if (Trailer.EntrySize < sizeof(SNAPSHOT_SECTION_ENTRY) ||
+      Trailer.TableOffset < File->Header.HeaderSize ||
+      Trailer.TableOffset > TableEnd) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "section table out of bounds");
+  }
+  // The product of two UINT32s cannot wrap a UINT64; anything but an exact
+  // fit between TableOffset and the trailer is rejected, larger ones included
+  TableSize = (UINT64)Trailer.SectionCount * Trailer.EntrySize;
+  if (TableSize != TableEnd - Trailer.TableOffset) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "section table out of bounds");
+  }
+  if (MiuCrc32Update(0, File->Data + Trailer.TableOffset, (UINTN)TableSize) != Trailer.TableCrc32) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "section table CRC mismatch");
+  }
+
+  // Entries may grow in later versions; keep the fields this tool knows
+  File->SectionCount = Trailer.SectionCount;
+  File->Sections     = calloc(Trailer.SectionCount + 1, sizeof(SNAPSHOT_SECTION_ENTRY));
+  if (File->Sections == NULL) {
+    SnapshotFree(File);
+    return SnapshotError(Path, "out of memory");
+  }
+  for (UINT32 i = 0; i < Trailer.SectionCount; i++) {
+    SNAPSHOT_SECTION_ENTRY *Entry = &File->Sections[i];
+
+    memcpy(Entry, File->Data + Trailer.TableOffset + (UINT64)i * Trailer.EntrySize, sizeof(*Entry));
+    Entry->Name[sizeof(Entry->Name) - 1] = '\0';
+    if (Entry->Offset > Trailer.TableOffset || Entry->StoredSize > Trailer.TableOffset - Entry->Offset) {
+      SnapshotFree(File);
+      return SnapshotError(Path, "section payload out of bounds");
+    }
+    // Every block needs a header and expands to at most BlockSize bytes, so
+    // this bounds the buffer SnapshotReadSection() allocates
+    if ((Entry->Flags & SNAPSHOT_SECTION_COMPRESSED) != 0 ?
+        Entry->RawSize > Entry->StoredSize / sizeof(SNAPSHOT_BLOCK_HEADER) * File->Header.BlockSize :
+        Entry->RawSize != Entry->StoredSize) {
+      SnapshotFree(File);
+      return SnapshotError(Path, "section size out of bounds");
+    }
+  }
+  return 0;
+}
+
+VOID
+SnapshotFree (
+  IN OUT SNAPSHOT_FILE  *File
+  )
+{
+  free(File->Data);
+  free(File->Sections);
+  memset(File, 0, sizeof(*File));
+}
+
+/**
+  Expand the MiuLz block run of a compressed section into Out.
+**/
+STATIC
+int
+InflateSection (
+  IN  CONST SNAPSHOT_FILE           *File,
+  IN  CONST SNAPSHOT_SECTION_ENTRY  *Section,
+  OUT UINT8                         *Out
+  )
+{
+  CONST UINT8            *In     = File->Data + Section->Offset;
+  UINT64                 InSize  = Section->StoredSize;
+  UINT64                 InPos   = 0;
+  UINT64                 OutPos  = 0;
+  SNAPSHOT_BLOCK_HEADER  Block;
+  UINT32                 Stored;
+
+  while (InPos < InSize) {
+    if (InSize - InPos < sizeof(Block)) {
+      return -1;
+    }
+    memcpy(&Block, In + InPos, sizeof(Block));
+    InPos += sizeof(Block);
+
+    Stored = Block.StoredSize & ~(UINT32)SNAPSHOT_BLOCK_STORED;
+    if (Stored > InSize - InPos || Block.RawSize > File->Header.BlockSize ||
+        Block.RawSize > Section->RawSize - OutPos) {
+      return -1;
+    }
+    if ((Block.StoredSize & SNAPSHOT_BLOCK_STORED) != 0) {
+      if (Stored != Block.RawSize) {
+        return -1;
+      }
+      memcpy(Out + OutPos, In + InPos, Stored);
+    } else if (MiuLzDecompress(In + InPos, Stored, Out + OutPos, Block.RawSize) != Block.RawSize) {
+      return -1;
+    }
+    InPos  += Stored;
+    OutPos += Block.RawSize;
+  }
+  return (OutPos == Section->RawSize) ? 0 : -1;
+}
+
+int
+SnapshotReadSection (
+  IN  CONST SNAPSHOT_FILE           *File,
+  IN  CONST SNAPSHOT_SECTION_ENTRY  *Section,
+  OUT UINT8                         **Payload
+  )
+{
+  int   Status;
+  char  Message[96];
+
+  *Payload = malloc((size_t)Section->RawSize + 1);
+  if (*Payload == NULL) {
+    return SnapshotError(File->Path, "out of memory");
+  }
+
+  if ((Section->Flags & SNAPSHOT_SECTION_COMPRESSED) != 0) {
+    Status = InflateSection(File, Section, *Payload);
+  } else if (Section->StoredSize == Section->RawSize) {
+    memcpy(*Payload, File->Data + Section->Offset, (size_t)Section->RawSize);
+    Status = 0;
+  } else {
+    Status = -1;
+  }
+
+  if (Status == 0 && MiuCrc32Update(0, *Payload, (UINTN)Section->RawSize) != Section->Crc32) {
+    snprintf(Message, sizeof(Message), "section %s: CRC mismatch", Section->Name);
+    free(*Payload);
+    *Payload = NULL;
+    return SnapshotError(File->Path, Message);
+  }
+  if (Status != 0) {
+    snprintf(Message, sizeof(Message), "section %s: malformed payload", Section->Name);
+    free(*Payload);
+    *Payload = NULL;
+    return SnapshotError(File->Path, Message);
+  }
+  return 0;
+}
+
+CONST SNAPSHOT_SECTION_ENTRY *
+SnapshotFindSection (
+  IN CONST SNAPSHOT_FILE  *File,
+  IN CONST CHAR8          *Name
+  )
+{
+  char  *End;
+  long  Type = strtol(Name, &End, 0);
+
+  for (UINT32 i = 0; i < File->SectionCount; i++) {
+    if (strcmp(File->Sections[i].Name, Name) == 0 ||
+        (*End == '\0' && End != Name && File->Sections[i].Type == (UINT32)Type)) {
+      return &File->Sections[i];
+    }
+  }
+  return NULL;
+}
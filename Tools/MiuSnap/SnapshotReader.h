@@ -0,0 +1,64 @@
+/** @file
+  Loads a MiU snapshot (Application/MiU/SnapshotFormat.h) and returns its
+  sections decompressed and CRC-checked.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef SNAPSHOT_READER_H_
+#define SNAPSHOT_READER_H_
+
+#include <Base.h>
+#include "SnapshotFormat.h"
+
+typedef struct {
+  CONST CHAR8             *Path;
+  UINT8                   *Data;          // The whole file
+  UINTN                   Size;
+  SNAPSHOT_HEADER         Header;
+  SNAPSHOT_SECTION_ENTRY  *Sections;      // Copy of the section table
+  UINT32                  SectionCount;
+} SNAPSHOT_FILE;
+
+/**
+  Read Path and validate the header, trailer and section table. On error a
+  message naming the file is printed to stderr.
+
+  @return 0 on success, -1 on error.
+**/
+int
+SnapshotOpen (
+  IN  CONST CHAR8    *Path,
+  OUT SNAPSHOT_FILE  *File
+  );
+
+VOID
+SnapshotFree (
+  IN OUT SNAPSHOT_FILE  *File
+  );
+
+/**
+  Return the uncompressed payload of a section and check its CRC-32.
+
+  @param[out]  Payload  malloc'd buffer of Section->RawSize bytes; free()
+                        it. Empty sections return a 1-byte buffer.
+
+  @return 0 on success, -1 if the section is malformed or its CRC differs.
+**/
+int
+SnapshotReadSection (
+  IN  CONST SNAPSHOT_FILE           *File,
+  IN  CONST SNAPSHOT_SECTION_ENTRY  *Section,
+  OUT UINT8                         **Payload
+  );
+
+/**
+  The first section with Name, or NULL. Name may also be the type number.
+**/
+CONST SNAPSHOT_SECTION_ENTRY *
+SnapshotFindSection (
+  IN CONST SNAPSHOT_FILE  *File,
+  IN CONST CHAR8          *Name
+  );
+
+#endif // SNAPSHOT_READER_H_
@@ -0,0 +1,946 @@
+/** @file
+  Section decoders and the text/JSON renderers.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SnapshotViews.h"
+#include "VariableArchive.h"
+
+#define LOAD_OPTION_ACTIVE  0x00000001
+
+typedef struct {
+  UINT32       Value;
+  CONST CHAR8  *Name;
+} VIEW_NAME;
+
+STATIC CONST VIEW_NAME  mSectionTypeNames[] = {
+  { SNAPSHOT_SECTION_ACPI,          "acpi"         },
+  { SNAPSHOT_SECTION_VARIABLES,     "variables"    },
+  { SNAPSHOT_SECTION_MEMORY_MAP,    "memmap"       },
+  { SNAPSHOT_SECTION_PCI,           "pci"          },
+  { SNAPSHOT_SECTION_SMBIOS,        "smbios"       },
+  { SNAPSHOT_SECTION_LOAD_OPTIONS,  "loadoptions"  },
+  { SNAPSHOT_SECTION_CONFIG_TABLES, "configtables" },
+};
+
+STATIC CONST VIEW_NAME  mSmbiosTypeNames[] = {
+  { 0,   "BIOS Information"                  },
+  { 1,   "System Information"                },
+  { 2,   "Baseboard Information"             },
+  { 3,   "System Enclosure"                  },
+  { 4,   "Processor Information"             },
+  { 7,   "Cache Information"                 },
+  { 8,   "Port Connector Information"        },
+  { 9,   "System Slots"                      },
+  { 11,  "OEM Strings"                       },
+  { 16,  "Physical Memory Array"             },
+  { 17,  "Memory Device"                     },
+  { 19,  "Memory Array Mapped Address"       },
+  { 20,  "Memory Device Mapped Address"      },
+  { 32,  "System Boot Information"           },
+  { 38,  "IPMI Device Information"           },
+  { 41,  "Onboard Devices Extended"          },
+  { 43,  "TPM Device"                        },
+  { 127, "End of Table"                      },
+};
+
+STATIC CONST CHAR8  *mMemoryTypeNames[] = {
+  "Reserved", "LoaderCode", "LoaderData", "BootServicesCode", "BootServicesData",
+  "RuntimeServicesCode", "RuntimeServicesData", "Conventional", "Unusable",
+  "ACPIReclaim", "ACPIMemoryNVS", "MMIO", "MMIOPortSpace", "PalCode",
+  "Persistent", "Unaccepted",
+};
+
+STATIC CONST CHAR8  *mLoadOptionPrefixes[] = {
+  "Boot", "Driver", "SysPrep", "PlatformRecovery",
+};
+
+STATIC CONST struct {
+  CONST CHAR8  *Guid;
+  CONST CHAR8  *Name;
+} mConfigTableNames[] = {
+  { "8868E871-E4F1-11D3-BC22-0080C73C8881", "ACPI 2.0"           },
+  { "EB9D2D30-2D88-11D3-9A16-0090273FC14D", "ACPI 1.0"           },
+  { "EB9D2D31-2D88-11D3-9A16-0090273FC14D", "SMBIOS"             },
+  { "F2FD1544-9794-4A2C-992E-E5BBCF20E394", "SMBIOS3"            },
+  { "B122A263-3661-4F68-9929-78F8B0D62180", "ESRT"               },
+  { "DCFA911D-26EB-469F-A220-38B7DC461220", "Memory Attributes"  },
+  { "49152E77-1ADA-4764-B7A2-7AFEFED95E8B", "Debug Image Info"   },
+  { "7739F24C-93D7-11D4-9A3A-0090273FC14D", "HOB List"           },
+};
+
+STATIC CONST CHAR8 *
+LookupName (
+  IN CONST VIEW_NAME  *Table,
+  IN UINTN            Count,
+  IN UINT32           Value
+  )
+{
+  for (UINTN i = 0; i < Count; i++) {
+    if (Table[i].Value == Value) {
+      return Table[i].Name;
+    }
+  }
+  return "";
+}
+
+CONST CHAR8 *
+SectionTypeName (
+  IN UINT32  Type
+  )
+{
+  CONST CHAR8 *Name = LookupName(mSectionTypeNames, ARRAY_SIZE(mSectionTypeNames), Type);
+
+  return (Name[0] != '\0') ? Name : "unknown";
+}
+
+STATIC
+UINT16
+Read16 (
+  IN CONST UINT8  *Ptr
+  )
+{
+  return (UINT16)(Ptr[0] | (Ptr[1] << 8));
+}
+
+STATIC
+UINT32
+Read32 (
+  IN CONST UINT8  *Ptr
+  )
+{
+  return (UINT32)Read16(Ptr) | ((UINT32)Read16(Ptr + 2) << 16);
+}
+
+STATIC
+UINT64
+Read64 (
+  IN CONST UINT8  *Ptr
+  )
+{
+  return (UINT64)Read32(Ptr) | ((UINT64)Read32(Ptr + 4) << 32);
+}
+
+// GUID in the registry format, from its little-endian in-memory layout
+STATIC
+VOID
+FormatGuid (
+  IN  CONST UINT8  *Bytes,
+  OUT CHAR8        *Out,
+  IN  UINTN        OutSize
+  )
+{
+  snprintf(Out, OutSize, "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+           Read32(Bytes), Read16(Bytes + 4), Read16(Bytes + 6), Bytes[8], Bytes[9],
+           Bytes[10], Bytes[11], Bytes[12], Bytes[13], Bytes[14], Bytes[15]);
+}
+
+/**
+  Convert a NUL-terminated little-endian UCS-2 string of at most MaxChars
+  characters to UTF-8. Control characters become '?'.
+**/
+STATIC
+VOID
+Ucs2ToUtf8 (
+  IN  CONST UINT8  *Bytes,
+  IN  UINTN        MaxChars,
+  OUT CHAR8        *Out,
+  IN  UINTN        OutSize
+  )
+{
+  UINTN Used = 0;
+
+  for (UINTN i = 0; i < MaxChars; i++) {
+    UINT16 Char = Read16(Bytes + 2 * i);
+    UINT8  Encoded[3];
+    UINTN  Length;
+
+    if (Char == 0) {
+      break;
+    }
+    if (Char < 0x20 || Char == 0x7F) {
+      Encoded[0] = '?';
+      Length     = 1;
+    } else if (Char < 0x80) {
+      Encoded[0] = (UINT8)Char;
+      Length     = 1;
+    } else if (Char < 0x800) {
+      Encoded[0] = (UINT8)(0xC0 | (Char >> 6));
+      Encoded[1] = (UINT8)(0x80 | (Char & 0x3F));
+      Length     = 2;
+    } else {
+      Encoded[0] = (UINT8)(0xE0 | (Char >> 12));
+      Encoded[1] = (UINT8)(0x80 | ((Char >> 6) & 0x3F));
+      Encoded[2] = (UINT8)(0x80 | (Char & 0x3F));
+      Length     = 3;
+    }
+    if (Used + Length >= OutSize) {
+      break;
+    }
+    memcpy(Out + Used, Encoded, Length);
+    Used += Length;
+  }
+  Out[Used] = '\0';
+}
+
+// Printable copy of a fixed-size ASCII field such as an ACPI OEM ID
+STATIC
+VOID
+CopyAsciiField (
+  IN  CONST UINT8  *Bytes,
+  IN  UINTN        Length,
+  OUT CHAR8        *Out
+  )
+{
+  UINTN i;
+
+  for (i = 0; i < Length && Bytes[i] != 0; i++) {
+    Out[i] = (Bytes[i] >= 0x20 && Bytes[i] < 0x7F) ? (CHAR8)Bytes[i] : '?';
+  }
+  while (i > 0 && Out[i - 1] == ' ') {
+    i--;
+  }
+  Out[i] = '\0';
+}
+
+STATIC
+VIEW_ITEM *
+AddItem (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Data,
+  IN     UINTN         DataSize
+  )
+{
+  VIEW_ITEM *Item;
+
+  if (View->ItemCount == View->ItemCapacity) {
+    UINTN     Capacity = (View->ItemCapacity == 0) ? 64 : View->ItemCapacity * 2;
+    VIEW_ITEM *Items   = realloc(View->Items, Capacity * sizeof(VIEW_ITEM));
+
+    if (Items == NULL) {
+      return NULL;
+    }
+    View->Items        = Items;
+    View->ItemCapacity = Capacity;
+  }
+  Item = &View->Items[View->ItemCount++];
+  memset(Item, 0, sizeof(*Item));
+  Item->Data     = Data;
+  Item->DataSize = DataSize;
+  return Item;
+}
+
+STATIC
+VOID
+AddFieldV (
+  IN OUT VIEW_FIELD   *Fields,
+  IN OUT UINTN        *FieldCount,
+  IN     CONST CHAR8  *Name,
+  IN     BOOLEAN      IsNumber,
+  IN     CONST CHAR8  *Format,
+  IN     va_list      Args
+  )
+{
+  VIEW_FIELD *Field;
+
+  if (*FieldCount >= VIEW_FIELD_MAX) {
+    return;
+  }
+  Field           = &Fields[(*FieldCount)++];
+  Field->Name     = Name;
+  Field->IsNumber = IsNumber;
+  vsnprintf(Field->Value, sizeof(Field->Value), Format, Args);
+}
+
+STATIC
+VOID
+AddField (
+  IN OUT VIEW_ITEM    *Item,
+  IN     CONST CHAR8  *Name,
+  IN     BOOLEAN      IsNumber,
+  IN     CONST CHAR8  *Format,
+  ...
+  )
+{
+  va_list Args;
+
+  va_start(Args, Format);
+  AddFieldV(Item->Fields, &Item->FieldCount, Name, IsNumber, Format, Args);
+  va_end(Args);
+}
+
+STATIC
+VOID
+AddInfo (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST CHAR8   *Name,
+  IN     BOOLEAN       IsNumber,
+  IN     CONST CHAR8   *Format,
+  ...
+  )
+{
+  va_list Args;
+
+  va_start(Args, Format);
+  AddFieldV(View->Info, &View->InfoCount, Name, IsNumber, Format, Args);
+  va_end(Args);
+}
+
+//
+// Decoders. Each walks the payload of one section type; a record that runs
+// past the end marks the view truncated and stops the walk.
+//
+
+STATIC
+int
+DecodePci (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  UINTN               Offset = 0;
+  SNAPSHOT_PCI_DEVICE Device;
+
+  while (Offset < Size) {
+    CONST UINT8 *Config;
+    VIEW_ITEM   *Item;
+
+    if (Size - Offset < sizeof(Device)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    memcpy(&Device, Payload + Offset, sizeof(Device));
+    Offset += sizeof(Device);
+    if (Device.ConfigSize > Size - Offset) {
+      View->Truncated = TRUE;
+      break;
+    }
+    Config = Payload + Offset;
+    Offset += Device.ConfigSize;
+
+    Item = AddItem(View, Config, Device.ConfigSize);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "%04x:%02x:%02x.%x",
+             Device.Segment, Device.Bus, Device.Device, Device.Function);
+    AddField(Item, "bdf", FALSE, "%s", Item->Key);
+    AddField(Item, "vendor", FALSE, "%04x", Device.VendorId);
+    AddField(Item, "device", FALSE, "%04x", Device.DeviceId);
+    if (Device.ConfigSize >= 0x0C) {
+      AddField(Item, "class", FALSE, "%02x%02x%02x", Config[0x0B], Config[0x0A], Config[0x09]);
+    }
+    AddField(Item, "config_size", TRUE, "%u", Device.ConfigSize);
+  }
+  return 0;
+}
+
+STATIC
+int
+DecodeSmbios (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  UINTN                  Offset;
+  SNAPSHOT_SMBIOS        Header;
+  SNAPSHOT_SMBIOS_RECORD Record;
+
+  if (Size < sizeof(Header)) {
+    View->Truncated = (BOOLEAN)(Size != 0);
+    return 0;
+  }
+  memcpy(&Header, Payload, sizeof(Header));
+  AddInfo(View, "version", FALSE, "%u.%u", Header.MajorVersion, Header.MinorVersion);
+  AddInfo(View, "records", TRUE, "%u", Header.RecordCount);
+
+  for (Offset = sizeof(Header); Offset < Size;) {
+    VIEW_ITEM *Item;
+
+    if (Size - Offset < sizeof(Record)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    memcpy(&Record, Payload + Offset, sizeof(Record));
+    Offset += sizeof(Record);
+    if (Record.Length > Size - Offset) {
+      View->Truncated = TRUE;
+      break;
+    }
+
+    Item = AddItem(View, Payload + Offset, Record.Length);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "0x%04X", Record.Handle);
+    AddField(Item, "handle", FALSE, "0x%04X", Record.Handle);
+    AddField(Item, "type", TRUE, "%u", Record.Type);
+    AddField(Item, "name", FALSE, "%s", LookupName(mSmbiosTypeNames, ARRAY_SIZE(mSmbiosTypeNames), Record.Type));
+    AddField(Item, "length", TRUE, "%u", (Record.Length >= 2) ? Payload[Offset + 1] : 0);
+    AddField(Item, "size", TRUE, "%u", Record.Length);
+    Offset += Record.Length;
+  }
+  return 0;
+}
+
+STATIC
+int
+DecodeAcpi (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  UINTN               Offset = 0;
+  SNAPSHOT_ACPI_TABLE Table;
+
+  while (Offset < Size) {
+    CONST UINT8 *Bytes;
+    VIEW_ITEM   *Item;
+    CHAR8       Signature[9];
+    CHAR8       OemId[7]      = "";
+    CHAR8       OemTableId[9] = "";
+    UINT8       Revision      = 0;
+    UINT32      OemRevision   = 0;
+
+    if (Size - Offset < sizeof(Table)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    memcpy(&Table, Payload + Offset, sizeof(Table));
+    Offset += sizeof(Table);
+    if (Table.Length > Size - Offset) {
+      View->Truncated = TRUE;
+      break;
+    }
+    Bytes   = Payload + Offset;
+    Offset += Table.Length;
+
+    // The RSDP has an 8-byte signature and its own layout
+    if (Table.Length >= 20 && memcmp(Bytes, "RSD PTR ", 8) == 0) {
+      strcpy(Signature, "RSDP");
+      CopyAsciiField(Bytes + 9, 6, OemId);
+      Revision = Bytes[15];
+    } else if (Table.Length >= 36) {
+      CopyAsciiField(Bytes, 4, Signature);
+      CopyAsciiField(Bytes + 10, 6, OemId);
+      CopyAsciiField(Bytes + 16, 8, OemTableId);
+      Revision    = Bytes[8];
+      OemRevision = Read32(Bytes + 24);
+    } else {
+      strcpy(Signature, "????");
+    }
+
+    Item = AddItem(View, Bytes, Table.Length);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "%s", Signature);
+    AddField(Item, "signature", FALSE, "%s", Signature);
+    AddField(Item, "address", FALSE, "0x%llx", (unsigned long long)Table.Address);
+    AddField(Item, "length", TRUE, "%u", Table.Length);
+    AddField(Item, "revision", TRUE, "%u", Revision);
+    AddField(Item, "oem_id", FALSE, "%s", OemId);
+    AddField(Item, "oem_table_id", FALSE, "%s", OemTableId);
+    AddField(Item, "oem_revision", FALSE, "0x%x", OemRevision);
+  }
+  return 0;
+}
+
+STATIC
+VOID
+FormatAttributes (
+  IN  UINT32  Attributes,
+  OUT CHAR8   *Out,
+  IN  UINTN   OutSize
+  )
+{
+  STATIC CONST CHAR8 *Names[] = { "NV", "BS", "RT", "HR", "AW", "AT", "AP", "EA" };
+  UINTN              Used     = 0;
+
+  Out[0] = '\0';
+  for (UINTN Bit = 0; Bit < ARRAY_SIZE(Names); Bit++) {
+    if ((Attributes & (1U << Bit)) != 0 && Used + 4 < OutSize) {
+      Used += (UINTN)snprintf(Out + Used, OutSize - Used, "%s%s", (Used != 0) ? "|" : "", Names[Bit]);
+    }
+  }
+}
+
+STATIC
+int
+DecodeVariables (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  UINTN                   Offset = 0;
+  VARIABLE_ARCHIVE_RECORD Record;
+
+  for (;;) {
+    VIEW_ITEM *Item;
+    CHAR8     Name[64];
+    CHAR8     Guid[40];
+    CHAR8     Attributes[32];
+
+    if (Size - Offset < sizeof(UINT32)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    if (Read32(Payload + Offset) == 0) {
+      break;      // End marker
+    }
+    if (Size - Offset < sizeof(Record)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    memcpy(&Record, Payload + Offset, sizeof(Record));
+    if (Record.RecordSize > Size - Offset ||
+        (UINT64)sizeof(Record) + Record.NameSize + Record.DataSize != Record.RecordSize) {
+      View->Truncated = TRUE;
+      break;
+    }
+
+    Ucs2ToUtf8(Payload + Offset + sizeof(Record), Record.NameSize / 2, Name, sizeof(Name));
+    FormatGuid((CONST UINT8 *)&Record.VendorGuid, Guid, sizeof(Guid));
+    FormatAttributes(Record.Attributes, Attributes, sizeof(Attributes));
+
+    Item = AddItem(View, Payload + Offset + sizeof(Record) + Record.NameSize, Record.DataSize);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "%s:%s", Guid, Name);
+    AddField(Item, "guid", FALSE, "%s", Guid);
+    AddField(Item, "name", FALSE, "%s", Name);
+    AddField(Item, "attributes", FALSE, "%s", Attributes);
+    AddField(Item, "size", TRUE, "%u", Record.DataSize);
+    Offset += Record.RecordSize;
+  }
+  return 0;
+}
+
+STATIC
+int
+DecodeMemoryMap (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  SNAPSHOT_MEMORY_MAP Header;
+  UINTN               Offset;
+
+  if (Size < sizeof(Header)) {
+    View->Truncated = (BOOLEAN)(Size != 0);
+    return 0;
+  }
+  memcpy(&Header, Payload, sizeof(Header));
+  AddInfo(View, "descriptor_size", TRUE, "%u", Header.DescriptorSize);
+  AddInfo(View, "descriptor_version", TRUE, "%u", Header.DescriptorVersion);
+  // EFI_MEMORY_DESCRIPTOR ends with Attribute at offset 32
+  if (Header.DescriptorSize < 40) {
+    View->Truncated = (BOOLEAN)(Header.DescriptorCount != 0);
+    return 0;
+  }
+
+  for (Offset = sizeof(Header); Offset < Size; Offset += Header.DescriptorSize) {
+    CONST UINT8 *Descriptor = Payload + Offset;
+    UINT32      Type;
+    VIEW_ITEM   *Item;
+
+    if (Size - Offset < Header.DescriptorSize) {
+      View->Truncated = TRUE;
+      break;
+    }
+    Type = Read32(Descriptor);
+    Item = AddItem(View, Descriptor, Header.DescriptorSize);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "0x%016llx", (unsigned long long)Read64(Descriptor + 8));
+    if (Type < ARRAY_SIZE(mMemoryTypeNames)) {
+      AddField(Item, "type", FALSE, "%s", mMemoryTypeNames[Type]);
+    } else {
+      AddField(Item, "type", FALSE, "0x%x", Type);
+    }
+    AddField(Item, "start", FALSE, "%s", Item->Key);
+    AddField(Item, "pages", TRUE, "%llu", (unsigned long long)Read64(Descriptor + 24));
+    AddField(Item, "attribute", FALSE, "0x%016llx", (unsigned long long)Read64(Descriptor + 32));
+  }
+  return 0;
+}
+
+STATIC
+int
+DecodeLoadOptions (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  UINTN                Offset = 0;
+  SNAPSHOT_LOAD_OPTION Option;
+
+  while (Offset < Size) {
+    CONST UINT8 *Data;
+    VIEW_ITEM   *Item;
+    CHAR8       Description[VIEW_VALUE_SIZE] = "";
+
+    if (Size - Offset < sizeof(Option)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    memcpy(&Option, Payload + Offset, sizeof(Option));
+    Offset += sizeof(Option);
+    if (Option.DataSize > Size - Offset) {
+      View->Truncated = TRUE;
+      break;
+    }
+    Data    = Payload + Offset;
+    Offset += Option.DataSize;
+
+    // EFI_LOAD_OPTION: Attributes, FilePathListLength, then the description
+    if (Option.DataSize > 6) {
+      Ucs2ToUtf8(Data + 6, (Option.DataSize - 6) / 2, Description, sizeof(Description));
+    }
+
+    Item = AddItem(View, Data, Option.DataSize);
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "%s%04X",
+             (Option.Type < ARRAY_SIZE(mLoadOptionPrefixes)) ? mLoadOptionPrefixes[Option.Type] : "Option",
+             Option.Number);
+    AddField(Item, "name", FALSE, "%s", Item->Key);
+    AddField(Item, "position", TRUE, "%u", Option.OrderPosition);
+    AddField(Item, "active", FALSE, "%s", (Option.DataSize >= 4 && (Read32(Data) & LOAD_OPTION_ACTIVE) != 0) ? "yes" : "no");
+    AddField(Item, "flags", FALSE, "%s%s%s",
+             (Option.Flags & BIT0) ? "BootNext" : "",
+             ((Option.Flags & BIT0) && (Option.Flags & BIT1)) ? "|" : "",
+             (Option.Flags & BIT1) ? "BootCurrent" : "");
+    AddField(Item, "description", FALSE, "%s", Description);
+    AddField(Item, "size", TRUE, "%u", Option.DataSize);
+  }
+  return 0;
+}
+
+STATIC
+int
+DecodeConfigTables (
+  IN OUT SECTION_VIEW  *View,
+  IN     CONST UINT8   *Payload,
+  IN     UINTN         Size
+  )
+{
+  SNAPSHOT_SYSTEM_TABLE System;
+  UINTN                 Offset;
+  CHAR8                 Vendor[VIEW_VALUE_SIZE];
+
+  if (Size < sizeof(System)) {
+    View->Truncated = (BOOLEAN)(Size != 0);
+    return 0;
+  }
+  memcpy(&System, Payload, sizeof(System));
+  Ucs2ToUtf8(Payload + offsetof(SNAPSHOT_SYSTEM_TABLE, FirmwareVendor), ARRAY_SIZE(System.FirmwareVendor),
+             Vendor, sizeof(Vendor));
+  AddInfo(View, "firmware_vendor", FALSE, "%s", Vendor);
+  AddInfo(View, "firmware_revision", FALSE, "0x%08x", System.FirmwareRevision);
+  // The minor revision holds two digits: 0x46 is 2.7, 0x47 would be 2.7.1
+  if ((System.UefiRevision & 0xFFFF) % 10 != 0) {
+    AddInfo(View, "uefi_revision", FALSE, "%u.%u.%u", System.UefiRevision >> 16,
+            (System.UefiRevision & 0xFFFF) / 10, (System.UefiRevision & 0xFFFF) % 10);
+  } else {
+    AddInfo(View, "uefi_revision", FALSE, "%u.%u", System.UefiRevision >> 16, (System.UefiRevision & 0xFFFF) / 10);
+  }
+
+  for (Offset = sizeof(System); Offset < Size; Offset += sizeof(SNAPSHOT_CONFIG_TABLE)) {
+    CONST CHAR8 *Name = "";
+    VIEW_ITEM   *Item;
+    CHAR8       Guid[40];
+
+    if (Size - Offset < sizeof(SNAPSHOT_CONFIG_TABLE)) {
+      View->Truncated = TRUE;
+      break;
+    }
+    FormatGuid(Payload + Offset, Guid, sizeof(Guid));
+    for (UINTN i = 0; i < ARRAY_SIZE(mConfigTableNames); i++) {
+      if (strcmp(Guid, mConfigTableNames[i].Guid) == 0) {
+        Name = mConfigTableNames[i].Name;
+      }
+    }
+
+    Item = AddItem(View, Payload + Offset, sizeof(SNAPSHOT_CONFIG_TABLE));
+    if (Item == NULL) {
+      return -1;
+    }
+    snprintf(Item->Key, sizeof(Item->Key), "%s", Guid);
+    AddField(Item, "guid", FALSE, "%s", Guid);
+    AddField(Item, "name", FALSE, "%s", Name);
+    AddField(Item, "address", FALSE, "0x%llx", (unsigned long long)Read64(Payload + Offset + sizeof(GUID)));
+  }
+  return 0;
+}
+
+STATIC
+int
+CompareItemKeys (
+  CONST VOID  *Left,
+  CONST VOID  *Right
+  )
+{
+  CONST VIEW_ITEM *A     = *(VIEW_ITEM * CONST *)Left;
+  CONST VIEW_ITEM *B     = *(VIEW_ITEM * CONST *)Right;
+  int             Result = strcmp(A->Key, B->Key);
+
+  // Equal keys keep payload order, so the first one stays unnumbered
+  return (Result != 0) ? Result : (A < B) ? -1 : (A > B);
+}
+
+/**
+  Append #2, #3... to repeated keys, numbered in payload order.
+**/
+STATIC
+int
+MakeKeysUnique (
+  IN OUT SECTION_VIEW  *View
+  )
+{
+  VIEW_ITEM **Sorted;
+  UINTN     Repeat = 1;
+
+  if (View->ItemCount < 2) {
+    return 0;
+  }
+  Sorted = malloc(View->ItemCount * sizeof(*Sorted));
+  if (Sorted == NULL) {
+    return -1;
+  }
+  for (UINTN i = 0; i < View->ItemCount; i++) {
+    Sorted[i] = &View->Items[i];
+  }
+  qsort(Sorted, View->ItemCount, sizeof(*Sorted), CompareItemKeys);
+
+  // Walk backwards so the comparison still sees the unnumbered key
+  for (UINTN i = View->ItemCount - 1; i > 0; i--) {
+    if (strcmp(Sorted[i]->Key, Sorted[i - 1]->Key) == 0) {
+      Repeat++;
+      continue;
+    }
+    for (UINTN n = 1; n < Repeat; n++) {
+      UINTN Length = strlen(Sorted[i + n]->Key);
+      snprintf(Sorted[i + n]->Key + Length, sizeof(Sorted[i + n]->Key) - Length, "#%u", (unsigned)(n + 1));
+    }
+    Repeat = 1;
+  }
+  for (UINTN n = 1; n < Repeat; n++) {
+    UINTN Length = strlen(Sorted[n]->Key);
+    snprintf(Sorted[n]->Key + Length, sizeof(Sorted[n]->Key) - Length, "#%u", (unsigned)(n + 1));
+  }
+
+  free(Sorted);
+  return 0;
+}
+
+int
+BuildSectionView (
+  IN  CONST SNAPSHOT_FILE           *File,
+  IN  CONST SNAPSHOT_SECTION_ENTRY  *Section,
+  OUT SECTION_VIEW                  *View
+  )
+{
+  UINTN  Size = (UINTN)Section->RawSize;
+  int    Status;
+
+  memset(View, 0, sizeof(*View));
+  View->Section = Section;
+  if (SnapshotReadSection(File, Section, &View->Payload) != 0) {
+    return -1;
+  }
+
+  switch (Section->Type) {
+    case SNAPSHOT_SECTION_PCI:           Status = DecodePci(View, View->Payload, Size);          break;
+    case SNAPSHOT_SECTION_SMBIOS:        Status = DecodeSmbios(View, View->Payload, Size);       break;
+    case SNAPSHOT_SECTION_ACPI:          Status = DecodeAcpi(View, View->Payload, Size);         break;
+    case SNAPSHOT_SECTION_VARIABLES:     Status = DecodeVariables(View, View->Payload, Size);    break;
+    case SNAPSHOT_SECTION_MEMORY_MAP:    Status = DecodeMemoryMap(View, View->Payload, Size);    break;
+    case SNAPSHOT_SECTION_LOAD_OPTIONS:  Status = DecodeLoadOptions(View, View->Payload, Size);  break;
+    case SNAPSHOT_SECTION_CONFIG_TABLES: Status = DecodeConfigTables(View, View->Payload, Size); break;
+    default:
+      // Unknown to this tool: one item so the diff still compares the bytes
+      Status = (AddItem(View, View->Payload, Size) == NULL) ? -1 : 0;
+      if (Status == 0) {
+        strcpy(View->Items[0].Key, "payload");
+        AddField(&View->Items[0], "size", TRUE, "%llu", (unsigned long long)Size);
+      }
+      break;
+  }
+
+  if (Status == 0) {
+    Status = MakeKeysUnique(View);
+  }
+  if (Status != 0) {
+    fprintf(stderr, "MiuSnap: %s: out of memory decoding %s\n", File->Path, Section->Name);
+    FreeSectionView(View);
+    return -1;
+  }
+  return 0;
+}
+
+VOID
+FreeSectionView (
+  IN OUT SECTION_VIEW  *View
+  )
+{
+  free(View->Payload);
+  free(View->Items);
+  memset(View, 0, sizeof(*View));
+}
+
+CONST VIEW_FIELD *
+FindViewField (
+  IN CONST VIEW_FIELD  *Fields,
+  IN UINTN             FieldCount,
+  IN CONST CHAR8       *Name
+  )
+{
+  for (UINTN i = 0; i < FieldCount; i++) {
+    if (strcmp(Fields[i].Name, Name) == 0) {
+      return &Fields[i];
+    }
+  }
+  return NULL;
+}
+
+// Numbers right-aligned, text left-aligned, no padding after the last column
+STATIC
+VOID
+PrintTextRow (
+  IN FILE              *Out,
+  IN CONST VIEW_FIELD  *Fields,
+  IN UINTN             Columns,
+  IN CONST UINTN       *Width,
+  IN BOOLEAN           Header
+  )
+{
+  for (UINTN c = 0; c < Columns; c++) {
+    CONST CHAR8 *Text = Header ? Fields[c].Name : Fields[c].Value;
+    BOOLEAN     Last  = (BOOLEAN)(c + 1 == Columns);
+
+    if (!Header && Fields[c].IsNumber) {
+      fprintf(Out, "%*s", (int)Width[c], Text);
+    } else {
+      fprintf(Out, "%-*s", Last ? 0 : (int)Width[c], Text);
+    }
+    fputs(Last ? "\n" : "  ", Out);
+  }
+}
+
+VOID
+PrintSectionViewText (
+  IN FILE                *Out,
+  IN CONST SECTION_VIEW  *View
+  )
+{
+  CONST SNAPSHOT_SECTION_ENTRY *Section = View->Section;
+  UINTN                        Width[VIEW_FIELD_MAX];
+  UINTN                        Columns = (View->ItemCount != 0) ? View->Items[0].FieldCount : 0;
+
+  fprintf(Out, "== %s: %u items, %llu bytes\n", Section->Name, Section->ItemCount,
+          (unsigned long long)Section->RawSize);
+  for (UINTN i = 0; i < View->InfoCount; i++) {
+    fprintf(Out, "   %s: %s\n", View->Info[i].Name, View->Info[i].Value);
+  }
+
+  // Every item of a section has the same columns; size them to the widest value
+  for (UINTN c = 0; c < Columns; c++) {
+    Width[c] = strlen(View->Items[0].Fields[c].Name);
+    for (UINTN i = 0; i < View->ItemCount; i++) {
+      UINTN Length = strlen(View->Items[i].Fields[c].Value);
+      Width[c] = (Length > Width[c]) ? Length : Width[c];
+    }
+  }
+  if (Columns != 0) {
+    PrintTextRow(Out, View->Items[0].Fields, Columns, Width, TRUE);
+  }
+  for (UINTN i = 0; i < View->ItemCount; i++) {
+    PrintTextRow(Out, View->Items[i].Fields, Columns, Width, FALSE);
+  }
+  if (View->Truncated) {
+    fprintf(Out, "   (payload ends inside an item)\n");
+  }
+}
+
+VOID
+PrintJsonString (
+  IN FILE         *Out,
+  IN CONST CHAR8  *String
+  )
+{
+  fputc('"', Out);
+  for (; *String != '\0'; String++) {
+    UINT8 Char = (UINT8)*String;
+
+    if (Char == '"' || Char == '\\') {
+      fprintf(Out, "\\%c", Char);
+    } else if (Char < 0x20) {
+      fprintf(Out, "\\u%04x", Char);
+    } else {
+      fputc(Char, Out);
+    }
+  }
+  fputc('"', Out);
+}
+
+STATIC
+VOID
+PrintJsonFields (
+  IN FILE              *Out,
+  IN CONST VIEW_FIELD  *Fields,
+  IN UINTN             Count
+  )
+{
+  fputc('{', Out);
+  for (UINTN i = 0; i < Count; i++) {
+    PrintJsonString(Out, Fields[i].Name);
+    fputc(':', Out);
+    if (Fields[i].IsNumber) {
+      fputs(Fields[i].Value, Out);
+    } else {
+      PrintJsonString(Out, Fields[i].Value);
+    }
+    if (i + 1 < Count) {
+      fputc(',', Out);
+    }
+  }
+  fputc('}', Out);
+}
+
+VOID
+PrintSectionViewJson (
+  IN FILE                *Out,
+  IN CONST SECTION_VIEW  *View
+  )
+{
+  CONST SNAPSHOT_SECTION_ENTRY *Section = View->Section;
+
+  fprintf(Out, "{\"name\":");
+  PrintJsonString(Out, Section->Name);
+  fprintf(Out, ",\"type\":%u,\"raw_size\":%llu,\"crc32\":\"%08x\",\"item_count\":%u,\"truncated\":%s,\"info\":",
+          Section->Type, (unsigned long long)Section->RawSize, Section->Crc32, Section->ItemCount,
+          View->Truncated ? "true" : "false");
+  PrintJsonFields(Out, View->Info, View->InfoCount);
+  fprintf(Out, ",\"items\":[");
+  for (UINTN i = 0; i < View->ItemCount; i++) {
+    PrintJsonFields(Out, View->Items[i].Fields, View->Items[i].FieldCount);
+    if (i + 1 < View->ItemCount) {
+      fputc(',', Out);
+    }
+  }
+  fprintf(Out, "]}");
+}
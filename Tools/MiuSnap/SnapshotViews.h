@@ -0,0 +1,96 @@
+/** @file
+  Decodes snapshot sections into rows of named fields, the same columns the
+  MiU screens show. One decoder per section type feeds the text and JSON
+  output and the diff.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef SNAPSHOT_VIEWS_H_
+#define SNAPSHOT_VIEWS_H_
+
+#include <stdio.h>
+#include "SnapshotReader.h"
+
+#define VIEW_FIELD_MAX   8
+#define VIEW_VALUE_SIZE  96
+
+typedef struct {
+  CONST CHAR8  *Name;                     // Column header and JSON key
+  CHAR8        Value[VIEW_VALUE_SIZE];
+  BOOLEAN      IsNumber;                  // Written without quotes in JSON
+} VIEW_FIELD;
+
+typedef struct {
+  CHAR8        Key[128];                  // Identifies the item across snapshots
+  VIEW_FIELD   Fields[VIEW_FIELD_MAX];
+  UINTN        FieldCount;
+  CONST UINT8  *Data;                     // Bytes the diff compares, inside the payload
+  UINTN        DataSize;
+} VIEW_ITEM;
+
+typedef struct {
+  CONST SNAPSHOT_SECTION_ENTRY  *Section;
+  UINT8                         *Payload;
+  VIEW_FIELD                    Info[VIEW_FIELD_MAX];   // Section-wide values
+  UINTN                         InfoCount;
+  VIEW_ITEM                     *Items;
+  UINTN                         ItemCount;
+  UINTN                         ItemCapacity;
+  BOOLEAN                       Truncated;  // The payload ended inside an item
+} SECTION_VIEW;
+
+/**
+  Read, verify and decode one section. Item keys are made unique by
+  appending #2, #3... to repeats in payload order.
+
+  @return 0 on success, -1 if the section could not be read.
+**/
+int
+BuildSectionView (
+  IN  CONST SNAPSHOT_FILE           *File,
+  IN  CONST SNAPSHOT_SECTION_ENTRY  *Section,
+  OUT SECTION_VIEW                  *View
+  );
+
+VOID
+FreeSectionView (
+  IN OUT SECTION_VIEW  *View
+  );
+
+// Aligned columns with a header row, then the section-wide values
+VOID
+PrintSectionViewText (
+  IN FILE                *Out,
+  IN CONST SECTION_VIEW  *View
+  );
+
+// One JSON object: the section entry, "info" and "items"
+VOID
+PrintSectionViewJson (
+  IN FILE                *Out,
+  IN CONST SECTION_VIEW  *View
+  );
+
+// Field of an item by name, or NULL
+CONST VIEW_FIELD *
+FindViewField (
+  IN CONST VIEW_FIELD  *Fields,
+  IN UINTN             FieldCount,
+  IN CONST CHAR8       *Name
+  );
+
+// A JSON string literal with escapes
+VOID
+PrintJsonString (
+  IN FILE         *Out,
+  IN CONST CHAR8  *String
+  );
+
+// Name of a SNAPSHOT_SECTION_* type, "unknown" for others
+CONST CHAR8 *
+SectionTypeName (
+  IN UINT32  Type
+  );
+
+#endif // SNAPSHOT_VIEWS_H_
@@ -0,0 +1,351 @@
+/** @file
+  Writes the snapshots RunChecks.sh feeds to MiuSnap: two small valid
+  captures that differ in a few items, and damaged files that must be
+  rejected without crashing. The sections are laid out with the firmware's
+  SnapshotFormat.h and compressed with its MiuLz codec.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Base.h>
+#include "SnapshotFormat.h"
+#include "VariableArchive.h"
+#include "MiuLz.h"
+
+#define TEST_FILE_MAX     SIZE_1MB
+#define TEST_SECTION_MAX  8
+#define TEST_TYPE_FUTURE  99      // A section type MiuSnap does not know
+
+typedef struct {
+  UINT8                   Data[TEST_FILE_MAX];
+  UINTN                   Size;
+  SNAPSHOT_SECTION_ENTRY  Sections[TEST_SECTION_MAX];
+  UINT32                  SectionCount;
+} SNAPSHOT_BUILDER;
+
+STATIC SNAPSHOT_BUILDER  mBuilder;
+STATIC UINT32            mHashTable[MIULZ_HASH_SIZE];
+STATIC CONST CHAR8       *mOutDir;
+
+STATIC
+VOID
+Append (
+  IN CONST VOID  *Data,
+  IN UINTN       Size
+  )
+{
+  if (Size > TEST_FILE_MAX - mBuilder.Size) {
+    fprintf(stderr, "MakeTestSnapshots: builder overflow\n");
+    exit(2);
+  }
+  memcpy(mBuilder.Data + mBuilder.Size, Data, Size);
+  mBuilder.Size += Size;
+}
+
+STATIC
+VOID
+BeginSnapshot (
+  VOID
+  )
+{
+  SNAPSHOT_HEADER Header;
+
+  memset(&mBuilder, 0, sizeof(mBuilder));
+  memset(&Header, 0, sizeof(Header));
+  Header.Signature  = SNAPSHOT_SIGNATURE;
+  Header.Version    = SNAPSHOT_VERSION;
+  Header.HeaderSize = sizeof(Header);
+  Header.BlockSize  = SNAPSHOT_BLOCK_SIZE;
+  Header.Year       = 2026;
+  Header.Month      = 1;
+  Header.Day        = 2;
+  Append(&Header, sizeof(Header));
+}
+
+/**
+  Add one section. Compressed sections are cut into blocks as the firmware
+  writer does; a block MiuLz cannot shrink is stored raw.
+**/
+STATIC
+SNAPSHOT_SECTION_ENTRY *
+AddSection (
+  IN UINT32       Type,
+  IN CONST CHAR8  *Name,
+  IN CONST UINT8  *Raw,
+  IN UINTN        RawSize,
+  IN UINT32       ItemCount,
+  IN BOOLEAN      Compress
+  )
+{
+  STATIC UINT8           Packed[MIULZ_BOUND(SNAPSHOT_BLOCK_SIZE)];
+  SNAPSHOT_SECTION_ENTRY *Entry = &mBuilder.Sections[mBuilder.SectionCount++];
+
+  memset(Entry, 0, sizeof(*Entry));
+  Entry->Type      = Type;
+  Entry->Flags     = Compress ? SNAPSHOT_SECTION_COMPRESSED : 0;
+  Entry->Offset    = mBuilder.Size;
+  Entry->RawSize   = RawSize;
+  Entry->Crc32     = MiuCrc32Update(0, Raw, RawSize);
+  Entry->ItemCount = ItemCount;
+  strncpy(Entry->Name, Name, sizeof(Entry->Name) - 1);
+
+  if (!Compress) {
+    Append(Raw, RawSize);
+  } else {
+    for (UINTN Offset = 0; Offset < RawSize; Offset += SNAPSHOT_BLOCK_SIZE) {
+      SNAPSHOT_BLOCK_HEADER Block;
+      UINTN                 Chunk = (RawSize - Offset < SNAPSHOT_BLOCK_SIZE) ? RawSize - Offset : SNAPSHOT_BLOCK_SIZE;
+      UINTN                 Size;
+
+      memset(mHashTable, 0, sizeof(mHashTable));
+      Size          = MiuLzCompress(Raw + Offset, Chunk, Packed, sizeof(Packed), mHashTable);
+      Block.RawSize = (UINT32)Chunk;
+      if (Size != 0) {
+        Block.StoredSize = (UINT32)Size;
+        Append(&Block, sizeof(Block));
+        Append(Packed, Size);
+      } else {
+        Block.StoredSize = (UINT32)Chunk | SNAPSHOT_BLOCK_STORED;
+        Append(&Block, sizeof(Block));
+        Append(Raw + Offset, Chunk);
+      }
+    }
+  }
+  Entry->StoredSize = mBuilder.Size - Entry->Offset;
+  return Entry;
+}
+
+STATIC
+VOID
+WriteFile (
+  IN CONST CHAR8  *Name,
+  IN CONST UINT8  *Data,
+  IN UINTN        Size
+  )
+{
+  CHAR8 Path[512];
+  FILE  *Out;
+
+  snprintf(Path, sizeof(Path), "%s/%s", mOutDir, Name);
+  Out = fopen(Path, "wb");
+  if (Out == NULL || fwrite(Data, 1, Size, Out) != Size || fclose(Out) != 0) {
+    perror(Path);
+    exit(2);
+  }
+}
+
+// Append the section table and trailer, then write the file
+STATIC
+VOID
+EndSnapshot (
+  IN CONST CHAR8  *Name
+  )
+{
+  SNAPSHOT_TRAILER Trailer;
+
+  memset(&Trailer, 0, sizeof(Trailer));
+  Trailer.TableOffset  = mBuilder.Size;
+  Trailer.SectionCount = mBuilder.SectionCount;
+  Trailer.EntrySize    = sizeof(SNAPSHOT_SECTION_ENTRY);
+  Trailer.TableCrc32   = MiuCrc32Update(0, mBuilder.Sections, mBuilder.SectionCount * sizeof(SNAPSHOT_SECTION_ENTRY));
+  Trailer.Signature    = SNAPSHOT_END_SIGNATURE;
+  Append(mBuilder.Sections, mBuilder.SectionCount * sizeof(SNAPSHOT_SECTION_ENTRY));
+  Append(&Trailer, sizeof(Trailer));
+  WriteFile(Name, mBuilder.Data, mBuilder.Size);
+}
+
+STATIC
+UINTN
+AddPciDevice (
+  OUT UINT8   *Out,
+  IN  UINT8   Bus,
+  IN  UINT8   Device,
+  IN  UINT16  VendorId,
+  IN  UINT16  DeviceId,
+  IN  UINT8   Class
+  )
+{
+  SNAPSHOT_PCI_DEVICE Header;
+  UINT8               Config[256];
+
+  memset(&Header, 0, sizeof(Header));
+  memset(Config, 0, sizeof(Config));
+  Header.Bus        = Bus;
+  Header.Device     = Device;
+  Header.VendorId   = VendorId;
+  Header.DeviceId   = DeviceId;
+  Header.ConfigSize = sizeof(Config);
+  memcpy(Config, &VendorId, sizeof(VendorId));
+  memcpy(Config + 2, &DeviceId, sizeof(DeviceId));
+  Config[0x0B] = Class;
+  memcpy(Out, &Header, sizeof(Header));
+  memcpy(Out + sizeof(Header), Config, sizeof(Config));
+  return sizeof(Header) + sizeof(Config);
+}
+
+STATIC
+UINTN
+AddVariable (
+  OUT UINT8        *Out,
+  IN  CONST CHAR8  *Name,
+  IN  CONST UINT8  *Data,
+  IN  UINT32       DataSize
+  )
+{
+  STATIC CONST EFI_GUID   GlobalVariable = { 0x8BE4DF61, 0x93CA, 0x11D2, { 0xAA, 0x0D, 0x00, 0xE0, 0x98, 0x03, 0x2B, 0x8C } };
+  VARIABLE_ARCHIVE_RECORD Record;
+  UINTN                   Length = strlen(Name) + 1;
+
+  Record.NameSize   = (UINT32)(Length * sizeof(CHAR16));
+  Record.DataSize   = DataSize;
+  Record.RecordSize = (UINT32)sizeof(Record) + Record.NameSize + DataSize;
+  Record.Attributes = 0x7;
+  Record.VendorGuid = GlobalVariable;
+  memcpy(Out, &Record, sizeof(Record));
+  for (UINTN i = 0; i < Length; i++) {
+    CHAR16 Char = (CHAR16)Name[i];
+    memcpy(Out + sizeof(Record) + i * sizeof(CHAR16), &Char, sizeof(Char));
+  }
+  memcpy(Out + sizeof(Record) + Record.NameSize, Data, DataSize);
+  return Record.RecordSize;
+}
+
+/**
+  A capture with compressed PCI and variables sections, an uncompressed
+  SMBIOS section and a section of an unknown type whose only block does not
+  compress and so is stored. Variant adds a device, changes a variable and
+  bumps the SMBIOS version.
+**/
+STATIC
+VOID
+BuildCapture (
+  IN CONST CHAR8  *Name,
+  IN BOOLEAN      Variant
+  )
+{
+  STATIC UINT8           Pci[4 * 300];
+  STATIC UINT8           Variables[1024];
+  UINT8                  Noise[200];
+  UINT8                  Timeout[2] = { Variant ? 2 : 5, 0 };
+  UINT32                 Seed       = 1;
+  UINTN                  PciSize;
+  UINTN                  VariablesSize;
+  UINT32                 End = 0;
+  SNAPSHOT_SMBIOS        Smbios;
+  SNAPSHOT_SMBIOS_RECORD Record;
+  UINT8                  Smbios0[0x18 + 2] = { 0, 0x18, 0, 0 };
+  UINT8                  SmbiosSection[sizeof(Smbios) + sizeof(Record) + sizeof(Smbios0)];
+  SNAPSHOT_SECTION_ENTRY *Future;
+  SNAPSHOT_BLOCK_HEADER  Block;
+
+  // Noise keeps MiuLz from shrinking the unknown section, so it is stored
+  for (UINTN i = 0; i < sizeof(Noise); i++) {
+    Seed     = Seed * 1103515245 + 12345;
+    Noise[i] = (UINT8)(Seed >> 16);
+  }
+
+  BeginSnapshot();
+
+  PciSize  = AddPciDevice(Pci, 0, 0, 0x8086, 0x1234, 0x06);
+  PciSize += AddPciDevice(Pci + PciSize, 0, 0x1F, 0x8086, 0xA0C8, 0x04);
+  if (Variant) {
+    PciSize += AddPciDevice(Pci + PciSize, 1, 0, 0x10DE, 0x2204, 0x03);
+  }
+  AddSection(SNAPSHOT_SECTION_PCI, "pci", Pci, PciSize, Variant ? 3 : 2, TRUE);
+
+  VariablesSize  = AddVariable(Variables, "Timeout", Timeout, sizeof(Timeout));
+  VariablesSize += AddVariable(Variables + VariablesSize, "Lang", (CONST UINT8 *)"eng", 4);
+  memcpy(Variables + VariablesSize, &End, sizeof(End));
+  VariablesSize += sizeof(End);
+  AddSection(SNAPSHOT_SECTION_VARIABLES, "variables", Variables, VariablesSize, 2, TRUE);
+
+  memset(&Smbios, 0, sizeof(Smbios));
+  memset(&Record, 0, sizeof(Record));
+  Smbios.MajorVersion = 3;
+  Smbios.MinorVersion = Variant ? 4 : 3;
+  Smbios.RecordCount  = 1;
+  Record.Length       = sizeof(Smbios0);
+  memcpy(SmbiosSection, &Smbios, sizeof(Smbios));
+  memcpy(SmbiosSection + sizeof(Smbios), &Record, sizeof(Record));
+  memcpy(SmbiosSection + sizeof(Smbios) + sizeof(Record), Smbios0, sizeof(Smbios0));
+  AddSection(SNAPSHOT_SECTION_SMBIOS, "smbios", SmbiosSection, sizeof(SmbiosSection), 1, FALSE);
+
+  Future = AddSection(TEST_TYPE_FUTURE, "future", Noise, sizeof(Noise), 1, TRUE);
+  memcpy(&Block, mBuilder.Data + Future->Offset, sizeof(Block));
+  if ((Block.StoredSize & SNAPSHOT_BLOCK_STORED) == 0) {
+    fprintf(stderr, "MakeTestSnapshots: the noise block compressed, no stored block to test\n");
+    exit(2);
+  }
+  EndSnapshot(Name);
+  WriteFile("future.raw", Noise, sizeof(Noise));
+}
+
+/**
+  Files MiuSnap must reject: exit status 2 when they cannot be opened, 1
+  from verify when only a section is damaged.
+**/
+STATIC
+VOID
+BuildDamaged (
+  VOID
+  )
+{
+  SNAPSHOT_TRAILER       Trailer;
+  SNAPSHOT_SECTION_ENTRY *Entry;
+  STATIC UINT8           Pci[300];
+  UINTN                  Size;
+
+  // A payload byte flipped after the CRC was taken
+  BuildCapture("bad-crc.miu", FALSE);
+  mBuilder.Data[mBuilder.Sections[2].Offset + 1] ^= 0x01;
+  WriteFile("bad-crc.miu", mBuilder.Data, mBuilder.Size);
+
+  // Cut short: no trailer
+  BuildCapture("truncated.miu", FALSE);
+  WriteFile("truncated.miu", mBuilder.Data, mBuilder.Size / 2);
+
+  // TableOffset + SectionCount * EntrySize wraps around to the trailer
+  BeginSnapshot();
+  memset(&Trailer, 0, sizeof(Trailer));
+  Trailer.TableOffset  = 0x20000001F;
+  Trailer.SectionCount = MAX_UINT32;
+  Trailer.EntrySize    = MAX_UINT32;
+  Trailer.Signature    = SNAPSHOT_END_SIGNATURE;
+  Append(&Trailer, sizeof(Trailer));
+  WriteFile("overflow-table.miu", mBuilder.Data, mBuilder.Size);
+
+  // Section table starting past the end of the file
+  Trailer.TableOffset  = MAX_UINT32;
+  Trailer.SectionCount = 1;
+  Trailer.EntrySize    = sizeof(SNAPSHOT_SECTION_ENTRY);
+  memcpy(mBuilder.Data + sizeof(SNAPSHOT_HEADER), &Trailer, sizeof(Trailer));
+  WriteFile("table-past-end.miu", mBuilder.Data, mBuilder.Size);
+
+  // A compressed section claiming far more bytes than its blocks can hold
+  BeginSnapshot();
+  Size           = AddPciDevice(Pci, 0, 0, 0x8086, 0x1234, 0x06);
+  Entry          = AddSection(SNAPSHOT_SECTION_PCI, "pci", Pci, Size, 1, TRUE);
+  Entry->RawSize = MAX_UINT64;
+  EndSnapshot("huge-section.miu");
+}
+
+int
+main (
+  int   Argc,
+  char  **Argv
+  )
+{
+  if (Argc != 2) {
+    fprintf(stderr, "Usage: MakeTestSnapshots OUTDIR\n");
+    return 2;
+  }
+  mOutDir = Argv[1];
+
+  BuildCapture("base.miu", FALSE);
+  BuildCapture("changed.miu", TRUE);
+  BuildDamaged();
+  return 0;
+}
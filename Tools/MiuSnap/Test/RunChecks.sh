@@ -0,0 +1,83 @@
+#!/bin/sh
+#
+# Runs MiuSnap over the snapshots MakeTestSnapshots writes and checks the
+# exit status of each command: 0 success or no difference, 1 differences
+# or a bad section, 2 errors. A crash (status above 128) always fails.
+#
+# Usage: RunChecks.sh MIUSNAP MAKETESTSNAPSHOTS OUTDIR
+#
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+MIUSNAP=$1
+OUT=$3
+FAILED=0
+
+mkdir -p "$OUT" && "$2" "$OUT" || exit 2
+
+# expect STATUS ARGS...: run MiuSnap with ARGS and compare its exit status
+expect () {
+  Want=$1
+  shift
+  "$MIUSNAP" "$@" > "$OUT/last.out" 2>&1
+  Got=$?
+  if [ "$Got" -ne "$Want" ]; then
+    echo "FAIL: MiuSnap $* exited $Got, expected $Want"
+    sed 's/^/  | /' "$OUT/last.out"
+    FAILED=$((FAILED + 1))
+  else
+    echo "ok:   MiuSnap $*"
+  fi
+}
+
+# expect_output PATTERN: the last command printed PATTERN
+expect_output () {
+  if ! grep -q -- "$1" "$OUT/last.out"; then
+    echo "FAIL: output has no '$1'"
+    FAILED=$((FAILED + 1))
+  fi
+}
+
+B=$OUT/base.miu
+C=$OUT/changed.miu
+
+expect 0 verify "$B" "$C"
+expect 0 info "$B"
+expect 0 info "$B" --json
+expect_output '"name":"future","type":99'
+expect 0 show "$B"
+expect 0 show "$B" --json
+expect_output '"vendor":"8086"'
+expect_output '"name":"Lang"'
+expect 0 show "$C" pci 5
+expect_output '0000:01:00.0'
+expect 0 extract "$B" future "$OUT/future.bin"
+if ! cmp -s "$OUT/future.bin" "$OUT/future.raw"; then
+  echo "FAIL: extract of the unknown section returned the wrong bytes"
+  FAILED=$((FAILED + 1))
+fi
+
+expect 0 diff "$B" "$B"
+expect 1 diff "$B" "$C"
+expect_output '+ 0000:01:00.0'
+expect_output 'Timeout  contents differ'
+expect_output 'version: 3.3 -> 3.4'
+expect 1 diff "$B" "$C" --json
+expect_output '"identical":false'
+expect 0 diff "$B" "$C" future
+expect 2 diff "$B" "$C" nosuchsection
+
+expect 1 verify "$OUT/bad-crc.miu"
+expect 2 show "$OUT/bad-crc.miu" smbios
+for Damaged in truncated overflow-table table-past-end huge-section; do
+  expect 2 info "$OUT/$Damaged.miu"
+  expect 2 diff "$B" "$OUT/$Damaged.miu"
+done
+expect 2 info "$OUT/missing.miu"
+expect 2 frobnicate "$B"
+
+if [ "$FAILED" -ne 0 ]; then
+  echo "$FAILED check(s) failed"
+  exit 1
+fi
+echo "All checks passed"
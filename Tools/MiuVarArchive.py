@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+## @file
+#  Host-side reader for the UEFI variable archive written by MiU
+#  (Ctrl+S in the variable list, layout in Application/MiU/VariableArchive.h).
+#
+#  Usage:
+#    MiuVarArchive.py variable_archive.bin              list every variable
+#    MiuVarArchive.py variable_archive.bin --json       dump as JSON
+#    MiuVarArchive.py variable_archive.bin -x OUTDIR    extract Name-GUID.bin files
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+##
+
+import argparse
+import json
+import os
+import struct
+import sys
+import uuid
+
+SIGNATURE = b"MIUVARS\0"
+HEADER = struct.Struct("<8sII")       # Signature, Version, HeaderSize
+RECORD = struct.Struct("<II16sII")    # RecordSize, Attributes, VendorGuid, NameSize, DataSize
+
+ATTRIBUTE_NAMES = (
+    (0x01, "NV"),
+    (0x02, "BS"),
+    (0x04, "RT"),
+    (0x08, "HR"),
+    (0x10, "AW"),
+    (0x20, "AT"),
+    (0x40, "AP"),
+    (0x80, "EA"),
+)
+
+
+def attribute_string(attributes):
+    return "|".join(name for bit, name in ATTRIBUTE_NAMES if attributes & bit)
+
+
+def safe_file_stem(text):
+    """Map everything outside [A-Za-z0-9_-] to '_', like MakeExportFileName()."""
+    return "".join(c if c.isascii() and (c.isalnum() or c in "_-") else "_" for c in text)
+
+
+def read_archive(path):
+    """Yield (name, guid, attributes, data) for every record in the archive."""
+    with open(path, "rb") as f:
+        blob = f.read()
+
+    if len(blob) < HEADER.size:
+        raise ValueError("file too small for an archive header")
+    signature, version, header_size = HEADER.unpack_from(blob, 0)
+    if signature != SIGNATURE:
+        raise ValueError("not a MiU variable archive")
+    if version != 1:
+        raise ValueError("unsupported archive version %d" % version)
+
+    offset = header_size
+    while offset + 4 <= len(blob):
+        (record_size,) = struct.unpack_from("<I", blob, offset)
+        if record_size == 0:
+            return
+        if record_size < RECORD.size or offset + record_size > len(blob):
+            raise ValueError("truncated record at offset 0x%x" % offset)
+
+        _, attributes, guid, name_size, data_size = RECORD.unpack_from(blob, offset)
+        if RECORD.size + name_size + data_size != record_size:
+            raise ValueError("inconsistent record sizes at offset 0x%x" % offset)
+
+        name_start = offset + RECORD.size
+        name = blob[name_start:name_start + name_size].decode("utf-16-le").rstrip("\0")
+        data = blob[name_start + name_size:name_start + name_size + data_size]
+        yield name, str(uuid.UUID(bytes_le=guid)).upper(), attributes, data
+        offset += record_size
+
+    raise ValueError("archive has no end marker (export was interrupted?)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read a MiU UEFI variable archive.")
+    parser.add_argument("archive")
+    parser.add_argument("--json", action="store_true", help="print records as JSON")
+    parser.add_argument("-x", "--extract", metavar="DIR", help="write each variable's data to DIR")
+    args = parser.parse_args()
+
+    try:
+        records = list(read_archive(args.archive))
+    except (OSError, ValueError) as error:
+        print("error: %s" % error, file=sys.stderr)
+        return 1
+
+    if args.json:
+        json.dump([{"name": name, "guid": guid, "attributes": attributes,
+                    "data": data.hex()} for name, guid, attributes, data in records],
+                  sys.stdout, indent=2)
+        print()
+    else:
+        for name, guid, attributes, data in records:
+            print("%-36s %-32s %-12s %6d" % (guid, name, attribute_string(attributes), len(data)))
+        print("%d variables, %d bytes of data" % (len(records), sum(len(r[3]) for r in records)))
+
+    if args.extract:
+        # Names come from the archive, which may have been made anywhere
+        os.makedirs(args.extract, exist_ok=True)
+        root = os.path.realpath(args.extract)
+        for name, guid, _, data in records:
+            path = os.path.realpath(os.path.join(root, "%s-%s.bin" % (safe_file_stem(name), guid)))
+            if os.path.dirname(path) != root:
+                print("error: refusing to write %s outside %s" % (path, root), file=sys.stderr)
+                return 1
+            with open(path, "wb") as f:
+                f.write(data)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())